@@ -333,6 +333,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/storage/resource_options.cpp",
     "src/mbgl/storage/resource_transform.cpp",
     "src/mbgl/storage/response.cpp",
+    "src/mbgl/style/batch_filter.cpp",
+    "src/mbgl/style/batch_filter.hpp",
     "src/mbgl/style/collection.hpp",
     "src/mbgl/style/conversion/color_ramp_property_value.cpp",
     "src/mbgl/style/conversion/constant.cpp",
@@ -364,6 +366,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/style/expression/assertion.cpp",
     "src/mbgl/style/expression/at.cpp",
     "src/mbgl/style/expression/boolean_operator.cpp",
+    "src/mbgl/style/expression/bytecode.cpp",
+    "src/mbgl/style/expression/bytecode.hpp",
     "src/mbgl/style/expression/case.cpp",
     "src/mbgl/style/expression/check_subtype.cpp",
     "src/mbgl/style/expression/coalesce.cpp",
@@ -379,6 +383,7 @@ MLN_CORE_SOURCE = [
     "src/mbgl/style/expression/find_zoom_curve.cpp",
     "src/mbgl/style/expression/format_expression.cpp",
     "src/mbgl/style/expression/formatted.cpp",
+    "src/mbgl/style/expression/geojson_feature.hpp",
     "src/mbgl/style/expression/get_covering_stops.cpp",
     "src/mbgl/style/expression/image.cpp",
     "src/mbgl/style/expression/image_expression.cpp",
@@ -460,6 +465,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/style/sources/geojson_source.cpp",
     "src/mbgl/style/sources/geojson_source_impl.cpp",
     "src/mbgl/style/sources/geojson_source_impl.hpp",
+    "src/mbgl/style/sources/geojson_stream_reader.cpp",
+    "src/mbgl/style/sources/geojson_stream_reader.hpp",
     "src/mbgl/style/sources/image_source.cpp",
     "src/mbgl/style/sources/image_source_impl.cpp",
     "src/mbgl/style/sources/image_source_impl.hpp",
@@ -486,6 +493,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/text/get_anchors.cpp",
     "src/mbgl/text/get_anchors.hpp",
     "src/mbgl/text/glyph.cpp",
+    "src/mbgl/text/glyph_cache.cpp",
+    "src/mbgl/text/glyph_cache.hpp",
     "src/mbgl/text/glyph_manager.cpp",
     "src/mbgl/text/glyph_manager.hpp",
     "src/mbgl/text/glyph_manager_observer.hpp",
@@ -500,6 +509,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/text/quads.hpp",
     "src/mbgl/text/shaping.cpp",
     "src/mbgl/text/shaping.hpp",
+    "src/mbgl/text/shaping_cache.cpp",
+    "src/mbgl/text/shaping_cache.hpp",
     "src/mbgl/text/tagged_string.cpp",
     "src/mbgl/text/tagged_string.hpp",
     "src/mbgl/text/harfbuzz.cpp",
@@ -508,6 +519,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/tile/custom_geometry_tile.hpp",
     "src/mbgl/tile/custom_vector_tile.cpp",
     "src/mbgl/tile/custom_vector_tile.hpp",
+    "src/mbgl/tile/feature_cache.cpp",
+    "src/mbgl/tile/feature_cache.hpp",
     "src/mbgl/tile/geojson_tile.cpp",
     "src/mbgl/tile/geojson_tile.hpp",
     "src/mbgl/tile/geojson_tile_data.hpp",
@@ -517,6 +530,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/tile/geometry_tile_data.hpp",
     "src/mbgl/tile/geometry_tile_worker.cpp",
     "src/mbgl/tile/geometry_tile_worker.hpp",
+    "src/mbgl/tile/parallel_bucket_builder.cpp",
+    "src/mbgl/tile/parallel_bucket_builder.hpp",
     "src/mbgl/tile/raster_dem_tile.cpp",
     "src/mbgl/tile/raster_dem_tile.hpp",
     "src/mbgl/tile/raster_dem_tile_worker.cpp",
@@ -525,6 +540,8 @@ MLN_CORE_SOURCE = [
     "src/mbgl/tile/raster_tile.hpp",
     "src/mbgl/tile/raster_tile_worker.cpp",
     "src/mbgl/tile/raster_tile_worker.hpp",
+    "src/mbgl/tile/raw_tile_cache.cpp",
+    "src/mbgl/tile/raw_tile_cache.hpp",
     "src/mbgl/tile/tile.cpp",
     "src/mbgl/tile/tile.hpp",
     "src/mbgl/tile/tile_cache.cpp",
@@ -594,6 +611,10 @@ MLN_CORE_SOURCE = [
     "src/mbgl/util/mat4.hpp",
     "src/mbgl/util/math.hpp",
     "src/mbgl/util/padding.cpp",
+    "src/mbgl/util/parallel_jobs.cpp",
+    "src/mbgl/util/parallel_jobs.hpp",
+    "src/mbgl/util/polygon_index.cpp",
+    "src/mbgl/util/polygon_index.hpp",
     "src/mbgl/util/premultiply.cpp",
     "src/mbgl/util/quaternion.cpp",
     "src/mbgl/util/quaternion.hpp",
@@ -703,6 +724,7 @@ MLN_CORE_HEADERS = [
     "include/mbgl/platform/settings.hpp",
     "include/mbgl/platform/thread.hpp",
     "include/mbgl/platform/time.hpp",
+    "include/mbgl/renderer/placement_stats.hpp",
     "include/mbgl/renderer/query.hpp",
     "include/mbgl/renderer/renderer.hpp",
     "include/mbgl/renderer/renderer_frontend.hpp",
@@ -809,6 +831,7 @@ MLN_CORE_HEADERS = [
     "include/mbgl/style/variable_anchor_offset_collection.hpp",
     "include/mbgl/text/glyph.hpp",
     "include/mbgl/text/glyph_range.hpp",
+    "include/mbgl/tile/tile_cache_stats.hpp",
     "include/mbgl/tile/tile_id.hpp",
     "include/mbgl/tile/tile_operation.hpp",
     "include/mbgl/tile/tile_necessity.hpp",
@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
+
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+#include <mbgl/style/property_expression.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace mln;
+using namespace mln::style;
+
+namespace {
+
+// Data-driven expressions like the ones of common styles
+const std::array<const char*, 3> expressions = {
+    // A color for each class of feature
+    R"(["match", ["get", "class"],
+        "park", ["to-color", "#c8facc"],
+        ["forest", "wood"], ["to-color", "#add19e"],
+        "water", ["to-color", "#aad3df"],
+        ["residential", "commercial", "industrial"], ["to-color", "#e0dfdf"],
+        ["to-color", "#f2efe9"]])",
+    // A width growing with zoom, scaled by a property
+    R"(["interpolate", ["exponential", 1.5], ["zoom"],
+        5, ["*", ["number", ["get", "width"], 1], 0.5],
+        12, ["*", ["number", ["get", "width"], 1], 2],
+        18, ["+", ["*", ["number", ["get", "width"], 1], 8], 4]])",
+    // An opacity picked by several conditions, with fallbacks for missing properties
+    R"(["case",
+        ["all", ["==", ["get", "class"], "water"], [">", ["coalesce", ["get", "rank"], 0], 3]], 0.8,
+        ["any", ["==", ["get", "class"], "park"], ["<", ["number", ["coalesce", ["get", "rank"], 10]], 2]], 0.6,
+        ["/", ["max", ["number", ["coalesce", ["get", "rank"], 1]], 1], 10]])",
+};
+
+std::vector<StubGeometryTileFeature> makeFeatures() {
+    const std::array<const char*, 8> classes = {
+        "park", "forest", "wood", "water", "residential", "commercial", "industrial", "farmland"};
+    std::vector<StubGeometryTileFeature> features;
+    for (std::size_t i = 0; i < 1000; ++i) {
+        PropertyMap properties{{"class", std::string(classes[i % classes.size()])},
+                               {"width", static_cast<double>(i % 7) + 0.5}};
+        if (i % 3 != 0) {
+            properties.emplace("rank", static_cast<int64_t>(i % 11));
+        }
+        features.emplace_back(std::move(properties));
+    }
+    return features;
+}
+
+template <typename T>
+void evaluate(benchmark::State& state) {
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_EXPRESSION_BYTECODE, state.range(1) != 0);
+    const char* json = expressions[static_cast<std::size_t>(state.range(0))];
+    const PropertyExpression<T> property(expression::dsl::createExpression(json));
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_EXPRESSION_BYTECODE, false);
+    const auto features = makeFeatures();
+
+    for (auto _ : state) {
+        for (const auto& feature : features) {
+            benchmark::DoNotOptimize(property.evaluate(14.5f, feature, T()));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(features.size()));
+}
+
+// Arguments are the expression, and whether it's evaluated through its bytecode
+void Evaluate_ExpressionColor(benchmark::State& state) {
+    evaluate<Color>(state);
+}
+
+void Evaluate_ExpressionNumber(benchmark::State& state) {
+    evaluate<float>(state);
+}
+
+} // namespace
+
+BENCHMARK(Evaluate_ExpressionColor)->Args({0, 0})->Args({0, 1});
+BENCHMARK(Evaluate_ExpressionNumber)->Args({1, 0})->Args({1, 1})->Args({2, 0})->Args({2, 1});
@@ -0,0 +1,113 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/tile/feature_cache.hpp>
+#include <mbgl/tile/vector_mvt_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <optional>
+
+using namespace mln;
+
+namespace {
+
+struct Group {
+    std::string sourceLayer;
+    style::Filter filter;
+};
+
+/// Layer groups in the proportions of a production style, where most groups read the road layer
+/// with a filter per road class.
+std::vector<Group> makeGroups() {
+    const std::vector<std::pair<std::string, std::vector<std::string>>> classes = {
+        {"road",
+         {"motorway",
+          "motorway_link",
+          "trunk",
+          "primary",
+          "secondary",
+          "tertiary",
+          "street",
+          "street_limited",
+          "service",
+          "track",
+          "path",
+          "major_rail",
+          "minor_rail",
+          "pedestrian",
+          "link",
+          "construction"}},
+        {"landuse", {"park", "wood", "grass", "cemetery", "hospital", "school"}},
+        {"building", {"building", "building:part"}},
+        {"poi_label", {"park", "restaurant", "shop", "school"}},
+        {"water", {"water"}},
+    };
+
+    std::vector<Group> groups;
+    for (const auto& [sourceLayer, values] : classes) {
+        for (const auto& value : values) {
+            style::conversion::Error error;
+            const std::string json = R"(["!=", "class", ")" + value + R"("])";
+            auto filter = style::conversion::convertJSON<style::Filter>(json, error);
+            groups.push_back({.sourceLayer = sourceLayer, .filter = std::move(*filter)});
+        }
+    }
+    return groups;
+}
+
+} // namespace
+
+/// Reads the features of a dense tile the way tile parsing does, once per layer group, with and
+/// without sharing decoded features between groups.
+static void FeatureCache_DenseTile(benchmark::State& state) {
+    const bool shared = state.range(0) != 0;
+    const auto data = std::make_shared<const std::string>(
+        util::read_file("metrics/integration/tiles/14-8803-5375.mvt"));
+    const auto groups = makeGroups();
+    const CanonicalTileID tileID{14, 8803, 5375};
+
+    FeatureCache::Stats stats;
+    for (auto _ : state) {
+        VectorMVTTileData tile(data);
+        std::optional<FeatureCache> cache;
+        if (shared) {
+            cache.emplace(64 * 1024 * 1024);
+            for (const auto& group : groups) {
+                cache->addUse(group.sourceLayer);
+            }
+        }
+
+        std::size_t vertices = 0;
+        for (const auto& group : groups) {
+            auto layer = cache ? cache->getLayer(tile, group.sourceLayer) : tile.getLayer(group.sourceLayer);
+            if (!layer) {
+                continue;
+            }
+            for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+                const auto feature = layer->getFeature(i);
+                const auto context = style::expression::EvaluationContext(14.0f, feature.get())
+                                         .withCanonicalTileID(&tileID);
+                if (!group.filter(context)) {
+                    continue;
+                }
+                for (const auto& ring : feature->getGeometries()) {
+                    vertices += ring.size();
+                }
+            }
+        }
+        benchmark::DoNotOptimize(vertices);
+
+        if (cache) {
+            stats = cache->getStats();
+        }
+    }
+
+    state.counters["shared"] = static_cast<double>(stats.hits);
+    state.counters["decoded"] = static_cast<double>(stats.misses);
+    state.counters["bytes"] = static_cast<double>(stats.bytes);
+}
+
+BENCHMARK(FeatureCache_DenseTile)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -1,12 +1,23 @@
 #include <benchmark/benchmark.h>
 
+#include <mbgl/math/angles.hpp>
+#include <mbgl/style/batch_filter.hpp>
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/conversion/filter.hpp>
 #include <mbgl/style/conversion_impl.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/tile/vector_mvt_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
 #include <mbgl/benchmark/stub_geometry_tile_feature.hpp>
 
+#include <cmath>
+#include <numbers>
+#include <random>
+#include <string>
+
 using namespace mln;
 
 style::Filter parse(const char* expression) {
@@ -30,5 +41,112 @@ static void Parse_EvaluateFilter(benchmark::State& state) {
     }
 }
 
+namespace {
+
+const CanonicalTileID denseTileID{14, 8803, 5375};
+
+/// Filters of the forms common in production styles, all reading the road layer of a dense tile
+const std::vector<const char*> layerFilters = {
+    R"FILTER(["==", "class", "street"])FILTER",
+    R"FILTER(["in", "class", "motorway", "trunk", "primary", "secondary"])FILTER",
+    R"FILTER(["all", ["has", "class"], ["!=", "type", "service"], ["==", "$type", "LineString"]])FILTER",
+    R"FILTER(["match", ["get", "class"], ["motorway", "trunk"], true, false])FILTER",
+};
+
+/// A `within` filter with a boundary of `vertices` vertices around the middle of the dense tile, covering about
+/// half of it, as a city boundary would
+std::string makeWithinFilter(std::size_t vertices) {
+    const double tiles = std::pow(2.0, denseTileID.z);
+    const auto lon = [&](double x) {
+        return x / tiles * util::DEGREES_MAX - util::LONGITUDE_MAX;
+    };
+    const auto lat = [&](double y) {
+        return util::rad2deg(std::atan(std::sinh(std::numbers::pi * (1 - 2 * y / tiles))));
+    };
+
+    std::string filter = R"(["within", {"type": "Polygon", "coordinates": [[)";
+    for (std::size_t i = 0; i <= vertices; ++i) {
+        const double angle = 2 * std::numbers::pi * static_cast<double>(i % vertices) / static_cast<double>(vertices);
+        const double radius = 0.4 + 0.05 * std::sin(7 * angle);
+        filter += (i ? ", [" : "[") + std::to_string(lon(denseTileID.x + 0.5 + radius * std::cos(angle))) + ", " +
+                  std::to_string(lat(denseTileID.y + 0.5 + radius * std::sin(angle))) + "]";
+    }
+    return filter + "]]}]";
+}
+
+/// Points of interest spread over the dense tile
+std::vector<StubGeometryTileFeature> makePoints(std::size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<int16_t> position(0, util::EXTENT - 1);
+    std::vector<StubGeometryTileFeature> points;
+    for (std::size_t i = 0; i < count; ++i) {
+        points.emplace_back(FeatureIdentifier{},
+                            FeatureType::Point,
+                            GeometryCollection{{{position(generator), position(generator)}}},
+                            PropertyMap{});
+    }
+    return points;
+}
+
+} // namespace
+
+/// Evaluates a filter for every feature of a layer one at a time, as tile parsing does by default
+static void Parse_EvaluateFilterLayer(benchmark::State& state) {
+    const style::Filter filter = parse(layerFilters[state.range(0)]);
+    const VectorMVTTileData tile(
+        std::make_shared<const std::string>(util::read_file("metrics/integration/tiles/14-8803-5375.mvt")));
+    const auto layer = tile.getLayer("road");
+
+    std::size_t selected = 0;
+    for (auto _ : state) {
+        selected = 0;
+        for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+            const auto feature = layer->getFeature(i);
+            selected += filter(
+                style::expression::EvaluationContext(14.0f, feature.get()).withCanonicalTileID(&denseTileID));
+        }
+        benchmark::DoNotOptimize(selected);
+    }
+    state.counters["features"] = static_cast<double>(layer->featureCount());
+    state.counters["selected"] = static_cast<double>(selected);
+}
+
+/// Evaluates the same filters for the whole layer at once
+static void Parse_EvaluateBatchFilterLayer(benchmark::State& state) {
+    const style::Filter filter = parse(layerFilters[state.range(0)]);
+    const VectorMVTTileData tile(
+        std::make_shared<const std::string>(util::read_file("metrics/integration/tiles/14-8803-5375.mvt")));
+    const auto layer = tile.getLayer("road");
+
+    std::size_t selected = 0;
+    for (auto _ : state) {
+        const style::BatchFilter batch(filter);
+        selected = batch(*layer, 14.0f, denseTileID).count();
+        benchmark::DoNotOptimize(selected);
+    }
+    state.counters["features"] = static_cast<double>(layer->featureCount());
+    state.counters["selected"] = static_cast<double>(selected);
+}
+
+/// Evaluates a `within` filter for the points of interest of a tile, against boundaries of growing complexity
+static void Parse_EvaluateWithinFilter(benchmark::State& state) {
+    const style::Filter filter = parse(makeWithinFilter(static_cast<std::size_t>(state.range(0))).c_str());
+    const auto points = makePoints(5000);
+
+    std::size_t selected = 0;
+    for (auto _ : state) {
+        selected = 0;
+        for (const auto& point : points) {
+            selected += filter(style::expression::EvaluationContext(14.0f, &point).withCanonicalTileID(&denseTileID));
+        }
+        benchmark::DoNotOptimize(selected);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * points.size()));
+    state.counters["selected"] = static_cast<double>(selected);
+}
+
 BENCHMARK(Parse_Filter);
 BENCHMARK(Parse_EvaluateFilter);
+BENCHMARK(Parse_EvaluateFilterLayer)->DenseRange(0, 3);
+BENCHMARK(Parse_EvaluateBatchFilterLayer)->DenseRange(0, 3);
+BENCHMARK(Parse_EvaluateWithinFilter)->Arg(100)->Arg(1000)->Arg(10000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,164 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/style/conversion/geojson.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/style/sources/geojson_stream_reader.hpp>
+#include <mbgl/util/monotonic_timer.hpp>
+
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+
+using namespace mln;
+
+namespace {
+
+constexpr std::size_t featureCount = 200000;
+constexpr std::size_t chunkSize = 16384;
+
+std::shared_ptr<const std::string> makeCollection() {
+    std::string json = R"({"type": "FeatureCollection", "features": [)";
+    for (std::size_t i = 0; i < featureCount; ++i) {
+        json += (i ? "," : "") + std::string(R"({"type": "Feature", "id": )") + std::to_string(i) +
+                R"(, "properties": {"name": "feature )" + std::to_string(i) + R"(", "rank": )" +
+                std::to_string(i % 10) + R"(}, "geometry": {"type": "LineString", "coordinates": [[)" +
+                std::to_string(i % 360 - 180.0) + ", 10.5], [" + std::to_string(i % 360 - 179.5) + ", 11]]}}";
+    }
+    return std::make_shared<const std::string>(json + "]}");
+}
+
+const std::shared_ptr<const std::string>& collection() {
+    static const auto data = makeCollection();
+    return data;
+}
+
+#ifdef __linux__
+// A value of /proc/self/status, in kB
+double readProcessStatus(const std::string& key) {
+    std::ifstream status("/proc/self/status");
+    for (std::string line; std::getline(status, line);) {
+        if (line.starts_with(key + ":")) {
+            return std::stod(line.substr(key.size() + 1));
+        }
+    }
+    return 0;
+}
+#endif
+
+// Reports how far the resident set grows above its size when created, as the `peak_rss_mb` counter. The peak is
+// reset first, so that earlier benchmarks don't hide it. Only supported on Linux.
+class PeakRSS {
+public:
+    PeakRSS() {
+#ifdef __linux__
+        std::ofstream("/proc/self/clear_refs") << "5";
+        initial = readProcessStatus("VmRSS");
+#endif
+    }
+
+    void report(benchmark::State& state) const {
+#ifdef __linux__
+        state.counters["peak_rss_mb"] = (readProcessStatus("VmHWM") - initial) / 1024;
+#else
+        (void)state;
+#endif
+    }
+
+private:
+    double initial = 0;
+};
+
+// The whole document is parsed into a DOM before any feature is available
+void Parse_GeoJSONDocument(benchmark::State& state) {
+    const auto& data = collection();
+    const PeakRSS peakRSS;
+    for (auto _ : state) {
+        style::conversion::Error error;
+        auto geoJSON = style::conversion::convertJSON<GeoJSON>(*data, error);
+        benchmark::DoNotOptimize(geoJSON);
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data->size()));
+    peakRSS.report(state);
+}
+
+// The features are read a chunk at a time, the first of them being available after the first chunk
+void Parse_GeoJSONStream(benchmark::State& state) {
+    const auto& data = collection();
+    const PeakRSS peakRSS;
+    double firstChunk = 0;
+    for (auto _ : state) {
+        style::GeoJSONStreamReader reader(data);
+        const auto start = util::MonotonicTimer::now();
+        reader.read(chunkSize);
+        firstChunk += std::chrono::duration<double, std::milli>(util::MonotonicTimer::now() - start).count();
+        while (!reader.isDone()) {
+            reader.read(chunkSize);
+        }
+        benchmark::DoNotOptimize(reader.getFeatures());
+    }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(data->size()));
+    state.counters["first_chunk_ms"] = firstChunk / static_cast<double>(state.iterations());
+    peakRSS.report(state);
+}
+
+GeoJSONFeature makePoint(uint64_t id, std::mt19937& generator) {
+    std::uniform_real_distribution<double> longitude(-180.0, 180.0);
+    std::uniform_real_distribution<double> latitude(-80.0, 80.0);
+    GeoJSONFeature feature{mapbox::geometry::point<double>{longitude(generator), latitude(generator)}};
+    feature.id = id;
+    return feature;
+}
+
+// Arguments are the features moved by each update, and whether the data is updated with the diff, or indexed anew
+// with all the features as before. Every tile of zoom level 2 is read after the update, like a view of the world.
+void Update_GeoJSON(benchmark::State& state) {
+    const auto changedCount = static_cast<uint64_t>(state.range(0));
+    const bool incremental = state.range(1) != 0;
+
+    std::mt19937 generator(42);
+    style::GeoJSONData::Features features;
+    for (uint64_t i = 0; i < featureCount; ++i) {
+        features.push_back(makePoint(i, generator));
+    }
+    Mutable<style::GeoJSONOptions> options = makeMutable<style::GeoJSONOptions>();
+    options->updatable = incremental;
+    auto data = style::GeoJSONData::create(features, Scheduler::GetSequenced(), std::move(options));
+
+    std::uniform_int_distribution<uint64_t> feature(0, featureCount - 1);
+    for (auto _ : state) {
+        style::GeoJSONDiff diff;
+        for (uint64_t i = 0; i < changedCount; ++i) {
+            diff.update.push_back(makePoint(feature(generator), generator));
+        }
+        if (incremental) {
+            data = data->update(diff);
+        } else {
+            for (auto& point : diff.update) {
+                features[point.id.get<uint64_t>()] = std::move(point);
+            }
+            data = style::GeoJSONData::create(features, Scheduler::GetSequenced());
+        }
+        for (uint32_t x = 0; x < 4; ++x) {
+            for (uint32_t y = 0; y < 4; ++y) {
+                data->getTile({2, x, y}, [](const style::GeoJSONData::TileFeatures&) {}, true);
+            }
+        }
+    }
+}
+
+} // namespace
+
+BENCHMARK(Parse_GeoJSONDocument)->Unit(benchmark::kMillisecond);
+BENCHMARK(Parse_GeoJSONStream)->Unit(benchmark::kMillisecond);
+BENCHMARK(Update_GeoJSON)
+    ->Args({1, 0})
+    ->Args({1, 1})
+    ->Args({100, 0})
+    ->Args({100, 1})
+    ->Args({10000, 0})
+    ->Args({10000, 1})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,132 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/tile/parallel_bucket_builder.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/layermanager/layer_manager.hpp>
+#include <mbgl/layout/layout.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/transition_parameters.hpp>
+#include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/style/conversion/json.hpp>
+#include <mbgl/style/conversion_impl.hpp>
+#include <mbgl/style/layers/circle_layer.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/tile/vector_mvt_tile_data.hpp>
+#include <mbgl/util/chrono.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/thread_pool.hpp>
+
+using namespace mln;
+using namespace mln::style;
+
+namespace {
+
+const OverscaledTileID tileID{14, 8803, 5375};
+
+struct Group {
+    std::string sourceLayer;
+    std::vector<Immutable<LayerProperties>> layers;
+};
+
+/// A style with several layers per source layer of a dense streets tile, each with its own
+/// filter so that every layer becomes a separate group, as in detailed production styles.
+std::vector<Group> makeGroups() {
+    const std::vector<std::pair<std::string, const char*>> sourceLayers = {{"building", "fill"},
+                                                                           {"landuse", "fill"},
+                                                                           {"water", "fill"},
+                                                                           {"hillshade", "fill"},
+                                                                           {"road", "line"},
+                                                                           {"tunnel", "line"},
+                                                                           {"bridge", "line"},
+                                                                           {"barrier_line", "line"},
+                                                                           {"waterway", "line"},
+                                                                           {"contour", "line"},
+                                                                           {"poi_label", "circle"},
+                                                                           {"housenum_label", "circle"}};
+    constexpr int layersPerSourceLayer = 4;
+
+    std::vector<Group> groups;
+    for (const auto& [sourceLayer, type] : sourceLayers) {
+        for (int i = 0; i < layersPerSourceLayer; ++i) {
+            const std::string id = sourceLayer + "-" + std::to_string(i);
+            const std::string filterJSON = R"(["!=", "class", ")" + id + R"("])";
+            conversion::Error error;
+            const auto filter = conversion::convertJSON<Filter>(filterJSON, error);
+
+            std::unique_ptr<Layer> layer;
+            if (std::string_view(type) == "fill") {
+                layer = std::make_unique<FillLayer>(id, "source");
+            } else if (std::string_view(type) == "line") {
+                layer = std::make_unique<LineLayer>(id, "source");
+            } else {
+                layer = std::make_unique<CircleLayer>(id, "source");
+            }
+            layer->setSourceLayer(sourceLayer);
+            layer->setFilter(*filter);
+
+            auto renderLayer = LayerManager::get()->createRenderLayer(layer->baseImpl);
+            renderLayer->transition(TransitionParameters{.now = Clock::now(), .transition = TransitionOptions()});
+            renderLayer->evaluate(PropertyEvaluationParameters(static_cast<float>(tileID.overscaledZ)));
+            groups.push_back({.sourceLayer = sourceLayer, .layers = {renderLayer->evaluatedProperties}});
+        }
+    }
+    return groups;
+}
+
+} // namespace
+
+/// Latency of building all buckets of one dense tile, by the number of helper tasks
+/// joining the calling thread. Zero helpers is the serial baseline.
+static void ParallelBucketBuilder_DenseTile(benchmark::State& state) {
+    const auto helpers = static_cast<std::size_t>(state.range(0));
+    const auto data = std::make_shared<const std::string>(
+        util::read_file("metrics/integration/tiles/14-8803-5375.mvt"));
+    const auto groups = makeGroups();
+
+    TaggedScheduler scheduler{std::make_shared<ThreadPool>(), util::SimpleIdentity{}};
+    const std::atomic<bool> obsolete{false};
+    std::set<std::string> availableImages;
+
+    for (auto _ : state) {
+        VectorMVTTileData tile(data);
+        ParallelBucketBuilder builder(scheduler,
+                                      obsolete,
+                                      {.fontFaces = nullptr,
+                                       .availableImages = availableImages,
+                                       .firstLoad = true,
+                                       .showCollisionBoxes = false});
+        for (const auto& group : groups) {
+            if (auto layer = tile.getLayer(group.sourceLayer)) {
+                const BucketParameters parameters{.tileID = tileID,
+                                                  .mode = MapMode::Continuous,
+                                                  .pixelRatio = 1.0f,
+                                                  .layerType = group.layers.front()->baseImpl->getTypeInfo()};
+                builder.add(parameters, group.layers, std::move(layer));
+            }
+        }
+
+        auto featureIndex = std::make_unique<FeatureIndex>(nullptr);
+        mln::unordered_map<std::string, LayerRenderData> renderData;
+        std::vector<std::unique_ptr<Layout>> layouts;
+        GlyphDependencies glyphDependencies;
+        ImageDependencies imageDependencies;
+        builder.build(helpers,
+                      {.featureIndex = featureIndex,
+                       .renderData = renderData,
+                       .layouts = layouts,
+                       .glyphDependencies = glyphDependencies,
+                       .imageDependencies = imageDependencies});
+        benchmark::DoNotOptimize(renderData);
+    }
+}
+
+BENCHMARK(ParallelBucketBuilder_DenseTile)
+    ->Arg(0)
+    ->Arg(1)
+    ->Arg(3)
+    ->Arg(7)
+    ->Unit(benchmark::kMillisecond)
+    ->UseRealTime();
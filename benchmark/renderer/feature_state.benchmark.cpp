@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/renderer/buckets/circle_bucket.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+#include <mbgl/tile/geojson_tile_data.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+constexpr std::size_t featureCount = 100000;
+// The features whose state changes in each frame
+constexpr std::size_t changedCount = featureCount / 100;
+
+std::vector<FeatureStates> makeFrames() {
+    std::mt19937 generator(42);
+    std::uniform_int_distribution<std::size_t> feature(0, featureCount - 1);
+    std::vector<FeatureStates> frames(16);
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        while (frames[i].size() < changedCount) {
+            frames[i].emplace(util::toString(feature(generator)), FeatureState{{"hover", i % 2 == 0}});
+        }
+    }
+    return frames;
+}
+
+// Arguments are whether only the modified ranges of the vertices are uploaded, or all of them as before. Copying
+// into memory stands in for the upload, which needs a context.
+void Update_FeatureState(benchmark::State& state) {
+    const bool ranges = state.range(0) != 0;
+
+    auto features = std::make_shared<mapbox::feature::feature_collection<int16_t>>();
+    features->reserve(featureCount);
+    for (uint64_t i = 0; i < featureCount; ++i) {
+        features->emplace_back(mapbox::geometry::point<int16_t>{0, 0}, PropertyMap{}, i);
+    }
+    const GeoJSONTileLayer layer(features);
+
+    style::CirclePaintProperties::PossiblyEvaluated evaluated;
+    evaluated.get<style::CircleColor>() = PossiblyEvaluatedPropertyValue<Color>(
+        style::PropertyExpression<Color>(style::expression::dsl::createExpression(
+            R"(["case", ["boolean", ["feature-state", "hover"], false], ["to-color", "red"], ["to-color", "blue"]])")));
+    CircleBinders binders(evaluated, 0.0f);
+    for (std::size_t i = 0; i < featureCount; ++i) {
+        binders.populateVertexVectors(*layer.getFeature(i), 4 * (i + 1), i, {}, {}, CanonicalTileID(0, 0, 0));
+    }
+
+    const auto& vertices = binders.interleavedVertexBuffer.sharedVertexVector;
+    std::vector<uint8_t> buffer(vertices->data(), vertices->data() + vertices->bytes());
+    vertices->setUploaded();
+
+    const auto frames = makeFrames();
+    const std::vector<gfx::VertexVectorBase::ModifiedRange> all;
+    std::size_t frame = 0;
+    std::size_t uploaded = 0;
+    for (auto _ : state) {
+        binders.updateVertexVectors(frames[frame++ % frames.size()], layer, {});
+
+        if (const auto& modified = ranges ? vertices->getModifiedRanges() : all; !modified.empty()) {
+            for (const auto& range : modified) {
+                std::memcpy(buffer.data() + range.offset, vertices->data() + range.offset, range.size);
+                uploaded += range.size;
+            }
+        } else {
+            std::memcpy(buffer.data(), vertices->data(), vertices->bytes());
+            uploaded += vertices->bytes();
+        }
+        vertices->setUploaded();
+        benchmark::ClobberMemory();
+    }
+
+    state.counters["uploaded_bytes"] = static_cast<double>(uploaded) / static_cast<double>(state.iterations());
+    state.counters["full_bytes"] = static_cast<double>(vertices->bytes());
+}
+
+} // namespace
+
+BENCHMARK(Update_FeatureState)->Arg(0)->Arg(1);
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
@@ -7,6 +8,7 @@
 #include <mbgl/util/string.hpp>
 #include <mbgl/util/logging.hpp>
 
+#include <filesystem>
 #include <random>
 
 class OfflineDatabase : public benchmark::Fixture {
@@ -200,3 +202,55 @@ BENCHMARK_F(OfflineDatabase, ResizeDatabase)(benchmark::State& state) {
         }
     }
 }
+
+// A panning session against a database on disk: every new tile is written once it has been
+// downloaded, and four tiles already cached are read for each one, with and without WAL
+// journaling and batched writes.
+static void OfflineDatabase_MixedReadWrite(benchmark::State& state) {
+    using namespace mln;
+    using namespace std::chrono_literals;
+
+    const bool batched = state.range(0) != 0;
+    const auto path = std::filesystem::temp_directory_path() / "offline_database_benchmark.db";
+    const auto removeFiles = [&] {
+        std::error_code ec;
+        for (const char* suffix : {"", "-wal", "-shm", "-journal"}) {
+            std::filesystem::remove(path.string() + suffix, ec);
+        }
+    };
+    removeFiles();
+
+    Response response;
+    response.data = std::make_shared<std::string>(50 * 1024, 0);
+    response.expires = util::now() + 1h;
+    const auto tile = [](int32_t i) {
+        return Resource::tile("mapbox://tile_mixed", 1, i % 1024, i / 1024, 10, Tileset::Scheme::XYZ);
+    };
+
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES, batched);
+    {
+        mln::OfflineDatabase db{path.string(), TileServerOptions::DefaultConfiguration()};
+        platform::Settings::getInstance().set(platform::EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES, false);
+
+        int32_t written = 0;
+        for (; written < 100; ++written) {
+            db.put(tile(written), response);
+        }
+        db.flushPendingWrites();
+
+        std::mt19937 gen(0);
+        for (auto _ : state) {
+            db.put(tile(written++), response);
+            for (int i = 0; i < 4; ++i) {
+                auto res = db.get(tile(std::uniform_int_distribution<int32_t>(0, written - 1)(gen)));
+                benchmark::DoNotOptimize(res);
+            }
+        }
+        db.flushPendingWrites();
+    }
+    removeFiles();
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * 5));
+}
+
+BENCHMARK(OfflineDatabase_MixedReadWrite)->Arg(0)->Arg(1)->Unit(benchmark::kMicrosecond);
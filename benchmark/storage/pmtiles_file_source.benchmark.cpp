@@ -0,0 +1,57 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/storage/pmtiles_file_source.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/util/async_request.hpp>
+#include <mbgl/util/client_options.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <filesystem>
+#include <vector>
+
+using namespace mln;
+
+/// Requests every tile of the first zoom levels of a local archive at once, through the file
+/// source thread or through a memory mapping.
+static void PMTilesFileSource_Tiles(benchmark::State& state) {
+    const bool mapped = state.range(0) != 0;
+    const auto path = std::filesystem::current_path() / "test/fixtures/storage/pmtiles/geography-class-png.pmtiles";
+    const std::string url = std::string(util::PMTILES_PROTOCOL) + util::FILE_PROTOCOL + path.string();
+
+    util::RunLoop loop;
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_PMTILES_MEMORY_MAPPING, mapped);
+    PMTilesFileSource fileSource(ResourceOptions::Default(), ClientOptions());
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_PMTILES_MEMORY_MAPPING, false);
+
+    std::vector<Resource> resources;
+    for (int8_t z = 0; z <= 3; ++z) {
+        for (int32_t x = 0; x < (1 << z); ++x) {
+            for (int32_t y = 0; y < (1 << z); ++y) {
+                resources.push_back(Resource::tile(url, 1.0, x, y, z, Tileset::Scheme::XYZ));
+            }
+        }
+    }
+
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        std::vector<std::unique_ptr<AsyncRequest>> requests;
+        std::size_t pending = resources.size();
+        for (const auto& resource : resources) {
+            requests.push_back(fileSource.request(resource, [&](const Response& res) {
+                bytes += res.data ? res.data->size() : 0;
+                if (--pending == 0) {
+                    loop.stop();
+                }
+            }));
+        }
+        loop.run();
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * resources.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+BENCHMARK(PMTilesFileSource_Tiles)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,156 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/storage/offline_database.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/tile/raw_tile_cache.hpp>
+#include <mbgl/util/async_request.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/tile_server_options.hpp>
+
+#include <cmath>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+/// Answers tile requests from an offline database, the way the database file source does from
+/// its cache, including inflating the stored data.
+class DatabaseSource final : public FileSource {
+public:
+    explicit DatabaseSource(OfflineDatabase& db_)
+        : db(db_) {}
+
+    std::unique_ptr<AsyncRequest> request(const Resource& resource, Callback callback) override {
+        return util::RunLoop::Get()->invokeCancellable([this, resource, callback = std::move(callback)] {
+            auto response = db.get(resource);
+            callback(response ? *response : Response());
+        });
+    }
+
+    bool supportsCacheOnlyRequests() const override { return true; }
+    bool canRequest(const Resource&) const override { return true; }
+
+    void setResourceOptions(ResourceOptions) override {}
+    ResourceOptions getResourceOptions() override { return {}; }
+    void setClientOptions(ClientOptions) override {}
+    ClientOptions getClientOptions() override { return {}; }
+
+private:
+    OfflineDatabase& db;
+};
+
+struct Camera {
+    // Center in tile units at zoom 14, and the zoom level
+    double x;
+    double y;
+    int zoom;
+};
+
+/// A browsing session: panning east and back over the same streets, zooming in for a closer look
+/// and out again, then panning north and back.
+std::vector<Camera> makeTrace() {
+    std::vector<Camera> trace;
+    const double x0 = 8803.5;
+    const double y0 = 5375.5;
+    for (int i = 0; i <= 12; ++i) trace.push_back({.x = x0 + i * 0.5, .y = y0, .zoom = 14});
+    for (int i = 12; i >= 0; --i) trace.push_back({.x = x0 + i * 0.5, .y = y0, .zoom = 14});
+    for (int zoom : {15, 16, 15, 14, 13, 14}) trace.push_back({.x = x0, .y = y0, .zoom = zoom});
+    for (int i = 0; i <= 8; ++i) trace.push_back({.x = x0, .y = y0 - i * 0.5, .zoom = 14});
+    for (int i = 8; i >= 0; --i) trace.push_back({.x = x0, .y = y0 - i * 0.5, .zoom = 14});
+    return trace;
+}
+
+/// Tiles covering a 1280x768 viewport around the camera
+std::vector<CanonicalTileID> cover(const Camera& camera) {
+    const double scale = std::pow(2.0, camera.zoom - 14);
+    const double x = camera.x * scale;
+    const double y = camera.y * scale;
+    std::vector<CanonicalTileID> tiles;
+    for (auto ty = static_cast<int64_t>(std::floor(y - 1.5)); ty <= static_cast<int64_t>(std::floor(y + 1.5)); ++ty) {
+        for (auto tx = static_cast<int64_t>(std::floor(x - 2.5)); tx <= static_cast<int64_t>(std::floor(x + 2.5));
+             ++tx) {
+            tiles.emplace_back(static_cast<uint8_t>(camera.zoom), static_cast<uint32_t>(tx), static_cast<uint32_t>(ty));
+        }
+    }
+    return tiles;
+}
+
+Resource tileResource(const CanonicalTileID& id) {
+    return Resource::tile("mapbox://tiles/{z}/{x}/{y}.vector.pbf",
+                          1.0,
+                          id.x,
+                          id.y,
+                          id.z,
+                          Tileset::Scheme::XYZ,
+                          Resource::LoadingMethod::CacheOnly);
+}
+
+} // namespace
+
+/// Replays the tile requests of a browsing session against an offline database, with and without
+/// keeping tile data in memory in front of it.
+static void RawTileCache_Trace(benchmark::State& state) {
+    using namespace std::chrono_literals;
+
+    const bool cached = state.range(0) != 0;
+    const auto trace = makeTrace();
+
+    OfflineDatabase db{":memory:", TileServerOptions::DefaultConfiguration()};
+    Response response;
+    response.data = std::make_shared<std::string>(util::read_file("metrics/integration/tiles/14-8803-5375.mvt"));
+    response.expires = util::now() + 1h;
+    for (const auto& camera : trace) {
+        for (const auto& id : cover(camera)) {
+            db.put(tileResource(id), response);
+        }
+    }
+
+    util::RunLoop loop;
+    auto database = std::make_shared<DatabaseSource>(db);
+
+    RawTileCacheStats stats;
+    for (auto _ : state) {
+        std::shared_ptr<FileSource> fileSource = database;
+        std::shared_ptr<RawTileCache> cache;
+        if (cached) {
+            cache = std::make_shared<RawTileCache>(64 * 1024 * 1024);
+            cache->setFileSource(database);
+            fileSource = cache;
+        }
+
+        std::size_t bytes = 0;
+        for (const auto& camera : trace) {
+            std::vector<std::unique_ptr<AsyncRequest>> requests;
+            std::size_t pending = 0;
+            for (const auto& id : cover(camera)) {
+                pending++;
+                requests.push_back(fileSource->request(tileResource(id), [&](const Response& res) {
+                    bytes += res.data ? res.data->size() : 0;
+                    if (--pending == 0) {
+                        loop.stop();
+                    }
+                }));
+            }
+            loop.run();
+        }
+        benchmark::DoNotOptimize(bytes);
+
+        if (cache) {
+            stats = cache->getStats();
+        }
+    }
+
+    const auto requests = static_cast<double>(stats.hits + stats.misses);
+    state.counters["hit_rate"] = requests ? static_cast<double>(stats.hits) / requests : 0.0;
+    state.counters["hit_us"] = stats.hits ? std::chrono::duration<double, std::micro>(stats.hitLatency).count() /
+                                                static_cast<double>(stats.hits)
+                                          : 0.0;
+    state.counters["miss_us"] = stats.misses ? std::chrono::duration<double, std::micro>(stats.missLatency).count() /
+                                                   static_cast<double>(stats.misses)
+                                             : 0.0;
+}
+
+BENCHMARK(RawTileCache_Trace)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
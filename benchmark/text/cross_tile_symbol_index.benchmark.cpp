@@ -0,0 +1,157 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/renderer/buckets/symbol_bucket.hpp>
+#include <mbgl/style/variable_anchor_offset_collection.hpp>
+#include <mbgl/text/cross_tile_symbol_index.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/utf.hpp>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+SymbolInstance makeSymbolInstance(float x, float y, std::u16string key) {
+    ImageMap imageMap;
+    const ShapedTextOrientations shaping{};
+    style::SymbolLayoutProperties::Evaluated layout;
+    IndexedSubfeature subfeature(0, {}, {}, 0);
+    Anchor anchor(x, y, 0, 0);
+    std::array<float, 2> offset{{0.0f, 0.0f}};
+    VariableAnchorOffsetCollection variableAnchorOffsets(
+        std::vector<AnchorOffsetPair>{{style::SymbolAnchorType::Left, offset}});
+    const auto placementType = style::SymbolPlacementType::Point;
+
+    auto sharedData = std::make_shared<SymbolInstanceSharedData>(GeometryCoordinates{},
+                                                                 shaping,
+                                                                 std::nullopt,
+                                                                 std::nullopt,
+                                                                 layout,
+                                                                 placementType,
+                                                                 offset,
+                                                                 imageMap,
+                                                                 0.0f,
+                                                                 SymbolContent::IconSDF,
+                                                                 false,
+                                                                 false);
+    return SymbolInstance(anchor,
+                          std::move(sharedData),
+                          shaping,
+                          std::nullopt,
+                          std::nullopt,
+                          0,
+                          0,
+                          placementType,
+                          offset,
+                          0,
+                          0,
+                          offset,
+                          subfeature,
+                          0,
+                          0,
+                          std::move(key),
+                          0.0f,
+                          0.0f,
+                          0.0f,
+                          variableAnchorOffsets,
+                          false);
+}
+
+struct Tile {
+    OverscaledTileID id;
+    std::unique_ptr<SymbolBucket> bucket;
+};
+
+constexpr uint8_t minZoom = 13;
+constexpr uint8_t maxZoom = 15;
+constexpr uint32_t originX = 4096;
+constexpr uint32_t originY = 2720;
+
+/// The tiles of every zoom level over a 2x2 area of tiles at the lowest zoom level, all showing
+/// the same labels. Street names repeat across the area, as they do in a city.
+std::vector<std::vector<Tile>> makeTiles(std::size_t labelCount) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> position(0, 2 * util::EXTENT);
+    std::uniform_int_distribution<std::size_t> name(0, labelCount / 20);
+    struct Label {
+        double x;
+        double y;
+        std::u16string key;
+    };
+    std::vector<Label> labels;
+    for (std::size_t i = 0; i < labelCount; ++i) {
+        const auto key = util::convertUTF8ToUTF16("Street " + std::to_string(name(generator)));
+        labels.push_back({position(generator), position(generator), key});
+    }
+
+    const Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout =
+        makeMutable<style::SymbolLayoutProperties::PossiblyEvaluated>();
+    uint32_t bucketInstanceId = 0;
+    std::vector<std::vector<Tile>> zoomTiles;
+    for (uint8_t z = minZoom; z <= maxZoom; ++z) {
+        const uint32_t scale = 1u << (z - minZoom);
+        std::vector<std::vector<SymbolInstance>> instances(4 * scale * scale);
+        for (const auto& label : labels) {
+            const auto tileX = static_cast<uint32_t>(label.x * scale / util::EXTENT);
+            const auto tileY = static_cast<uint32_t>(label.y * scale / util::EXTENT);
+            instances[tileY * 2 * scale + tileX].push_back(
+                makeSymbolInstance(static_cast<float>(label.x * scale - tileX * util::EXTENT),
+                                   static_cast<float>(label.y * scale - tileY * util::EXTENT),
+                                   label.key));
+        }
+
+        std::vector<Tile> tiles;
+        for (uint32_t i = 0; i < instances.size(); ++i) {
+            auto bucket = std::make_unique<SymbolBucket>(layout,
+                                                         std::map<std::string, Immutable<style::LayerProperties>>{},
+                                                         16.0f,
+                                                         1.0f,
+                                                         z,
+                                                         false,
+                                                         false,
+                                                         "layer",
+                                                         std::move(instances[i]),
+                                                         std::vector<SortKeyRange>{},
+                                                         1.0f,
+                                                         false,
+                                                         std::vector<style::TextWritingModeType>{},
+                                                         false);
+            bucket->bucketInstanceId = ++bucketInstanceId;
+            const OverscaledTileID id(z, 0, z, originX * scale + i % (2 * scale), originY * scale + i / (2 * scale));
+            tiles.push_back({id, std::move(bucket)});
+        }
+        zoomTiles.push_back(std::move(tiles));
+    }
+    return zoomTiles;
+}
+
+} // namespace
+
+/// Zooms in and out again: the tiles of the next zoom level are added while the ones of the
+/// previous zoom level are still shown, and are matched against them, before those go away.
+static void CrossTileSymbolIndex_ZoomInOut(benchmark::State& state) {
+    const auto zoomTiles = makeTiles(static_cast<std::size_t>(state.range(0)));
+    const std::vector<uint8_t> sequence = {13, 14, 15, 14, 13};
+
+    uint32_t maxCrossTileID = 0;
+    CrossTileSymbolLayerIndex index(maxCrossTileID);
+    for (auto _ : state) {
+        for (const uint8_t z : sequence) {
+            std::unordered_set<uint32_t> currentIDs;
+            for (const auto& tile : zoomTiles[z - minZoom]) {
+                index.addBucket(tile.id, mat4{}, *tile.bucket);
+                currentIDs.insert(tile.bucket->bucketInstanceId);
+            }
+            index.removeStaleBuckets(currentIDs);
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * sequence.size() * state.range(0)));
+}
+
+BENCHMARK(CrossTileSymbolIndex_ZoomInOut)->Arg(10000)->Arg(50000)->Unit(benchmark::kMillisecond);
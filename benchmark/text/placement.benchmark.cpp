@@ -0,0 +1,64 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_observer.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/style/image.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mln;
+
+namespace {
+
+constexpr Size size{1000, 1000};
+
+class LoadingObserver : public MapObserver {
+public:
+    void onDidFinishLoadingMap() override { loaded = true; }
+
+    bool loaded = false;
+};
+
+} // namespace
+
+/// Renders the frames of a slow pan over Manhattan, with symbols placed in every frame, without and
+/// with incremental or parallel placement. The pan goes back and forth, so that no tiles arrive or go away.
+static void Placement_ContinuousPan(benchmark::State& state) {
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_INCREMENTAL_PLACEMENT, state.range(0) != 0);
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_PARALLEL_PLACEMENT, state.range(1) != 0);
+    NetworkStatus::Set(NetworkStatus::Status::Offline);
+
+    util::RunLoop loop;
+    LoadingObserver observer;
+    HeadlessFrontend frontend{size, 1.0f};
+    Map map{frontend,
+            observer,
+            MapOptions().withMapMode(MapMode::Continuous).withSize(size),
+            ResourceOptions().withCachePath("benchmark/fixtures/api/cache.db").withApiKey("foobar")};
+    map.getStyle().loadJSON(util::read_file("benchmark/fixtures/api/style.json"));
+    map.getStyle().setTransitionOptions(style::TransitionOptions{{}, {}, false});
+    map.getStyle().addImage(std::make_unique<style::Image>(
+        "test-icon", decodeImage(util::read_file("benchmark/fixtures/api/default_marker.png")), 1.0f));
+    map.jumpTo(CameraOptions().withCenter(LatLng{40.726989, -73.992857}).withZoom(15.0));
+    while (!observer.loaded) {
+        loop.runOnce();
+    }
+
+    std::size_t frame = 0;
+    for (auto _ : state) {
+        map.moveBy(frame++ % 20 < 10 ? ScreenCoordinate{2, 1} : ScreenCoordinate{-2, -1});
+        frontend.renderFrame();
+    }
+
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_INCREMENTAL_PLACEMENT, false);
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_PARALLEL_PLACEMENT, false);
+}
+
+BENCHMARK(Placement_ContinuousPan)->Args({0, 0})->Args({1, 0})->Args({0, 1})->Unit(benchmark::kMillisecond);
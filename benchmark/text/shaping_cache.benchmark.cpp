@@ -0,0 +1,140 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/glyph_pbf.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/text/tagged_string.hpp>
+#include <mbgl/tile/vector_mvt_tile_data.hpp>
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/utf.hpp>
+
+#include <array>
+#include <utility>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+const FontStack fontStack{{"Open Sans Regular"}};
+
+/// Street names, points of interest and house numbers of a dense city-centre tile
+std::vector<std::u16string> readLabels() {
+    const VectorMVTTileData tile(
+        std::make_shared<const std::string>(util::read_file("metrics/integration/tiles/14-8803-5375.mvt")));
+    const std::vector<std::pair<std::string, std::string>> labelLayers = {
+        {"road_label", "name"}, {"poi_label", "name"}, {"place_label", "name"}, {"housenum_label", "house_num"}};
+
+    std::vector<std::u16string> labels;
+    for (const auto& [layerName, key] : labelLayers) {
+        const auto layer = tile.getLayer(layerName);
+        for (std::size_t i = 0; layer && i < layer->featureCount(); ++i) {
+            const auto value = layer->getFeature(i)->getValue(key);
+            if (value && value->is<std::string>()) {
+                labels.push_back(util::convertUTF8ToUTF16(value->get<std::string>()));
+            }
+        }
+    }
+    return labels;
+}
+
+/// The glyph atlas of a tile, with every glyph at a position of its own
+GlyphPositions makeGlyphPositions(const GlyphMap& glyphMap, uint16_t tile) {
+    GlyphPositions positions;
+    for (const auto& [fontStackHash, glyphs] : glyphMap) {
+        uint16_t x = tile;
+        for (const auto& [id, glyph] : glyphs) {
+            const Rect<uint16_t> rect{x++, tile, 24, 24};
+            positions[fontStackHash].emplace(id, GlyphPosition{.rect = rect, .metrics = (*glyph)->metrics});
+        }
+    }
+    return positions;
+}
+
+Shaping shape(ShapingCache* cache,
+              const TaggedString& string,
+              BiDi& bidi,
+              const GlyphMap& glyphMap,
+              const GlyphPositions& glyphPositions) {
+    const ImagePositions imagePositions;
+    const float maxWidth = 10 * util::ONE_EM;
+    const float lineHeight = 1.2f * util::ONE_EM;
+    const std::array<float, 2> translate{{0.0f, 0.0f}};
+    if (!cache) {
+        return getShaping(string,
+                          maxWidth,
+                          lineHeight,
+                          style::SymbolAnchorType::Center,
+                          style::TextJustifyType::Center,
+                          0.0f,
+                          translate,
+                          WritingModeType::Horizontal,
+                          bidi,
+                          glyphMap,
+                          glyphPositions,
+                          imagePositions,
+                          16.0f,
+                          16.0f,
+                          false);
+    }
+    return cache->getShaping(string,
+                             maxWidth,
+                             lineHeight,
+                             style::SymbolAnchorType::Center,
+                             style::TextJustifyType::Center,
+                             0.0f,
+                             translate,
+                             WritingModeType::Horizontal,
+                             bidi,
+                             glyphMap,
+                             glyphPositions,
+                             imagePositions,
+                             16.0f,
+                             16.0f,
+                             false);
+}
+
+} // namespace
+
+/// Shapes the labels of a dense city-centre tile once for every zoom level the tile is shown at,
+/// each time with another glyph atlas, without and with a shaping cache. Many labels already repeat
+/// within the tile, as streets are split into several features.
+static void ShapingCache_CityCentre(benchmark::State& state) {
+    const bool cached = state.range(0) != 0;
+    constexpr uint16_t zoomLevels = 4;
+
+    const auto labels = readLabels();
+    GlyphMap glyphMap;
+    auto& glyphs = glyphMap[FontStackHasher()(fontStack)];
+    for (auto& glyph : parseGlyphPBF(GlyphRange{0, 255, GlyphIDType::FontPBF},
+                                     util::read_file("test/fixtures/resources/glyphs.pbf"))) {
+        const GlyphID id = glyph.id;
+        glyphs.emplace(id, Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+    }
+    std::vector<GlyphPositions> atlases;
+    for (uint16_t zoom = 0; zoom < zoomLevels; ++zoom) {
+        atlases.push_back(makeGlyphPositions(glyphMap, zoom));
+    }
+    const SectionOptions section(1.0, fontStack, GlyphIDType::FontPBF, 0);
+
+    BiDi bidi;
+    ShapingCacheStats stats;
+    for (auto _ : state) {
+        ShapingCache cache(64 * 1024 * 1024);
+        for (const auto& glyphPositions : atlases) {
+            for (const auto& label : labels) {
+                benchmark::DoNotOptimize(
+                    shape(cached ? &cache : nullptr, TaggedString(label, section), bidi, glyphMap, glyphPositions));
+            }
+        }
+        stats = cache.getStats();
+    }
+
+    const auto shaped = static_cast<double>(stats.hits + stats.misses);
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * labels.size() * zoomLevels));
+    state.counters["labels"] = static_cast<double>(labels.size());
+    state.counters["hit_rate"] = shaped ? static_cast<double>(stats.hits) / shaped : 0.0;
+}
+
+BENCHMARK(ShapingCache_CityCentre)->Arg(0)->Arg(1)->Unit(benchmark::kMillisecond);
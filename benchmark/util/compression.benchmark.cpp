@@ -0,0 +1,82 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+
+#if defined(__QT__) && (defined(_WIN32) || defined(__EMSCRIPTEN__))
+#include <QtZlib/zlib.h>
+#else
+#include <zlib.h>
+#endif
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+// Vector tiles as served, gzip compressed
+std::vector<std::string> loadTiles(int windowBits) {
+    std::vector<std::string> tiles;
+    for (const char* name : {"0-0-0.mvt", "14-8803-5375.mvt", "1-0-0.osm_basemap.pbf"}) {
+        tiles.push_back(util::compress(util::read_file(std::string("metrics/integration/tiles/") + name), windowBits));
+    }
+    return tiles;
+}
+
+// Inflates the way util::decompress used to: a new stream per call, and output appended to the
+// result through a stack buffer.
+std::string inflateOnce(const std::string& raw) {
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, util::DETECT) != Z_OK) {
+        throw std::runtime_error("failed to initialize inflate");
+    }
+
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(raw.data()));
+    stream.avail_in = uInt(raw.size());
+
+    std::string result;
+    char out[16384];
+    int code;
+    do {
+        stream.next_out = reinterpret_cast<Bytef*>(out);
+        stream.avail_out = sizeof(out);
+        code = inflate(&stream, 0);
+        if (result.size() < stream.total_out) {
+            result.append(out, stream.total_out - result.size());
+        }
+    } while (code == Z_OK);
+
+    inflateEnd(&stream);
+    if (code != Z_STREAM_END) {
+        throw std::runtime_error("decompression error");
+    }
+    return result;
+}
+
+} // namespace
+
+// Inflates real tiles with a new stream for each, as before, or with the reused stream of the
+// thread, either into output sized from the gzip trailer or into output grown as it fills.
+static void Compression_Decompress(benchmark::State& state) {
+    const bool reused = state.range(0) != 0;
+    const int windowBits = state.range(1) != 0 ? util::GZIP : util::ZLIB;
+    const auto tiles = loadTiles(windowBits);
+
+    std::size_t bytes = 0;
+    for (auto _ : state) {
+        for (const auto& tile : tiles) {
+            const auto data = reused ? util::decompress(tile) : inflateOnce(tile);
+            bytes += data.size();
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * tiles.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(bytes));
+}
+
+BENCHMARK(Compression_Decompress)->Args({0, 0})->Args({0, 1})->Args({1, 0})->Args({1, 1});
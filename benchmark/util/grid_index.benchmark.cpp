@@ -0,0 +1,298 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/constants.hpp>
+#include <mbgl/util/grid_index.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <optional>
+#include <random>
+#include <unordered_set>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+// The grid index as it was before cells were kept in blocks of a shared pool: a vector of element
+// IDs per cell, and hash sets to report elements spanning several cells once.
+namespace reference {
+
+template <class T>
+class GridIndex {
+public:
+    using BBox = typename mln::GridIndex<T>::BBox;
+    using BCircle = typename mln::GridIndex<T>::BCircle;
+
+    GridIndex(const float width_, const float height_, const uint32_t cellSize_)
+        : width(width_),
+          height(height_),
+          xCellCount(static_cast<size_t>(std::ceil(width / cellSize_))),
+          yCellCount(static_cast<size_t>(std::ceil(height / cellSize_))),
+          xScale(xCellCount / width),
+          yScale(yCellCount / height),
+          boxCells(xCellCount * yCellCount),
+          circleCells(xCellCount * yCellCount) {}
+
+    void insert(T&& t, const BBox& bbox) {
+        const auto uid = static_cast<uint32_t>(boxElements.size());
+        for (std::size_t x = toXCell(bbox.min.x); x <= toXCell(bbox.max.x); ++x) {
+            for (std::size_t y = toYCell(bbox.min.y); y <= toYCell(bbox.max.y); ++y) {
+                boxCells[xCellCount * y + x].push_back(uid);
+            }
+        }
+        boxElements.emplace_back(std::move(t), bbox);
+    }
+
+    void insert(T&& t, const BCircle& bcircle) {
+        const auto uid = static_cast<uint32_t>(circleElements.size());
+        const auto bbox = toBox(bcircle);
+        for (std::size_t x = toXCell(bbox.min.x); x <= toXCell(bbox.max.x); ++x) {
+            for (std::size_t y = toYCell(bbox.min.y); y <= toYCell(bbox.max.y); ++y) {
+                circleCells[xCellCount * y + x].push_back(uid);
+            }
+        }
+        circleElements.emplace_back(std::move(t), bcircle);
+    }
+
+    std::vector<T> query(const BBox& queryBBox) const {
+        std::vector<T> result;
+        query(queryBBox, [&](const T& t) -> bool {
+            result.push_back(t);
+            return false;
+        });
+        return result;
+    }
+
+    bool hitTest(const BBox& queryBBox, std::optional<std::function<bool(const T&)>> predicate = std::nullopt) const {
+        bool hit = false;
+        query(queryBBox, [&](const T& t) -> bool {
+            hit = !predicate || (*predicate)(t);
+            return hit;
+        });
+        return hit;
+    }
+
+    bool hitTest(const BCircle& queryBCircle,
+                 std::optional<std::function<bool(const T&)>> predicate = std::nullopt) const {
+        bool hit = false;
+        query(queryBCircle, [&](const T& t) -> bool {
+            hit = !predicate || (*predicate)(t);
+            return hit;
+        });
+        return hit;
+    }
+
+private:
+    void query(const BBox& queryBBox, std::function<bool(const T&)> resultFn) const {
+        std::unordered_set<uint32_t> seenBoxes;
+        std::unordered_set<uint32_t> seenCircles;
+        if (queryBBox.max.x < 0 || queryBBox.min.x >= width || queryBBox.max.y < 0 || queryBBox.min.y >= height) {
+            return;
+        }
+        for (std::size_t x = toXCell(queryBBox.min.x); x <= toXCell(queryBBox.max.x); ++x) {
+            for (std::size_t y = toYCell(queryBBox.min.y); y <= toYCell(queryBBox.max.y); ++y) {
+                const std::size_t cellIndex = xCellCount * y + x;
+                for (auto uid : boxCells[cellIndex]) {
+                    if (seenBoxes.insert(uid).second && boxesCollide(queryBBox, boxElements[uid].second) &&
+                        resultFn(boxElements[uid].first)) {
+                        return;
+                    }
+                }
+                for (auto uid : circleCells[cellIndex]) {
+                    if (seenCircles.insert(uid).second && circleAndBoxCollide(circleElements[uid].second, queryBBox) &&
+                        resultFn(circleElements[uid].first)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    void query(const BCircle& queryBCircle, std::function<bool(const T&)> resultFn) const {
+        std::unordered_set<uint32_t> seenBoxes;
+        std::unordered_set<uint32_t> seenCircles;
+        const BBox queryBBox = toBox(queryBCircle);
+        if (queryBBox.max.x < 0 || queryBBox.min.x >= width || queryBBox.max.y < 0 || queryBBox.min.y >= height) {
+            return;
+        }
+        for (std::size_t x = toXCell(queryBBox.min.x); x <= toXCell(queryBBox.max.x); ++x) {
+            for (std::size_t y = toYCell(queryBBox.min.y); y <= toYCell(queryBBox.max.y); ++y) {
+                const std::size_t cellIndex = xCellCount * y + x;
+                for (auto uid : boxCells[cellIndex]) {
+                    if (seenBoxes.insert(uid).second && circleAndBoxCollide(queryBCircle, boxElements[uid].second) &&
+                        resultFn(boxElements[uid].first)) {
+                        return;
+                    }
+                }
+                for (auto uid : circleCells[cellIndex]) {
+                    if (seenCircles.insert(uid).second && circlesCollide(queryBCircle, circleElements[uid].second) &&
+                        resultFn(circleElements[uid].first)) {
+                        return;
+                    }
+                }
+            }
+        }
+    }
+
+    static BBox toBox(const BCircle& circle) {
+        return BBox{{circle.center.x - circle.radius, circle.center.y - circle.radius},
+                    {circle.center.x + circle.radius, circle.center.y + circle.radius}};
+    }
+
+    std::size_t toXCell(const float x) const {
+        return static_cast<size_t>(std::max(0.0, std::min(xCellCount - 1.0, std::floor(x * xScale))));
+    }
+
+    std::size_t toYCell(const float y) const {
+        return static_cast<size_t>(std::max(0.0, std::min(yCellCount - 1.0, std::floor(y * yScale))));
+    }
+
+    static bool boxesCollide(const BBox& first, const BBox& second) {
+        return first.min.x <= second.max.x && first.min.y <= second.max.y && first.max.x >= second.min.x &&
+               first.max.y >= second.min.y;
+    }
+
+    static bool circlesCollide(const BCircle& first, const BCircle& second) {
+        const auto dx = second.center.x - first.center.x;
+        const auto dy = second.center.y - first.center.y;
+        const auto bothRadii = first.radius + second.radius;
+        return (bothRadii * bothRadii) > (dx * dx + dy * dy);
+    }
+
+    static bool circleAndBoxCollide(const BCircle& circle, const BBox& box) {
+        const auto halfRectWidth = (box.max.x - box.min.x) / 2;
+        const auto distX = std::abs(circle.center.x - (box.min.x + halfRectWidth));
+        if (distX > (halfRectWidth + circle.radius)) {
+            return false;
+        }
+        const auto halfRectHeight = (box.max.y - box.min.y) / 2;
+        const auto distY = std::abs(circle.center.y - (box.min.y + halfRectHeight));
+        if (distY > (halfRectHeight + circle.radius)) {
+            return false;
+        }
+        if (distX <= halfRectWidth || distY <= halfRectHeight) {
+            return true;
+        }
+        const auto dx = distX - halfRectWidth;
+        const auto dy = distY - halfRectHeight;
+        return (dx * dx + dy * dy) <= (circle.radius * circle.radius);
+    }
+
+    const float width;
+    const float height;
+    const std::size_t xCellCount;
+    const std::size_t yCellCount;
+    const double xScale;
+    const double yScale;
+
+    std::vector<std::pair<T, BBox>> boxElements;
+    std::vector<std::pair<T, BCircle>> circleElements;
+    std::vector<std::vector<uint32_t>> boxCells;
+    std::vector<std::vector<uint32_t>> circleCells;
+};
+
+} // namespace reference
+
+// The collision grid of a 1000x1000 viewport with its padding
+constexpr float gridSize = 1200;
+constexpr uint32_t cellSize = 25;
+
+/// A symbol to place: either a point label box, or the circles along a line label
+struct Candidate {
+    mapbox::geometry::box<float> box;
+    std::vector<geometry::circle<float>> circles;
+};
+
+/// Labels of a dense city centre, about a third of them along lines
+std::vector<Candidate> makeCandidates(std::size_t count) {
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<float> position(0, gridSize);
+    std::uniform_real_distribution<float> width(20, 150);
+    std::uniform_real_distribution<float> height(10, 30);
+    std::uniform_real_distribution<float> angle(0, static_cast<float>(util::M2PI));
+
+    std::vector<Candidate> candidates(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        const float x = position(generator);
+        const float y = position(generator);
+        if (i % 3 == 2) {
+            const float a = angle(generator);
+            for (int j = 0; j < 10; ++j) {
+                candidates[i].circles.push_back({{x + j * 12 * std::cos(a), y + j * 12 * std::sin(a)}, 7});
+            }
+        } else {
+            candidates[i].box = {{x, y}, {x + width(generator), y + height(generator)}};
+        }
+    }
+    return candidates;
+}
+
+template <class Grid>
+std::size_t place(Grid& grid, const std::vector<Candidate>& candidates) {
+    std::size_t placed = 0;
+    for (uint32_t i = 0; i < candidates.size(); ++i) {
+        const auto& candidate = candidates[i];
+        if (candidate.circles.empty()) {
+            if (!grid.hitTest(candidate.box)) {
+                grid.insert(uint32_t(i), candidate.box);
+                ++placed;
+            }
+        } else if (std::none_of(candidate.circles.begin(), candidate.circles.end(), [&](const auto& circle) {
+                       return grid.hitTest(circle);
+                   })) {
+            for (const auto& circle : candidate.circles) {
+                grid.insert(uint32_t(i), circle);
+            }
+            ++placed;
+        }
+    }
+    return placed;
+}
+
+} // namespace
+
+/// Places the labels of a frame: every label is tested against the ones placed before it, and
+/// inserted when it doesn't collide.
+template <class Grid>
+static void GridIndex_Placement(benchmark::State& state) {
+    const auto candidates = makeCandidates(static_cast<std::size_t>(state.range(0)));
+    std::size_t placed = 0;
+    for (auto _ : state) {
+        Grid grid(gridSize, gridSize, cellSize);
+        placed = place(grid, candidates);
+        benchmark::DoNotOptimize(grid);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * candidates.size()));
+    state.counters["placed"] = static_cast<double>(placed);
+}
+
+/// Queries the placed labels under small boxes, as feature queries under the cursor do
+template <class Grid>
+static void GridIndex_Query(benchmark::State& state) {
+    const auto candidates = makeCandidates(static_cast<std::size_t>(state.range(0)));
+    Grid grid(gridSize, gridSize, cellSize);
+    place(grid, candidates);
+
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<float> position(0, gridSize - 40);
+    std::vector<mapbox::geometry::box<float>> queries;
+    for (int i = 0; i < 1000; ++i) {
+        const float x = position(generator);
+        const float y = position(generator);
+        queries.push_back({{x, y}, {x + 40, y + 40}});
+    }
+
+    for (auto _ : state) {
+        for (const auto& query : queries) {
+            benchmark::DoNotOptimize(grid.query(query));
+        }
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * queries.size()));
+}
+
+BENCHMARK_TEMPLATE(GridIndex_Placement, reference::GridIndex<uint32_t>)->Arg(2000)->Arg(8000);
+BENCHMARK_TEMPLATE(GridIndex_Placement, GridIndex<uint32_t>)->Arg(2000)->Arg(8000);
+BENCHMARK_TEMPLATE(GridIndex_Query, reference::GridIndex<uint32_t>)->Arg(8000);
+BENCHMARK_TEMPLATE(GridIndex_Query, GridIndex<uint32_t>)->Arg(8000);
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/map/map.hpp>
+#include <mbgl/map/map_observer.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/storage/network_status.hpp>
+#include <mbgl/storage/resource_options.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+using namespace mln;
+
+namespace {
+
+// A 1024x1024 static map at pixel ratio 2, as the static map service renders them
+const PremultipliedImage& renderStill() {
+    static const PremultipliedImage image = [] {
+        NetworkStatus::Set(NetworkStatus::Status::Offline);
+        util::RunLoop loop;
+        const Size size{1024, 1024};
+        const float pixelRatio = 2.0f;
+        HeadlessFrontend frontend{size, pixelRatio};
+        Map map{frontend,
+                MapObserver::nullObserver(),
+                MapOptions().withMapMode(MapMode::Static).withSize(size).withPixelRatio(pixelRatio),
+                ResourceOptions().withCachePath("benchmark/fixtures/api/cache.db").withApiKey("foobar")};
+        map.getStyle().loadJSON(util::read_file("benchmark/fixtures/api/style.json"));
+        map.jumpTo(CameraOptions().withCenter(LatLng{40.726989, -73.992857}).withZoom(15.0)); // Manhattan
+        return frontend.render(map).image;
+    }();
+    return image;
+}
+
+} // namespace
+
+/// Encodes a rendered map with the given compression level, filtering and thread count. The
+/// first variant is what encodePNG(image) does.
+static void PNGWriter_Encode(benchmark::State& state) {
+    const PremultipliedImage& image = renderStill();
+    PNGEncodeOptions options;
+    options.compressionLevel = static_cast<int>(state.range(0));
+    options.adaptiveFiltering = state.range(1) != 0;
+    options.threads = static_cast<std::size_t>(state.range(2));
+
+    std::size_t size = 0;
+    for (auto _ : state) {
+        size = encodePNG(image, options).size();
+        benchmark::DoNotOptimize(size);
+    }
+
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * image.bytes()));
+    state.counters["png_bytes"] = static_cast<double>(size);
+    state.counters["ratio"] = static_cast<double>(size) / static_cast<double>(image.bytes());
+}
+
+BENCHMARK(PNGWriter_Encode)
+    ->Args({-1, 0, 1})
+    ->Args({1, 0, 1})
+    ->Args({1, 1, 1})
+    ->Args({6, 1, 1})
+    ->Args({9, 1, 1})
+    ->Args({1, 1, 4})
+    ->Args({6, 1, 4})
+    ->Args({9, 1, 4})
+    ->Unit(benchmark::kMillisecond);
@@ -0,0 +1,98 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/identity.hpp>
+#include <mbgl/util/thread_pool.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+// Roughly the cost of a small tile parse sub-step, enough to make queue contention visible
+void spin(std::size_t iterations) {
+    std::size_t value = 0;
+    for (std::size_t i = 0; i < iterations; ++i) {
+        benchmark::DoNotOptimize(value += i);
+    }
+}
+
+/// Many producers on different tags submitting short tasks, as concurrent tile workers do while panning.
+void runContention(benchmark::State& state, SchedulingStrategy strategy) {
+    const auto workers = std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+    std::shared_ptr<Scheduler> pool = std::make_shared<ParallelScheduler>(workers - 1, strategy);
+
+    const auto tagCount = static_cast<std::size_t>(state.range(0));
+    const auto tasksPerTag = static_cast<std::size_t>(state.range(1));
+    std::vector<util::SimpleIdentity> tags(tagCount);
+
+    std::atomic<std::size_t> executed{0};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < tasksPerTag; ++i) {
+            for (const auto& tag : tags) {
+                pool->schedule(tag, [&] {
+                    spin(256);
+                    executed++;
+                });
+            }
+        }
+        for (const auto& tag : tags) {
+            pool->waitForEmpty(tag);
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(executed.load()));
+}
+
+/// Tasks fanning out more tasks from worker threads, which stay local under work stealing.
+void runFanOut(benchmark::State& state, SchedulingStrategy strategy) {
+    const auto workers = std::max<std::size_t>(std::thread::hardware_concurrency(), 2);
+    std::shared_ptr<Scheduler> pool = std::make_shared<ParallelScheduler>(workers - 1, strategy);
+
+    const util::SimpleIdentity tag;
+    const auto fanOut = static_cast<std::size_t>(state.range(0));
+
+    std::atomic<std::size_t> executed{0};
+    for (auto _ : state) {
+        for (std::size_t i = 0; i < workers * 4; ++i) {
+            pool->schedule(tag, [&, fanOut] {
+                for (std::size_t j = 0; j < fanOut; ++j) {
+                    pool->schedule(tag, [&] {
+                        spin(256);
+                        executed++;
+                    });
+                }
+            });
+        }
+        pool->waitForEmpty(tag);
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(executed.load()));
+}
+
+void ThreadPool_Contention_SharedQueue(benchmark::State& state) {
+    runContention(state, SchedulingStrategy::SharedQueue);
+}
+
+void ThreadPool_Contention_WorkStealing(benchmark::State& state) {
+    runContention(state, SchedulingStrategy::WorkStealing);
+}
+
+void ThreadPool_FanOut_SharedQueue(benchmark::State& state) {
+    runFanOut(state, SchedulingStrategy::SharedQueue);
+}
+
+void ThreadPool_FanOut_WorkStealing(benchmark::State& state) {
+    runFanOut(state, SchedulingStrategy::WorkStealing);
+}
+
+} // namespace
+
+BENCHMARK(ThreadPool_Contention_SharedQueue)->Args({1, 1000})->Args({16, 100})->Args({64, 50})->UseRealTime();
+BENCHMARK(ThreadPool_Contention_WorkStealing)->Args({1, 1000})->Args({16, 100})->Args({64, 50})->UseRealTime();
+BENCHMARK(ThreadPool_FanOut_SharedQueue)->Arg(16)->Arg(128)->UseRealTime();
+BENCHMARK(ThreadPool_FanOut_WorkStealing)->Arg(16)->Arg(128)->UseRealTime();
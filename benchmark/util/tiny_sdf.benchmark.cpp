@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+// Rasters like those of local CJK glyphs at double resolution: antialiased strokes within a
+// 60x60 bitmap, including the glyph border.
+std::vector<AlphaImage> makeRasters() {
+    std::vector<AlphaImage> rasters;
+    for (uint32_t i = 0; i < 64; i++) {
+        AlphaImage raster({60, 60});
+        raster.fill(0);
+        for (uint32_t stroke = 0; stroke < 3 + i % 4; stroke++) {
+            const bool horizontal = (i + stroke) % 2 == 0;
+            const uint32_t offset = 10 + (i * 7 + stroke * 11) % 38;
+            for (uint32_t along = 8 + stroke % 3; along < 52 - (i + stroke) % 5; along++) {
+                for (uint32_t across = offset; across < offset + 4; across++) {
+                    const uint8_t alpha = across == offset || across == offset + 3 ? 128 : 255;
+                    uint8_t& pixel = horizontal ? raster.data[across * 60 + along] : raster.data[along * 60 + across];
+                    pixel = std::max(pixel, alpha);
+                }
+            }
+        }
+        rasters.push_back(std::move(raster));
+    }
+    return rasters;
+}
+
+} // namespace
+
+/// Transforms a batch of glyph rasters: with a generator allocating its working memory for each
+/// raster, and with the generator of the thread, as GlyphManager does.
+static void TinySDF_Transform(benchmark::State& state) {
+    const auto rasters = makeRasters();
+
+    for (auto _ : state) {
+        for (const auto& raster : rasters) {
+            if (state.range(0) == 0) {
+                benchmark::DoNotOptimize(util::TinySDF().transform(raster, 16, .25));
+            } else {
+                benchmark::DoNotOptimize(util::transformRasterToSDF(raster, 16, .25));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * rasters.size()));
+}
+
+BENCHMARK(TinySDF_Transform)->Arg(0)->Arg(1);
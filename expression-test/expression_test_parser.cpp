@@ -309,8 +309,7 @@ bool parseInputs(const JSValue& inputsValue, TestData& data) {
 
 } // namespace
 
-std::tuple<std::filesystem::path, std::vector<std::filesystem::path>, bool, uint32_t> parseArguments(int argc,
-                                                                                                     char** argv) {
+Arguments parseArguments(int argc, char** argv) {
     args::ArgumentParser argumentParser("MapLibre Native Expression Test Runner");
 
     args::HelpFlag helpFlag(argumentParser, "help", "Display this help menu", {'h', "help"});
@@ -318,6 +317,8 @@ std::tuple<std::filesystem::path, std::vector<std::filesystem::path>, bool, uint
     args::ValueFlag<uint32_t> seedValue(argumentParser, "seed", "Shuffle seed (default: random)", {"seed"});
     args::PositionalList<std::string> testNameValues(argumentParser, "URL", "Test name(s)");
     args::ValueFlag<std::string> testFilterValue(argumentParser, "filter", "Test filter regex", {'f', "filter"});
+    args::Flag bytecodeFlag(
+        argumentParser, "bytecode", "Evaluate expressions compiled into bytecode where possible", {'b', "bytecode"});
 
     try {
         argumentParser.ParseCLI(argc, argv);
@@ -378,7 +379,8 @@ std::tuple<std::filesystem::path, std::vector<std::filesystem::path>, bool, uint
     return Arguments{std::move(rootPath),
                      std::move(testPaths),
                      shuffleFlag ? args::get(shuffleFlag) : false,
-                     seedValue ? args::get(seedValue) : 1u};
+                     seedValue ? args::get(seedValue) : 1u,
+                     bytecodeFlag ? args::get(bytecodeFlag) : false};
 }
 
 Ignores parseExpressionIgnores() {
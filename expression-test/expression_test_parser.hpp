@@ -78,7 +78,7 @@ struct Ignore {
     std::string reason;
 };
 
-using Arguments = std::tuple<std::filesystem::path, std::vector<std::filesystem::path>, bool, uint32_t>;
+using Arguments = std::tuple<std::filesystem::path, std::vector<std::filesystem::path>, bool, uint32_t, bool>;
 Arguments parseArguments(int argc, char** argv);
 
 using Ignores = std::vector<Ignore>;
@@ -3,6 +3,7 @@
 #include "expression_test_parser.hpp"
 #include "test_runner_common.hpp"
 
+#include <mbgl/style/expression/bytecode.hpp>
 #include <mbgl/util/io.hpp>
 
 #include <rapidjson/writer.h>
@@ -97,16 +98,28 @@ void writeTestData(const JSDocument& document, const std::string& rootPath, cons
 
 } // namespace
 
-TestRunOutput runExpressionTest(TestData& data, const std::string& rootPath, const std::string& id) {
+TestRunOutput runExpressionTest(TestData& data, const std::string& rootPath, const std::string& id, bool bytecode) {
     TestRunOutput output(id);
-    const auto evaluateExpression = [&data](std::unique_ptr<style::expression::Expression>& expression,
-                                            TestResult& result) {
+    const auto evaluateExpression = [&data, bytecode](std::unique_ptr<style::expression::Expression>& expression,
+                                                      TestResult& result) {
         assert(expression);
+        const auto program = bytecode ? style::expression::Bytecode::compile(*expression) : nullptr;
         std::vector<Value> outputs;
         if (!data.inputs.empty()) {
             for (const auto& input : data.inputs) {
                 mln::style::expression::EvaluationResult evaluationResult;
-                if (input.canonical) {
+                // The tree evaluates what the bytecode gives up on, including all errors
+                std::optional<style::expression::Value> compiled;
+                if (program) {
+                    compiled = program->evaluate(input.zoom,
+                                                 input.feature,
+                                                 input.heatmapDensity,
+                                                 input.availableImages,
+                                                 input.canonical ? &*input.canonical : nullptr);
+                }
+                if (compiled) {
+                    evaluationResult = std::move(*compiled);
+                } else if (input.canonical) {
                     evaluationResult = expression->evaluate(
                         input.zoom, input.feature, input.heatmapDensity, input.availableImages, *input.canonical);
                 } else {
@@ -29,4 +29,5 @@ public:
     std::vector<std::string> ids;
 };
 
-TestRunOutput runExpressionTest(TestData&, const std::string& rootPath, const std::string& id);
+/// Runs the test, evaluating the expression through its bytecode where it has one if `bytecode` is set
+TestRunOutput runExpressionTest(TestData&, const std::string& rootPath, const std::string& id, bool bytecode);
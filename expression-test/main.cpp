@@ -16,7 +16,8 @@ int main(int argc, char** argv) try {
     std::filesystem::path rootPath;
     bool shuffle;
     uint32_t seed;
-    std::tie(rootPath, testPaths, shuffle, seed) = parseArguments(argc, argv);
+    bool bytecode;
+    std::tie(rootPath, testPaths, shuffle, seed, bytecode) = parseArguments(argc, argv);
 
     // Parse ignores
     const auto ignores = parseExpressionIgnores();
@@ -48,7 +49,7 @@ int main(int argc, char** argv) try {
 
         std::optional<TestRunOutput> testRun;
         if (auto testData = parseTestData(path)) {
-            testRun = runExpressionTest(*testData, rootPath.string(), id);
+            testRun = runExpressionTest(*testData, rootPath.string(), id, bytecode);
         }
 
         if (!testRun) {
@@ -77,6 +77,9 @@ public:
 
     ActorRef<std::decay_t<Object>> self() { return parent.self(); }
 
+    /// See `Mailbox::setPriority`
+    void setPriority(TaskPriority priority) { parent.mailbox->setPriority(std::move(priority)); }
+
 private:
     const std::shared_ptr<Scheduler> retainer;
     AspiringActor<Object> parent;
@@ -37,6 +37,11 @@ public:
 
     bool isOpen() const;
 
+    /// Have receipt of messages scheduled with the given priority, which may be updated later
+    /// to move pending messages ahead of or behind other work. Must be set before messages
+    /// are pushed.
+    void setPriority(TaskPriority);
+
     void push(std::unique_ptr<Message>);
     void receive();
 
@@ -49,6 +54,7 @@ private:
     };
 
     util::SimpleIdentity schedulerTag = util::SimpleIdentity::Empty;
+    TaskPriority priority;
     mapbox::base::WeakPtr<Scheduler> weakScheduler;
 
     std::recursive_mutex receivingMutex;
@@ -47,6 +47,13 @@ public:
 
     const OptionalActorRef<Object>& self() { return selfRef; }
 
+    /// Prioritize message processing of the asynchronous actor, synchronous objects ignore this
+    void setPriority(TaskPriority priority) {
+        if (actor) {
+            actor->setPriority(std::move(priority));
+        }
+    }
+
 private:
     class SyncObject {
     public:
@@ -4,6 +4,8 @@
 
 #include <mapbox/std/weak.hpp>
 
+#include <atomic>
+#include <cstdint>
 #include <functional>
 #include <memory>
 #include <type_traits>
@@ -12,6 +14,11 @@ namespace mln {
 
 class Mailbox;
 
+/// A priority shared between the producer of a stream of tasks and the scheduler running them.
+/// The producer may change the value at any time, including while tasks are pending; higher
+/// values run first, and zero is the priority of tasks scheduled without one.
+using TaskPriority = std::shared_ptr<const std::atomic<int32_t>>;
+
 /**
     A `Scheduler` is responsible for coordinating the processing of messages by
     one or more actors via their mailboxes. It's an abstract interface. Currently,
@@ -42,6 +49,18 @@ public:
     virtual void schedule(std::function<void()>&&) = 0;
     virtual void schedule(const util::SimpleIdentity, std::function<void()>&&) = 0;
 
+    /// Enqueues a function whose position in the queue is decided by the current value of
+    /// `priority` when a worker becomes available. Schedulers that don't support priorities
+    /// treat this like a plain `schedule`.
+    virtual void scheduleWithPriority(const util::SimpleIdentity tag,
+                                      std::function<void()>&& fn,
+                                      const TaskPriority& /*priority*/) {
+        schedule(tag, std::move(fn));
+    }
+
+    /// The number of tasks this scheduler may run at the same time
+    virtual std::size_t getConcurrency() const { return 1; }
+
     /// Makes a weak pointer to this Scheduler.
     virtual mapbox::base::WeakPtr<Scheduler> makeWeakPtr() = 0;
     /// Enqueues a function for execution on the render thread owned by the given tag.
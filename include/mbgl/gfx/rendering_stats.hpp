@@ -65,6 +65,12 @@ struct RenderingStats {
     int numVertexBuffers = 0;
     /// Sum of vertex buffers update sizes
     std::size_t vertexUpdateBytes = 0;
+    /// Number of times only the modified ranges of a vertex buffer are updated
+    std::size_t vertexPartialUpdates = 0;
+    /// Sum of the modified ranges updated in vertex buffers, included in `vertexUpdateBytes`
+    std::size_t vertexPartialUpdateBytes = 0;
+    /// Sum of the sizes of the vertex buffers updated in ranges, which updating them entirely would have taken
+    std::size_t vertexPartialUpdateFullBytes = 0;
 
     /// Number of active uniform buffers
     int numUniformBuffers = 0;
@@ -15,6 +15,70 @@ DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_THREAD_PRIORITY_FILE, thread_priority_file
 DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_THREAD_PRIORITY_NETWORK, thread_priority_network);
 DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_THREAD_PRIORITY_DATABASE, thread_priority_database);
 
+// The value for EXPERIMENTAL_THREAD_POOL_WORK_STEALING must be a bool. When set before the
+// background pool is first created, its workers use per-thread deques with work stealing.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_THREAD_POOL_WORK_STEALING, thread_pool_work_stealing);
+
+// The value for EXPERIMENTAL_TILE_PRIORITY_SCHEDULING must be a bool. When set, tiles created
+// afterwards schedule their parsing by distance to the screen centre instead of in FIFO order.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_TILE_PRIORITY_SCHEDULING, tile_priority_scheduling);
+
+// The value for EXPERIMENTAL_PARALLEL_BUCKET_BUILDING must be a bool. When set, tiles created
+// afterwards build the buckets of their layer groups concurrently on the background pool.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_PARALLEL_BUCKET_BUILDING, parallel_bucket_building);
+
+// The value for EXPERIMENTAL_BATCH_FILTER_EVALUATION must be a bool. When set, tiles created
+// afterwards evaluate layer filters for all features of a source layer at once.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_BATCH_FILTER_EVALUATION, batch_filter_evaluation);
+
+// The value for EXPERIMENTAL_FEATURE_CACHE must be a bool. When set, tiles created afterwards decode
+// the features of a source layer read by several layer groups once, and share them between the groups.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_FEATURE_CACHE, feature_cache);
+
+// The value for EXPERIMENTAL_PMTILES_MEMORY_MAPPING must be a bool. When set, PMTiles file sources
+// created afterwards read tiles of local archives through a memory mapping, on the background pool.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_PMTILES_MEMORY_MAPPING, pmtiles_memory_mapping);
+
+// The value for EXPERIMENTAL_MBTILES_CONNECTION_POOL must be a bool. When set, MBTiles file sources
+// created afterwards read tiles on the background pool, through a pool of read-only connections.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_MBTILES_CONNECTION_POOL, mbtiles_connection_pool);
+
+// The value for EXPERIMENTAL_MBTILES_MMAP_SIZE must be a double, the number of bytes of each
+// database the connections of that pool read through a memory mapping (`PRAGMA mmap_size`).
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_MBTILES_MMAP_SIZE, mbtiles_mmap_size);
+
+// The value for EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES must be a bool. When set, offline
+// databases opened afterwards use WAL journaling and batch ambient cache writes and access times.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES, offline_database_batched_writes);
+
+// The value for EXPERIMENTAL_GLYPH_CACHE_SIZE must be a double, the number of bytes of glyphs
+// rasterized from local fonts that maps created afterwards share through a process-wide cache.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_GLYPH_CACHE_SIZE, glyph_cache_size);
+
+// The value for EXPERIMENTAL_GLYPH_CACHE_PATH must be a string. When set before the glyph cache is
+// first used, the cache also keeps glyphs in a file at this path, for later processes.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_GLYPH_CACHE_PATH, glyph_cache_path);
+
+// The value for EXPERIMENTAL_SHAPING_CACHE_SIZE must be a double, the number of bytes of label
+// shapings and HarfBuzz shaping results that maps created afterwards share through a process-wide cache.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_SHAPING_CACHE_SIZE, shaping_cache_size);
+
+// The value for EXPERIMENTAL_INCREMENTAL_PLACEMENT must be a bool. When set, continuous symbol placement
+// keeps the results of symbols a pan without zoom or rotation doesn't affect, and only places the others.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_INCREMENTAL_PLACEMENT, incremental_placement);
+
+// The value for EXPERIMENTAL_PARALLEL_PLACEMENT must be a bool. When set, symbol placement projects the labels
+// along lines of all buckets on the background thread pool, then places the symbols in layer order as before.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_PARALLEL_PLACEMENT, parallel_placement);
+
+// The value for EXPERIMENTAL_EXPRESSION_BYTECODE must be a bool. When set, data-driven property expressions
+// created afterwards are also compiled into bytecode, which features are evaluated with where it can.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_EXPRESSION_BYTECODE, expression_bytecode);
+
+// The value for EXPERIMENTAL_GEOJSON_STREAMING must be a bool. When set, GeoJSON sources loaded from a URL read
+// feature collections a chunk of features at a time, and show the features read so far while they are read.
+DECLARE_MAPLIBRE_SETTING(EXPERIMENTAL_GEOJSON_STREAMING, geojson_streaming);
+
 /// Settings class provides non-persistent, in-process key-value storage.
 class Settings final {
 public:
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mln {
+
+// Counters of the symbol placements made by a renderer.
+struct PlacementStats {
+    // Placements made since the renderer was created
+    std::uint64_t placements = 0;
+    // Symbols tested against the collision grid, and symbols which kept their result of the
+    // previous placement instead, with EXPERIMENTAL_INCREMENTAL_PLACEMENT
+    std::uint64_t symbolsPlaced = 0;
+    std::uint64_t symbolsReused = 0;
+    // Approximate bytes held by the latest placement to record what its symbols were placed with,
+    // for the next placement to reuse
+    std::size_t recordBytes = 0;
+};
+
+} // namespace mln
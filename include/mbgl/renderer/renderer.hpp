@@ -1,11 +1,14 @@
 #pragma once
 
+#include <mbgl/renderer/placement_stats.hpp>
 #include <mbgl/renderer/query.hpp>
+#include <mbgl/tile/tile_cache_stats.hpp>
 #include <mbgl/annotation/annotation.hpp>
 #include <mbgl/util/geo.hpp>
 #include <mbgl/util/geojson.hpp>
 
 #include <functional>
+#include <map>
 #include <memory>
 #include <string>
 #include <vector>
@@ -114,6 +117,44 @@ public:
     // Memory
     void setTileCacheEnabled(bool);
     bool getTileCacheEnabled() const;
+
+    /**
+     * @brief Limits the approximate CPU and GPU memory held by the tiles each
+     * source keeps cached for reuse, in addition to the limit on their number.
+     *
+     * Tiles which are cheap to load again for the memory they hold are evicted
+     * first. Zero, the default, leaves only the limit on the number of tiles.
+     */
+    void setTileCacheMaxBytes(std::size_t);
+    std::size_t getTileCacheMaxBytes() const;
+
+    /**
+     * @brief Returns the hit, miss and eviction counters and the current
+     * contents of each source's tile cache, by source ID.
+     */
+    std::map<std::string, TileCacheStats> getTileCacheStats() const;
+
+    /**
+     * @brief Keeps the data of loaded tiles in memory, up to the given number
+     * of bytes, so that tiles evicted from the tile caches can be loaded again
+     * without requesting them from the file source.
+     *
+     * Zero, the default, disables keeping tile data.
+     */
+    void setRawTileCacheMaxBytes(std::size_t);
+    std::size_t getRawTileCacheMaxBytes() const;
+
+    /**
+     * @brief Returns the hit, miss and eviction counters, the latencies and
+     * the current contents of the cache of tile data.
+     */
+    RawTileCacheStats getRawTileCacheStats() const;
+
+    /**
+     * @brief Returns the number of symbol placements made, of the symbols they
+     * placed and reused, and the memory held to reuse them.
+     */
+    PlacementStats getPlacementStats() const;
     void reduceMemoryUse();
     void clearData();
 
@@ -36,6 +36,10 @@ public:
     mln::Value serialize() const override;
     std::string getOperator() const override { return "match"; }
 
+    const std::unique_ptr<Expression>& getInput() const noexcept { return input; }
+    const Branches& getBranches() const noexcept { return branches; }
+    const std::unique_ptr<Expression>& getOtherwise() const noexcept { return otherwise; }
+
 private:
     std::unique_ptr<Expression> input;
     Branches branches;
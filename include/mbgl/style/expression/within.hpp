@@ -3,9 +3,15 @@
 #include <mbgl/style/expression/expression.hpp>
 #include <mbgl/util/geojson.hpp>
 
+#include <array>
+#include <memory>
+#include <mutex>
 #include <optional>
 
 namespace mln {
+
+class PolygonIndex;
+
 namespace style {
 namespace expression {
 
@@ -29,8 +35,19 @@ public:
     std::string getOperator() const override { return "within"; }
 
 private:
+    const PolygonIndex& getPolygonIndex(uint8_t z) const;
+
     GeoJSON geoJSONSource;
     Feature::geometry_type geometries;
+
+    struct PolygonIndexSlot {
+        std::once_flag once;
+        std::unique_ptr<const PolygonIndex> index;
+    };
+
+    // The polygons in the tile coordinates of each zoom level, shared by all tiles of that zoom level and
+    // projected when a feature of one of them is first evaluated. Once built, an index is read without locking.
+    mutable std::array<PolygonIndexSlot, 33> polygonIndexes;
 };
 
 } // namespace expression
@@ -19,6 +19,10 @@ using UniqueGPUExpression = std::unique_ptr<GPUExpression>;
 
 namespace style {
 
+namespace expression {
+class Bytecode;
+} // namespace expression
+
 class PropertyExpressionBase {
 public:
     using Expression = expression::Expression;
@@ -57,7 +61,14 @@ public:
     const ZoomCurvePtr& getZoomCurve() const { return zoomCurve; }
 
 protected:
+    // The results of the bytecode of a data-driven expression, see EXPERIMENTAL_EXPRESSION_BYTECODE.
+    // Nothing when there is no bytecode, or it can't evaluate the expression in this context.
+    std::optional<double> evaluateBytecodeNumber(const expression::EvaluationContext&) const;
+    std::optional<Color> evaluateBytecodeColor(const expression::EvaluationContext&) const;
+    std::optional<expression::Value> evaluateBytecode(const expression::EvaluationContext&) const;
+
     std::shared_ptr<const Expression> expression;
+    std::shared_ptr<const expression::Bytecode> bytecode;
 
     ZoomCurvePtr zoomCurve;
 
@@ -82,6 +93,24 @@ public:
           defaultValue(std::move(defaultValue_)) {}
 
     T evaluate(const expression::EvaluationContext& context, T finalDefaultValue = T()) const {
+        if (bytecode) {
+            if constexpr (std::is_same_v<T, float>) {
+                if (const auto number = evaluateBytecodeNumber(context)) {
+                    return static_cast<float>(*number);
+                }
+            } else if constexpr (std::is_same_v<T, Color>) {
+                if (const auto color = evaluateBytecodeColor(context)) {
+                    return *color;
+                }
+            } else if (const auto value = evaluateBytecode(context)) {
+                const std::optional<T> typed = expression::fromExpressionValue<T>(*value);
+                if (typed) {
+                    return *typed;
+                }
+                return defaultValue ? *defaultValue : finalDefaultValue;
+            }
+        }
+
         const expression::EvaluationResult result = expression->evaluate(context);
         if (result) {
             const std::optional<T> typed = expression::fromExpressionValue<T>(*result);
@@ -9,6 +9,7 @@
 #include <map>
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace mln {
 
@@ -16,6 +17,8 @@ class AsyncRequest;
 class Scheduler;
 namespace style {
 
+class GeoJSONStreamReader;
+
 struct GeoJSONOptions {
     // GeoJSON-VT options
     uint8_t minzoom = 0;
@@ -37,9 +40,22 @@ struct GeoJSONOptions {
 
     // Update options
     bool synchronousUpdate = false;
+    /// Index feature collections in parts by where the features are, so that `GeoJSONSource::updateGeoJSON()` only
+    /// indexes anew the parts it changes. Features are drawn in the order of the parts, rather than in the order of
+    /// the collection.
+    bool updatable = false;
 
     static Immutable<GeoJSONOptions> defaultOptions();
 };
+
+/// Changes to the features of a GeoJSON source, which are matched by their identifiers
+struct GeoJSONDiff {
+    /// Features to add, replacing the features with the same identifiers
+    mapbox::feature::feature_collection<double> update;
+    /// Identifiers of the features to remove
+    std::vector<FeatureIdentifier> remove;
+};
+
 class GeoJSONData {
 public:
     using TileFeatures = mapbox::feature::feature_collection<int16_t>;
@@ -51,6 +67,14 @@ public:
     virtual ~GeoJSONData() = default;
     virtual void getTile(const CanonicalTileID&, const std::function<void(TileFeatures)>&, bool runSynchronously) = 0;
 
+    /// Returns data with the diff applied, which shares with this data the parts of the index the diff leaves as
+    /// they are. Only data created from a feature collection with `GeoJSONOptions::updatable` can be updated, null
+    /// is returned for other data.
+    virtual std::shared_ptr<GeoJSONData> update(const GeoJSONDiff&) const { return nullptr; }
+
+    /// Whether the features of the tile may differ from the ones of `previous`, when this data was updated from it
+    virtual bool isTileChanged(const CanonicalTileID&, const GeoJSONData& /* previous */) const { return true; }
+
     // SuperclusterData
     virtual Features getChildren(std::uint32_t) = 0;
     virtual Features getLeaves(std::uint32_t, std::uint32_t limit, std::uint32_t offset) = 0;
@@ -66,6 +90,9 @@ public:
     void setURL(const std::string& url);
     void setGeoJSON(const GeoJSON&);
     void setGeoJSONData(std::shared_ptr<GeoJSONData>);
+    /// Adds, replaces and removes features of the data by their identifiers. Only the tiles the changed features
+    /// are in are loaded again.
+    void updateGeoJSON(const GeoJSONDiff&);
 
     std::optional<std::string> getURL() const;
     const GeoJSONOptions& getOptions() const;
@@ -86,6 +113,10 @@ protected:
     Mutable<Source::Impl> createMutable() const noexcept final;
 
 private:
+    /// Reads the next chunk of features of the document loaded from the URL, and publishes the data read so far
+    /// once there are `publishCount` features
+    void readGeoJSONStream(std::shared_ptr<GeoJSONStreamReader>, uint64_t generation, std::size_t publishCount);
+
     std::optional<std::string> url;
     std::unique_ptr<AsyncRequest> req;
     std::atomic<uint64_t> requestGeneration{0};
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <mbgl/util/chrono.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+namespace mln {
+
+// Counters of a source's cache of tiles which are no longer displayed, but kept in case
+// they are needed again.
+struct TileCacheStats {
+    // Tiles taken from the cache when they were needed again
+    std::uint64_t hits = 0;
+    // Tiles which were needed and had to be loaded because they were not in the cache
+    std::uint64_t misses = 0;
+    // Tiles removed from the cache to stay within its limits
+    std::uint64_t evictions = 0;
+    // Tiles currently in the cache
+    std::size_t tiles = 0;
+    // Approximate bytes of CPU and GPU memory held by the tiles currently in the cache
+    std::size_t bytes = 0;
+};
+
+// Counters of the cache of tile data kept in memory in front of the file source, so that tiles
+// evicted from the tile caches can be loaded again without I/O.
+struct RawTileCacheStats {
+    // Tile requests answered from memory
+    std::uint64_t hits = 0;
+    // Tile requests passed on to the file source
+    std::uint64_t misses = 0;
+    // Tile data removed from the cache to stay within its limit
+    std::uint64_t evictions = 0;
+    // Tiles whose data is currently in the cache
+    std::size_t tiles = 0;
+    // Bytes of tile data currently in the cache
+    std::size_t bytes = 0;
+    // Total time from request to response, for the requests answered from memory and for those
+    // passed on to the file source
+    Duration hitLatency = Duration::zero();
+    Duration missLatency = Duration::zero();
+};
+
+} // namespace mln
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
@@ -13,9 +14,40 @@ enum CompressionFormat {
     DETECT = 15 + 32
 };
 
+// Codecs whose decompression can be provided by the platform
+enum class Codec : uint8_t {
+    // gzip and zlib data, inflated with zlib unless replaced, e.g. by libdeflate
+    Deflate,
+    // zstd data, which can only be decompressed once a decompressor is set
+    Zstd
+};
+
+// The container of the data handed to a decompressor
+enum class CompressedFormat : uint8_t {
+    Gzip,
+    Zlib,
+    Zstd
+};
+
+// Decompresses `size` bytes at `data`, held in the given container, or throws. `decompressedSize` is
+// the size of the output if the container records it, or 0.
+using Decompressor = std::string (*)(const char* data,
+                                     std::size_t size,
+                                     std::size_t decompressedSize,
+                                     CompressedFormat format);
+
+// Sets the decompressor used for a codec, from any thread, and returns the one it replaces. Passing
+// nullptr restores the built-in one.
+Decompressor setDecompressor(Codec, Decompressor) noexcept;
+bool hasDecompressor(Codec) noexcept;
+
 bool is_compressed(const std::string&);
+bool is_compressed(const char* data, std::size_t size);
 std::string compress(const std::string& raw, int windowBits = CompressionFormat::ZLIB);
 std::string decompress(const std::string& raw, int windowBits = CompressionFormat::DETECT);
+// Decompresses data which is not held in a string, e.g. in a memory mapped file, without copying it first
+std::string decompress(const char* data, std::size_t size, int windowBits = CompressionFormat::DETECT);
+std::string decompress(Codec, const char* data, std::size_t size);
 
 std::uint32_t crc32(const void* raw, size_t size) noexcept;
 
@@ -175,8 +175,20 @@ using UnassociatedImage = Image<ImageAlphaMode::Unassociated>;
 using PremultipliedImage = Image<ImageAlphaMode::Premultiplied>;
 using AlphaImage = Image<ImageAlphaMode::Exclusive>;
 
+struct PNGEncodeOptions {
+    /// zlib compression level, from 1 (fastest) to 9 (smallest). -1 selects zlib's default.
+    int compressionLevel = -1;
+    /// Picks a filter for every row instead of storing rows as they are. Usually makes the output
+    /// smaller for a small cost in speed.
+    bool adaptiveFiltering = false;
+    /// Number of threads encoding blocks of rows concurrently, including the calling thread.
+    /// Small images are encoded on fewer threads, and helpers are limited by the background scheduler's concurrency.
+    std::size_t threads = 1;
+};
+
 // TODO: don't use std::string for binary data.
 PremultipliedImage decodeImage(const std::string&);
 std::string encodePNG(const PremultipliedImage&);
+std::string encodePNG(const PremultipliedImage&, const PNGEncodeOptions&);
 
 } // namespace mln
@@ -1,8 +1,14 @@
 #pragma once
 
+#include <mbgl/util/containers.hpp>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <list>
 #include <stdexcept>
 #include <unordered_map>
+#include <utility>
 
 namespace mln {
 
@@ -57,4 +63,111 @@ private:
     std::unordered_map<Item, typename std::list<Item>::iterator, Hash> map;
 };
 
+// Simple non-thread-safe map which evicts its least recently used values once their sizes, as
+// given when they are put, add up to more than a limit. Pointers to values are valid until the
+// map is next modified.
+template <typename Key, typename Value, typename Hash = std::hash<Key>>
+class SizedLRU {
+public:
+    explicit SizedLRU(std::size_t maxBytes_)
+        : maxBytes(maxBytes_) {}
+
+    // Number of cached values, and the sum of their sizes
+    std::size_t size() const { return entries.size(); }
+    std::size_t getBytes() const { return bytes; }
+
+    // Number of values evicted to stay within the limit
+    uint64_t getEvictions() const { return evictions; }
+
+    std::size_t getMaxBytes() const { return maxBytes; }
+    void setMaxBytes(std::size_t maxBytes_) {
+        maxBytes = maxBytes_;
+        evict();
+    }
+
+    bool contains(const Key& key) const { return entries.find(key) != entries.end(); }
+
+    // Returns the value of a key without changing its order, or null
+    Value* find(const Key& key) {
+        const auto it = entries.find(key);
+        return it != entries.end() ? &it->second.value : nullptr;
+    }
+
+    // Returns the value of a key and makes it the most recently used, or null
+    Value* get(const Key& key) {
+        const auto it = entries.find(key);
+        if (it == entries.end()) {
+            return nullptr;
+        }
+        order.splice(order.end(), order, it->second.order);
+        return &it->second.value;
+    }
+
+    // Adds or replaces the value of a key as the most recently used, evicting others as needed.
+    // A value larger than the limit on its own isn't kept, and false is returned.
+    bool put(const Key& key, Value value, std::size_t valueBytes) {
+        remove(key);
+        if (valueBytes > maxBytes) {
+            return false;
+        }
+        order.push_back(key);
+        entries.emplace(key, Entry{std::move(value), valueBytes, std::prev(order.end())});
+        bytes += valueBytes;
+        evict();
+        return true;
+    }
+
+    void remove(const Key& key) {
+        const auto it = entries.find(key);
+        if (it != entries.end()) {
+            erase(it);
+        }
+    }
+
+    void clear() {
+        entries.clear();
+        order.clear();
+        bytes = 0;
+    }
+
+    // Calls a function with each key and value, from the least to the most recently used
+    template <typename Fn>
+    void forEach(Fn&& fn) const {
+        for (const auto& key : order) {
+            fn(key, entries.find(key)->second.value);
+        }
+    }
+
+private:
+    struct Entry {
+        Value value;
+        std::size_t bytes;
+        typename std::list<Key>::iterator order;
+    };
+    using Entries = mln::unordered_map<Key, Entry, Hash>;
+
+    void evict() {
+        while (bytes > maxBytes && !order.empty()) {
+            const auto it = entries.find(order.front());
+            assert(it != entries.end());
+            erase(it);
+            evictions++;
+        }
+    }
+
+    void erase(typename Entries::iterator it) {
+        assert(bytes >= it->second.bytes);
+        bytes -= it->second.bytes;
+        order.erase(it->second.order);
+        entries.erase(it);
+    }
+
+    std::size_t maxBytes;
+    std::size_t bytes = 0;
+    uint64_t evictions = 0;
+    Entries entries;
+    // Keys from least to most recently used
+    std::list<Key> order;
+};
+
 } // namespace mln
@@ -7,18 +7,22 @@
 #include <mbgl/util/constants.hpp>
 #include <mbgl/util/mapbox.hpp>
 #include <mbgl/util/expected.hpp>
+#include <mbgl/util/chrono.hpp>
 
 #include <list>
 #include <map>
 #include <memory>
 #include <string>
 #include <optional>
+#include <utility>
+#include <vector>
 
 namespace mapbox {
 namespace sqlite {
 class Database;
 class Statement;
 class Query;
+class Transaction;
 class Exception;
 } // namespace sqlite
 } // namespace mapbox
@@ -37,8 +41,20 @@ struct MapboxTileLimitExceededException : util::Exception {
         : util::Exception("Mapbox tile limit exceeded") {}
 };
 
+// When the EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES setting is enabled, the database uses WAL
+// journaling with `synchronous = NORMAL`, and ambient cache writes are made in a transaction that
+// stays open for up to `BatchedWritesInterval` or `MaxBatchedWrites` writes. Access times of read
+// resources, used for LRU eviction, are kept in memory and written with the next batch. Every
+// other operation commits the pending batch first. The database stays consistent on a crash, but
+// the writes and access times of the last batch are lost, and on power loss so can be the last
+// committed batches. Losing them only means downloading those resources again. A write which fails
+// is undone on its own, leaving the rest of the batch pending. Databases are only switched to WAL
+// journaling while the setting is enabled, and are left in that mode afterwards.
 class OfflineDatabase {
 public:
+    static constexpr Duration BatchedWritesInterval = std::chrono::seconds(1);
+    static constexpr std::size_t MaxBatchedWrites = 256;
+
     OfflineDatabase(std::string path, const TileServerOptions& options);
     ~OfflineDatabase();
 
@@ -50,6 +66,10 @@ public:
     // Return value is (inserted, stored size)
     std::pair<bool, uint64_t> put(const Resource&, const Response&);
 
+    // Commits the batched writes and access times, if any.
+    void flushPendingWrites();
+    bool hasPendingWrites() const;
+
     // Force Mapbox GL Native to revalidate tiles stored in the ambient
     // cache with the tile server before using them, making sure they
     // are the latest version. This is more efficient than cleaning the
@@ -119,9 +139,15 @@ private:
     bool disabled();
     void vacuum();
     void checkFlags();
+    void useWriteAheadLog();
+    void flushPendingWritesIfDue();
+    void discardPendingWrites();
 
     mapbox::sqlite::Statement& getStatement(const char*);
 
+    void updateTileAccessed(const Resource::TileData&, Timestamp);
+    void updateResourceAccessed(const std::string& url, Timestamp);
+
     std::optional<std::pair<Response, uint64_t>> getTile(const Resource::TileData&);
     std::optional<int64_t> hasTile(const Resource::TileData&);
     bool putTile(const Resource::TileData&, const Response&, const std::string&, bool compressed);
@@ -189,6 +215,13 @@ private:
 
     bool autopack = true;
     bool readOnly = false;
+
+    const bool batchedWrites;
+    std::unique_ptr<mapbox::sqlite::Transaction> batch;
+    TimePoint batchStart;
+    std::size_t batchSize = 0;
+    std::vector<std::pair<Resource::TileData, Timestamp>> accessedTiles;
+    std::vector<std::pair<std::string, Timestamp>> accessedResources;
 };
 
 } // namespace mln
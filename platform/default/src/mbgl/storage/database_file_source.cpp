@@ -11,6 +11,7 @@
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/thread.hpp>
+#include <mbgl/util/timer.hpp>
 
 #include <map>
 #include <utility>
@@ -36,6 +37,7 @@ public:
                                                                        "Cached resource is unusable");
         }
         req.invoke(&FileSourceRequest::setResponse, *offlineResponse);
+        scheduleFlush();
     }
 
     void setDatabasePath(const std::string& path, const std::function<void()>& callback) {
@@ -47,6 +49,7 @@ public:
 
     void forward(const Resource& resource, const Response& response, const std::function<void()>& callback) {
         db->put(resource, response);
+        scheduleFlush();
         if (callback) {
             callback();
         }
@@ -58,7 +61,10 @@ public:
 
     void runPackDatabaseAutomatically(bool autopack) { db->runPackDatabaseAutomatically(autopack); }
 
-    void put(const Resource& resource, const Response& response) { db->put(resource, response); }
+    void put(const Resource& resource, const Response& response) {
+        db->put(resource, response);
+        scheduleFlush();
+    }
 
     void invalidateAmbientCache(const std::function<void(std::exception_ptr)>& callback) {
         callback(db->invalidateAmbientCache());
@@ -152,9 +158,23 @@ private:
         return downloads.emplace(regionID, std::move(download)).first->second.get();
     }
 
+    // Commits writes batched by the database once the session goes idle
+    void scheduleFlush() {
+        if (flushScheduled || !db->hasPendingWrites()) {
+            return;
+        }
+        flushScheduled = true;
+        flushTimer.start(OfflineDatabase::BatchedWritesInterval, Duration::zero(), [this] {
+            flushScheduled = false;
+            db->flushPendingWrites();
+        });
+    }
+
     std::unique_ptr<OfflineDatabase> db;
     std::map<int64_t, std::unique_ptr<OfflineDownload>> downloads;
     std::shared_ptr<FileSource> onlineFileSource;
+    util::Timer flushTimer;
+    bool flushScheduled = false;
 };
 
 class DatabaseFileSource::Impl {
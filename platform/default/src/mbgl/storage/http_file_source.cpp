@@ -19,6 +19,7 @@
 #include <cassert>
 #include <cstring>
 #include <cstdio>
+#include <cstdlib>
 #include <optional>
 
 namespace {
@@ -389,6 +390,21 @@ size_t HTTPRequest::headerCallback(char *const buffer, const size_t size, const
     } else if ((begin = headerMatches("x-rate-limit-reset: ", buffer, length)) != std::string::npos) {
         baton->xRateLimitReset = std::string(buffer + begin,
                                              length - begin - 2); // remove \r\n
+    } else if ((begin = headerMatches("content-length: ", buffer, length)) != std::string::npos) {
+        // Allocate the body once instead of growing it as it arrives, for responses whose body is
+        // kept. The length is only a hint, it is that of the encoded body and capped to not trust
+        // servers with large allocations.
+        long responseCode = 0;
+        curl_easy_getinfo(baton->handle, CURLINFO_RESPONSE_CODE, &responseCode);
+        if (responseCode == 200 || responseCode == 206) {
+            const std::string value{buffer + begin, length - begin - 2}; // remove \r\n
+            const auto contentLength = std::strtoull(value.c_str(), nullptr, 10);
+            if (!baton->data) {
+                baton->data = std::make_shared<std::string>();
+            }
+            baton->data->reserve(
+                static_cast<std::size_t>(std::min<unsigned long long>(contentLength, 32 * 1024 * 1024)));
+        }
     }
     // NOLINTEND(bugprone-assignment-in-if-condition)
 
@@ -426,6 +442,10 @@ void HTTPRequest::handleResult(CURLcode code) {
 
         if (responseCode == 200 || responseCode == 206) {
             if (data) {
+                // The body may be much shorter than announced, e.g. when the connection was cut
+                if (data->capacity() - data->size() > data->size() / 4 + 4096) {
+                    data->shrink_to_fit();
+                }
                 response->data = std::move(data);
             } else {
                 response->data = std::make_shared<std::string>();
@@ -1,9 +1,11 @@
 #include <sstream>
 #include <map>
 
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/file_source_request.hpp>
+#include <mbgl/storage/resource.hpp>
 
 #include <rapidjson/document.h>
 #include <rapidjson/rapidjson.h>
@@ -15,9 +17,14 @@
 #include <mbgl/util/chrono.hpp>
 #include <mbgl/util/compression.hpp>
 #include <mbgl/util/filesystem.hpp>
+#include <mbgl/util/thread_pool.hpp>
 
 #include <mbgl/storage/sqlite3.hpp>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 #include <sys/types.h>
 #include <sys/stat.h>
 
@@ -35,6 +42,25 @@ bool acceptsURL(const std::string &url) {
 std::string url_to_path(const std::string &url) {
     return mln::util::percentDecode(url.substr(std::char_traits<char>::length(mln::util::MBTILES_PROTOCOL)));
 }
+
+std::string db_path(const std::string &path) {
+    return path.substr(0, path.find('?'));
+}
+
+// Rows are numbered from the bottom in MBTiles
+int64_t tile_row(const mln::Resource &resource) {
+    return (int64_t{1} << resource.tileData->z) - 1 - resource.tileData->y;
+}
+
+const char *const tileQuery =
+    "SELECT tile_data FROM tiles "
+    "WHERE zoom_level = ?1 AND tile_column = ?2 AND tile_row = ?3";
+
+// Pooled tiles are read by the file source's own threads, rather than by the workers parsing them
+constexpr unsigned maxReaderThreads = 4;
+
+// Pools unused for this long are closed, as they are once the sources reading them are removed
+constexpr auto poolIdleTime = std::chrono::seconds(60);
 } // namespace
 
 namespace mln {
@@ -70,8 +96,6 @@ public:
         return std::string(buffer.GetString(), buffer.GetSize());
     }
 
-    std::string db_path(const std::string &path) { return path.substr(0, path.find('?')); }
-
     // Generate a tilejson resource from .mbtiles file
     void request_tilejson(const Resource &resource, ActorRef<FileSourceRequest> req) {
         const auto path = url_to_path(resource.url);
@@ -190,33 +214,22 @@ public:
     void request_tile(const Resource &resource, ActorRef<FileSourceRequest> req) {
         std::string base_path = url_to_path(resource.url);
         std::string path = db_path(base_path);
-        auto &db = get_db(path);
-
-        int iy = resource.tileData->y;
-        int iz = resource.tileData->z;
-
-        auto x = std::to_string(resource.tileData->x);
-        auto y = std::to_string((int)(pow(2, iz) - 1) - iy);
-        auto z = std::to_string(iz);
-
-        std::string sql = "SELECT tile_data FROM tiles where zoom_level = " + z + " AND tile_column = " + x +
-                          " AND tile_row = " + y;
-        mapbox::sqlite::Statement stmt(db, sql.c_str());
 
         Response response;
         response.noContent = true;
 
-        for (mapbox::sqlite::Query q(stmt); q.run();) {
+        mapbox::sqlite::Query q(get_tile_statement(path));
+        q.bind(1, static_cast<int64_t>(resource.tileData->z));
+        q.bind(2, static_cast<int64_t>(resource.tileData->x));
+        q.bind(3, tile_row(resource));
+        if (q.run()) {
             std::optional<std::string> data = q.get<std::optional<std::string>>(0);
             if (data) {
-                response.data = std::make_shared<std::string>(*data);
+                response.data = util::is_compressed(*data) ? std::make_shared<std::string>(util::decompress(*data))
+                                                           : std::make_shared<std::string>(std::move(*data));
                 response.noContent = false;
                 response.expires = Timestamp::max();
                 response.etag = resource.url;
-
-                if (util::is_compressed(*response.data)) {
-                    response.data = std::make_shared<std::string>(util::decompress(*response.data));
-                }
             }
         }
         req.invoke(&FileSourceRequest::setResponse, response);
@@ -244,15 +257,29 @@ public:
 
 private:
     std::map<std::string, mapbox::sqlite::Database> db_cache;
+    // The tile query of each database, prepared once. Destroyed before the databases.
+    std::map<std::string, std::unique_ptr<mapbox::sqlite::Statement>> tile_statements;
 
     void close_db(const std::string &path) {
+        tile_statements.erase(path);
         auto ptr = db_cache.find(path);
         if (ptr != db_cache.end()) {
             db_cache.erase(path);
         }
     }
 
-    void close_all() { db_cache.clear(); }
+    void close_all() {
+        tile_statements.clear();
+        db_cache.clear();
+    }
+
+    mapbox::sqlite::Statement &get_tile_statement(const std::string &path) {
+        auto &statement = tile_statements[path];
+        if (!statement) {
+            statement = std::make_unique<mapbox::sqlite::Statement>(get_db(path), tileQuery);
+        }
+        return *statement;
+    }
 
     // Multiple databases open simultaneously, to effectively support multiple .mbtiles maps
     mapbox::sqlite::Database &get_db(const std::string &path) {
@@ -272,18 +299,139 @@ private:
     ClientOptions clientOptions;
 };
 
+// Read-only connections to a database, each with the tile query prepared. Each connection is used
+// by one reader thread at a time, so there are never more connections than reader threads and
+// acquiring one doesn't wait.
+class MBTilesFileSource::ConnectionPool {
+public:
+    ConnectionPool(std::string path_, int64_t mmapSize_)
+        : path(std::move(path_)),
+          mmapSize(mmapSize_) {}
+
+    Response getTile(const Resource &resource) {
+        Response response;
+        response.noContent = true;
+
+        try {
+            auto connection = acquire();
+            std::optional<std::string> data;
+            {
+                mapbox::sqlite::Query query(connection->tileStatement);
+                query.bind(1, static_cast<int64_t>(resource.tileData->z));
+                query.bind(2, static_cast<int64_t>(resource.tileData->x));
+                query.bind(3, tile_row(resource));
+                if (query.run()) {
+                    data = query.get<std::optional<std::string>>(0);
+                }
+            }
+            release(std::move(connection));
+
+            if (data) {
+                response.data = util::is_compressed(*data) ? std::make_shared<std::string>(util::decompress(*data))
+                                                           : std::make_shared<std::string>(std::move(*data));
+                response.noContent = false;
+                response.expires = Timestamp::max();
+                response.etag = resource.url;
+            }
+        } catch (const std::exception &e) {
+            response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other,
+                                                               std::string("Error reading MBTiles tile: ") + e.what());
+        }
+
+        return response;
+    }
+
+private:
+    struct Connection {
+        Connection(const std::string &path, int64_t mmapSize)
+            : db(openDatabase(path, mmapSize)),
+              tileStatement(db, tileQuery) {}
+
+        static mapbox::sqlite::Database openDatabase(const std::string &path, int64_t mmapSize) {
+            auto db = mapbox::sqlite::Database::open(path, mapbox::sqlite::ReadOnly);
+            if (mmapSize > 0) {
+                db.exec("PRAGMA mmap_size = " + std::to_string(mmapSize));
+            }
+            return db;
+        }
+
+        mapbox::sqlite::Database db;
+        mapbox::sqlite::Statement tileStatement;
+    };
+
+    std::unique_ptr<Connection> acquire() {
+        {
+            std::scoped_lock lock(mutex);
+            if (!idle.empty()) {
+                auto connection = std::move(idle.back());
+                idle.pop_back();
+                return connection;
+            }
+        }
+        return std::make_unique<Connection>(path, mmapSize);
+    }
+
+    void release(std::unique_ptr<Connection> connection) {
+        std::scoped_lock lock(mutex);
+        idle.push_back(std::move(connection));
+    }
+
+    const std::string path;
+    const int64_t mmapSize;
+
+    std::mutex mutex;
+    std::vector<std::unique_ptr<Connection>> idle;
+};
+
 MBTilesFileSource::MBTilesFileSource(const ResourceOptions &resourceOptions, const ClientOptions &clientOptions)
     : thread(std::make_unique<util::Thread<Impl>>(
           util::makeThreadPrioritySetter(platform::EXPERIMENTAL_THREAD_PRIORITY_FILE),
           "MBTilesFileSource",
           resourceOptions.clone(),
-          clientOptions.clone())) {}
+          clientOptions.clone())),
+      connectionPooling([] {
+          const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_MBTILES_CONNECTION_POOL);
+          const auto *enabled = value.getBool();
+          return enabled && *enabled;
+      }()),
+      mmapSize([] {
+          const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_MBTILES_MMAP_SIZE);
+          const auto *size = value.getDouble();
+          return size ? static_cast<int64_t>(*size) : int64_t{0};
+      }()) {
+    if (connectionPooling) {
+        const auto threads = std::clamp(std::thread::hardware_concurrency(), 1u, maxReaderThreads);
+        readers = std::make_unique<ParallelScheduler>(threads - 1);
+    }
+}
+
+std::shared_ptr<MBTilesFileSource::ConnectionPool> MBTilesFileSource::getConnectionPool(const std::string &path) {
+    const auto now = Clock::now();
+    std::scoped_lock lock(poolsMutex);
+    // Connections close once the tasks still reading through a pool are done
+    std::erase_if(pools, [&](const auto &entry) { return now - entry.second.lastUsed > poolIdleTime; });
+    auto &entry = pools[path];
+    if (!entry.pool) {
+        entry.pool = std::make_shared<ConnectionPool>(path, mmapSize);
+    }
+    entry.lastUsed = now;
+    return entry.pool;
+}
 
 std::unique_ptr<AsyncRequest> MBTilesFileSource::request(const Resource &resource, FileSource::Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
 
     // assume if there is a tile request, that the mbtiles file has been validated
     if (resource.kind == Resource::Tile) {
+        if (readers) {
+            readers->schedule([pool = getConnectionPool(db_path(url_to_path(resource.url))),
+                               resource,
+                               ref = req->actor()] {
+                ref.invoke(&FileSourceRequest::setResponse, pool->getTile(resource));
+            });
+            return req;
+        }
+
         thread->actor().invoke(&Impl::request_tile, resource, req->actor());
         return req;
     }
@@ -320,7 +468,12 @@ bool MBTilesFileSource::canRequest(const Resource &resource) const {
     return acceptsURL(resource.url);
 }
 
-MBTilesFileSource::~MBTilesFileSource() = default;
+MBTilesFileSource::~MBTilesFileSource() {
+    // Finish reading before the pools are closed
+    readers.reset();
+    std::scoped_lock lock(poolsMutex);
+    pools.clear();
+}
 
 void MBTilesFileSource::setResourceOptions(ResourceOptions options) {
     thread->actor().invoke(&Impl::setResourceOptions, options.clone());
@@ -1,3 +1,4 @@
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/response.hpp>
 #include <mbgl/storage/sqlite3.hpp>
@@ -26,7 +27,13 @@ std::string OfflineDatabase::cacheKey(const Resource& resource) {
 
 OfflineDatabase::OfflineDatabase(std::string path_, const TileServerOptions& options)
     : path(std::move(path_)),
-      tileServerOptions(options) {
+      tileServerOptions(options),
+      batchedWrites([] {
+          const auto value = platform::Settings::getInstance().get(
+              platform::EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES);
+          const auto* enabled = value.getBool();
+          return enabled && *enabled;
+      }()) {
     try {
         initialize();
     } catch (...) {
@@ -79,6 +86,7 @@ void OfflineDatabase::initialize() {
             // fall through
         case 6:
             // Happy path; we're done
+            useWriteAheadLog();
             return;
         default:
             // Downgrade: delete the database and try to reinitialize.
@@ -95,6 +103,8 @@ void OfflineDatabase::changePath(const std::string& path_) {
 }
 
 void OfflineDatabase::cleanup() {
+    flushPendingWrites();
+
     // Deleting these SQLite objects may result in exceptions
     try {
         statements.clear();
@@ -161,6 +171,7 @@ void OfflineDatabase::handleError(const char* action) {
 void OfflineDatabase::removeExisting() {
     Log::Warning(Event::Database, "Removing existing incompatible offline database");
 
+    discardPendingWrites();
     statements.clear();
     db.reset();
 
@@ -182,6 +193,7 @@ void OfflineDatabase::createSchema() {
     vacuum();
     db->exec("PRAGMA journal_mode = DELETE");
     db->exec("PRAGMA synchronous = FULL");
+    useWriteAheadLog();
     mapbox::sqlite::Transaction transaction(*db);
     db->exec(offlineDatabaseSchema);
     db->exec("PRAGMA user_version = 6");
@@ -244,6 +256,62 @@ void OfflineDatabase::checkFlags() {
     }
 }
 
+// Batched writes rely on WAL journaling, which only syncs on checkpoints with `synchronous = NORMAL`.
+// Other databases are left as they are, so opening one doesn't modify it.
+void OfflineDatabase::useWriteAheadLog() {
+    assert(db);
+    checkFlags();
+
+    if (batchedWrites) {
+        db->exec("PRAGMA journal_mode = WAL");
+        db->exec("PRAGMA synchronous = NORMAL");
+    }
+}
+
+bool OfflineDatabase::hasPendingWrites() const {
+    return batch || !accessedTiles.empty() || !accessedResources.empty();
+}
+
+void OfflineDatabase::flushPendingWrites() try {
+    if (!hasPendingWrites()) {
+        return;
+    }
+
+    if (!batch) {
+        batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+    }
+    for (const auto& [tile, accessed] : accessedTiles) {
+        updateTileAccessed(tile, accessed);
+    }
+    for (const auto& [url, accessed] : accessedResources) {
+        updateResourceAccessed(url, accessed);
+    }
+    batch->commit();
+    batch.reset();
+    discardPendingWrites();
+} catch (...) {
+    discardPendingWrites();
+    handleError("write batched resources");
+}
+
+void OfflineDatabase::flushPendingWritesIfDue() {
+    if (batchSize + accessedTiles.size() + accessedResources.size() >= MaxBatchedWrites ||
+        (hasPendingWrites() && Clock::now() - batchStart >= BatchedWritesInterval)) {
+        flushPendingWrites();
+    }
+}
+
+void OfflineDatabase::discardPendingWrites() {
+    if (batch) {
+        // Rolls back uncommitted writes, whose sizes were already added to the ambient cache size
+        batch.reset();
+        currentAmbientCacheSize = std::nullopt;
+    }
+    batchSize = 0;
+    accessedTiles.clear();
+    accessedResources.clear();
+}
+
 mapbox::sqlite::Statement& OfflineDatabase::getStatement(const char* sql) {
     if (!db) {
         initialize();
@@ -261,6 +329,9 @@ std::optional<Response> OfflineDatabase::get(const Resource& resource) try {
     }
 
     auto result = getInternal(resource);
+    if (batchedWrites) {
+        flushPendingWritesIfDue();
+    }
     return result ? std::optional<Response>{result->first} : std::nullopt;
 } catch (...) {
     handleError("read resource");
@@ -296,11 +367,40 @@ std::pair<bool, uint64_t> OfflineDatabase::put(const Resource& resource, const R
         return {false, 0};
     }
 
+    if (batchedWrites) {
+        if (!hasPendingWrites()) {
+            batchStart = Clock::now();
+        }
+        if (!batch) {
+            batch = std::make_unique<mapbox::sqlite::Transaction>(*db, mapbox::sqlite::Transaction::Immediate);
+        }
+
+        // Each write has its own savepoint, so a failed one is undone without the rest of the batch
+        db->exec("SAVEPOINT batched_write");
+        std::pair<bool, uint64_t> result;
+        try {
+            result = putInternal(resource, response, true);
+        } catch (...) {
+            db->exec("ROLLBACK TO batched_write");
+            db->exec("RELEASE batched_write");
+            // The undone write may have been counted already
+            currentAmbientCacheSize = std::nullopt;
+            handleError("write resource");
+            return {false, 0};
+        }
+        db->exec("RELEASE batched_write");
+        batchSize++;
+        flushPendingWritesIfDue();
+        return result;
+    }
+
     mapbox::sqlite::Transaction transaction(*db, mapbox::sqlite::Transaction::Immediate);
     auto result = putInternal(resource, response, true);
     transaction.commit();
     return result;
 } catch (...) {
+    // The batch is lost when the failed write can't be undone on its own
+    discardPendingWrites();
     handleError("write resource");
     return {false, 0};
 }
@@ -359,14 +459,21 @@ std::pair<bool, uint64_t> OfflineDatabase::putInternal(const Resource& resource,
     return {inserted, size};
 }
 
+void OfflineDatabase::updateResourceAccessed(const std::string& url, Timestamp accessed) {
+    mapbox::sqlite::Query accessedQuery{getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2")};
+    accessedQuery.bind(1, accessed);
+    accessedQuery.bind(2, url);
+    accessedQuery.run();
+}
+
 std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const Resource& resource) {
     // Update accessed timestamp used for LRU eviction.
-    if (!readOnly) {
+    if (!readOnly && batchedWrites) {
+        if (!hasPendingWrites()) batchStart = Clock::now();
+        accessedResources.emplace_back(cacheKey(resource), util::now());
+    } else if (!readOnly) {
         try {
-            mapbox::sqlite::Query accessedQuery{getStatement("UPDATE resources SET accessed = ?1 WHERE url = ?2")};
-            accessedQuery.bind(1, util::now());
-            accessedQuery.bind(2, cacheKey(resource));
-            accessedQuery.run();
+            updateResourceAccessed(cacheKey(resource), util::now());
         } catch (const mapbox::sqlite::Exception& ex) {
             if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
                 throw;
@@ -407,8 +514,8 @@ std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getResource(const
         response.data = std::make_shared<std::string>(util::decompress(*data));
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -511,28 +618,35 @@ bool OfflineDatabase::putResource(const Resource& resource,
     return true;
 }
 
+void OfflineDatabase::updateTileAccessed(const Resource::TileData& tile, Timestamp accessed) {
+    // clang-format off
+    mapbox::sqlite::Query accessedQuery{ getStatement(
+        "UPDATE tiles "
+        "SET accessed       = ?1 "
+        "WHERE url_template = ?2 "
+        "  AND pixel_ratio  = ?3 "
+        "  AND x            = ?4 "
+        "  AND y            = ?5 "
+        "  AND z            = ?6 ") };
+    // clang-format on
+
+    accessedQuery.bind(1, accessed);
+    accessedQuery.bind(2, tile.urlTemplate);
+    accessedQuery.bind(3, tile.pixelRatio);
+    accessedQuery.bind(4, tile.x);
+    accessedQuery.bind(5, tile.y);
+    accessedQuery.bind(6, tile.z);
+    accessedQuery.run();
+}
+
 std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Resource::TileData& tile) {
     // Update accessed timestamp used for LRU eviction.
-    if (!readOnly) {
+    if (!readOnly && batchedWrites) {
+        if (!hasPendingWrites()) batchStart = Clock::now();
+        accessedTiles.emplace_back(tile, util::now());
+    } else if (!readOnly) {
         try {
-            // clang-format off
-            mapbox::sqlite::Query accessedQuery{ getStatement(
-                "UPDATE tiles "
-                "SET accessed       = ?1 "
-                "WHERE url_template = ?2 "
-                "  AND pixel_ratio  = ?3 "
-                "  AND x            = ?4 "
-                "  AND y            = ?5 "
-                "  AND z            = ?6 ") };
-            // clang-format on
-
-            accessedQuery.bind(1, util::now());
-            accessedQuery.bind(2, tile.urlTemplate);
-            accessedQuery.bind(3, tile.pixelRatio);
-            accessedQuery.bind(4, tile.x);
-            accessedQuery.bind(5, tile.y);
-            accessedQuery.bind(6, tile.z);
-            accessedQuery.run();
+            updateTileAccessed(tile, util::now());
         } catch (const mapbox::sqlite::Exception& ex) {
             if (ex.code == mapbox::sqlite::ResultCode::NotADB || ex.code == mapbox::sqlite::ResultCode::Corrupt) {
                 throw;
@@ -581,8 +695,8 @@ std::optional<std::pair<Response, uint64_t>> OfflineDatabase::getTile(const Reso
         response.data = std::make_shared<std::string>(util::decompress(*data));
         size = data->length();
     } else {
-        response.data = std::make_shared<std::string>(*data);
         size = data->length();
+        response.data = std::make_shared<std::string>(std::move(*data));
     }
 
     return std::make_pair(response, size);
@@ -720,6 +834,7 @@ bool OfflineDatabase::putTile(const Resource::TileData& tile,
 
 std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
     checkFlags();
+    flushPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query tileQuery{ getStatement(
@@ -753,6 +868,7 @@ std::exception_ptr OfflineDatabase::invalidateAmbientCache() try {
 
 std::exception_ptr OfflineDatabase::clearAmbientCache() try {
     checkFlags();
+    flushPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query tileQuery{ getStatement(
@@ -786,6 +902,7 @@ std::exception_ptr OfflineDatabase::clearAmbientCache() try {
 
 std::exception_ptr OfflineDatabase::invalidateRegion(int64_t regionID) try {
     checkFlags();
+    flushPendingWrites();
 
     {
         // clang-format off
@@ -869,6 +986,7 @@ expected<std::optional<OfflineRegion>, std::exception_ptr> OfflineDatabase::getR
 expected<OfflineRegion, std::exception_ptr> OfflineDatabase::createRegion(const OfflineRegionDefinition& definition,
                                                                           const OfflineRegionMetadata& metadata) try {
     checkFlags();
+    flushPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
@@ -887,6 +1005,7 @@ expected<OfflineRegion, std::exception_ptr> OfflineDatabase::createRegion(const
 
 expected<OfflineRegions, std::exception_ptr> OfflineDatabase::mergeDatabase(const std::string& sideDatabasePath) {
     checkFlags();
+    flushPendingWrites();
 
     try {
         // clang-format off
@@ -969,6 +1088,7 @@ expected<OfflineRegions, std::exception_ptr> OfflineDatabase::mergeDatabase(cons
 expected<OfflineRegionMetadata, std::exception_ptr> OfflineDatabase::updateMetadata(
     const int64_t regionID, const OfflineRegionMetadata& metadata) try {
     checkFlags();
+    flushPendingWrites();
 
     // clang-format off
     mapbox::sqlite::Query query{ getStatement(
@@ -987,6 +1107,7 @@ expected<OfflineRegionMetadata, std::exception_ptr> OfflineDatabase::updateMetad
 
 std::exception_ptr OfflineDatabase::deleteRegion(OfflineRegion&& region) try {
     checkFlags();
+    flushPendingWrites();
 
     {
         mapbox::sqlite::Query query{getStatement("DELETE FROM regions WHERE id = ?")};
@@ -1024,6 +1145,7 @@ std::optional<int64_t> OfflineDatabase::hasRegionResource(const Resource& resour
 
 uint64_t OfflineDatabase::putRegionResource(int64_t regionID, const Resource& resource, const Response& response) try {
     checkFlags();
+    flushPendingWrites();
 
     if (!db) {
         initialize();
@@ -1041,6 +1163,7 @@ void OfflineDatabase::putRegionResources(int64_t regionID,
                                          const std::list<std::tuple<Resource, Response>>& resources,
                                          OfflineRegionStatus& status) try {
     checkFlags();
+    flushPendingWrites();
 
     if (!db) {
         initialize();
@@ -1388,6 +1511,7 @@ std::exception_ptr OfflineDatabase::initAmbientCacheSize() {
 }
 
 std::exception_ptr OfflineDatabase::setMaximumAmbientCacheSize(uint64_t size) {
+    flushPendingWrites();
     uint64_t previousMaximumAmbientCacheSize = maximumAmbientCacheSize;
 
     if (auto exception = initAmbientCacheSize()) {
@@ -1460,6 +1584,7 @@ void OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resour
     if (!db) {
         initialize();
     }
+    flushPendingWrites();
     mapbox::sqlite::Transaction transaction(*db);
     for (const auto& resource : resources) {
         markUsed(regionID, resource);
@@ -1471,6 +1596,7 @@ void OfflineDatabase::markUsedResources(int64_t regionID, const std::list<Resour
 
 std::exception_ptr OfflineDatabase::pack() try {
     if (!db) initialize();
+    flushPendingWrites();
     vacuum();
     return nullptr;
 } catch (...) {
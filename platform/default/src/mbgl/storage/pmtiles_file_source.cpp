@@ -1,6 +1,7 @@
 #include <sstream>
 #include <map>
 
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/file_source_manager.hpp>
 #include <mbgl/storage/file_source_request.hpp>
@@ -20,9 +21,20 @@
 
 #include <pmtiles.hpp>
 
+#include <algorithm>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+
 #include <sys/types.h>
 #include <sys/stat.h>
 
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #if defined(__QT__) && (defined(_WIN32) || defined(__EMSCRIPTEN__))
 #include <QtZlib/zlib.h>
 #else
@@ -45,6 +57,29 @@ bool acceptsURL(const std::string& url) {
 std::string extract_url(const std::string& url) {
     return url.substr(std::char_traits<char>::length(mln::util::PMTILES_PROTOCOL));
 }
+
+// zstd is only supported once the platform has set a decompressor for it
+bool isSupportedCompression(uint8_t compression) {
+    return compression == pmtiles::COMPRESSION_NONE || compression == pmtiles::COMPRESSION_GZIP ||
+           (compression == pmtiles::COMPRESSION_ZSTD && mln::util::hasDecompressor(mln::util::Codec::Zstd));
+}
+
+// Archives with gzip compression may hold uncompressed tiles too
+bool isCompressedTile(uint8_t compression, const char* data, std::size_t size) {
+    return (compression == pmtiles::COMPRESSION_GZIP && mln::util::is_compressed(data, size)) ||
+           compression == pmtiles::COMPRESSION_ZSTD;
+}
+
+std::string decompressData(uint8_t compression, const char* data, std::size_t size) {
+    switch (compression) {
+        case pmtiles::COMPRESSION_GZIP:
+            return mln::util::decompress(data, size);
+        case pmtiles::COMPRESSION_ZSTD:
+            return mln::util::decompress(mln::util::Codec::Zstd, data, size);
+        default:
+            return std::string(data, size);
+    }
+}
 } // namespace
 
 // temporary, remove this when it's available in `pmtiles.hpp`
@@ -176,18 +211,15 @@ public:
                         response.expires = tileResponse.expires;
                         response.etag = tileResponse.etag;
 
-                        if (header.tile_compression == pmtiles::COMPRESSION_GZIP) {
-                            // Support uncompressed tiles
-                            if (util::is_compressed(*tileResponse.data)) {
-                                try {
-                                    response.data = std::make_shared<std::string>(util::decompress(*tileResponse.data));
-                                } catch (const std::exception& e) {
-                                    response.error = std::make_unique<Response::Error>(
-                                        Response::Error::Reason::Other,
-                                        std::string("Error decompressing PMTiles tile: ") + e.what());
-                                }
-                            } else {
-                                response.data = tileResponse.data;
+                        const auto& data = *tileResponse.data;
+                        if (isCompressedTile(header.tile_compression, data.data(), data.size())) {
+                            try {
+                                response.data = std::make_shared<std::string>(
+                                    decompressData(header.tile_compression, data.data(), data.size()));
+                            } catch (const std::exception& e) {
+                                response.error = std::make_unique<Response::Error>(
+                                    Response::Error::Reason::Other,
+                                    std::string("Error decompressing PMTiles tile: ") + e.what());
                             }
                         }
 
@@ -285,10 +317,8 @@ private:
                 try {
                     pmtiles::headerv3 header = pmtiles::deserialize_header(response.data->substr(0, 127));
 
-                    if ((header.internal_compression != pmtiles::COMPRESSION_NONE &&
-                         header.internal_compression != pmtiles::COMPRESSION_GZIP) ||
-                        (header.tile_compression != pmtiles::COMPRESSION_NONE &&
-                         header.tile_compression != pmtiles::COMPRESSION_GZIP)) {
+                    if (!isSupportedCompression(header.internal_compression) ||
+                        !isSupportedCompression(header.tile_compression)) {
                         throw std::runtime_error("Compression method not supported");
                     }
 
@@ -447,17 +477,20 @@ private:
                             return;
                         }
 
-                        std::string data = *responseMetadata.data;
+                        const std::string& data = *responseMetadata.data;
 
-                        if (header.internal_compression == pmtiles::COMPRESSION_GZIP) {
+                        if (header.internal_compression != pmtiles::COMPRESSION_NONE) {
+                            std::string decompressed;
                             try {
-                                data = util::decompress(data);
+                                decompressed = decompressData(header.internal_compression, data.data(), data.size());
                             } catch (const std::exception& e) {
                                 callback(std::make_unique<Response::Error>(
                                     Response::Error::Reason::Other,
                                     std::string("Error decompressing PMTiles metadata: ") + e.what()));
                                 return;
                             }
+                            parse_callback(decompressed);
+                            return;
                         }
 
                         parse_callback(data);
@@ -547,14 +580,19 @@ private:
                 }
 
                 try {
-                    std::string directoryData = *response.data;
-
-                    if (header.internal_compression == pmtiles::COMPRESSION_GZIP) {
-                        directoryData = util::decompress(directoryData);
+                    const std::string& directoryData = *response.data;
+
+                    if (header.internal_compression != pmtiles::COMPRESSION_NONE) {
+                        storeDirectory(url,
+                                       directoryOffset,
+                                       directoryLength,
+                                       decompressData(header.internal_compression,
+                                                      directoryData.data(),
+                                                      directoryData.size()));
+                    } else {
+                        storeDirectory(url, directoryOffset, directoryLength, directoryData);
                     }
 
-                    storeDirectory(url, directoryOffset, directoryLength, directoryData);
-
                     callback(std::unique_ptr<Response::Error>());
                 } catch (const std::exception& e) {
                     callback(std::make_unique<Response::Error>(
@@ -627,18 +665,277 @@ private:
     }
 };
 
+namespace {
+
+// The state of a local file, to notice when it is rewritten or replaced
+struct FileVersion {
+    std::filesystem::file_time_type modified;
+    std::uintmax_t size = 0;
+
+    bool operator==(const FileVersion&) const = default;
+};
+
+std::optional<FileVersion> getFileVersion(const std::string& path) {
+    std::error_code error;
+    const auto modified = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return std::nullopt;
+    }
+    const auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        return std::nullopt;
+    }
+    return FileVersion{.modified = modified, .size = size};
+}
+
+constexpr auto mappedArchiveIdleTime = std::chrono::seconds(60);
+
+} // namespace
+
+// A local archive mapped into memory. Directories are decoded once, on first use, into sorted
+// arrays which are then searched without locking, so tiles can be read from any thread.
+class PMTilesFileSource::MappedArchive {
+public:
+    // Returns null when the file can't be mapped or uses an unsupported compression
+    static std::shared_ptr<MappedArchive> open(const std::string& path, const FileVersion& version) {
+#ifdef _WIN32
+        (void)path;
+        (void)version;
+        return nullptr;
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return nullptr;
+        }
+
+        struct stat info{};
+        void* mapping = MAP_FAILED;
+        if (::fstat(fd, &info) == 0 && info.st_size >= pmtilesHeaderLength) {
+            mapping = ::mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            return nullptr;
+        }
+
+        auto archive = std::shared_ptr<MappedArchive>(
+            new MappedArchive(static_cast<const char*>(mapping), static_cast<std::size_t>(info.st_size), version));
+        try {
+            archive->header = pmtiles::deserialize_header(std::string(archive->data, pmtilesHeaderLength));
+        } catch (const std::exception&) {
+            return nullptr;
+        }
+
+        const auto& header = archive->header;
+        if (!isSupportedCompression(header.internal_compression) || !isSupportedCompression(header.tile_compression)) {
+            return nullptr;
+        }
+
+        archive->root.offset = header.root_dir_offset;
+        archive->root.length = header.root_dir_bytes;
+        return archive;
+#endif
+    }
+
+    ~MappedArchive() {
+#ifndef _WIN32
+        ::munmap(const_cast<char*>(data), size);
+#endif
+    }
+
+    // The state of the file when it was opened
+    const FileVersion& getVersion() const { return version; }
+
+    Response getTile(const Resource& resource) const {
+        Response response;
+        response.noContent = true;
+
+        const auto& tileData = *resource.tileData;
+        if (tileData.z < header.min_zoom || tileData.z > header.max_zoom) {
+            return response;
+        }
+
+        const char* tile = nullptr;
+        uint32_t length = 0;
+        try {
+            const uint64_t tileID = pmtiles::zxy_to_tileid(static_cast<uint8_t>(tileData.z),
+                                                           static_cast<uint32_t>(tileData.x),
+                                                           static_cast<uint32_t>(tileData.y));
+            const auto address = findTile(tileID);
+            if (address.second == 0) {
+                return response;
+            }
+            tile = bytes(address.first, address.second);
+            length = address.second;
+        } catch (const std::exception& e) {
+            response.error = std::make_unique<Response::Error>(
+                Response::Error::Reason::Other, std::string("Error fetching PMTiles tile address: ") + e.what());
+            return response;
+        }
+
+        response.noContent = false;
+        if (isCompressedTile(header.tile_compression, tile, length)) {
+            try {
+                response.data = std::make_shared<std::string>(decompressData(header.tile_compression, tile, length));
+            } catch (const std::exception& e) {
+                response.noContent = true;
+                response.error = std::make_unique<Response::Error>(
+                    Response::Error::Reason::Other, std::string("Error decompressing PMTiles tile: ") + e.what());
+            }
+        } else {
+            // Responses own their data, so uncompressed tiles are copied out of the mapping, once
+            response.data = std::make_shared<std::string>(tile, length);
+        }
+
+        return response;
+    }
+
+private:
+    struct Directory {
+        uint64_t offset = 0;
+        uint64_t length = 0;
+
+        std::once_flag decoded;
+        std::vector<pmtiles::entryv3> entries;
+        // The leaf directories entries point to, by entry index
+        std::vector<std::unique_ptr<Directory>> leaves;
+    };
+
+    MappedArchive(const char* data_, std::size_t size_, FileVersion version_)
+        : data(data_),
+          size(size_),
+          version(std::move(version_)) {}
+
+    const char* bytes(uint64_t offset, uint64_t length) const {
+        if (offset > size || length > size - offset) {
+            throw std::runtime_error("range outside of the archive");
+        }
+        return data + offset;
+    }
+
+    void decode(Directory& directory) const {
+        const char* compressed = bytes(directory.offset, directory.length);
+        const auto length = static_cast<std::size_t>(directory.length);
+        directory.entries = pmtiles::deserialize_directory(
+            decompressData(header.internal_compression, compressed, length));
+
+        directory.leaves.resize(directory.entries.size());
+        for (std::size_t i = 0; i < directory.entries.size(); ++i) {
+            const auto& entry = directory.entries[i];
+            if (entry.run_length == 0 && entry.length > 0) {
+                directory.leaves[i] = std::make_unique<Directory>();
+                directory.leaves[i]->offset = header.leaf_dirs_offset + entry.offset;
+                directory.leaves[i]->length = entry.length;
+            }
+        }
+    }
+
+    // Returns the absolute offset and length of the tile's data, with a length of 0 when the archive
+    // doesn't have the tile
+    std::pair<uint64_t, uint32_t> findTile(uint64_t tileID) const {
+        Directory* directory = &root;
+        for (uint32_t depth = 0; depth <= 3; ++depth) {
+            // Throws and leaves the directory to be decoded by the next lookup when it is corrupt
+            std::call_once(directory->decoded, [&] { decode(*directory); });
+
+            // The last entry starting at or before the tile, as in `pmtiles::find_tile`
+            const auto& entries = directory->entries;
+            const auto it = std::upper_bound(
+                entries.begin(), entries.end(), tileID, [](uint64_t id, const pmtiles::entryv3& entry) {
+                    return id < entry.tile_id;
+                });
+            if (it == entries.begin()) {
+                return {0, 0};
+            }
+
+            const auto& entry = *std::prev(it);
+            if (entry.length == 0) {
+                return {0, 0};
+            }
+            if (entry.run_length > 0) {
+                if (tileID - entry.tile_id >= entry.run_length) {
+                    return {0, 0};
+                }
+                return {header.tile_data_offset + entry.offset, entry.length};
+            }
+
+            directory = directory->leaves[std::distance(entries.begin(), std::prev(it))].get();
+        }
+
+        throw std::runtime_error("Maximum directory depth exceeded");
+    }
+
+    const char* const data;
+    const std::size_t size;
+    const FileVersion version;
+    pmtiles::headerv3 header;
+    mutable Directory root;
+};
+
 PMTilesFileSource::PMTilesFileSource(const ResourceOptions& resourceOptions, const ClientOptions& clientOptions)
     : thread(std::make_unique<util::Thread<Impl>>(
           util::makeThreadPrioritySetter(platform::EXPERIMENTAL_THREAD_PRIORITY_FILE),
           "PMTilesFileSource",
           resourceOptions.clone(),
-          clientOptions.clone())) {}
+          clientOptions.clone())),
+      memoryMapping([] {
+          const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PMTILES_MEMORY_MAPPING);
+          const auto* enabled = value.getBool();
+          return enabled && *enabled;
+      }()) {}
+
+std::shared_ptr<PMTilesFileSource::MappedArchive> PMTilesFileSource::getMappedArchive(const std::string& url) {
+    if (!memoryMapping) {
+        return nullptr;
+    }
+
+    const auto archiveURL = extract_url(url);
+    if (!archiveURL.starts_with(util::FILE_PROTOCOL)) {
+        return nullptr;
+    }
+
+    const auto path = util::percentDecode(archiveURL.substr(std::char_traits<char>::length(util::FILE_PROTOCOL)));
+    const auto version = getFileVersion(path);
+    if (!version) {
+        return nullptr;
+    }
+
+    const auto now = Clock::now();
+    {
+        std::scoped_lock lock(archivesMutex);
+        std::erase_if(archives, [&](const auto& entry) { return now - entry.second.lastUsed > mappedArchiveIdleTime; });
+        const auto it = archives.find(archiveURL);
+        if (it != archives.end() && it->second.archive->getVersion() == *version) {
+            it->second.lastUsed = now;
+            return it->second.archive;
+        }
+    }
+
+    // Mapped without holding the lock, so other archives are read meanwhile. Archives which can't be mapped are read
+    // through the file source thread, and tried again next time.
+    auto archive = MappedArchive::open(path, *version);
+    std::scoped_lock lock(archivesMutex);
+    if (archive) {
+        archives.insert_or_assign(archiveURL, MappedEntry{.archive = archive, .lastUsed = now});
+    } else {
+        archives.erase(archiveURL);
+    }
+    return archive;
+}
 
 std::unique_ptr<AsyncRequest> PMTilesFileSource::request(const Resource& resource, FileSource::Callback callback) {
     auto req = std::make_unique<FileSourceRequest>(std::move(callback));
 
     // assume if there is a tile request, that the pmtiles file has been validated
     if (resource.kind == Resource::Tile) {
+        if (auto archive = getMappedArchive(resource.url)) {
+            // Read directly from the mapping, concurrently with other tiles
+            Scheduler::GetBackground()->schedule([archive = std::move(archive), resource, ref = req->actor()] {
+                ref.invoke(&FileSourceRequest::setResponse, archive->getTile(resource));
+            });
+            return req;
+        }
+
         thread->actor().invoke(&Impl::request_tile, req.get(), resource, req->actor());
         return req;
     }
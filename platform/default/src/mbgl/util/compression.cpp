@@ -6,6 +6,8 @@
 #include <zlib.h>
 #endif
 
+#include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
 #include <stdexcept>
@@ -32,9 +34,13 @@ namespace util {
 #undef compress
 
 bool is_compressed(const std::string &v) {
-    if (v.size() > 2) {
-        const auto byte0 = static_cast<uint8_t>(v[0]);
-        const auto byte1 = static_cast<uint8_t>(v[1]);
+    return is_compressed(v.data(), v.size());
+}
+
+bool is_compressed(const char *data, std::size_t size) {
+    if (size > 2) {
+        const auto byte0 = static_cast<uint8_t>(data[0]);
+        const auto byte1 = static_cast<uint8_t>(data[1]);
         if (byte0 == 0x1f && byte1 == 0x8b) {
             // gzip (rfc1952)
             return true;
@@ -54,15 +60,51 @@ bool is_compressed(const std::string &v) {
     return false;
 }
 
-std::string compress(const std::string &raw, int windowBits) {
-    z_stream deflate_stream;
-    memset(&deflate_stream, 0, sizeof(deflate_stream));
+namespace {
+
+// A deflate stream for each thread, reset for every call and only set up again for another format
+class DeflateStream {
+public:
+    DeflateStream() { memset(&stream, 0, sizeof(stream)); }
 
-    // TODO: reuse z_streams
-    if (deflateInit2(&deflate_stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-        throw std::runtime_error("failed to initialize deflate");
+    ~DeflateStream() {
+        if (windowBits) {
+            deflateEnd(&stream);
+        }
     }
 
+    z_stream &reset(int windowBits_) {
+        if (windowBits == windowBits_) {
+            if (deflateReset(&stream) != Z_OK) {
+                throw std::runtime_error("failed to reset deflate");
+            }
+            return stream;
+        }
+
+        if (windowBits) {
+            deflateEnd(&stream);
+            windowBits = 0;
+        }
+        memset(&stream, 0, sizeof(stream));
+        if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, windowBits_, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+            throw std::runtime_error("failed to initialize deflate");
+        }
+        windowBits = windowBits_;
+        return stream;
+    }
+
+private:
+    z_stream stream;
+    // The format the stream is set up for, or 0 before it is
+    int windowBits = 0;
+};
+
+} // namespace
+
+std::string compress(const std::string &raw, int windowBits) {
+    thread_local DeflateStream deflateStream;
+    z_stream &deflate_stream = deflateStream.reset(windowBits);
+
     deflate_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(raw.data()));
     deflate_stream.avail_in = uInt(raw.size());
 
@@ -80,49 +122,125 @@ std::string compress(const std::string &raw, int windowBits) {
         }
     } while (code == Z_OK);
 
-    deflateEnd(&deflate_stream);
-
     if (code != Z_STREAM_END) {
-        throw std::runtime_error(deflate_stream.msg);
+        throw std::runtime_error(deflate_stream.msg ? deflate_stream.msg : "compression error");
     }
 
     return result;
 }
 
+namespace {
+
+std::atomic<Decompressor> deflateDecompressor{nullptr};
+std::atomic<Decompressor> zstdDecompressor{nullptr};
+
+std::atomic<Decompressor> &decompressorFor(Codec codec) {
+    return codec == Codec::Zstd ? zstdDecompressor : deflateDecompressor;
+}
+
+// An inflate stream for each thread, reset for every call instead of being allocated again
+class InflateStream {
+public:
+    InflateStream() {
+        memset(&stream, 0, sizeof(stream));
+        if (inflateInit2(&stream, CompressionFormat::DETECT) != Z_OK) {
+            throw std::runtime_error("failed to initialize inflate");
+        }
+    }
+
+    ~InflateStream() { inflateEnd(&stream); }
+
+    z_stream &reset(int windowBits) {
+        if (inflateReset2(&stream, windowBits) != Z_OK) {
+            throw std::runtime_error("failed to reset inflate");
+        }
+        return stream;
+    }
+
+private:
+    z_stream stream;
+};
+
+bool isGzip(const char *data, std::size_t size) {
+    return size > 2 && static_cast<uint8_t>(data[0]) == 0x1f && static_cast<uint8_t>(data[1]) == 0x8b;
+}
+
+// gzip data ends with the size of the decompressed data modulo 2^32 (ISIZE). Returns 0 if there is
+// none, or if it is not plausible as deflate cannot compress by more than 1032:1.
+std::size_t gzipDecompressedSize(const char *data, std::size_t size) {
+    if (size < 18 || !isGzip(data, size)) {
+        return 0;
+    }
+    const auto *trailer = reinterpret_cast<const uint8_t *>(data + size - 4);
+    const std::size_t isize = static_cast<std::size_t>(trailer[0]) | static_cast<std::size_t>(trailer[1]) << 8 |
+                              static_cast<std::size_t>(trailer[2]) << 16 | static_cast<std::size_t>(trailer[3]) << 24;
+    return isize / 1032 <= size ? isize : 0;
+}
+
+} // namespace
+
+Decompressor setDecompressor(Codec codec, Decompressor decompressor) noexcept {
+    return decompressorFor(codec).exchange(decompressor);
+}
+
+bool hasDecompressor(Codec codec) noexcept {
+    return codec == Codec::Deflate || decompressorFor(codec).load() != nullptr;
+}
+
 std::string decompress(const std::string &raw, int windowBits) {
-    z_stream inflate_stream;
-    memset(&inflate_stream, 0, sizeof(inflate_stream));
+    return decompress(raw.data(), raw.size(), windowBits);
+}
 
-    // TODO: reuse z_streams
-    if (inflateInit2(&inflate_stream, windowBits) != Z_OK) {
-        throw std::runtime_error("failed to initialize inflate");
+std::string decompress(const char *data, std::size_t size, int windowBits) {
+    const bool gzip = windowBits == CompressionFormat::GZIP || windowBits == CompressionFormat::DETECT;
+    const std::size_t decompressedSize = gzip ? gzipDecompressedSize(data, size) : 0;
+    if (windowBits != CompressionFormat::DEFLATE) {
+        if (const auto decompressor = deflateDecompressor.load(std::memory_order_relaxed)) {
+            const bool gzipData = windowBits == CompressionFormat::GZIP ||
+                                  (windowBits == CompressionFormat::DETECT && isGzip(data, size));
+            return decompressor(
+                data, size, decompressedSize, gzipData ? CompressedFormat::Gzip : CompressedFormat::Zlib);
+        }
     }
 
-    inflate_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(raw.data()));
-    inflate_stream.avail_in = uInt(raw.size());
+    thread_local InflateStream inflateStream;
+    z_stream &inflate_stream = inflateStream.reset(windowBits);
 
-    std::string result;
-    char out[16384];
+    inflate_stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+    inflate_stream.avail_in = uInt(size);
+
+    // Inflate straight into the result, sized for the whole output if it is known
+    std::string result(decompressedSize ? decompressedSize : std::max<std::size_t>(4 * size, 1024), '\0');
 
     int code;
     do {
-        inflate_stream.next_out = reinterpret_cast<Bytef *>(out);
-        inflate_stream.avail_out = sizeof(out);
-        code = inflate(&inflate_stream, 0);
-        if (result.size() < inflate_stream.total_out) {
-            result.append(out, inflate_stream.total_out - result.size());
+        if (inflate_stream.total_out == result.size()) {
+            result.resize(2 * result.size());
         }
+        inflate_stream.next_out = reinterpret_cast<Bytef *>(result.data() + inflate_stream.total_out);
+        inflate_stream.avail_out = uInt(result.size() - inflate_stream.total_out);
+        code = inflate(&inflate_stream, Z_NO_FLUSH);
     } while (code == Z_OK);
 
-    inflateEnd(&inflate_stream);
-
     if (code != Z_STREAM_END) {
         throw std::runtime_error(inflate_stream.msg ? inflate_stream.msg : "decompression error");
     }
 
+    result.resize(inflate_stream.total_out);
     return result;
 }
 
+std::string decompress(Codec codec, const char *data, std::size_t size) {
+    if (codec == Codec::Deflate) {
+        return decompress(data, size);
+    }
+    const auto decompressor = decompressorFor(codec).load(std::memory_order_relaxed);
+    if (!decompressor) {
+        throw std::runtime_error("no decompressor for this codec");
+    }
+    return decompressor(data, size, 0, CompressedFormat::Zstd);
+}
+
 std::uint32_t crc32(const void *raw, size_t size) noexcept {
     auto hash = ::crc32(0L, Z_NULL, 0);
     if (raw) {
@@ -1,16 +1,28 @@
-#include <mbgl/util/compression.hpp>
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/util/image.hpp>
-#include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/parallel_jobs.hpp>
+
+#if defined(__QT__) && (defined(_WIN32) || defined(__EMSCRIPTEN__))
+#include <QtZlib/zlib.h>
+#else
+#include <zlib.h>
+#endif
 
 #include <boost/crc.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
+#include <stdexcept>
+#include <vector>
 
 #define NETWORK_BYTE_UINT32(value) char((value) >> 24), char((value) >> 16), char((value) >> 8), char((value) >> 0)
 
 namespace {
 
+using namespace mln;
+
 void addChunk(std::string& png, const char* type, const char* data = "", const uint32_t size = 0) {
     assert(strlen(type) == 4);
 
@@ -29,15 +41,269 @@ void addChunk(std::string& png, const char* type, const char* data = "", const u
     png.append(crc, 4);
 }
 
+constexpr std::size_t pixelBytes = 4;
+
+// Deflate back-references reach this far, so this much of the preceding block primes the next one.
+constexpr std::size_t windowSize = 32768;
+
+// Blocks smaller than this compress noticeably worse than the whole image and aren't worth a thread.
+constexpr std::size_t minBlockSize = 256 * 1024;
+
+enum RowFilter : uint8_t {
+    FilterNone = 0,
+    FilterSub = 1,
+    FilterUp = 2,
+    FilterAverage = 3,
+    FilterPaeth = 4,
+    FilterCount
+};
+
+// Unpremultiplied values indexed by alpha * 256 + color, rounded the same way as util::unpremultiply.
+const uint8_t* unpremultiplyTable() {
+    static const auto table = [] {
+        auto result = std::make_unique<uint8_t[]>(256 * 256);
+        for (uint32_t a = 0; a < 256; ++a) {
+            for (uint32_t c = 0; c < 256; ++c) {
+                result[a * 256 + c] = a ? static_cast<uint8_t>((255 * c + (a / 2)) / a) : static_cast<uint8_t>(c);
+            }
+        }
+        return result;
+    }();
+    return table.get();
+}
+
+void unpremultiplyRow(const uint8_t* src, uint8_t* dst, std::size_t stride) {
+    const uint8_t* table = unpremultiplyTable();
+    for (std::size_t i = 0; i < stride; i += pixelBytes) {
+        const uint8_t* scale = table + src[i + 3] * 256;
+        dst[i + 0] = scale[src[i + 0]];
+        dst[i + 1] = scale[src[i + 1]];
+        dst[i + 2] = scale[src[i + 2]];
+        dst[i + 3] = src[i + 3];
+    }
+}
+
+inline uint8_t paethPredictor(int a, int b, int c) {
+    const int pa = std::abs(b - c);
+    const int pb = std::abs(a - c);
+    const int pc = std::abs(a + b - 2 * c);
+    return static_cast<uint8_t>(pa <= pb && pa <= pc ? a : (pb <= pc ? b : c));
+}
+
+// Applies one of the PNG row filters. `prev` is the unfiltered row above, all zeros for the first row.
+void filterRow(RowFilter filter, const uint8_t* row, const uint8_t* prev, uint8_t* out, std::size_t stride) {
+    switch (filter) {
+        case FilterNone:
+            std::memcpy(out, row, stride);
+            break;
+        case FilterSub:
+            std::memcpy(out, row, pixelBytes);
+            for (std::size_t i = pixelBytes; i < stride; ++i) {
+                out[i] = static_cast<uint8_t>(row[i] - row[i - pixelBytes]);
+            }
+            break;
+        case FilterUp:
+            for (std::size_t i = 0; i < stride; ++i) {
+                out[i] = static_cast<uint8_t>(row[i] - prev[i]);
+            }
+            break;
+        case FilterAverage:
+            for (std::size_t i = 0; i < pixelBytes; ++i) {
+                out[i] = static_cast<uint8_t>(row[i] - (prev[i] >> 1));
+            }
+            for (std::size_t i = pixelBytes; i < stride; ++i) {
+                out[i] = static_cast<uint8_t>(row[i] - ((row[i - pixelBytes] + prev[i]) >> 1));
+            }
+            break;
+        case FilterPaeth:
+            for (std::size_t i = 0; i < pixelBytes; ++i) {
+                out[i] = static_cast<uint8_t>(row[i] - prev[i]);
+            }
+            for (std::size_t i = pixelBytes; i < stride; ++i) {
+                const uint8_t predicted = paethPredictor(row[i - pixelBytes], prev[i], prev[i - pixelBytes]);
+                out[i] = static_cast<uint8_t>(row[i] - predicted);
+            }
+            break;
+        default:
+            assert(false);
+    }
+}
+
+// The heuristic recommended by the PNG specification: bytes read as signed values, the smaller the sum of their
+// magnitudes the better the row usually compresses.
+uint32_t filterCost(const uint8_t* out, std::size_t stride) {
+    uint32_t cost = 0;
+    for (std::size_t i = 0; i < stride; ++i) {
+        cost += static_cast<uint32_t>(std::abs(static_cast<int8_t>(out[i])));
+    }
+    return cost;
+}
+
+// Unpremultiplies and filters rows [begin, end) into `out`, each row prefixed with its filter type.
+void filterRows(const PremultipliedImage& src, uint32_t begin, uint32_t end, bool adaptive, uint8_t* out) {
+    const std::size_t stride = src.stride();
+    std::vector<uint8_t> rows(2 * stride, 0);
+    uint8_t* prev = rows.data();
+    uint8_t* row = rows.data() + stride;
+    if (begin > 0) {
+        unpremultiplyRow(src.data.get() + (begin - 1) * stride, prev, stride);
+    }
+
+    adaptive = adaptive && stride > 0;
+    std::vector<uint8_t> candidates(adaptive ? FilterCount * stride : 0);
+    for (uint32_t y = begin; y < end; ++y) {
+        unpremultiplyRow(src.data.get() + y * stride, row, stride);
+
+        if (!adaptive) {
+            // Keeps the output identical to earlier versions of the encoder
+            *out++ = FilterNone;
+            std::memcpy(out, row, stride);
+        } else {
+            uint8_t best = FilterNone;
+            uint32_t bestCost = UINT32_MAX;
+            for (uint8_t filter = FilterNone; filter < FilterCount; ++filter) {
+                uint8_t* candidate = candidates.data() + filter * stride;
+                filterRow(static_cast<RowFilter>(filter), row, prev, candidate, stride);
+                const uint32_t cost = filterCost(candidate, stride);
+                if (cost < bestCost) {
+                    best = filter;
+                    bestCost = cost;
+                }
+            }
+            *out++ = best;
+            std::memcpy(out, candidates.data() + best * stride, stride);
+        }
+        out += stride;
+        std::swap(prev, row);
+    }
+}
+
+// Deflates one block. Blocks other than the last one end on a byte boundary without a final block marker, so that
+// raw blocks can be concatenated into one stream. With windowBits > 0 the block is a complete zlib stream.
+std::string deflateBlock(const uint8_t* data,
+                         std::size_t size,
+                         const uint8_t* dictionary,
+                         std::size_t dictionarySize,
+                         bool last,
+                         int level,
+                         int windowBits,
+                         int strategy) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (deflateInit2(&stream, level, Z_DEFLATED, windowBits, 8, strategy) != Z_OK) {
+        throw std::runtime_error("failed to initialize deflate");
+    }
+    if (dictionarySize && deflateSetDictionary(&stream, dictionary, uInt(dictionarySize)) != Z_OK) {
+        deflateEnd(&stream);
+        throw std::runtime_error("failed to set deflate dictionary");
+    }
+
+    std::string result(deflateBound(&stream, uLong(size)) + 16, '\0');
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = uInt(size);
+    stream.next_out = reinterpret_cast<Bytef*>(result.data());
+    stream.avail_out = uInt(result.size());
+
+    const int flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+    int code;
+    while (true) {
+        code = deflate(&stream, flush);
+        if (code == Z_STREAM_ERROR || code == Z_STREAM_END || stream.avail_out != 0) {
+            break;
+        }
+        // Out of space, which the bound above makes unlikely
+        result.resize(result.size() * 2);
+        stream.next_out = reinterpret_cast<Bytef*>(result.data() + stream.total_out);
+        stream.avail_out = uInt(result.size() - stream.total_out);
+    }
+    result.resize(stream.total_out);
+    deflateEnd(&stream);
+
+    if (code == Z_STREAM_ERROR || (last && code != Z_STREAM_END)) {
+        throw std::runtime_error("failed to deflate image data");
+    }
+    return result;
+}
+
+// Runs job(0) to job(count - 1) on the calling thread and on up to `threads - 1` tasks on the background scheduler.
+void runJobs(std::size_t count, std::size_t threads, util::ParallelJobs::Job job) {
+    util::ParallelJobs jobs(count, std::move(job));
+    jobs.schedule(*Scheduler::GetBackground(), threads - 1);
+    jobs.run();
+}
+
+std::string encodeIDAT(const PremultipliedImage& src, const PNGEncodeOptions& options) {
+    const std::size_t rowBytes = 1 + src.stride();
+    const uint32_t height = src.size.height;
+    const std::size_t threads = std::max<std::size_t>(options.threads, 1);
+    const std::size_t blocks = std::clamp<std::size_t>(
+        std::min<std::size_t>(threads, height * rowBytes / minBlockSize), 1, std::max<uint32_t>(height, 1));
+    auto blockBegin = [&](std::size_t block) {
+        return static_cast<uint32_t>(block * height / blocks);
+    };
+
+    std::vector<uint8_t> filtered(height * rowBytes);
+    runJobs(blocks, threads, [&](std::size_t block) {
+        const uint32_t begin = blockBegin(block);
+        filterRows(src, begin, blockBegin(block + 1), options.adaptiveFiltering, filtered.data() + begin * rowBytes);
+    });
+
+    const int level = options.compressionLevel;
+    // Filtered rows are mostly small values, which zlib handles better with this strategy
+    const int strategy = options.adaptiveFiltering ? Z_FILTERED : Z_DEFAULT_STRATEGY;
+    if (blocks == 1) {
+        return deflateBlock(filtered.data(), filtered.size(), nullptr, 0, true, level, 15, strategy);
+    }
+
+    std::vector<std::string> compressed(blocks);
+    std::vector<uLong> checksums(blocks);
+    runJobs(blocks, threads, [&](std::size_t block) {
+        const std::size_t begin = blockBegin(block) * rowBytes;
+        const std::size_t size = blockBegin(block + 1) * rowBytes - begin;
+        const std::size_t dictionarySize = std::min(begin, windowSize);
+        const uint8_t* data = filtered.data() + begin;
+        compressed[block] = deflateBlock(
+            data, size, data - dictionarySize, dictionarySize, block + 1 == blocks, level, -15, strategy);
+        checksums[block] = adler32(adler32(0, Z_NULL, 0), data, uInt(size));
+    });
+
+    // Join the raw blocks into a zlib stream: a header matching the compression level, and the Adler-32 checksum of
+    // all the data at the end.
+    const int flevel = level == Z_DEFAULT_COMPRESSION ? 2 : (level < 2 ? 0 : (level < 6 ? 1 : (level == 6 ? 2 : 3)));
+    int header = (0x78 << 8) | (flevel << 6);
+    header += 31 - header % 31;
+    uLong checksum = checksums[0];
+    std::size_t size = 2 + 4;
+    for (std::size_t block = 0; block < blocks; ++block) {
+        size += compressed[block].size();
+        if (block > 0) {
+            const std::size_t blockSize = (blockBegin(block + 1) - blockBegin(block)) * rowBytes;
+            checksum = adler32_combine(checksum, checksums[block], z_off_t(blockSize));
+        }
+    }
+
+    std::string idat;
+    idat.reserve(size);
+    idat.push_back(char(header >> 8));
+    idat.push_back(char(header & 0xFF));
+    for (const auto& block : compressed) {
+        idat.append(block);
+    }
+    const char trailer[4] = {NETWORK_BYTE_UINT32(checksum)};
+    idat.append(trailer, 4);
+    return idat;
+}
+
 } // namespace
 
 namespace mln {
 
 // Encode PNGs without libpng.
 std::string encodePNG(const PremultipliedImage& pre) {
-    // Make copy of the image so that we can unpremultiply it.
-    const auto src = util::unpremultiply(pre.clone());
+    return encodePNG(pre, PNGEncodeOptions());
+}
 
+std::string encodePNG(const PremultipliedImage& src, const PNGEncodeOptions& options) {
     // PNG magic bytes
     const char preamble[8] = {char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
 
@@ -52,15 +318,8 @@ std::string encodePNG(const PremultipliedImage& pre) {
         0,                                    // interlace method == none
     };
 
-    // Prepare the (compressed) data chunk.
-    const auto stride = src.stride();
-    std::string idat;
-    for (uint32_t y = 0; y < src.size.height; y++) {
-        // Every scanline needs to be prefixed with one byte that indicates the filter type.
-        idat.append(1, 0); // filter type 0
-        idat.append(reinterpret_cast<const char*>(src.data.get() + y * stride), stride);
-    }
-    idat = util::compress(idat);
+    // Prepare the (compressed) data chunk. Every scanline is prefixed with one byte that indicates the filter type.
+    const std::string idat = encodeIDAT(src, options);
 
     // Assemble the PNG.
     std::string png;
@@ -72,6 +72,11 @@ bool Mailbox::isOpen() const {
     return !closed && weakScheduler;
 }
 
+void Mailbox::setPriority(TaskPriority priority_) {
+    std::scoped_lock pushingLock(pushingMutex);
+    priority = std::move(priority_);
+}
+
 void Mailbox::push(std::unique_ptr<Message> message) {
     MLN_TRACE_FUNC();
     auto idleState = State::Idle;
@@ -159,7 +164,10 @@ void Mailbox::scheduleToRecieve(const std::optional<util::SimpleIdentity>& tag)
                 locked->receive();
             }
         };
-        if (tag) {
+        if (priority) {
+            weakScheduler->scheduleWithPriority(
+                tag ? *tag : util::SimpleIdentity::Empty, std::move(setToRecieve), priority);
+        } else if (tag) {
             weakScheduler->schedule(*tag, std::move(setToRecieve));
         } else {
             weakScheduler->schedule(std::move(setToRecieve));
@@ -1,4 +1,5 @@
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/util/thread_local.hpp>
 #include <mbgl/util/thread_pool.hpp>
 #include <mbgl/util/run_loop.hpp>
@@ -41,7 +42,11 @@ std::shared_ptr<Scheduler> Scheduler::GetBackground() {
     std::shared_ptr<Scheduler> scheduler = weak.lock();
 
     if (!scheduler) {
-        weak = scheduler = std::make_shared<ThreadPool>();
+        const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_THREAD_POOL_WORK_STEALING);
+        const auto* workStealing = value.getBool();
+        weak = scheduler = std::make_shared<ThreadPool>((workStealing && *workStealing)
+                                                            ? SchedulingStrategy::WorkStealing
+                                                            : SchedulingStrategy::SharedQueue);
     }
 
     return scheduler;
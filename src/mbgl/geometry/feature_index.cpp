@@ -146,6 +146,35 @@ void FeatureIndex::insert(const GeometryCollection& geometries,
     }
 }
 
+void FeatureIndex::append(const FeatureIndex& other) {
+    const auto baseSortIndex = sortIndex;
+
+    // Consecutive elements almost always come from the same feature, so remember the last strings interned
+    const std::string* lastLayerName = nullptr;
+    const std::string* lastLeaderID = nullptr;
+    const std::string* emplacedLayerName = nullptr;
+    const std::string* emplacedLeaderID = nullptr;
+
+    for (const auto& [subfeature, box] : other.grid.getBoxElements()) {
+        if (&subfeature.getSourceLayerName() != lastLayerName) {
+            lastLayerName = &subfeature.getSourceLayerName();
+            emplacedLayerName = &*uniqueLayerIDs.insert(*lastLayerName).first;
+        }
+        if (&subfeature.getBucketLeaderID() != lastLeaderID) {
+            lastLeaderID = &subfeature.getBucketLeaderID();
+            emplacedLeaderID =
+                &bucketLayerIDs.insert(std::make_pair(*lastLeaderID, std::vector<std::string>{})).first->first;
+        }
+        grid.insert(RefIndexedSubfeature(subfeature.getIndex(),
+                                         *emplacedLayerName,
+                                         *emplacedLeaderID,
+                                         baseSortIndex + subfeature.getSortIndex()),
+                    box);
+    }
+
+    sortIndex += other.sortIndex;
+}
+
 void FeatureIndex::query(std::unordered_map<std::string, std::vector<Feature>>& result,
                          const GeometryCoordinates& queryGeometry,
                          const TransformState& transformState,
@@ -8,6 +8,7 @@
 #include <mbgl/util/grid_index.hpp>
 #include <mbgl/util/mat4.hpp>
 
+#include <optional>
 #include <vector>
 #include <string>
 #include <unordered_map>
@@ -118,6 +119,10 @@ public:
                 const std::string& sourceLayerName,
                 const std::string& bucketLeaderID);
 
+    /// Insert everything from another index as if its features had been inserted here after the existing ones.
+    /// Used to combine indexes built for separate layer groups in parallel.
+    void append(const FeatureIndex&);
+
     void query(std::unordered_map<std::string, std::vector<Feature>>& result,
                const GeometryCoordinates& queryGeometry,
                const TransformState&,
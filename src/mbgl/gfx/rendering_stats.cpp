@@ -50,6 +50,9 @@ RenderingStats& RenderingStats::operator+=(const RenderingStats& r) {
     indexUpdateBytes += r.indexUpdateBytes;
     numVertexBuffers += r.numVertexBuffers;
     vertexUpdateBytes += r.vertexUpdateBytes;
+    vertexPartialUpdates += r.vertexPartialUpdates;
+    vertexPartialUpdateBytes += r.vertexPartialUpdateBytes;
+    vertexPartialUpdateFullBytes += r.vertexPartialUpdateFullBytes;
     numUniformBuffers += r.numUniformBuffers;
     numUniformUpdates += r.numUniformUpdates;
     uniformUpdateBytes += r.uniformUpdateBytes;
@@ -96,6 +99,9 @@ std::string RenderingStats::toString(std::string_view sep) const {
     optionalStatLine(ss, indexUpdateBytes, "indexUpdateBytes", sep);
     optionalStatLine(ss, numVertexBuffers, "numVertexBuffers", sep);
     optionalStatLine(ss, vertexUpdateBytes, "vertexUpdateBytes", sep);
+    optionalStatLine(ss, vertexPartialUpdates, "vertexPartialUpdates", sep);
+    optionalStatLine(ss, vertexPartialUpdateBytes, "vertexPartialUpdateBytes", sep);
+    optionalStatLine(ss, vertexPartialUpdateFullBytes, "vertexPartialUpdateFullBytes", sep);
     optionalStatLine(ss, numUniformBuffers, "numUniformBuffers", sep);
     optionalStatLine(ss, numUniformUpdates, "numUniformUpdates", sep);
     optionalStatLine(ss, uniformUpdateBytes, "uniformUpdateBytes", sep);
@@ -265,6 +271,9 @@ void RenderingStatsView::update(style::Style& style, const gfx::RenderingStats&
 
     printNumber(ss, "Vertex buffers", stats.numVertexBuffers, true);
     printMemory(ss, "Vertex buffers updates", stats.vertexUpdateBytes, options.verbose);
+    printNumber(ss, "Vertex buffers partial updates", stats.vertexPartialUpdates, options.verbose);
+    printMemory(ss, "Vertex buffers partial updates", stats.vertexPartialUpdateBytes, options.verbose);
+    printMemory(ss, "Vertex buffers partial updates, in full", stats.vertexPartialUpdateFullBytes, options.verbose);
 
     printNumber(ss, "Uniform buffers", stats.numUniformBuffers, true);
     printNumber(ss, "Uniform buffer updates", stats.numUniformUpdates, options.verbose);
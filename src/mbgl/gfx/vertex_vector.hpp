@@ -3,6 +3,7 @@
 #include <mbgl/util/ignore.hpp>
 #include <mbgl/util/monotonic_timer.hpp>
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -15,12 +16,21 @@ struct VertexBufferBase {
 
 class VertexVectorBase {
 public:
+    /// A range of bytes of the vector
+    struct ModifiedRange {
+        std::size_t offset;
+        std::size_t size;
+    };
+
     VertexVectorBase() = default;
     VertexVectorBase(const VertexVectorBase&) {} // buffer is not copied
     VertexVectorBase(VertexVectorBase&& other)
         : buffer(std::move(other.buffer)),
           dirty(other.dirty),
-          released(other.released) {}
+          released(other.released),
+          modifiedInRanges(other.modifiedInRanges),
+          modifiedRanges(std::move(other.modifiedRanges)),
+          modifiedRangesBytes(other.modifiedRangesBytes) {}
     virtual ~VertexVectorBase() = default;
 
     virtual const void* getRawData() const = 0;
@@ -37,7 +47,71 @@ public:
         if (dirty || force) {
             lastModified = util::MonotonicTimer::now();
             dirty = false;
+            modifiedInRanges = false;
+            modifiedRanges.clear();
+            modifiedRangesBytes = 0;
+        }
+    }
+
+    /// Marks a range of bytes, rewritten in place, as modified. While the vector is otherwise unchanged since
+    /// it was last uploaded, only the modified ranges need to be updated in its buffer.
+    void updateModifiedRange(std::size_t offset, std::size_t size) {
+        if (dirty) {
+            // The vector changed otherwise, the whole buffer is updated anyway
+            updateModified();
+            return;
+        }
+        lastModified = util::MonotonicTimer::now();
+        if (!modifiedInRanges) {
+            return;
+        }
+        modifiedRanges.push_back({offset, size});
+        modifiedRangesBytes += size;
+        // Ranges may overlap, this only bounds how many are kept until the next upload
+        if (modifiedRangesBytes >= getRawCount() * getRawSize()) {
+            modifiedInRanges = false;
+            modifiedRanges.clear();
+            modifiedRangesBytes = 0;
+        }
+    }
+
+    /// The ranges of bytes modified since the vector was last uploaded, sorted and merged. Empty when the whole
+    /// vector has to be uploaded: when it changed otherwise, or when the ranges cover half of it anyway.
+    const std::vector<ModifiedRange>& getModifiedRanges() {
+        if (!modifiedInRanges || modifiedRanges.empty()) {
+            modifiedRanges.clear();
+            return modifiedRanges;
+        }
+        std::ranges::sort(modifiedRanges, {}, &ModifiedRange::offset);
+        std::size_t merged = 0;
+        for (std::size_t i = 1; i < modifiedRanges.size(); ++i) {
+            auto& last = modifiedRanges[merged];
+            const auto& range = modifiedRanges[i];
+            if (range.offset <= last.offset + last.size) {
+                last.size = std::max(last.size, range.offset + range.size - last.offset);
+            } else {
+                modifiedRanges[++merged] = range;
+            }
+        }
+        modifiedRanges.resize(merged + 1);
+
+        modifiedRangesBytes = 0;
+        for (const auto& range : modifiedRanges) {
+            modifiedRangesBytes += range.size;
         }
+        if (2 * modifiedRangesBytes >= getRawCount() * getRawSize()) {
+            modifiedInRanges = false;
+            modifiedRanges.clear();
+            modifiedRangesBytes = 0;
+        }
+        return modifiedRanges;
+    }
+
+    /// Indicates that the buffer holds the current contents of the vector, and starts tracking modified ranges
+    void setUploaded() {
+        modifiedInRanges = true;
+        modifiedRanges.clear();
+        modifiedRangesBytes = 0;
     }
 
     // Indicates that the owner/producer will not modify this again
@@ -48,6 +122,11 @@ protected:
     bool dirty = true;
     bool released = false;
 
+    // Whether all the modifications since the last upload are in `modifiedRanges`
+    bool modifiedInRanges = false;
+    std::vector<ModifiedRange> modifiedRanges;
+    std::size_t modifiedRangesBytes = 0;
+
     std::chrono::duration<double> lastModified = util::MonotonicTimer::now();
 };
 using VertexVectorBasePtr = std::shared_ptr<VertexVectorBase>;
@@ -52,6 +52,29 @@ void UploadPass::updateVertexBufferResource(gfx::VertexBufferResource& resource,
     commandEncoder.context.renderingStats().bufferObjUpdates++;
 }
 
+void UploadPass::updateVertexBufferRanges(gfx::VertexBufferResource& resource,
+                                          const void* data,
+                                          std::size_t size,
+                                          const std::vector<gfx::VertexVectorBase::ModifiedRange>& ranges) {
+    commandEncoder.context.vertexBuffer = static_cast<gl::VertexBufferResource&>(resource).getBuffer();
+
+    std::size_t updateSize = 0;
+    for (const auto& range : ranges) {
+        MBGL_CHECK_ERROR(glBufferSubData(
+            GL_ARRAY_BUFFER, range.offset, range.size, static_cast<const uint8_t*>(data) + range.offset));
+        updateSize += range.size;
+    }
+
+    auto& stats = commandEncoder.context.renderingStats();
+    stats.vertexUpdateBytes += updateSize;
+    stats.bufferUpdateBytes += updateSize;
+    stats.bufferUpdates++;
+    stats.bufferObjUpdates++;
+    stats.vertexPartialUpdates++;
+    stats.vertexPartialUpdateBytes += updateSize;
+    stats.vertexPartialUpdateFullBytes += size;
+}
+
 std::unique_ptr<gfx::IndexBufferResource> UploadPass::createIndexBufferResource(const void* data,
                                                                                 std::size_t size,
                                                                                 const gfx::BufferUsageType usage,
@@ -106,8 +129,14 @@ const gfx::UniqueVertexBufferResource& UploadPass::getBuffer(const gfx::VertexVe
             if (rawBufSize <= resource.getByteSize()) {
                 // If the source changed, update the buffer contents
                 if (vec->isModifiedAfter(resource.getLastUpdated())) {
-                    updateVertexBufferResource(resource, rawBufPtr, rawBufSize);
+                    if (const auto& ranges = vec->getModifiedRanges(); ranges.empty()) {
+                        updateVertexBufferResource(resource, rawBufPtr, rawBufSize);
+                    } else {
+                        // Only parts of it were rewritten, e.g., the vertices of features whose state changed
+                        updateVertexBufferRanges(resource, rawBufPtr, rawBufSize, ranges);
+                    }
                     resource.setLastUpdated(vec->getLastModified());
+                    vec->setUploaded();
                 }
                 return rawData->resource;
             }
@@ -117,6 +146,7 @@ const gfx::UniqueVertexBufferResource& UploadPass::getBuffer(const gfx::VertexVe
             auto buffer = std::make_unique<VertexBufferGL>();
             buffer->resource = createVertexBufferResource(rawBufPtr, rawBufSize, usage, /*persistent=*/false);
             vec->setBuffer(std::move(buffer));
+            vec->setUploaded();
             return static_cast<VertexBufferGL*>(vec->getBuffer())->resource;
         }
     }
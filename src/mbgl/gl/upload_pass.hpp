@@ -1,14 +1,13 @@
 #pragma once
 
 #include <mbgl/gfx/upload_pass.hpp>
+#include <mbgl/gfx/vertex_vector.hpp>
 #include <mbgl/gl/types.hpp>
 
 namespace mln {
 namespace gfx {
 
 class CommandEncoder;
-class VertexVectorBase;
-using VertexVectorBasePtr = std::shared_ptr<VertexVectorBase>;
 
 } // namespace gfx
 
@@ -57,6 +56,12 @@ public:
         /*out*/ std::vector<std::unique_ptr<gfx::VertexBufferResource>>& outBuffers) override;
 
 private:
+    /// Updates the ranges of the buffer modified in the vector since it was last uploaded
+    void updateVertexBufferRanges(gfx::VertexBufferResource&,
+                                  const void* data,
+                                  std::size_t size,
+                                  const std::vector<gfx::VertexVectorBase::ModifiedRange>&);
+
     gl::CommandEncoder& commandEncoder;
     const gfx::DebugGroup<gfx::CommandEncoder> debugGroup;
 };
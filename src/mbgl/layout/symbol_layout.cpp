@@ -7,6 +7,7 @@
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
 #include <mbgl/text/get_anchors.hpp>
 #include <mbgl/text/shaping.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/text/glyph_manager.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/tile.hpp>
@@ -127,7 +128,8 @@ SymbolLayout::SymbolLayout(const BucketParameters& parameters,
       pixelRatio(parameters.pixelRatio),
       tileSize(static_cast<uint32_t>(util::tileSize_D * overscaling)),
       tilePixelRatio(static_cast<float>(util::EXTENT) / tileSize),
-      layout(createLayout(toSymbolLayerProperties(layers.at(0)).layerImpl().layout, zoom)) {
+      layout(createLayout(toSymbolLayerProperties(layers.at(0)).layerImpl().layout, zoom)),
+      shapingCache(ShapingCache::getShared()) {
     const SymbolLayer::Impl& leader = toSymbolLayerProperties(layers.at(0)).layerImpl();
 
     textSize = leader.layout.get<TextSize>();
@@ -611,10 +613,29 @@ void SymbolLayout::prepareSymbols(const GlyphMap& glyphMap,
                                     WritingModeType writingMode,
                                     SymbolAnchorType textAnchor,
                                     TextJustifyType textJustify) {
+                const float maxWidth = isPointPlacement
+                                           ? layout->evaluate<TextMaxWidth>(zoom, feature, canonicalID) * util::ONE_EM
+                                           : 0.0f;
+                if (shapingCache) {
+                    return shapingCache->getShaping(formattedText,
+                                                    maxWidth,
+                                                    lineHeight,
+                                                    textAnchor,
+                                                    textJustify,
+                                                    spacing,
+                                                    textOffset,
+                                                    writingMode,
+                                                    bidi,
+                                                    glyphMap,
+                                                    glyphPositions,
+                                                    imagePositions,
+                                                    layoutTextSize,
+                                                    layoutTextSizeAtBucketZoomLevel,
+                                                    allowVerticalPlacement);
+                }
                 Shaping result = getShaping(
                     /* string */ formattedText,
-                    /* maxWidth: ems */
-                    isPointPlacement ? layout->evaluate<TextMaxWidth>(zoom, feature, canonicalID) * util::ONE_EM : 0.0f,
+                    /* maxWidth: ems */ maxWidth,
                     /* ems */ lineHeight,
                     textAnchor,
                     textJustify,
@@ -19,6 +19,7 @@ namespace mln {
 class BucketParameters;
 class Anchor;
 class PlacedSymbol;
+class ShapingCache;
 
 namespace style {
 class Filter;
@@ -150,6 +151,8 @@ private:
     BiDi bidi; // Consider moving this up to geometry tile worker to reduce
                // reinstantiation costs; use of BiDi/ubiditransform object must
                // be constrained to one thread
+    // Shapings of strings which other tiles shaped already, if set
+    std::shared_ptr<ShapingCache> shapingCache;
 
     bool needFinalizeSymbolsVal = false;
 };
@@ -55,6 +55,13 @@ public:
 
     bool needsUpload() const { return hasData() && !uploaded; }
 
+    // Approximate bytes of the bucket's vertex, index and image data. Once uploaded, the data
+    // is counted again for the copy held by the GPU.
+    std::size_t getMemoryUsage() const {
+        const std::size_t bytes = getDataSize();
+        return uploaded ? 2 * bytes : bytes;
+    }
+
     // The following methods are implemented by buckets that require cross-tile indexing and placement.
 
     // Returns a pair, the first element of which is a bucket cross-tile id
@@ -81,6 +88,9 @@ public:
 
 protected:
     Bucket() = default;
+
+    virtual std::size_t getDataSize() const { return 0; }
+
     std::atomic<bool> uploaded{false};
 
     util::SimpleIdentity bucketID;
@@ -32,6 +32,14 @@ bool CircleBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t CircleBucket::getDataSize() const {
+    std::size_t bytes = vertices.bytes() + triangles.bytes();
+    for (const auto& [id, binders] : paintPropertyBinders) {
+        bytes += binders.interleavedVertexBuffer.sharedVertexVector->bytes();
+    }
+    return bytes;
+}
+
 namespace {
 template <class Property>
 float get(const CirclePaintProperties::PossiblyEvaluated& evaluated,
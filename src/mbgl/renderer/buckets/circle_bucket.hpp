@@ -27,6 +27,8 @@ public:
 
     bool hasData() const override;
 
+    std::size_t getDataSize() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
@@ -82,6 +82,17 @@ bool FillBucket::hasData() const {
     return !triangleSegments.empty() || !basicLineSegments.empty();
 }
 
+std::size_t FillBucket::getDataSize() const {
+    std::size_t bytes = vertices.bytes() + triangles.bytes() + basicLines.bytes();
+#if MLN_TRIANGULATE_FILL_OUTLINES
+    bytes += lineVertices.bytes() + lineIndexes.bytes();
+#endif
+    for (const auto& [id, binders] : paintPropertyBinders) {
+        bytes += binders.interleavedVertexBuffer.sharedVertexVector->bytes();
+    }
+    return bytes;
+}
+
 float FillBucket::getQueryRadius(const RenderLayer& layer) const {
     using namespace style;
     const auto& evaluated = getEvaluated<FillLayerProperties>(layer.evaluatedProperties);
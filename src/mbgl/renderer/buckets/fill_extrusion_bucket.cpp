@@ -222,6 +222,14 @@ bool FillExtrusionBucket::hasData() const {
     return !triangleSegments.empty();
 }
 
+std::size_t FillExtrusionBucket::getDataSize() const {
+    std::size_t bytes = vertices.bytes() + triangles.bytes();
+    for (const auto& [id, binders] : paintPropertyBinders) {
+        bytes += binders.interleavedVertexBuffer.sharedVertexVector->bytes();
+    }
+    return bytes;
+}
+
 float FillExtrusionBucket::getQueryRadius(const RenderLayer& layer) const {
     const auto& evaluated = getEvaluated<FillExtrusionLayerProperties>(layer.evaluatedProperties);
     const std::array<float, 2>& translate = evaluated.get<FillExtrusionTranslate>();
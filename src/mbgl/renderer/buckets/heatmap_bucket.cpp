@@ -32,6 +32,14 @@ bool HeatmapBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t HeatmapBucket::getDataSize() const {
+    std::size_t bytes = vertices.bytes() + triangles.bytes();
+    for (const auto& [id, binders] : paintPropertyBinders) {
+        bytes += binders.interleavedVertexBuffer.sharedVertexVector->bytes();
+    }
+    return bytes;
+}
+
 void HeatmapBucket::addFeature(const GeometryTileFeature& feature,
                                const GeometryCollection& geometry,
                                const ImagePositions&,
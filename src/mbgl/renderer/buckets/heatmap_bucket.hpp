@@ -30,6 +30,8 @@ public:
                     const CanonicalTileID&) override;
     bool hasData() const override;
 
+    std::size_t getDataSize() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
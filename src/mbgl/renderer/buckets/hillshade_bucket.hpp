@@ -27,6 +27,8 @@ public:
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
 
+    std::size_t getDataSize() const override;
+
     void clear();
     void setMask(TileMask&&);
 
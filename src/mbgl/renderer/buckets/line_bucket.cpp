@@ -137,6 +137,14 @@ bool LineBucket::hasData() const {
     return !segments.empty();
 }
 
+std::size_t LineBucket::getDataSize() const {
+    std::size_t bytes = vertices.bytes() + triangles.bytes();
+    for (const auto& [id, binders] : paintPropertyBinders) {
+        bytes += binders.interleavedVertexBuffer.sharedVertexVector->bytes();
+    }
+    return bytes;
+}
+
 namespace {
 template <class Property>
 float get(const LinePaintProperties::PossiblyEvaluated& evaluated,
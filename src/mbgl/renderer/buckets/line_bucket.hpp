@@ -35,6 +35,8 @@ public:
 
     bool hasData() const override;
 
+    std::size_t getDataSize() const override;
+
     void upload(gfx::UploadPass&) override;
 
     float getQueryRadius(const RenderLayer&) const override;
@@ -105,4 +105,12 @@ bool RasterBucket::hasData() const {
     return !!image;
 }
 
+std::size_t RasterBucket::getDataSize() const {
+    std::size_t bytes = vertices.bytes() + indices.bytes();
+    if (image) {
+        bytes += image->bytes();
+    }
+    return bytes;
+}
+
 } // namespace mln
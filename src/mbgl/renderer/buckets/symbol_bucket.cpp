@@ -96,6 +96,26 @@ bool SymbolBucket::hasData() const {
            hasTextCollisionBoxData() || hasIconCollisionCircleData() || hasTextCollisionCircleData();
 }
 
+std::size_t SymbolBucket::getDataSize() const {
+    const auto bufferSize = [](const Buffer& buffer) {
+        return buffer.vertices().bytes() + buffer.dynamicVertices().bytes() + buffer.opacityVertices().bytes() +
+               buffer.triangles.bytes() + buffer.placedSymbols.size() * sizeof(PlacedSymbol);
+    };
+    const auto collisionSize = [](const CollisionBuffer* buffer) -> std::size_t {
+        return buffer ? buffer->vertices().bytes() + buffer->dynamicVertices().bytes() : 0;
+    };
+
+    std::size_t bytes = bufferSize(text) + bufferSize(icon) + bufferSize(sdfIcon);
+    bytes += collisionSize(iconCollisionBox.get()) + collisionSize(textCollisionBox.get());
+    bytes += collisionSize(iconCollisionCircle.get()) + collisionSize(textCollisionCircle.get());
+    bytes += symbolInstances.size() * sizeof(SymbolInstance);
+    for (const auto& [id, properties] : paintProperties) {
+        bytes += properties.iconBinders.interleavedVertexBuffer.sharedVertexVector->bytes();
+        bytes += properties.textBinders.interleavedVertexBuffer.sharedVertexVector->bytes();
+    }
+    return bytes;
+}
+
 void SymbolBucket::update(const FeatureStates& states,
                           const GeometryTileLayer& layer,
                           const std::string& layerID,
@@ -228,6 +228,7 @@ public:
 
     void upload(gfx::UploadPass&) override;
     bool hasData() const override;
+    std::size_t getDataSize() const override;
     void update(const FeatureStates&, const GeometryTileLayer&, const std::string&, const ImagePositions&) override;
     std::pair<uint32_t, bool> registerAtCrossTileIndex(CrossTileSymbolLayerIndex&, const RenderTile&) override;
     void place(Placement&, const BucketPlacementData&, std::set<uint32_t>&) override;
@@ -39,6 +39,13 @@ struct InterleavedVertexBuffer {
         memcpy(const_cast<void*>(data), &value, sizeof(value));
     }
 
+    /// Marks the vertices from `start` to `end`, rewritten in place, as modified
+    void setModified(std::size_t start, std::size_t end) {
+        if (start < end) {
+            sharedVertexVector->updateModifiedRange(stride * start, stride * (end - start));
+        }
+    }
+
     template <typename T>
     const T& get(std::size_t index, std::size_t offset) {
         assert(stride * index + offset + sizeof(T) <= sharedVertexVector->bytes());
@@ -342,6 +349,7 @@ public:
         for (std::size_t i = start; i < end; ++i) {
             this->interleavedVertexBuffer->set(i, this->vertexOffset, value);
         }
+        this->interleavedVertexBuffer->setModified(start, end);
     }
 
     std::tuple<float> interpolationFactor(float) const override { return std::tuple<float>{0.0f}; }
@@ -456,6 +464,7 @@ public:
         for (std::size_t i = start; i < end; ++i) {
             this->interleavedVertexBuffer->set(i, this->vertexOffset, value);
         }
+        this->interleavedVertexBuffer->setModified(start, end);
     }
 
     std::tuple<float> interpolationFactor(float currentZoom) const override {
@@ -727,8 +736,8 @@ public:
     void updateVertexVectors(const FeatureStates& states,
                              const GeometryTileLayer& layer,
                              const ImagePositions& imagePositions) {
+        // Binders mark the vertices of the features they update, so that only those are uploaded again
         util::ignore({(binders.template get<Ps>()->updateVertexVectors(states, layer, imagePositions), 0)...});
-        interleavedVertexBuffer.sharedVertexVector->updateModified(true);
     }
 
     void setPatternParameters(const std::optional<ImagePosition>& posA,
@@ -23,6 +23,7 @@
 #include <mbgl/style/source_impl.hpp>
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/tile/raw_tile_cache.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/util/instrumentation.hpp>
 #include <mbgl/util/math.hpp>
@@ -116,7 +117,9 @@ RenderOrchestrator::RenderOrchestrator(bool backgroundLayerAsColor_,
                                        TaggedScheduler& threadPool_,
                                        const std::optional<std::string>& localFontFamily_)
     : observer(&nullObserver()),
-      glyphManager(std::make_unique<GlyphManager>(std::make_unique<LocalGlyphRasterizer>(localFontFamily_))),
+      glyphManager(std::make_unique<GlyphManager>(std::make_unique<LocalGlyphRasterizer>(localFontFamily_),
+                                                  GlyphCache::getShared(),
+                                                  localFontFamily_.value_or(std::string()))),
       imageManager(ImageManager::create()),
       lineAtlas(std::make_unique<LineAtlas>()),
       patternAtlas(std::make_unique<PatternAtlas>()),
@@ -127,6 +130,7 @@ RenderOrchestrator::RenderOrchestrator(bool backgroundLayerAsColor_,
       backgroundLayerAsColor(backgroundLayerAsColor_),
       threadPool(threadPool_) {
     glyphManager->setObserver(this);
+    glyphManager->setShapingCache(ShapingCache::getShared());
     imageManager->setObserver(this);
 }
 
@@ -186,10 +190,16 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
     PropertyEvaluationParameters evaluationParameters{zoomHistory, updateParameters->timePoint, transitionDuration};
     evaluationParameters.zoomChanged = zoomChanged;
 
+    std::shared_ptr<FileSource> tileFileSource = updateParameters->fileSource;
+    if (rawTileCache && tileFileSource) {
+        rawTileCache->setFileSource(std::move(tileFileSource));
+        tileFileSource = rawTileCache;
+    }
+
     TileParameters tileParameters{.pixelRatio = updateParameters->pixelRatio,
                                   .debugOptions = updateParameters->debugOptions,
                                   .transformState = updateParameters->transformState,
-                                  .fileSource = updateParameters->fileSource,
+                                  .fileSource = std::move(tileFileSource),
                                   .mode = updateParameters->mode,
                                   .annotationManager = updateParameters->annotationManager,
                                   .imageManager = imageManager,
@@ -339,6 +349,7 @@ std::unique_ptr<RenderTree> RenderOrchestrator::createRenderTree(
         std::unique_ptr<RenderSource> renderSource = RenderSource::create(entry.second, threadPool);
         renderSource->setObserver(this);
         renderSource->setCacheEnabled(tileCacheEnabled);
+        renderSource->setCacheMaxBytes(tileCacheMaxBytes);
         renderSource->setFastPFOREnabled(updateParameters->fastPFOREnabled);
         renderSources.emplace(entry.first, std::move(renderSource));
     }
@@ -768,6 +779,54 @@ bool RenderOrchestrator::getTileCacheEnabled() const {
     return tileCacheEnabled;
 }
 
+void RenderOrchestrator::setTileCacheMaxBytes(std::size_t maxBytes) {
+    tileCacheMaxBytes = maxBytes;
+
+    for (const auto& entry : renderSources) {
+        entry.second->setCacheMaxBytes(maxBytes);
+    }
+}
+
+std::size_t RenderOrchestrator::getTileCacheMaxBytes() const {
+    return tileCacheMaxBytes;
+}
+
+std::map<std::string, TileCacheStats> RenderOrchestrator::getTileCacheStats() const {
+    std::map<std::string, TileCacheStats> result;
+    for (const auto& entry : renderSources) {
+        if (const auto stats = entry.second->getCacheStats()) {
+            result.emplace(entry.first, *stats);
+        }
+    }
+    return result;
+}
+
+void RenderOrchestrator::setRawTileCacheMaxBytes(std::size_t maxBytes) {
+    if (!maxBytes) {
+        if (rawTileCache) {
+            // Tiles which are loading keep the cache alive until they are done, without it keeping their data
+            rawTileCache->setMaxBytes(0);
+            rawTileCache.reset();
+        }
+    } else if (rawTileCache) {
+        rawTileCache->setMaxBytes(maxBytes);
+    } else {
+        rawTileCache = std::make_shared<RawTileCache>(maxBytes);
+    }
+}
+
+std::size_t RenderOrchestrator::getRawTileCacheMaxBytes() const {
+    return rawTileCache ? rawTileCache->getMaxBytes() : 0;
+}
+
+RawTileCacheStats RenderOrchestrator::getRawTileCacheStats() const {
+    return rawTileCache ? rawTileCache->getStats() : RawTileCacheStats();
+}
+
+PlacementStats RenderOrchestrator::getPlacementStats() const {
+    return placementController.getStats();
+}
+
 void RenderOrchestrator::reduceMemoryUse() {
     MLN_TRACE_FUNC();
 
@@ -776,6 +835,9 @@ void RenderOrchestrator::reduceMemoryUse() {
         entry.second->reduceMemoryUse();
     }
     imageManager->reduceMemoryUse();
+    if (rawTileCache) {
+        rawTileCache->clear();
+    }
     observer->onInvalidate();
 }
 
@@ -878,6 +940,10 @@ void RenderOrchestrator::clearData() {
 
     imageManager->clear();
     glyphManager->evict(fontStacks(*layerImpls));
+
+    if (rawTileCache) {
+        rawTileCache->clear();
+    }
 }
 
 void RenderOrchestrator::addChanges(UniqueChangeRequestVec& changes) {
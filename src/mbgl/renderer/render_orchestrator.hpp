@@ -34,6 +34,7 @@ class GlyphManager;
 class ImageManager;
 class LineAtlas;
 class PatternAtlas;
+class RawTileCache;
 class CrossTileSymbolIndex;
 class RenderTree;
 
@@ -95,6 +96,13 @@ public:
 
     void setTileCacheEnabled(bool);
     bool getTileCacheEnabled() const;
+    void setTileCacheMaxBytes(std::size_t);
+    std::size_t getTileCacheMaxBytes() const;
+    std::map<std::string, TileCacheStats> getTileCacheStats() const;
+    void setRawTileCacheMaxBytes(std::size_t);
+    std::size_t getRawTileCacheMaxBytes() const;
+    RawTileCacheStats getRawTileCacheStats() const;
+    PlacementStats getPlacementStats() const;
     void reduceMemoryUse();
     void dumpDebugLogs();
     void collectPlacedSymbolData(bool);
@@ -226,6 +234,8 @@ private:
     bool contextLost = false;
     bool placedSymbolDataCollected = false;
     bool tileCacheEnabled = true;
+    std::size_t tileCacheMaxBytes = 0;
+    std::shared_ptr<RawTileCache> rawTileCache;
 
 #if MLN_RENDER_BACKEND_OPENGL
     bool androidGoldfishMitigationEnabled{false};
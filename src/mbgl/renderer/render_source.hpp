@@ -2,6 +2,7 @@
 
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/map/mode.hpp>
+#include <mbgl/tile/tile_cache_stats.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/util/mat4.hpp>
@@ -13,6 +14,7 @@
 
 #include <map>
 #include <memory>
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
@@ -106,6 +108,11 @@ public:
 
     virtual void setCacheEnabled(bool) {}
 
+    virtual void setCacheMaxBytes(std::size_t) {}
+
+    // Counters of the source's tile cache, if it has one
+    virtual std::optional<TileCacheStats> getCacheStats() const { return std::nullopt; }
+
     virtual void setFastPFOREnabled(bool) {}
 
     virtual void reduceMemoryUse() = 0;
@@ -165,6 +165,34 @@ bool Renderer::getTileCacheEnabled() const {
     return impl->orchestrator.getTileCacheEnabled();
 }
 
+void Renderer::setTileCacheMaxBytes(std::size_t maxBytes) {
+    impl->orchestrator.setTileCacheMaxBytes(maxBytes);
+}
+
+std::size_t Renderer::getTileCacheMaxBytes() const {
+    return impl->orchestrator.getTileCacheMaxBytes();
+}
+
+std::map<std::string, TileCacheStats> Renderer::getTileCacheStats() const {
+    return impl->orchestrator.getTileCacheStats();
+}
+
+void Renderer::setRawTileCacheMaxBytes(std::size_t maxBytes) {
+    impl->orchestrator.setRawTileCacheMaxBytes(maxBytes);
+}
+
+std::size_t Renderer::getRawTileCacheMaxBytes() const {
+    return impl->orchestrator.getRawTileCacheMaxBytes();
+}
+
+RawTileCacheStats Renderer::getRawTileCacheStats() const {
+    return impl->orchestrator.getRawTileCacheStats();
+}
+
+PlacementStats Renderer::getPlacementStats() const {
+    return impl->orchestrator.getPlacementStats();
+}
+
 void Renderer::reduceMemoryUse() {
     gfx::BackendScope guard{impl->backend};
     impl->reduceMemoryUse();
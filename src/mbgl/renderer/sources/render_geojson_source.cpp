@@ -84,7 +84,7 @@ void RenderGeoJSONSource::update(Immutable<style::Source::Impl> baseImpl_,
     enabled = needsRendering;
 
     auto data_ = impl().getData().lock();
-    if (data.lock() != data_) {
+    if (auto previous = data.lock(); previous != data_) {
         data = data_;
         if (parameters.mode != MapMode::Continuous) {
             // Clearing the tile pyramid in order to avoid render tests being flaky.
@@ -94,8 +94,13 @@ void RenderGeoJSONSource::update(Immutable<style::Source::Impl> baseImpl_,
             const uint8_t maxZ = impl().getZoomRange().max;
             for (const auto& pair : tilePyramid.getTiles()) {
                 if (pair.first.canonical.z <= maxZ) {
-                    static_cast<GeoJSONTile*>(pair.second.get())
-                        ->updateData(data_, needsRelayout, parameters.isUpdateSynchronous);
+                    auto* tile = static_cast<GeoJSONTile*>(pair.second.get());
+                    // Updated data only loads again the tiles with features that changed
+                    if (!needsRelayout && previous && !data_->isTileChanged(pair.first.canonical, *previous)) {
+                        tile->retainData(data_);
+                    } else {
+                        tile->updateData(data_, needsRelayout, parameters.isUpdateSynchronous);
+                    }
                 }
             }
         }
@@ -562,6 +562,14 @@ void RenderTileSource::setCacheEnabled(bool enable) {
     tilePyramid.setCacheEnabled(enable);
 }
 
+void RenderTileSource::setCacheMaxBytes(std::size_t maxBytes) {
+    tilePyramid.setCacheMaxBytes(maxBytes);
+}
+
+std::optional<TileCacheStats> RenderTileSource::getCacheStats() const {
+    return tilePyramid.getCacheStats();
+}
+
 void RenderTileSource::reduceMemoryUse() {
     tilePyramid.reduceMemoryUse();
 }
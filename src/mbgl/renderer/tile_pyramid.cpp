@@ -9,6 +9,7 @@
 #include <mbgl/util/tile_cover.hpp>
 #include <mbgl/util/tile_range.hpp>
 #include <mbgl/util/enum.hpp>
+#include <mbgl/util/tile_coordinate.hpp>
 #include <mbgl/util/logging.hpp>
 
 #include <mbgl/algorithm/update_renderables.hpp>
@@ -25,6 +26,29 @@ using namespace style;
 namespace {
 TileObserver nullObserver;
 const std::map<OverscaledTileID, std::unique_ptr<Tile>> emptyPrefetchedTiles;
+
+// Priorities for tile background work, higher values are processed first. Tiles covering the
+// current view outrank the parents and children standing in for them, which outrank prefetched
+// tiles. Tiles that left the view sort behind all unprioritized work.
+constexpr int32_t idealTilePriority = 3 << 20;
+constexpr int32_t fallbackTilePriority = 2 << 20;
+constexpr int32_t prefetchTilePriority = 1 << 20;
+constexpr int32_t cachedTilePriority = -1;
+
+int32_t getTilePriority(const OverscaledTileID& id,
+                        const TileCoordinate& center,
+                        const int32_t idealZoom,
+                        const int32_t basePriority) {
+    // Distance between the tile centre and the screen centre, in tiles of the ideal zoom level
+    const double tiles = std::pow(2.0, id.canonical.z);
+    const double scale = std::pow(2.0, idealZoom - id.canonical.z);
+    const double dx = (id.canonical.x + 0.5 + id.wrap * tiles) * scale - center.p.x;
+    const double dy = (id.canonical.y + 0.5) * scale - center.p.y;
+
+    // Within a class, prefer tiles near the centre and close to the ideal zoom level
+    const double penalty = (std::hypot(dx, dy) * 64.0) + (std::abs(idealZoom - id.overscaledZ) * 256.0);
+    return basePriority - static_cast<int32_t>(std::min(penalty, static_cast<double>(prefetchTilePriority - 1)));
+}
 } // namespace
 
 TilePyramid::TilePyramid(const TaggedScheduler& threadPool_)
@@ -76,6 +100,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
                 // for them and thus suppress network requests on
                 // tiles expiration (see `OnlineFileRequest`).
                 entry.second->setNecessity(TileNecessity::Optional);
+                entry.second->setPriority(cachedTilePriority);
                 cache.add(entry.first, std::move(entry.second));
             } else {
                 cache.deferredRelease(std::move(entry.second));
@@ -101,6 +126,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
     int32_t overscaledZoom = util::coveringZoomLevel(zoom, type, tileSize);
     int32_t tileZoom = overscaledZoom;
     int32_t panZoom = zoomRange.max;
+    int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
 
     const std::optional<uint8_t>& sourcePrefetchZoomDelta = sourceImpl.getPrefetchZoomDelta();
     const std::optional<uint8_t>& maxParentTileOverscaleFactor = sourceImpl.getMaxOverscaleFactorForParentTiles();
@@ -117,8 +143,6 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
                                                      .tileLodMode = parameters.tileLodMode};
 
     if (std::cmp_greater_equal(overscaledZoom, zoomRange.min)) {
-        int32_t idealZoom = std::min<int32_t>(zoomRange.max, overscaledZoom);
-
         // Make sure we're not reparsing overzoomed raster tiles.
         if (type == SourceType::Raster) {
             tileZoom = idealZoom;
@@ -264,6 +288,7 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
                         cache.deferredRelease(std::move(tile));
                     } else {
                         tile->setNecessity(TileNecessity::Optional);
+                        tile->setPriority(cachedTilePriority);
                         cache.add(key, std::move(tile));
                     }
                 }
@@ -280,6 +305,22 @@ void TilePyramid::update(const std::vector<Immutable<style::LayerProperties>>& l
         pair.second->setShowCollisionBoxes(parameters.debugOptions & MapDebugOptions::Collision);
     }
 
+    // Re-rank tile work for the new camera, this also reorders work which is already queued.
+    {
+        std::sort(idealTiles.begin(), idealTiles.end());
+        std::sort(panTiles.begin(), panTiles.end());
+        const auto center = TileCoordinate::fromLatLng(idealZoom, parameters.transformState.getLatLng());
+        for (auto& [tileID, tile] : tiles) {
+            int32_t basePriority = fallbackTilePriority;
+            if (std::binary_search(idealTiles.begin(), idealTiles.end(), tileID)) {
+                basePriority = idealTilePriority;
+            } else if (std::binary_search(panTiles.begin(), panTiles.end(), tileID)) {
+                basePriority = prefetchTilePriority;
+            }
+            tile->setPriority(getTilePriority(tileID, center, idealZoom, basePriority));
+        }
+    }
+
     // Initialize renderable tiles and update the contained layer render data.
     for (auto& entry : renderedTiles) {
         Tile& tile = entry.second;
@@ -419,6 +460,14 @@ void TilePyramid::setCacheEnabled(bool enable) {
     cacheEnabled = enable;
 }
 
+void TilePyramid::setCacheMaxBytes(std::size_t maxBytes) {
+    cache.setMaxBytes(maxBytes);
+}
+
+TileCacheStats TilePyramid::getCacheStats() const {
+    return cache.getStats();
+}
+
 void TilePyramid::reduceMemoryUse() {
     cache.clear();
 }
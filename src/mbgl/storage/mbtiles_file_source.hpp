@@ -2,10 +2,20 @@
 
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource_options.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/client_options.hpp>
 #include <mbgl/util/thread.hpp>
 
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace mln {
+
+class ParallelScheduler;
+
 // File source for supporting .mbtiles maps.
 // can only load resource URLS that are absolute paths to local files
 class MBTilesFileSource : public FileSource {
@@ -24,7 +34,23 @@ public:
 
 private:
     class Impl;
+    class ConnectionPool;
+
+    std::shared_ptr<ConnectionPool> getConnectionPool(const std::string& path);
+
     std::unique_ptr<util::Thread<Impl>> thread; // impl
+
+    // Pools of connections tiles are read through, by database path, when enabled. The reads run on the readers,
+    // which are only used by this file source.
+    struct PoolEntry {
+        std::shared_ptr<ConnectionPool> pool;
+        TimePoint lastUsed;
+    };
+    const bool connectionPooling;
+    const int64_t mmapSize;
+    std::unique_ptr<ParallelScheduler> readers;
+    std::mutex poolsMutex;
+    std::map<std::string, PoolEntry> pools;
 };
 
 } // namespace mln
@@ -2,9 +2,15 @@
 
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/storage/resource_options.hpp>
+#include <mbgl/util/chrono.hpp>
 #include <mbgl/util/client_options.hpp>
 #include <mbgl/util/thread.hpp>
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
 namespace mln {
 // File source for supporting .pmtiles maps
 class PMTilesFileSource : public FileSource {
@@ -23,7 +29,21 @@ public:
 
 private:
     class Impl;
+    class MappedArchive;
+
+    std::shared_ptr<MappedArchive> getMappedArchive(const std::string& url);
+
     std::unique_ptr<util::Thread<Impl>> thread; // impl
+
+    // Local archives read through a memory mapping, by URL. They are checked against the file on every use, and
+    // released once unused for a while, as when the sources reading them are removed.
+    struct MappedEntry {
+        std::shared_ptr<MappedArchive> archive;
+        TimePoint lastUsed;
+    };
+    const bool memoryMapping;
+    std::mutex archivesMutex;
+    std::map<std::string, MappedEntry> archives;
 };
 
 } // namespace mln
@@ -0,0 +1,442 @@
+#include <mbgl/style/batch_filter.hpp>
+
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/tile/tile_id.hpp>
+#include <mbgl/util/containers.hpp>
+#include <mbgl/util/instrumentation.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+
+namespace mln {
+namespace style {
+
+using namespace expression;
+
+namespace {
+
+constexpr std::size_t bitsPerWord = 64;
+
+enum class LeafResult : std::uint8_t {
+    False,
+    True,
+    Error
+};
+
+LeafResult evaluateLeaf(const Expression& expression, const EvaluationContext& context) {
+    const EvaluationResult result = expression.evaluate(context);
+    if (!result) {
+        return LeafResult::Error;
+    }
+    const std::optional<bool> typed = fromExpressionValue<bool>(*result);
+    return typed && *typed ? LeafResult::True : LeafResult::False;
+}
+
+/// Exposes a single column value, for evaluating leaves which read nothing else
+class ColumnFeature final : public GeometryTileFeature {
+public:
+    ColumnFeature(FeatureType type_, const std::string* key_, const std::optional<Value>* value_)
+        : type(type_),
+          key(key_),
+          value(value_) {}
+
+    FeatureType getType() const override { return type; }
+
+    std::optional<Value> getValue(const std::string& name) const override {
+        return key && value && name == *key ? *value : std::nullopt;
+    }
+
+private:
+    const FeatureType type;
+    const std::string* const key;
+    const std::optional<Value>* const value;
+};
+
+template <typename T>
+std::string tagged(char tag, T value) {
+    std::string result(1 + sizeof(T), tag);
+    std::memcpy(result.data() + 1, &value, sizeof(T));
+    return result;
+}
+
+/// Key under which equal scalar values share a dictionary entry. Arrays and objects don't,
+/// vector tiles can't contain them anyway.
+std::optional<std::string> dictionaryKey(const std::optional<Value>& value) {
+    if (!value) {
+        return std::string();
+    }
+    return value->match([](const NullValue&) -> std::optional<std::string> { return std::string(1, 'n'); },
+                        [](bool b) -> std::optional<std::string> { return std::string(1, b ? 't' : 'f'); },
+                        [](uint64_t u) -> std::optional<std::string> { return tagged('u', u); },
+                        [](int64_t i) -> std::optional<std::string> { return tagged('i', i); },
+                        [](double d) -> std::optional<std::string> { return tagged('d', d); },
+                        [](const std::string& s) -> std::optional<std::string> { return 's' + s; },
+                        [](const auto&) -> std::optional<std::string> { return std::nullopt; });
+}
+
+bool isPropertyAccessor(const std::string& name, std::size_t arguments) {
+    // Compound expressions which read the property named by their first argument, and nothing else
+    static const std::vector<std::string> names = {
+        "filter-==", "filter-<", "filter->", "filter-<=", "filter->=", "filter-has", "filter-in"};
+    if (name == "get" || name == "has") {
+        return arguments == 1;
+    }
+    return std::find(names.begin(), names.end(), name) != names.end();
+}
+
+bool isTypeAccessor(const std::string& name) {
+    return name == "geometry-type" || name == "filter-type-==" || name == "filter-type-in";
+}
+
+} // namespace
+
+struct BatchFilter::Column {
+    /// Empty for the geometry type
+    std::optional<std::string> key;
+
+    bool operator==(const Column&) const = default;
+};
+
+struct BatchFilter::Node {
+    enum class Type : std::uint8_t {
+        All,
+        Any,
+        Not,
+        /// Evaluated once per distinct value of `column`, or once in total without one
+        Column,
+        /// Evaluated once per feature
+        Feature
+    };
+
+    Type type;
+    const Expression* expression = nullptr;
+    std::optional<std::size_t> column;
+    std::size_t leaf = 0;
+    std::vector<Node> children;
+};
+
+struct BatchFilter::Bits {
+    std::vector<std::uint64_t> value;
+    std::vector<std::uint64_t> error;
+
+    explicit Bits(std::size_t words)
+        : value(words, 0),
+          error(words, 0) {}
+
+    void set(std::size_t i, LeafResult result) {
+        if (result == LeafResult::True) {
+            value[i / bitsPerWord] |= std::uint64_t{1} << (i % bitsPerWord);
+        } else if (result == LeafResult::Error) {
+            error[i / bitsPerWord] |= std::uint64_t{1} << (i % bitsPerWord);
+        }
+    }
+};
+
+namespace {
+
+/// The single column an expression reads, if any
+struct ColumnUse {
+    bool supported = true;
+    std::optional<std::optional<std::string>> column;
+
+    static ColumnUse merge(const ColumnUse& a, const ColumnUse& b) {
+        if (!a.supported || !b.supported) return {.supported = false};
+        if (!a.column) return b;
+        if (!b.column || *a.column == *b.column) return a;
+        return {.supported = false};
+    }
+};
+
+ColumnUse findColumn(const Expression& expression) {
+    if (!expression.has(Dependency::Feature)) {
+        return {};
+    }
+
+    switch (expression.getKind()) {
+        case Kind::Within:
+        case Kind::Distance:
+        case Kind::Let:
+        case Kind::Var:
+            return {.supported = false};
+        default:
+            break;
+    }
+
+    bool anyChildReadsFeature = false;
+    ColumnUse use;
+    expression.eachChild([&](const Expression& child) {
+        anyChildReadsFeature = anyChildReadsFeature || child.has(Dependency::Feature);
+        use = ColumnUse::merge(use, findColumn(child));
+    });
+
+    if (expression.getKind() != Kind::CompoundExpression) {
+        return use;
+    }
+
+    const auto name = expression.getOperator();
+    if (isTypeAccessor(name)) {
+        return ColumnUse::merge(use, {.column = std::optional<std::string>()});
+    }
+
+    std::vector<const Expression*> arguments;
+    expression.eachChild([&](const Expression& child) { arguments.push_back(&child); });
+    if (isPropertyAccessor(name, arguments.size())) {
+        if (arguments.empty() || arguments.front()->getKind() != Kind::Literal) {
+            return {.supported = false};
+        }
+        const auto& key = static_cast<const Literal*>(arguments.front())->getValue();
+        if (!key.is<std::string>()) {
+            return {.supported = false};
+        }
+        return ColumnUse::merge(use, {.column = std::optional<std::string>(key.get<std::string>())});
+    }
+
+    // Any other compound expression depending on the feature without getting it from its
+    // arguments reads something we don't have a column for
+    if (!anyChildReadsFeature) {
+        return {.supported = false};
+    }
+    return use;
+}
+
+} // namespace
+
+BatchFilter::BatchFilter(const Filter& filter)
+    : expression(filter.expression) {
+    if (expression) {
+        root = std::make_unique<Node>(compile(**expression));
+    }
+}
+
+BatchFilter::~BatchFilter() = default;
+
+BatchFilter::Node BatchFilter::compile(const Expression& e) {
+    const ColumnUse use = findColumn(e);
+    if (use.supported) {
+        Node node{.type = Node::Type::Column, .expression = &e, .leaf = leafCount++};
+        if (use.column) {
+            const Column column{.key = *use.column};
+            const auto it = std::find(columns.begin(), columns.end(), column);
+            node.column = static_cast<std::size_t>(it - columns.begin());
+            if (it == columns.end()) {
+                columns.push_back(column);
+            }
+        }
+        return node;
+    }
+
+    const auto kind = e.getKind();
+    if (kind == Kind::All || kind == Kind::Any ||
+        (kind == Kind::CompoundExpression && e.getOperator() == "!")) {
+        Node node{.type = kind == Kind::All   ? Node::Type::All
+                          : kind == Kind::Any ? Node::Type::Any
+                                              : Node::Type::Not};
+        e.eachChild([&](const Expression& child) { node.children.push_back(compile(child)); });
+        return node;
+    }
+
+    return {.type = Node::Type::Feature, .expression = &e, .leaf = leafCount++};
+}
+
+bool BatchFilter::isBatched() const {
+    return root && root->type != Node::Type::Feature;
+}
+
+BatchFilter::Selection BatchFilter::operator()(const GeometryTileLayer& layer,
+                                               float zoom,
+                                               const CanonicalTileID& canonical,
+                                               std::vector<std::unique_ptr<GeometryTileFeature>>* features) const {
+    MLN_TRACE_FUNC();
+
+    const std::size_t count = layer.featureCount();
+    const std::size_t words = (count + bitsPerWord - 1) / bitsPerWord;
+    const std::uint64_t tailMask = count % bitsPerWord ? (std::uint64_t{1} << (count % bitsPerWord)) - 1
+                                                       : ~std::uint64_t{0};
+
+    Selection selection;
+    if (!root) {
+        if (features) {
+            features->clear();
+        }
+        selection.words.assign(words, ~std::uint64_t{0});
+        if (words) {
+            selection.words.back() &= tailMask;
+        }
+        return selection;
+    }
+
+    // Dictionary encode the columns, and evaluate the leaves which need the whole feature, in one pass
+    struct Dictionary {
+        std::vector<std::uint32_t> codes;
+        std::vector<std::optional<Value>> values;
+        mln::unordered_map<std::string, std::uint32_t> lookup;
+    };
+    std::vector<Dictionary> dictionaries(columns.size());
+    for (auto& dictionary : dictionaries) {
+        dictionary.codes.resize(count);
+    }
+
+    std::vector<const Node*> featureLeaves;
+    std::vector<const Node*> columnLeaves;
+    const auto collect = [&](const auto& self, const Node& node) -> void {
+        if (node.type == Node::Type::Feature) {
+            featureLeaves.push_back(&node);
+        } else if (node.type == Node::Type::Column) {
+            columnLeaves.push_back(&node);
+        }
+        for (const auto& child : node.children) {
+            self(self, child);
+        }
+    };
+    collect(collect, *root);
+
+    std::vector<Bits> leaves(leafCount, Bits(words));
+    if (features) {
+        features->clear();
+        features->resize(count);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        std::unique_ptr<GeometryTileFeature> feature = layer.getFeature(i);
+
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            auto& dictionary = dictionaries[c];
+            if (!columns[c].key) {
+                dictionary.codes[i] = static_cast<std::uint32_t>(feature->getType());
+                continue;
+            }
+
+            auto value = feature->getValue(*columns[c].key);
+            auto key = dictionaryKey(value);
+            if (key) {
+                const auto it = dictionary.lookup.find(*key);
+                if (it != dictionary.lookup.end()) {
+                    dictionary.codes[i] = it->second;
+                    continue;
+                }
+            }
+            const auto code = static_cast<std::uint32_t>(dictionary.values.size());
+            dictionary.values.push_back(std::move(value));
+            dictionary.codes[i] = code;
+            if (key) {
+                dictionary.lookup.emplace(std::move(*key), code);
+            }
+        }
+
+        if (!featureLeaves.empty()) {
+            const auto context = EvaluationContext(zoom, feature.get()).withCanonicalTileID(&canonical);
+            for (const Node* leaf : featureLeaves) {
+                leaves[leaf->leaf].set(i, evaluateLeaf(*leaf->expression, context));
+            }
+        }
+
+        if (features) {
+            (*features)[i] = std::move(feature);
+        }
+    }
+
+    // Evaluate the column leaves once per distinct value and scatter the results
+    constexpr std::uint32_t featureTypes = static_cast<std::uint32_t>(FeatureType::Polygon) + 1;
+    std::vector<LeafResult> results;
+    for (const Node* leaf : columnLeaves) {
+        results.clear();
+        if (!leaf->column) {
+            const ColumnFeature feature(FeatureType::Unknown, nullptr, nullptr);
+            results.push_back(evaluateLeaf(
+                *leaf->expression, EvaluationContext(zoom, &feature).withCanonicalTileID(&canonical)));
+        } else if (const auto& column = columns[*leaf->column]; !column.key) {
+            for (std::uint32_t type = 0; type < featureTypes; ++type) {
+                const ColumnFeature feature(static_cast<FeatureType>(type), nullptr, nullptr);
+                results.push_back(evaluateLeaf(
+                    *leaf->expression, EvaluationContext(zoom, &feature).withCanonicalTileID(&canonical)));
+            }
+        } else {
+            for (const auto& value : dictionaries[*leaf->column].values) {
+                const ColumnFeature feature(FeatureType::Unknown, &*column.key, &value);
+                results.push_back(evaluateLeaf(
+                    *leaf->expression, EvaluationContext(zoom, &feature).withCanonicalTileID(&canonical)));
+            }
+        }
+
+        Bits& bits = leaves[leaf->leaf];
+        if (!leaf->column) {
+            for (std::size_t i = 0; i < count; ++i) {
+                bits.set(i, results.front());
+            }
+            continue;
+        }
+        const auto& codes = dictionaries[*leaf->column].codes;
+        for (std::size_t i = 0; i < count; ++i) {
+            bits.set(i, results[codes[i]]);
+        }
+    }
+
+    Bits result = evaluate(*root, leaves);
+    selection.words = std::move(result.value);
+    for (std::size_t w = 0; w < words; ++w) {
+        selection.words[w] &= ~result.error[w];
+    }
+    if (words) {
+        selection.words.back() &= tailMask;
+    }
+    if (features) {
+        for (std::size_t i = 0; i < count; ++i) {
+            if (!selection[i]) {
+                (*features)[i].reset();
+            }
+        }
+    }
+    return selection;
+}
+
+BatchFilter::Bits BatchFilter::evaluate(const Node& node, const std::vector<Bits>& leaves) const {
+    switch (node.type) {
+        case Node::Type::Column:
+        case Node::Type::Feature:
+            return leaves[node.leaf];
+        case Node::Type::Not: {
+            Bits bits = evaluate(node.children.front(), leaves);
+            for (std::size_t w = 0; w < bits.value.size(); ++w) {
+                bits.value[w] = ~bits.value[w] & ~bits.error[w];
+            }
+            return bits;
+        }
+        case Node::Type::All:
+        case Node::Type::Any:
+            break;
+    }
+
+    // Inputs are evaluated in order until one decides the result, the first error reached wins.
+    // Value and error bits are never both set.
+    const bool all = node.type == Node::Type::All;
+    Bits bits = evaluate(node.children.front(), leaves);
+    for (std::size_t c = 1; c < node.children.size(); ++c) {
+        const Bits next = evaluate(node.children[c], leaves);
+        for (std::size_t w = 0; w < bits.value.size(); ++w) {
+            if (all) {
+                // Undecided while true so far
+                bits.error[w] |= bits.value[w] & next.error[w];
+                bits.value[w] &= next.value[w];
+            } else {
+                // Undecided while false so far
+                const std::uint64_t undecided = ~bits.value[w] & ~bits.error[w];
+                bits.error[w] |= undecided & next.error[w];
+                bits.value[w] |= undecided & next.value[w];
+            }
+        }
+    }
+    return bits;
+}
+
+std::size_t BatchFilter::Selection::count() const {
+    std::size_t result = 0;
+    for (const auto word : words) {
+        result += std::popcount(word);
+    }
+    return result;
+}
+
+} // namespace style
+} // namespace mln
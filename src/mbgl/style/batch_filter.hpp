@@ -0,0 +1,72 @@
+#pragma once
+
+#include <mbgl/style/filter.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace mln {
+
+class CanonicalTileID;
+class GeometryTileFeature;
+class GeometryTileLayer;
+
+namespace style {
+
+/**
+ * Evaluates a filter for all features of a tile layer at once.
+ *
+ * The filter's expression is compiled into a tree of `all`, `any` and `!` nodes over leaves.
+ * Leaves which depend on a single property of the feature (the usual `==`, `in`, `has` and
+ * `match` forms, in both legacy and expression syntax) or only on its geometry type are
+ * evaluated once per distinct value of that column rather than once per feature. Columns are
+ * read from the layer in one pass and dictionary encoded, so a leaf costs one evaluation per
+ * distinct value plus a table lookup per feature. Leaves reading anything else are evaluated
+ * per feature.
+ *
+ * Leaf results are combined as bitmaps, one bit per feature, keeping track of evaluation errors
+ * so the selection is exactly the one `Filter::operator()` gives for each feature.
+ */
+class BatchFilter {
+public:
+    /// One bit per feature of the layer, set for the features passing the filter
+    struct Selection {
+        std::vector<std::uint64_t> words;
+
+        bool operator[](std::size_t i) const { return (words[i / 64] >> (i % 64)) & 1; }
+        std::size_t count() const;
+    };
+
+    explicit BatchFilter(const Filter&);
+    ~BatchFilter();
+
+    /// Whether any part of the filter is evaluated per distinct value rather than per feature
+    bool isBatched() const;
+
+    /// When `features` is given, it receives the features read from the layer which pass the filter, at their index,
+    /// so they don't need to be read again. It holds null for the others, and is left empty if no feature was read.
+    Selection operator()(const GeometryTileLayer&,
+                         float zoom,
+                         const CanonicalTileID&,
+                         std::vector<std::unique_ptr<GeometryTileFeature>>* features = nullptr) const;
+
+private:
+    struct Column;
+    struct Node;
+    struct Bits;
+
+    Node compile(const expression::Expression&);
+    Bits evaluate(const Node&, const std::vector<Bits>& leaves) const;
+
+    std::optional<std::shared_ptr<const expression::Expression>> expression;
+    std::unique_ptr<Node> root;
+    std::vector<Column> columns;
+    std::size_t leafCount = 0;
+};
+
+} // namespace style
+} // namespace mln
@@ -111,6 +111,16 @@ std::optional<GeoJSONOptions> Converter<GeoJSONOptions>::operator()(const Conver
         }
     }
 
+    const auto updatableValue = objectMember(value, "updatable");
+    if (updatableValue) {
+        if (toBool(*updatableValue)) {
+            options.updatable = *toBool(*updatableValue);
+        } else {
+            error.message = "GeoJSON source updatable value must be a boolean";
+            return std::nullopt;
+        }
+    }
+
     const auto clusterProperties = objectMember(value, "clusterProperties");
     if (clusterProperties) {
         if (!isObject(*clusterProperties)) {
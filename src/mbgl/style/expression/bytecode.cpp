@@ -0,0 +1,1040 @@
+#include <mbgl/style/expression/bytecode.hpp>
+
+#include <mbgl/math/log2.hpp>
+#include <mbgl/style/expression/compound_expression.hpp>
+#include <mbgl/style/expression/geojson_feature.hpp>
+#include <mbgl/style/expression/interpolate.hpp>
+#include <mbgl/style/expression/is_constant.hpp>
+#include <mbgl/style/expression/let.hpp>
+#include <mbgl/style/expression/literal.hpp>
+#include <mbgl/style/expression/match.hpp>
+#include <mbgl/style/expression/step.hpp>
+#include <mbgl/util/interpolate.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+namespace mln {
+namespace style {
+namespace expression {
+
+namespace {
+
+constexpr std::size_t maxRegisters = 64;
+// Feature properties, and results of subexpressions evaluated as trees, kept while evaluating
+constexpr std::size_t maxSlots = 16;
+// Interpolating between stops evaluates their code twice, which adds up for nested curves
+constexpr std::size_t maxInstructions = 1 << 16;
+
+// Properties of the evaluation context, which keep subexpressions from being folded into constants
+const auto globalProperties = std::array<std::string_view, 5>{
+    "zoom", "heatmap-density", "line-progress", "accumulated", "elevation"};
+
+using UnaryFunction = double (*)(double);
+
+// The functions of the single number compound expressions, as they evaluate them
+const std::array<std::pair<std::string_view, UnaryFunction>, 14> unaryFunctions = {{
+    {"sqrt", [](double x) { return std::sqrt(x); }},
+    {"log10", [](double x) { return std::log10(x); }},
+    {"ln", [](double x) { return std::log(x); }},
+    {"log2", [](double x) { return util::log2(x); }},
+    {"sin", [](double x) { return std::sin(x); }},
+    {"cos", [](double x) { return std::cos(x); }},
+    {"tan", [](double x) { return std::tan(x); }},
+    {"asin", [](double x) { return std::asin(x); }},
+    {"acos", [](double x) { return std::acos(x); }},
+    {"atan", [](double x) { return std::atan(x); }},
+    {"round", [](double x) { return std::round(x); }},
+    {"floor", [](double x) { return std::floor(x); }},
+    {"ceil", [](double x) { return std::ceil(x); }},
+    {"abs", [](double x) { return std::abs(x); }},
+}};
+
+double divide(double a, double b) {
+    if (b == 0) {
+        if (a == 0) return std::numeric_limits<double>::quiet_NaN();
+        if (a > 0) return std::numeric_limits<double>::infinity();
+        if (a < 0) return -std::numeric_limits<double>::infinity();
+    }
+    return a / b;
+}
+
+std::vector<const Expression*> childrenOf(const Expression& expression) {
+    std::vector<const Expression*> children;
+    expression.eachChild([&](const Expression& child) { children.push_back(&child); });
+    return children;
+}
+
+bool isScalar(const type::Type& type) {
+    return type == type::Null || type == type::Boolean || type == type::Number || type == type::String ||
+           type == type::Color || type == type::Value;
+}
+
+// There is no RTTI to tell `Match<std::string>` from `Match<int64_t>`, so look at the first label
+// of the serialized expression instead.
+bool hasStringLabels(const Expression& match) {
+    const mln::Value serialized = match.serialize();
+    const auto* items = serialized.getArray();
+    if (!items || items->size() < 3) {
+        return false;
+    }
+    const mln::Value* label = &(*items)[2];
+    if (const auto* labels = label->getArray(); labels && !labels->empty()) {
+        label = &labels->front();
+    }
+    return label->getString() != nullptr;
+}
+
+} // namespace
+
+enum class Bytecode::Op : uint8_t {
+    // dst = constants[operand]
+    Constant,
+    // dst = the zoom level
+    Zoom,
+    // dst = the feature property keys[operand], read once into property slot a
+    Get,
+    // dst = trees[operand] evaluated as a tree, kept in result slot a
+    Tree,
+    // dst = a + b, and so on, for numbers
+    Add,
+    Subtract,
+    Multiply,
+    Divide,
+    Modulo,
+    Power,
+    // dst = the smaller or larger of the accumulator a and the argument b
+    Min,
+    Max,
+    // dst = -a
+    Negate,
+    // dst = unaryFunctions[operand](a)
+    Math,
+    // dst = !a
+    Not,
+    // dst = a == b, and so on
+    Equal,
+    NotEqual,
+    Less,
+    LessEqual,
+    Greater,
+    GreaterEqual,
+    // Jumps to operand, always or depending on a
+    Jump,
+    JumpIfFalse,
+    JumpIfTrue,
+    JumpIfNotNull,
+    // Jumps to operand if a holds the register type b
+    JumpIfType,
+    // Gives up unless a holds the register type b
+    AssertType,
+    // Jumps to the branch of stringMatches[operand] or numberMatches[operand] for a
+    MatchString,
+    MatchNumber,
+    // dst = the output of the stop of curves[operand] for a
+    StepConstant,
+    // Jumps to the code of the stop of curves[operand] for a
+    Step,
+    // dst = the outputs of curves[operand] interpolated for a
+    InterpolateConstant,
+    // Jumps to the code of the stop or pair of stops of curves[operand] for a, setting b to the
+    // interpolation factor for a pair
+    Interpolate,
+    // dst = a and b interpolated by the factor in register operand
+    Lerp,
+};
+
+struct Bytecode::Frame {
+    std::array<Register, maxRegisters> registers;
+    std::array<std::optional<mln::Value>, maxSlots> properties;
+    std::array<std::optional<Value>, maxSlots> results;
+
+    static void setNumber(Register& target, double number) {
+        target.number = number;
+        target.type = RegisterType::Number;
+    }
+
+    static void setBoolean(Register& target, bool boolean) {
+        target.boolean = boolean;
+        target.type = RegisterType::Boolean;
+    }
+
+    /// Loads a feature property, which has to outlive the register if it's a string
+    static bool load(const mln::Value& value, Register& target) {
+        return value.match(
+            [&](const mln::NullValue&) {
+                target.type = RegisterType::Null;
+                return true;
+            },
+            [&](bool boolean) {
+                setBoolean(target, boolean);
+                return true;
+            },
+            [&](uint64_t number) {
+                setNumber(target, static_cast<double>(number));
+                return true;
+            },
+            [&](int64_t number) {
+                setNumber(target, static_cast<double>(number));
+                return true;
+            },
+            [&](double number) {
+                setNumber(target, number);
+                return true;
+            },
+            [&](const std::string& string) {
+                target.string = string;
+                target.type = RegisterType::String;
+                return true;
+            },
+            [&](const auto&) { return false; });
+    }
+
+    /// Loads an expression value, which has to outlive the register if it's a string
+    static bool load(const Value& value, Register& target) {
+        return value.match(
+            [&](const NullValue&) {
+                target.type = RegisterType::Null;
+                return true;
+            },
+            [&](bool boolean) {
+                setBoolean(target, boolean);
+                return true;
+            },
+            [&](double number) {
+                setNumber(target, number);
+                return true;
+            },
+            [&](const std::string& string) {
+                target.string = string;
+                target.type = RegisterType::String;
+                return true;
+            },
+            [&](const Color& color) {
+                target.color = color;
+                target.type = RegisterType::Color;
+                return true;
+            },
+            [&](const auto&) { return false; });
+    }
+
+    static Value toValue(const Register& source) {
+        switch (source.type) {
+            case RegisterType::Boolean:
+                return source.boolean;
+            case RegisterType::Number:
+                return source.number;
+            case RegisterType::String:
+                return std::string(source.string);
+            case RegisterType::Color:
+                return source.color;
+            case RegisterType::Null:
+                break;
+        }
+        return Null;
+    }
+
+    static bool equal(const Register& a, const Register& b) {
+        if (a.type != b.type) {
+            return false;
+        }
+        switch (a.type) {
+            case RegisterType::Boolean:
+                return a.boolean == b.boolean;
+            case RegisterType::Number:
+                return a.number == b.number;
+            case RegisterType::String:
+                return a.string == b.string;
+            case RegisterType::Color:
+                return a.color == b.color;
+            case RegisterType::Null:
+                break;
+        }
+        return true;
+    }
+
+    /// Orders two numbers or two strings, as `<` and friends require
+    template <typename Compare>
+    static bool compare(const Register& a, const Register& b, Register& target, Compare compare) {
+        if (a.type == RegisterType::Number && b.type == RegisterType::Number) {
+            setBoolean(target, compare(a.number, b.number));
+        } else if (a.type == RegisterType::String && b.type == RegisterType::String) {
+            setBoolean(target, compare(a.string, b.string));
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    /// Interpolates two numbers or two colors, as `interpolate` does
+    static bool lerp(const Register& lower, const Register& upper, double t, Register& target) {
+        if (lower.type == RegisterType::Number && upper.type == RegisterType::Number) {
+            setNumber(target, util::interpolate(lower.number, upper.number, t));
+        } else if (lower.type == RegisterType::Color && upper.type == RegisterType::Color) {
+            target.color = util::interpolate(lower.color, upper.color, t);
+            target.type = RegisterType::Color;
+        } else {
+            return false;
+        }
+        return true;
+    }
+};
+
+class Bytecode::Compiler {
+public:
+    explicit Compiler(Bytecode& program_)
+        : program(program_) {}
+
+    /// Emits the code leaving the result of the expression in register `target`. Fails when running out
+    /// of registers, slots or instructions.
+    bool compile(const Expression& expression, uint8_t target) {
+        if (full()) {
+            return false;
+        }
+        if (const auto constant = toConstant(fold(expression))) {
+            emit(Op::Constant, target, 0, 0, addConstant(*constant));
+            return true;
+        }
+
+        switch (expression.getKind()) {
+            case Kind::CompoundExpression:
+                return compileCompound(static_cast<const CompoundExpression&>(expression), target);
+            case Kind::Comparison:
+                return compileComparison(expression, target);
+            case Kind::Any:
+                return compileBoolean(expression, Op::JumpIfTrue, target);
+            case Kind::All:
+                return compileBoolean(expression, Op::JumpIfFalse, target);
+            case Kind::Case:
+                return compileCase(expression, target);
+            case Kind::Coalesce:
+                return compileCoalesce(expression, target);
+            case Kind::Assertion:
+                return compileAssertion(expression, target);
+            case Kind::Match:
+                if (hasStringLabels(expression)) {
+                    return compileMatch(static_cast<const Match<std::string>&>(expression),
+                                        Op::MatchString,
+                                        program.stringMatches,
+                                        target);
+                }
+                return compileMatch(
+                    static_cast<const Match<int64_t>&>(expression), Op::MatchNumber, program.numberMatches, target);
+            case Kind::Step:
+                return compileStep(static_cast<const Step&>(expression), target);
+            case Kind::Interpolate:
+                return compileInterpolate(static_cast<const Interpolate&>(expression), target);
+            case Kind::Let:
+                return compile(*static_cast<const Let&>(expression).getResult(), target);
+            case Kind::Var:
+                // Variables evaluate their binding where they are used, as they do in the tree
+                return compile(*static_cast<const Var&>(expression).getBoundExpression(), target);
+            default:
+                return compileTree(expression, target);
+        }
+    }
+
+private:
+    /// The value of a literal, or of a subexpression which only depends on literals
+    std::optional<Value> fold(const Expression& expression) const {
+        if (expression.getKind() == Kind::Literal) {
+            return static_cast<const Literal&>(expression).getValue();
+        }
+        if (expression.has(Dependency::Feature | Dependency::Zoom | Dependency::Image | Dependency::Elevation |
+                           Dependency::Override) ||
+            !isFeatureConstant(expression) || !isGlobalPropertyConstant(expression, globalProperties)) {
+            return std::nullopt;
+        }
+        const EvaluationResult result = expression.evaluate(EvaluationContext());
+        if (!result) {
+            return std::nullopt;
+        }
+        return *result;
+    }
+
+    std::optional<Register> toConstant(const std::optional<Value>& value) {
+        Register constant;
+        if (!value || !Frame::load(*value, constant)) {
+            return std::nullopt;
+        }
+        if (constant.type == RegisterType::String) {
+            constant.string = program.strings.emplace_back(constant.string);
+        }
+        return constant;
+    }
+
+    uint32_t addConstant(const Register& constant) {
+        program.constants.push_back(constant);
+        return static_cast<uint32_t>(program.constants.size() - 1);
+    }
+
+    std::optional<uint8_t> allocate() {
+        if (nextRegister >= maxRegisters) {
+            return std::nullopt;
+        }
+        return static_cast<uint8_t>(nextRegister++);
+    }
+
+    uint32_t emit(Op op, uint8_t target = 0, uint8_t a = 0, uint8_t b = 0, uint32_t operand = 0) {
+        program.instructions.push_back({.op = op, .dst = target, .a = a, .b = b, .operand = operand});
+        return static_cast<uint32_t>(program.instructions.size() - 1);
+    }
+
+    uint32_t here() const { return static_cast<uint32_t>(program.instructions.size()); }
+
+    bool full() const { return program.instructions.size() > maxInstructions; }
+
+    void patch(const std::vector<uint32_t>& jumps) {
+        for (const uint32_t jump : jumps) {
+            program.instructions[jump].operand = here();
+        }
+    }
+
+    bool compileTree(const Expression& expression, uint8_t target) {
+        if (resultSlots >= maxSlots) {
+            return false;
+        }
+        program.trees.push_back(&expression);
+        emit(Op::Tree, target, static_cast<uint8_t>(resultSlots++), 0, static_cast<uint32_t>(program.trees.size() - 1));
+        return true;
+    }
+
+    bool compileBinary(Op op, const Expression& lhs, const Expression& rhs, uint8_t target) {
+        const auto mark = nextRegister;
+        const auto right = allocate();
+        if (!right || !compile(lhs, target) || !compile(rhs, *right)) {
+            return false;
+        }
+        emit(op, target, target, *right);
+        nextRegister = mark;
+        return true;
+    }
+
+    /// Folds the arguments into an accumulator starting at `identity`, as the varargs number expressions do
+    bool compileVarargs(Op op, double identity, const std::vector<const Expression*>& args, uint8_t target) {
+        Register constant;
+        Frame::setNumber(constant, identity);
+        emit(Op::Constant, target, 0, 0, addConstant(constant));
+
+        const auto mark = nextRegister;
+        const auto argument = allocate();
+        if (!argument) {
+            return false;
+        }
+        for (const auto* arg : args) {
+            if (!compile(*arg, *argument)) {
+                return false;
+            }
+            emit(op, target, target, *argument);
+        }
+        nextRegister = mark;
+        return true;
+    }
+
+    bool compileCompound(const CompoundExpression& expression, uint8_t target) {
+        const std::string name = expression.getOperator();
+        const auto args = childrenOf(expression);
+
+        if (name == "zoom") {
+            emit(Op::Zoom, target);
+            return true;
+        }
+        if (name == "get" && args.size() == 1 && args[0]->getKind() == Kind::Literal) {
+            const auto& key = static_cast<const Literal*>(args[0])->getValue();
+            if (key.is<std::string>()) {
+                return compileGet(key.get<std::string>(), target);
+            }
+        }
+
+        if (name == "+") return compileVarargs(Op::Add, 0.0, args, target);
+        if (name == "*") return compileVarargs(Op::Multiply, 1.0, args, target);
+        if (name == "min") return compileVarargs(Op::Min, std::numeric_limits<double>::infinity(), args, target);
+        if (name == "max") return compileVarargs(Op::Max, -std::numeric_limits<double>::infinity(), args, target);
+
+        if (args.size() == 2) {
+            if (name == "-") return compileBinary(Op::Subtract, *args[0], *args[1], target);
+            if (name == "/") return compileBinary(Op::Divide, *args[0], *args[1], target);
+            if (name == "%") return compileBinary(Op::Modulo, *args[0], *args[1], target);
+            if (name == "^") return compileBinary(Op::Power, *args[0], *args[1], target);
+        }
+
+        if (args.size() == 1) {
+            if (name == "-" || name == "!") {
+                if (!compile(*args[0], target)) return false;
+                emit(name == "-" ? Op::Negate : Op::Not, target, target);
+                return true;
+            }
+            const auto function = std::find_if(unaryFunctions.begin(), unaryFunctions.end(), [&](const auto& entry) {
+                return entry.first == name;
+            });
+            if (function != unaryFunctions.end()) {
+                if (!compile(*args[0], target)) return false;
+                emit(Op::Math, target, target, 0, static_cast<uint32_t>(function - unaryFunctions.begin()));
+                return true;
+            }
+        }
+
+        return compileTree(expression, target);
+    }
+
+    bool compileGet(const std::string& key, uint8_t target) {
+        // Properties read several times share a slot, and are only read once
+        auto slot = propertySlots.find(key);
+        if (slot == propertySlots.end()) {
+            if (propertySlots.size() >= maxSlots) {
+                return false;
+            }
+            program.keys.push_back(key);
+            slot = propertySlots
+                       .emplace(key,
+                                std::pair(static_cast<uint8_t>(propertySlots.size()),
+                                          static_cast<uint32_t>(program.keys.size() - 1)))
+                       .first;
+        }
+        emit(Op::Get, target, slot->second.first, 0, slot->second.second);
+        return true;
+    }
+
+    bool compileComparison(const Expression& expression, uint8_t target) {
+        const auto args = childrenOf(expression);
+        if (args.size() != 2) {
+            // Collator comparisons
+            return compileTree(expression, target);
+        }
+
+        const std::string name = expression.getOperator();
+        const Op op = name == "==" ? Op::Equal
+                      : name == "!=" ? Op::NotEqual
+                      : name == "<"  ? Op::Less
+                      : name == "<=" ? Op::LessEqual
+                      : name == ">"  ? Op::Greater
+                                     : Op::GreaterEqual;
+        return compileBinary(op, *args[0], *args[1], target);
+    }
+
+    /// `any` and `all`, which stop at the first input deciding the result
+    bool compileBoolean(const Expression& expression, Op stop, uint8_t target) {
+        const auto inputs = childrenOf(expression);
+        if (inputs.empty()) {
+            Register constant;
+            Frame::setBoolean(constant, stop == Op::JumpIfFalse);
+            emit(Op::Constant, target, 0, 0, addConstant(constant));
+            return true;
+        }
+
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            if (!compile(*inputs[i], target)) {
+                return false;
+            }
+            if (i + 1 < inputs.size()) {
+                exits.push_back(emit(stop, 0, target));
+            }
+        }
+        patch(exits);
+        return true;
+    }
+
+    bool compileCase(const Expression& expression, uint8_t target) {
+        const auto children = childrenOf(expression);
+        const auto mark = nextRegister;
+        const auto test = allocate();
+        if (!test) {
+            return false;
+        }
+
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i + 1 < children.size(); i += 2) {
+            if (!compile(*children[i], *test)) {
+                return false;
+            }
+            const uint32_t next = emit(Op::JumpIfFalse, 0, *test);
+            if (!compile(*children[i + 1], target)) {
+                return false;
+            }
+            exits.push_back(emit(Op::Jump));
+            patch({next});
+        }
+        if (!compile(*children.back(), target)) {
+            return false;
+        }
+        patch(exits);
+        nextRegister = mark;
+        return true;
+    }
+
+    bool compileCoalesce(const Expression& expression, uint8_t target) {
+        if (expression.getType() == type::Image) {
+            // Images are held back until one is available
+            return compileTree(expression, target);
+        }
+
+        const auto args = childrenOf(expression);
+        if (args.empty()) {
+            Register constant;
+            constant.type = RegisterType::Null;
+            emit(Op::Constant, target, 0, 0, addConstant(constant));
+            return true;
+        }
+
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            if (!compile(*args[i], target)) {
+                return false;
+            }
+            if (i + 1 < args.size()) {
+                exits.push_back(emit(Op::JumpIfNotNull, 0, target));
+            }
+        }
+        patch(exits);
+        return true;
+    }
+
+    bool compileAssertion(const Expression& expression, uint8_t target) {
+        const type::Type& type = expression.getType();
+        RegisterType registerType;
+        if (type == type::Number) {
+            registerType = RegisterType::Number;
+        } else if (type == type::String) {
+            registerType = RegisterType::String;
+        } else if (type == type::Boolean) {
+            registerType = RegisterType::Boolean;
+        } else {
+            return compileTree(expression, target);
+        }
+
+        // The first input of the asserted type is the result
+        const auto inputs = childrenOf(expression);
+        std::vector<uint32_t> exits;
+        for (std::size_t i = 0; i < inputs.size(); ++i) {
+            if (!compile(*inputs[i], target)) {
+                return false;
+            }
+            const bool last = i + 1 == inputs.size();
+            const uint32_t check = emit(
+                last ? Op::AssertType : Op::JumpIfType, 0, target, static_cast<uint8_t>(registerType));
+            if (!last) {
+                exits.push_back(check);
+            }
+        }
+        patch(exits);
+        return true;
+    }
+
+    template <typename T, typename Table>
+    bool compileMatch(const Match<T>& match, Op op, std::vector<Table>& tables, uint8_t target) {
+        const auto mark = nextRegister;
+        const auto input = allocate();
+        if (!input || !compile(*match.getInput(), *input)) {
+            return false;
+        }
+        tables.emplace_back();
+        const auto index = static_cast<uint32_t>(tables.size() - 1);
+        emit(op, 0, *input, 0, index);
+
+        // Labels sharing an output jump to the same code
+        Table table;
+        std::unordered_map<const Expression*, uint32_t> outputs;
+        std::vector<uint32_t> exits;
+        for (const auto& [label, output] : match.getBranches()) {
+            auto compiled = outputs.find(output.get());
+            if (compiled == outputs.end()) {
+                compiled = outputs.emplace(output.get(), here()).first;
+                if (!compile(*output, target)) {
+                    return false;
+                }
+                exits.push_back(emit(Op::Jump));
+            }
+            table.targets.emplace(label, compiled->second);
+        }
+        table.otherwise = here();
+        if (!compile(*match.getOtherwise(), target)) {
+            return false;
+        }
+        patch(exits);
+        tables[index] = std::move(table);
+        nextRegister = mark;
+        return true;
+    }
+
+    /// The stops of a curve, with their outputs if all of them are constant
+    Curve curveOf(const Expression& expression, std::vector<const Expression*>& outputs) {
+        Curve curve;
+        bool constant = true;
+        const auto visit = [&](double input, const Expression& output) {
+            curve.inputs.push_back(input);
+            outputs.push_back(&output);
+            if (constant) {
+                if (const auto folded = toConstant(fold(output))) {
+                    curve.outputs.push_back(*folded);
+                } else {
+                    constant = false;
+                }
+            }
+        };
+        if (expression.getKind() == Kind::Step) {
+            static_cast<const Step&>(expression).eachStop(visit);
+        } else {
+            static_cast<const Interpolate&>(expression).eachStop(visit);
+        }
+        if (!constant) {
+            curve.outputs.clear();
+        }
+        return curve;
+    }
+
+    bool compileStep(const Step& step, uint8_t target) {
+        const auto mark = nextRegister;
+        const auto input = allocate();
+        if (!input || !compile(*step.getInput(), *input)) {
+            return false;
+        }
+
+        std::vector<const Expression*> outputs;
+        Curve curve = curveOf(step, outputs);
+        const auto index = static_cast<uint32_t>(program.curves.size());
+        program.curves.emplace_back();
+        if (!outputs.empty() && curve.outputs.size() == outputs.size()) {
+            emit(Op::StepConstant, target, *input, 0, index);
+        } else {
+            emit(Op::Step, 0, *input, 0, index);
+            std::vector<uint32_t> exits;
+            for (const auto* output : outputs) {
+                curve.stops.push_back(here());
+                if (!compile(*output, target)) {
+                    return false;
+                }
+                exits.push_back(emit(Op::Jump));
+            }
+            patch(exits);
+        }
+        program.curves[index] = std::move(curve);
+        nextRegister = mark;
+        return true;
+    }
+
+    bool compileInterpolate(const Interpolate& interpolate, uint8_t target) {
+        if (interpolate.getType() != type::Number && interpolate.getType() != type::Color) {
+            return compileTree(interpolate, target);
+        }
+
+        const auto mark = nextRegister;
+        const auto input = allocate();
+        if (!input || !compile(*interpolate.getInput(), *input)) {
+            return false;
+        }
+
+        std::vector<const Expression*> outputs;
+        Curve curve = curveOf(interpolate, outputs);
+        curve.interpolator = interpolate.getInterpolator();
+        const auto index = static_cast<uint32_t>(program.curves.size());
+        program.curves.emplace_back();
+        if (!outputs.empty() && curve.outputs.size() == outputs.size()) {
+            emit(Op::InterpolateConstant, target, *input, 0, index);
+        } else {
+            const auto factor = allocate();
+            const auto upper = allocate();
+            if (!factor || !upper) {
+                return false;
+            }
+            emit(Op::Interpolate, 0, *input, *factor, index);
+            std::vector<uint32_t> exits;
+            for (const auto* output : outputs) {
+                curve.stops.push_back(here());
+                if (!compile(*output, target)) {
+                    return false;
+                }
+                exits.push_back(emit(Op::Jump));
+            }
+            for (std::size_t i = 0; i + 1 < outputs.size(); ++i) {
+                curve.segments.push_back(here());
+                if (!compile(*outputs[i], target) || !compile(*outputs[i + 1], *upper)) {
+                    return false;
+                }
+                emit(Op::Lerp, target, target, *upper, *factor);
+                exits.push_back(emit(Op::Jump));
+            }
+            patch(exits);
+        }
+        program.curves[index] = std::move(curve);
+        nextRegister = mark;
+        return !full();
+    }
+
+    Bytecode& program;
+    std::size_t nextRegister = 1;
+    std::size_t resultSlots = 0;
+    // The slot and key index of each property read
+    std::unordered_map<std::string, std::pair<uint8_t, uint32_t>> propertySlots;
+};
+
+Bytecode::~Bytecode() = default;
+
+std::unique_ptr<const Bytecode> Bytecode::compile(const Expression& expression) {
+    if (!isScalar(expression.getType())) {
+        return nullptr;
+    }
+
+    std::unique_ptr<Bytecode> program(new Bytecode());
+    Compiler compiler(*program);
+    if (!compiler.compile(expression, 0) || program->instructions.size() > maxInstructions) {
+        return nullptr;
+    }
+    if (program->instructions.size() == 1 && program->instructions.front().op == Op::Tree) {
+        return nullptr;
+    }
+    return program;
+}
+
+std::optional<Value> Bytecode::evaluate(const EvaluationContext& context) const {
+    Frame frame;
+    if (const Register* result = run(context, frame)) {
+        return Frame::toValue(*result);
+    }
+    return std::nullopt;
+}
+
+std::optional<Value> Bytecode::evaluate(std::optional<float> zoom,
+                                        const Feature& feature,
+                                        std::optional<double> colorRampParameter,
+                                        const std::set<std::string>& availableImages,
+                                        const CanonicalTileID* canonical) const {
+    if (canonical) {
+        GeoJSONFeature f(feature, *canonical);
+        return evaluate(EvaluationContext(zoom, &f, colorRampParameter)
+                            .withAvailableImages(&availableImages)
+                            .withCanonicalTileID(canonical));
+    }
+    GeoJSONFeature f(feature);
+    return evaluate(EvaluationContext(zoom, &f, colorRampParameter).withAvailableImages(&availableImages));
+}
+
+std::optional<double> Bytecode::evaluateNumber(const EvaluationContext& context) const {
+    Frame frame;
+    const Register* result = run(context, frame);
+    if (result && result->type == RegisterType::Number) {
+        return result->number;
+    }
+    return std::nullopt;
+}
+
+std::optional<Color> Bytecode::evaluateColor(const EvaluationContext& context) const {
+    Frame frame;
+    const Register* result = run(context, frame);
+    if (result && result->type == RegisterType::Color) {
+        return result->color;
+    }
+    return std::nullopt;
+}
+
+const Bytecode::Register* Bytecode::run(const EvaluationContext& context, Frame& frame) const {
+    auto& registers = frame.registers;
+    const std::size_t count = instructions.size();
+    for (std::size_t pc = 0; pc < count;) {
+        const Instruction& instruction = instructions[pc++];
+        Register& dst = registers[instruction.dst];
+        const Register& a = registers[instruction.a];
+        const Register& b = registers[instruction.b];
+        const auto numbers = [&] { return a.type == RegisterType::Number && b.type == RegisterType::Number; };
+
+        switch (instruction.op) {
+            case Op::Constant:
+                dst = constants[instruction.operand];
+                break;
+            case Op::Zoom:
+                if (!context.zoom) return nullptr;
+                Frame::setNumber(dst, *context.zoom);
+                break;
+            case Op::Get: {
+                if (!context.feature) return nullptr;
+                auto& property = frame.properties[instruction.a];
+                if (!property) {
+                    auto value = context.feature->getValue(keys[instruction.operand]);
+                    property = value ? std::move(*value) : mln::Value(mln::NullValue());
+                }
+                if (!Frame::load(*property, dst)) return nullptr;
+                break;
+            }
+            case Op::Tree: {
+                EvaluationResult result = trees[instruction.operand]->evaluate(context);
+                if (!result) return nullptr;
+                auto& slot = frame.results[instruction.a];
+                slot = std::move(*result);
+                if (!Frame::load(*slot, dst)) return nullptr;
+                break;
+            }
+            case Op::Add:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, a.number + b.number);
+                break;
+            case Op::Subtract:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, a.number - b.number);
+                break;
+            case Op::Multiply:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, a.number * b.number);
+                break;
+            case Op::Divide:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, divide(a.number, b.number));
+                break;
+            case Op::Modulo:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, std::fmod(a.number, b.number));
+                break;
+            case Op::Power:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, std::pow(a.number, b.number));
+                break;
+            case Op::Min:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, std::fmin(b.number, a.number));
+                break;
+            case Op::Max:
+                if (!numbers()) return nullptr;
+                Frame::setNumber(dst, std::fmax(b.number, a.number));
+                break;
+            case Op::Negate:
+                if (a.type != RegisterType::Number) return nullptr;
+                Frame::setNumber(dst, -a.number);
+                break;
+            case Op::Math:
+                if (a.type != RegisterType::Number) return nullptr;
+                Frame::setNumber(dst, unaryFunctions[instruction.operand].second(a.number));
+                break;
+            case Op::Not:
+                if (a.type != RegisterType::Boolean) return nullptr;
+                Frame::setBoolean(dst, !a.boolean);
+                break;
+            case Op::Equal:
+                Frame::setBoolean(dst, Frame::equal(a, b));
+                break;
+            case Op::NotEqual:
+                Frame::setBoolean(dst, !Frame::equal(a, b));
+                break;
+            case Op::Less:
+                if (!Frame::compare(a, b, dst, std::less<>())) return nullptr;
+                break;
+            case Op::LessEqual:
+                if (!Frame::compare(a, b, dst, std::less_equal<>())) return nullptr;
+                break;
+            case Op::Greater:
+                if (!Frame::compare(a, b, dst, std::greater<>())) return nullptr;
+                break;
+            case Op::GreaterEqual:
+                if (!Frame::compare(a, b, dst, std::greater_equal<>())) return nullptr;
+                break;
+            case Op::Jump:
+                pc = instruction.operand;
+                break;
+            case Op::JumpIfFalse:
+            case Op::JumpIfTrue:
+                if (a.type != RegisterType::Boolean) return nullptr;
+                if (a.boolean == (instruction.op == Op::JumpIfTrue)) {
+                    pc = instruction.operand;
+                }
+                break;
+            case Op::JumpIfNotNull:
+                if (a.type != RegisterType::Null) {
+                    pc = instruction.operand;
+                }
+                break;
+            case Op::JumpIfType:
+                if (a.type == static_cast<RegisterType>(instruction.b)) {
+                    pc = instruction.operand;
+                }
+                break;
+            case Op::AssertType:
+                if (a.type != static_cast<RegisterType>(instruction.b)) return nullptr;
+                break;
+            case Op::MatchString: {
+                const StringMatch& match = stringMatches[instruction.operand];
+                pc = match.otherwise;
+                if (a.type == RegisterType::String) {
+                    if (const auto it = match.targets.find(a.string); it != match.targets.end()) {
+                        pc = it->second;
+                    }
+                }
+                break;
+            }
+            case Op::MatchNumber: {
+                const NumberMatch& match = numberMatches[instruction.operand];
+                pc = match.otherwise;
+                if (a.type == RegisterType::Number) {
+                    const auto rounded = static_cast<int64_t>(std::floor(a.number));
+                    if (a.number == static_cast<double>(rounded)) {
+                        if (const auto it = match.targets.find(rounded); it != match.targets.end()) {
+                            pc = it->second;
+                        }
+                    }
+                }
+                break;
+            }
+            case Op::StepConstant:
+            case Op::Step:
+            case Op::InterpolateConstant:
+            case Op::Interpolate: {
+                // The input is narrowed to a float, as the tree does
+                if (a.type != RegisterType::Number) return nullptr;
+                const auto x = static_cast<float>(a.number);
+                const Curve& curve = curves[instruction.operand];
+                if (std::isnan(x) || curve.inputs.empty()) return nullptr;
+
+                const auto upper = static_cast<std::size_t>(
+                    std::upper_bound(curve.inputs.begin(), curve.inputs.end(), static_cast<double>(x)) -
+                    curve.inputs.begin());
+                std::size_t stop = upper == 0 ? 0 : upper - 1;
+
+                if (instruction.op == Op::StepConstant) {
+                    dst = curve.outputs[stop];
+                    break;
+                }
+                if (instruction.op == Op::Step) {
+                    pc = curve.stops[stop];
+                    break;
+                }
+
+                // Between two stops, unless the factor lands on one of them
+                std::optional<double> t;
+                if (upper != 0 && upper != curve.inputs.size()) {
+                    const Range<double> range{curve.inputs[upper - 1], curve.inputs[upper]};
+                    const double factor = curve.interpolator->match(
+                        [&](const auto& interpolator) { return interpolator.interpolationFactor(range, x); });
+                    if (factor == 1.0) {
+                        stop = upper;
+                    } else if (factor != 0.0) {
+                        t = factor;
+                    }
+                }
+
+                if (instruction.op == Op::InterpolateConstant) {
+                    if (!t) {
+                        dst = curve.outputs[stop];
+                    } else if (!Frame::lerp(curve.outputs[stop], curve.outputs[stop + 1], *t, dst)) {
+                        return nullptr;
+                    }
+                } else if (!t) {
+                    pc = curve.stops[stop];
+                } else {
+                    Frame::setNumber(registers[instruction.b], *t);
+                    pc = curve.segments[stop];
+                }
+                break;
+            }
+            case Op::Lerp: {
+                const Register& factor = registers[instruction.operand];
+                if (!Frame::lerp(a, b, factor.number, dst)) return nullptr;
+                break;
+            }
+        }
+    }
+    return &registers[0];
+}
+
+} // namespace expression
+} // namespace style
+} // namespace mln
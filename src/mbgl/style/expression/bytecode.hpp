@@ -0,0 +1,150 @@
+#pragma once
+
+#include <mbgl/style/expression/expression.hpp>
+#include <mbgl/style/expression/interpolator.hpp>
+#include <mbgl/util/color.hpp>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace mln {
+
+class CanonicalTileID;
+
+namespace style {
+namespace expression {
+
+/**
+ * An expression compiled into instructions over a fixed set of registers, as an alternative to
+ * evaluating the expression tree.
+ *
+ * Registers hold null, booleans, numbers, strings and colors without allocating: strings point into
+ * the constants of the program, or into the feature property or subexpression result they come from.
+ * Subexpressions which don't depend on the feature, the zoom level or the available images are folded
+ * into constants. Kinds of subexpressions the compiler doesn't handle are evaluated as trees, and their
+ * results loaded into registers.
+ *
+ * Whenever the tree would produce an error, or a value registers can't hold, the program gives up and
+ * the caller evaluates the tree instead, so results and error messages are exactly the tree's.
+ */
+class Bytecode {
+public:
+    /// Compiles the expression. Returns null when the program couldn't do better than evaluating the
+    /// tree: when the expression doesn't produce a scalar, or needs more registers than a frame has.
+    static std::unique_ptr<const Bytecode> compile(const Expression&);
+
+    Bytecode(const Bytecode&) = delete;
+    Bytecode& operator=(const Bytecode&) = delete;
+    ~Bytecode();
+
+    /// The result of the expression, or nothing when the tree has to be evaluated instead
+    std::optional<Value> evaluate(const EvaluationContext&) const;
+
+    /// Same as `Expression::evaluate()` for a GeoJSON feature, optionally in the given tile
+    std::optional<Value> evaluate(std::optional<float> zoom,
+                                  const Feature&,
+                                  std::optional<double> colorRampParameter,
+                                  const std::set<std::string>& availableImages,
+                                  const CanonicalTileID* canonical) const;
+
+    /// The number result of the expression, without going through a `Value`
+    std::optional<double> evaluateNumber(const EvaluationContext&) const;
+
+    /// The color result of the expression, without going through a `Value`
+    std::optional<Color> evaluateColor(const EvaluationContext&) const;
+
+    std::size_t getInstructionCount() const noexcept { return instructions.size(); }
+
+    /// The number of subexpressions evaluated as trees
+    std::size_t getTreeCount() const noexcept { return trees.size(); }
+
+private:
+    enum class Op : uint8_t;
+
+    struct Instruction {
+        Op op;
+        uint8_t dst;
+        uint8_t a;
+        uint8_t b;
+        // A constant, property key, tree, table or jump target, depending on the operation
+        uint32_t operand;
+    };
+
+    enum class RegisterType : uint8_t {
+        Null,
+        Boolean,
+        Number,
+        String,
+        Color
+    };
+
+    // Registers start out null, and their value is only read for the type they hold
+    struct Register {
+        RegisterType type = RegisterType::Null;
+        union {
+            bool boolean = false;
+            double number;
+            std::string_view string;
+            Color color;
+        };
+    };
+
+    struct StringHash {
+        using is_transparent = void;
+        std::size_t operator()(std::string_view string) const noexcept {
+            return std::hash<std::string_view>()(string);
+        }
+    };
+
+    /// Jump targets of a `match` expression by label
+    struct StringMatch {
+        std::unordered_map<std::string, uint32_t, StringHash, std::equal_to<>> targets;
+        uint32_t otherwise = 0;
+    };
+
+    struct NumberMatch {
+        std::unordered_map<int64_t, uint32_t> targets;
+        uint32_t otherwise = 0;
+    };
+
+    /// The stops of a `step` or `interpolate` expression, with either their constant outputs, or jump
+    /// targets to the code evaluating them
+    struct Curve {
+        std::vector<double> inputs;
+        std::vector<Register> outputs;
+        // The code evaluating the output of each stop
+        std::vector<uint32_t> stops;
+        // The code interpolating between each pair of consecutive stops
+        std::vector<uint32_t> segments;
+        std::optional<Interpolator> interpolator;
+    };
+
+    struct Frame;
+    class Compiler;
+
+    Bytecode() = default;
+
+    const Register* run(const EvaluationContext&, Frame&) const;
+
+    std::vector<Instruction> instructions;
+    std::vector<Register> constants;
+    // Keeps the strings constant registers point to
+    std::deque<std::string> strings;
+    std::vector<std::string> keys;
+    std::vector<const Expression*> trees;
+    std::vector<StringMatch> stringMatches;
+    std::vector<NumberMatch> numberMatches;
+    std::vector<Curve> curves;
+};
+
+} // namespace expression
+} // namespace style
+} // namespace mln
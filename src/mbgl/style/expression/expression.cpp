@@ -1,5 +1,6 @@
 #include <mbgl/style/expression/compound_expression.hpp>
 #include <mbgl/style/expression/expression.hpp>
+#include <mbgl/style/expression/geojson_feature.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 
 #include <sstream>
@@ -47,43 +48,6 @@ std::string toString(const style::expression::Dependency deps) {
 namespace style {
 namespace expression {
 
-class GeoJSONFeature : public GeometryTileFeature {
-public:
-    const Feature& feature;
-    mutable std::optional<GeometryCollection> geometry;
-
-    explicit GeoJSONFeature(const Feature& feature_)
-        : feature(feature_) {}
-    GeoJSONFeature(const Feature& feature_, const CanonicalTileID& canonical)
-        : feature(feature_) {
-        geometry = convertGeometry(feature.geometry, canonical);
-        // https://github.com/mapbox/geojson-vt-cpp/issues/44
-        if (getTypeImpl() == FeatureType::Polygon) {
-            geometry = fixupPolygons(*geometry);
-        }
-    }
-
-    FeatureType getType() const override { return getTypeImpl(); }
-
-    const PropertyMap& getProperties() const override { return feature.properties; }
-    FeatureIdentifier getID() const override { return feature.id; }
-    std::optional<mln::Value> getValue(const std::string& key) const override {
-        auto it = feature.properties.find(key);
-        if (it != feature.properties.end()) {
-            return std::optional<mln::Value>(it->second);
-        }
-        return std::optional<mln::Value>();
-    }
-    const GeometryCollection& getGeometries() const override {
-        if (geometry) return *geometry;
-        geometry = GeometryCollection();
-        return *geometry;
-    }
-
-private:
-    FeatureType getTypeImpl() const { return apply_visitor(ToFeatureType(), feature.geometry); }
-};
-
 EvaluationResult Expression::evaluate(std::optional<float> zoom,
                                       const Feature& feature,
                                       std::optional<double> colorRampParameter) const {
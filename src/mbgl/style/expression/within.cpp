@@ -7,6 +7,7 @@
 
 #include <mbgl/util/geometry_util.hpp>
 #include <mbgl/util/logging.hpp>
+#include <mbgl/util/polygon_index.hpp>
 #include <mbgl/util/string.hpp>
 
 #include <rapidjson/document.h>
@@ -146,10 +147,8 @@ MultiLineString<int64_t> getTileLines(const GeometryCollection& lines,
 
 bool featureWithinPolygons(const GeometryTileFeature& feature,
                            const CanonicalTileID& canonical,
-                           const Feature::geometry_type& polygonGeoSet) {
-    WithinBBox polyBBox = DefaultWithinBBox;
-    const auto polygons = getTilePolygons(polygonGeoSet, canonical, polyBBox);
-    assert(!polygons.empty());
+                           const PolygonIndex& polygons) {
+    const WithinBBox& polyBBox = polygons.getBBox();
     const GeometryCollection& geometries = feature.getGeometries();
     switch (feature.getType()) {
         case FeatureType::Point: {
@@ -158,9 +157,8 @@ bool featureWithinPolygons(const GeometryTileFeature& feature,
             MultiPoint<int64_t> points = getTilePoints(geometries.at(0), canonical, pointBBox, polyBBox);
             if (!boxWithinBox(pointBBox, polyBBox)) return false;
 
-            return std::all_of(points.begin(), points.end(), [&polygons](const auto& p) {
-                return pointWithinPolygons<int64_t>(p, polygons);
-            });
+            return std::all_of(
+                points.begin(), points.end(), [&polygons](const auto& p) { return polygons.contains(p); });
         }
         case FeatureType::LineString: {
             WithinBBox lineBBox = DefaultWithinBBox;
@@ -168,7 +166,7 @@ bool featureWithinPolygons(const GeometryTileFeature& feature,
             if (!boxWithinBox(lineBBox, polyBBox)) return false;
 
             return std::all_of(multiLineString.begin(), multiLineString.end(), [&polygons](const auto& line) {
-                return lineStringWithinPolygons<int64_t>(line, polygons);
+                return polygons.contains(line);
             });
         }
         default:
@@ -225,7 +223,7 @@ EvaluationResult Within::evaluate(const EvaluationContext& params) const {
     auto geometryType = params.feature->getType();
     // Currently only support Point and LineString types in Polygon/Polygons
     if (geometryType == FeatureType::Point || geometryType == FeatureType::LineString) {
-        return featureWithinPolygons(*params.feature, *params.canonical, geometries);
+        return featureWithinPolygons(*params.feature, *params.canonical, getPolygonIndex(params.canonical->z));
     }
     mln::Log::Warning(mln::Event::General,
                       "within expression currently only support Point/LineString geometry "
@@ -234,6 +232,19 @@ EvaluationResult Within::evaluate(const EvaluationContext& params) const {
     return false;
 }
 
+const PolygonIndex& Within::getPolygonIndex(const uint8_t z) const {
+    // Tiles are parsed on several threads at once
+    assert(z < polygonIndexes.size());
+    auto& slot = polygonIndexes[z];
+    std::call_once(slot.once, [&] {
+        WithinBBox bbox = DefaultWithinBBox;
+        const CanonicalTileID canonical(z, 0, 0);
+        slot.index = std::make_unique<const PolygonIndex>(getTilePolygons(geometries, canonical, bbox));
+        assert(slot.index->getBBox() == bbox);
+    });
+    return *slot.index;
+}
+
 ParseResult Within::parse(const Convertible& value, ParsingContext& ctx) {
     if (isArray(value)) {
         // object value, quoted with ["within", value]
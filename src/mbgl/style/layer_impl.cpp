@@ -9,5 +9,10 @@ Layer::Impl::Impl(std::string layerID, std::string sourceID)
 
 void Layer::Impl::populateFontStack(std::set<FontStack>&) const {}
 
+const BatchFilter& Layer::Impl::getBatchFilter() const {
+    std::call_once(batchFilter.compiled, [&] { batchFilter.filter = std::make_unique<const BatchFilter>(filter); });
+    return *batchFilter.filter;
+}
+
 } // namespace style
 } // namespace mln
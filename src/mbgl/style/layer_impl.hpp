@@ -3,12 +3,14 @@
 #include <mbgl/style/layer.hpp>
 #include <mbgl/style/types.hpp>
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/batch_filter.hpp>
 
 #include <rapidjson/writer.h>
 #include <rapidjson/stringbuffer.h>
 
 #include <limits>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -51,6 +53,10 @@ public:
     /// Collect the style dependencies for this layer
     virtual expression::Dependency getDependencies() const noexcept { return expression::Dependency::None; }
 
+    /// The filter compiled for evaluation over whole tile layers. It is compiled on first use and shared by all the
+    /// tiles parsed with this Impl.
+    const BatchFilter& getBatchFilter() const;
+
     std::string id;
     std::string source;
     std::string sourceLayer;
@@ -61,6 +67,17 @@ public:
 
 protected:
     Impl(const Impl&) = default;
+
+private:
+    // Copies are made to change the layer, possibly its filter, so they compile their own
+    struct CompiledFilter {
+        CompiledFilter() = default;
+        CompiledFilter(const CompiledFilter&) {}
+
+        std::once_flag compiled;
+        std::unique_ptr<const BatchFilter> filter;
+    };
+    mutable CompiledFilter batchFilter;
 };
 
 // To be used in the inherited classes.
@@ -1,6 +1,8 @@
 #include <mbgl/style/property_expression.hpp>
 
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/paint_property_binder.hpp>
+#include <mbgl/style/expression/bytecode.hpp>
 #include <mbgl/util/convert.hpp>
 
 #include <mbgl/gfx/gpu_expression.hpp>
@@ -15,6 +17,12 @@ bool checkGPUCapable(const Expression& expression, const ZoomCurvePtr& zoomCurve
     return (expression.dependencies == Dependency::Zoom) && !zoomCurve.is<std::nullptr_t>() &&
            (expression.getType().is<type::NumberType>() || expression.getType().is<type::ColorType>());
 }
+
+bool bytecodeEnabled() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_EXPRESSION_BYTECODE);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
 } // namespace
 
 PropertyExpressionBase::PropertyExpressionBase(std::unique_ptr<expression::Expression> expression_)
@@ -28,10 +36,16 @@ PropertyExpressionBase::PropertyExpressionBase(std::unique_ptr<expression::Expre
     assert(isZoomConstant_ == expression::isZoomConstant(*expression));
     assert(isFeatureConstant_ == expression::isFeatureConstant(*expression));
     assert(isRuntimeConstant_ == expression::isRuntimeConstant(*expression));
+
+    // Data-driven expressions are evaluated once per feature
+    if (!isFeatureConstant_ && bytecodeEnabled()) {
+        bytecode = expression::Bytecode::compile(*expression);
+    }
 }
 
 PropertyExpressionBase::PropertyExpressionBase(PropertyExpressionBase&& other)
     : expression(std::move(other.expression)),
+      bytecode(std::move(other.bytecode)),
       zoomCurve(std::move(other.zoomCurve)),
       useIntegerZoom_(other.useIntegerZoom_),
       isZoomConstant_(other.isZoomConstant_),
@@ -41,6 +55,7 @@ PropertyExpressionBase::PropertyExpressionBase(PropertyExpressionBase&& other)
 
 PropertyExpressionBase::PropertyExpressionBase(const PropertyExpressionBase& other)
     : expression(other.expression),
+      bytecode(other.bytecode),
       zoomCurve(other.zoomCurve),
       useIntegerZoom_(other.useIntegerZoom_),
       isZoomConstant_(other.isZoomConstant_),
@@ -50,6 +65,7 @@ PropertyExpressionBase::PropertyExpressionBase(const PropertyExpressionBase& oth
 
 PropertyExpressionBase& PropertyExpressionBase::operator=(PropertyExpressionBase&& other) {
     expression = std::move(other.expression);
+    bytecode = std::move(other.bytecode);
     zoomCurve = other.zoomCurve;
     useIntegerZoom_ = other.useIntegerZoom_;
     isZoomConstant_ = other.isZoomConstant_;
@@ -61,6 +77,7 @@ PropertyExpressionBase& PropertyExpressionBase::operator=(PropertyExpressionBase
 
 PropertyExpressionBase& PropertyExpressionBase::operator=(const PropertyExpressionBase& other) {
     expression = other.expression;
+    bytecode = other.bytecode;
     zoomCurve = other.zoomCurve;
     useIntegerZoom_ = other.useIntegerZoom_;
     isZoomConstant_ = other.isZoomConstant_;
@@ -105,5 +122,17 @@ std::shared_ptr<const expression::Expression> PropertyExpressionBase::getSharedE
     return expression;
 }
 
+std::optional<double> PropertyExpressionBase::evaluateBytecodeNumber(const EvaluationContext& context) const {
+    return bytecode ? bytecode->evaluateNumber(context) : std::nullopt;
+}
+
+std::optional<Color> PropertyExpressionBase::evaluateBytecodeColor(const EvaluationContext& context) const {
+    return bytecode ? bytecode->evaluateColor(context) : std::nullopt;
+}
+
+std::optional<expression::Value> PropertyExpressionBase::evaluateBytecode(const EvaluationContext& context) const {
+    return bytecode ? bytecode->evaluate(context) : std::nullopt;
+}
+
 } // namespace style
 } // namespace mln
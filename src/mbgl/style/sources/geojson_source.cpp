@@ -1,3 +1,4 @@
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/file_source.hpp>
 #include <mbgl/style/conversion/geojson.hpp>
 #include <mbgl/style/conversion/json.hpp>
@@ -5,15 +6,32 @@
 #include <mbgl/style/source_observer.hpp>
 #include <mbgl/style/sources/geojson_source.hpp>
 #include <mbgl/style/sources/geojson_source_impl.hpp>
+#include <mbgl/style/sources/geojson_stream_reader.hpp>
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/util/async_request.hpp>
 #include <mbgl/util/logging.hpp>
 #include <mbgl/util/thread_pool.hpp>
 #include <mbgl/util/identity.hpp>
 
+#include <algorithm>
+
 namespace mln {
 namespace style {
 
+namespace {
+
+// The features read by each task, and the first count of features shown while streaming, which doubles after
+constexpr std::size_t streamChunkSize = 16384;
+constexpr std::size_t streamFirstPublishCount = 65536;
+
+bool streamingEnabled() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_GEOJSON_STREAMING);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+
+} // namespace
+
 // static
 Immutable<GeoJSONOptions> GeoJSONOptions::defaultOptions() {
     static Immutable<GeoJSONOptions> options = makeMutable<GeoJSONOptions>();
@@ -42,6 +60,7 @@ void GeoJSONSource::setURL(const std::string& url_) {
     if (loaded || req) {
         loaded = false;
         req.reset();
+        ++requestGeneration;
         observer->onSourceDescriptionChanged(*this);
     }
 }
@@ -52,10 +71,22 @@ void GeoJSONSource::setGeoJSON(const mapbox::geojson::geojson& geoJSON) {
 
 void GeoJSONSource::setGeoJSONData(std::shared_ptr<GeoJSONData> geoJSONData) {
     req.reset();
+    // Data loaded or streamed from the URL must not replace this
+    ++requestGeneration;
     baseImpl = makeMutable<Impl>(impl(), std::move(geoJSONData));
     observer->onSourceChanged(*this);
 }
 
+void GeoJSONSource::updateGeoJSON(const GeoJSONDiff& diff) {
+    const auto data = impl().getData().lock();
+    auto updated = data ? data->update(diff) : nullptr;
+    if (!updated) {
+        Log::Warning(Event::General, "GeoJSON source '" + getID() + "' can't be updated, its data is left as is");
+        return;
+    }
+    setGeoJSONData(std::move(updated));
+}
+
 std::optional<std::string> GeoJSONSource::getURL() const {
     return url;
 }
@@ -81,6 +112,10 @@ void GeoJSONSource::loadDescription(FileSource& fileSource) {
             return;
         } else if (res.noContent) {
             observer->onSourceError(*this, std::make_exception_ptr(std::runtime_error("unexpectedly empty GeoJSON")));
+        } else if (streamingEnabled()) {
+            readGeoJSONStream(std::make_shared<GeoJSONStreamReader>(res.data),
+                              ++requestGeneration,
+                              streamFirstPublishCount);
         } else {
             // Note: This task appears to be safe enough to schedule on the generic background queue.
             // This task does not reference other objects who's lifetimes are coupled with a map.
@@ -120,6 +155,70 @@ void GeoJSONSource::loadDescription(FileSource& fileSource) {
     });
 }
 
+void GeoJSONSource::readGeoJSONStream(std::shared_ptr<GeoJSONStreamReader> reader,
+                                      uint64_t generation,
+                                      std::size_t publishCount) {
+    using StreamResult = std::optional<Immutable<Source::Impl>>;
+    Scheduler::GetBackground()->scheduleAndReplyValue(
+        util::SimpleIdentity::Empty,
+        /* readChunkInBackground */
+        [currentImpl = baseImpl, reader, publishCount, seqScheduler{sequencedScheduler}]() -> StreamResult {
+            auto& current = static_cast<const Impl&>(*currentImpl);
+            if (!reader->read(streamChunkSize)) {
+                // Publish an empty source, as with the whole document, so that tiles don't wait for data
+                Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: " + *reader->getError());
+                return makeMutable<Impl>(current, nullptr);
+            }
+
+            if (reader->isDone() && !reader->isFeatureCollection()) {
+                // A single feature or geometry, which is small enough to be parsed the usual way
+                conversion::Error error;
+                std::shared_ptr<GeoJSONData> geoJSONData;
+                if (auto geoJSON = conversion::convertJSON<GeoJSON>(*reader->getData(), error)) {
+                    geoJSONData = GeoJSONData::create(*geoJSON, std::move(seqScheduler), current.getOptions());
+                } else {
+                    Log::Error(Event::ParseStyle, "Failed to parse GeoJSON data: " + error.message);
+                }
+                return makeMutable<Impl>(current, std::move(geoJSONData));
+            }
+
+            auto& features = reader->getFeatures();
+            if (!reader->isDone() && (!reader->isFeatureCollection() || features.size() < publishCount)) {
+                return std::nullopt;
+            }
+
+            // The data copies the features it indexes, so they are lent to it rather than copied here
+            GeoJSON geoJSON{std::move(features)};
+            auto geoJSONData = GeoJSONData::create(geoJSON, std::move(seqScheduler), current.getOptions());
+            features = std::move(geoJSON.get<FeatureCollection>());
+            return makeMutable<Impl>(current, std::move(geoJSONData));
+        },
+        /* onChunkRead */
+        [this, self = makeWeakPtr(), reader, generation, publishCount](StreamResult newImpl) {
+            auto guard = self.lock();
+            if (!self || generation != requestGeneration) {
+                // The source is gone, or a new request is being processed
+                return;
+            }
+
+            auto nextPublishCount = publishCount;
+            if (newImpl) {
+                baseImpl = std::move(*newImpl);
+                if (!loaded) {
+                    loaded = true;
+                    observer->onSourceLoaded(*this);
+                } else {
+                    observer->onSourceChanged(*this);
+                }
+                nextPublishCount = std::max(publishCount, reader->getFeatures().size()) * 2;
+            }
+
+            if (!reader->isDone()) {
+                readGeoJSONStream(reader, generation, nextPublishCount);
+            }
+        });
+}
+
 bool GeoJSONSource::supportsLayerType(const mln::style::LayerTypeInfo* info) const {
     return mln::underlying_type(Tile::Kind::Geometry) == mln::underlying_type(info->tileKind);
 }
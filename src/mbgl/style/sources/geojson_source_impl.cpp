@@ -18,11 +18,122 @@
 #pragma warning(pop)
 #endif
 
+#include <mapbox/geometry/for_each_point.hpp>
+
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <iterator>
+#include <numbers>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
 
 namespace mln {
 namespace style {
 
+namespace {
+
+// Data which can be updated splits its features by where they are into the tiles of this zoom level, and indexes
+// the features of each of these parts of its own
+constexpr uint8_t partZoom = 5;
+constexpr uint32_t partsPerSide = 1u << partZoom;
+// The locations of the features by identifier are kept in this many maps, which updates copy where they change them
+constexpr std::size_t locationMapCount = 1024;
+
+using Box = mapbox::geometry::box<double>;
+using Features = GeoJSONData::Features;
+using LocationMap = std::unordered_map<std::string, uint32_t>;
+
+// The bounds of the feature in world coordinates from 0 to 1, as geojson-vt projects them
+std::optional<Box> projectedBounds(const GeoJSONFeature& feature) {
+    std::optional<Box> bounds;
+    mapbox::geometry::for_each_point(feature.geometry, [&](const mapbox::geometry::point<double>& point) {
+        const double sine = std::sin(point.y * std::numbers::pi / 180);
+        const double y = 0.5 - 0.25 * std::log((1 + sine) / (1 - sine)) / std::numbers::pi;
+        const mapbox::geometry::point<double> projected{point.x / 360 + 0.5, std::clamp(y, 0.0, 1.0)};
+        if (!bounds) {
+            bounds = Box{projected, projected};
+        } else {
+            bounds->min = {std::min(bounds->min.x, projected.x), std::min(bounds->min.y, projected.y)};
+            bounds->max = {std::max(bounds->max.x, projected.x), std::max(bounds->max.y, projected.y)};
+        }
+    });
+    return bounds;
+}
+
+// The part the feature is indexed in, which is the one its center is in
+uint32_t partOf(const std::optional<Box>& bounds) {
+    if (!bounds) {
+        return 0;
+    }
+    const auto cell = [](double position) {
+        return std::min(static_cast<uint32_t>(std::clamp(position, 0.0, 1.0) * partsPerSide), partsPerSide - 1);
+    };
+    return cell((bounds->min.y + bounds->max.y) / 2) * partsPerSide + cell((bounds->min.x + bounds->max.x) / 2);
+}
+
+// Whether features within the bounds may be in the tile, including its buffer and the copies of the features
+// geojson-vt wraps around the antimeridian
+bool intersects(const Box& bounds, const CanonicalTileID& id, double buffer) {
+    const double size = std::ldexp(1.0, -static_cast<int>(id.z));
+    if (bounds.max.y < (id.y - buffer) * size || bounds.min.y > (id.y + 1 + buffer) * size) {
+        return false;
+    }
+    for (const double wrap : {-1.0, 0.0, 1.0}) {
+        if (bounds.max.x >= (id.x - buffer) * size + wrap && bounds.min.x <= (id.x + 1 + buffer) * size + wrap) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The features the diff adds, where later features with the same identifiers replace earlier ones
+std::vector<const GeoJSONFeature*> addedFeatures(const GeoJSONDiff& diff) {
+    std::unordered_map<std::string, std::size_t> indexes;
+    std::vector<const GeoJSONFeature*> added;
+    for (const auto& feature : diff.update) {
+        if (const auto key = featureIDtoString(feature.id)) {
+            if (const auto [it, inserted] = indexes.emplace(*key, added.size()); !inserted) {
+                added[it->second] = &feature;
+                continue;
+            }
+        }
+        added.push_back(&feature);
+    }
+    return added;
+}
+
+// Applies the diff to the features, which are left in their order, followed by the added ones
+Features applyDiff(const Features& features, const GeoJSONDiff& diff) {
+    const auto added = addedFeatures(diff);
+    std::unordered_set<std::string> keys;
+    for (const auto& id : diff.remove) {
+        if (auto key = featureIDtoString(id)) {
+            keys.insert(std::move(*key));
+        }
+    }
+    for (const auto* feature : added) {
+        if (auto key = featureIDtoString(feature->id)) {
+            keys.insert(std::move(*key));
+        }
+    }
+
+    Features result;
+    result.reserve(features.size() + added.size());
+    for (const auto& feature : features) {
+        if (const auto key = featureIDtoString(feature.id); !key || !keys.contains(*key)) {
+            result.push_back(feature);
+        }
+    }
+    for (const auto* feature : added) {
+        result.push_back(*feature);
+    }
+    return result;
+}
+
+} // namespace
+
 class GeoJSONVTData final : public GeoJSONData {
     void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn, bool runSynchronously) final {
         assert(fn);
@@ -57,26 +168,223 @@ class GeoJSONVTData final : public GeoJSONData {
     std::shared_ptr<Scheduler> sequencedScheduler;
 };
 
+/// The features of a part of the world, and their index
+struct GeoJSONVTPart {
+    explicit GeoJSONVTPart(Features features_, const mapbox::geojsonvt::Options& options)
+        : features(std::move(features_)) {
+        for (const auto& feature : features) {
+            if (const auto featureBounds = projectedBounds(feature)) {
+                bounds = bounds ? Box{{std::min(bounds->min.x, featureBounds->min.x),
+                                       std::min(bounds->min.y, featureBounds->min.y)},
+                                      {std::max(bounds->max.x, featureBounds->max.x),
+                                       std::max(bounds->max.y, featureBounds->max.y)}}
+                                : *featureBounds;
+            }
+        }
+        if (!features.empty()) {
+            index = std::make_shared<mapbox::geojsonvt::GeoJSONVT>(features, options);
+        }
+    }
+
+    const Features features;
+    std::optional<Box> bounds;
+    std::shared_ptr<mapbox::geojsonvt::GeoJSONVT> index; // Accessed on worker thread.
+};
+
+/// Tiles a feature collection split into parts by where the features are, so that updates only tile anew the parts
+/// with features that changed. Parts are shared with the data updated from this one, and read on the sequenced
+/// scheduler like the index of `GeoJSONVTData`.
+class UpdatableGeoJSONVTData final : public GeoJSONData {
+public:
+    UpdatableGeoJSONVTData(const Features& features,
+                           const mapbox::geojsonvt::Options& options_,
+                           double buffer_,
+                           std::shared_ptr<Scheduler> sequencedScheduler_)
+        : options(options_),
+          buffer(buffer_),
+          sequencedScheduler(std::move(sequencedScheduler_)) {
+        assert(sequencedScheduler);
+        std::vector<Features> partFeatures(parts.size());
+        for (std::size_t i = 0; i < locations.size(); ++i) {
+            locations[i] = std::make_shared<LocationMap>();
+        }
+        for (const auto& feature : features) {
+            const auto part = partOf(projectedBounds(feature));
+            partFeatures[part].push_back(feature);
+            if (auto key = featureIDtoString(feature.id)) {
+                auto& map = locationMap(*key);
+                map.insert_or_assign(std::move(*key), part);
+            }
+        }
+        for (std::size_t i = 0; i < parts.size(); ++i) {
+            parts[i] = std::make_shared<const GeoJSONVTPart>(std::move(partFeatures[i]), options);
+        }
+    }
+
+    void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn, bool runSynchronously) final {
+        assert(fn);
+        std::vector<std::shared_ptr<mapbox::geojsonvt::GeoJSONVT>> indexes;
+        for (const auto& part : parts) {
+            if (part->bounds && intersects(*part->bounds, id, buffer)) {
+                indexes.push_back(part->index);
+            }
+        }
+
+        auto getFeatures = [id, indexes = std::move(indexes)]() -> TileFeatures {
+            TileFeatures result;
+            for (const auto& index : indexes) {
+                const auto& features = index->getTile(id.z, id.x, id.y).features;
+                result.insert(result.end(), features.begin(), features.end());
+            }
+            return result;
+        };
+        if (runSynchronously) {
+            fn(getFeatures());
+        } else {
+            sequencedScheduler->scheduleAndReplyValue(util::SimpleIdentity::Empty, std::move(getFeatures), fn);
+        }
+    }
+
+    Features getChildren(const std::uint32_t) final { return {}; }
+
+    Features getLeaves(const std::uint32_t, const std::uint32_t, const std::uint32_t) final { return {}; }
+
+    std::uint8_t getClusterExpansionZoom(std::uint32_t) final { return 0; }
+
+    std::shared_ptr<GeoJSONData> update(const GeoJSONDiff& diff) const final {
+        auto result = std::make_shared<UpdatableGeoJSONVTData>(*this);
+        result->updatedFrom = this;
+        result->changed.clear();
+
+        // The features each changed part gains, and the identifiers of the features it loses
+        std::unordered_map<uint32_t, Features> added;
+        std::unordered_map<uint32_t, std::unordered_set<std::string>> removed;
+        std::unordered_set<std::size_t> copiedMaps;
+        const auto remove = [&](const std::string& key) -> LocationMap& {
+            const auto mapIndex = std::hash<std::string>()(key) % locationMapCount;
+            if (copiedMaps.insert(mapIndex).second) {
+                result->locations[mapIndex] = std::make_shared<LocationMap>(*locations[mapIndex]);
+            }
+            auto& map = *result->locations[mapIndex];
+            if (const auto it = map.find(key); it != map.end()) {
+                removed[it->second].insert(key);
+                map.erase(it);
+            }
+            return map;
+        };
+
+        for (const auto& id : diff.remove) {
+            if (const auto key = featureIDtoString(id)) {
+                remove(*key);
+            }
+        }
+        for (const auto* feature : addedFeatures(diff)) {
+            const auto bounds = projectedBounds(*feature);
+            const auto part = partOf(bounds);
+            if (auto key = featureIDtoString(feature->id)) {
+                remove(*key).insert_or_assign(std::move(*key), part);
+            }
+            if (bounds) {
+                result->changed.push_back(*bounds);
+            }
+            added[part].push_back(*feature);
+        }
+
+        std::unordered_set<uint32_t> changedParts;
+        for (const auto& pair : added) {
+            changedParts.insert(pair.first);
+        }
+        for (const auto& pair : removed) {
+            changedParts.insert(pair.first);
+        }
+        for (const auto part : changedParts) {
+            const auto& keys = removed[part];
+            Features features;
+            for (const auto& feature : parts[part]->features) {
+                if (!keys.empty()) {
+                    if (const auto key = featureIDtoString(feature.id); key && keys.contains(*key)) {
+                        if (const auto bounds = projectedBounds(feature)) {
+                            result->changed.push_back(*bounds);
+                        }
+                        continue;
+                    }
+                }
+                features.push_back(feature);
+            }
+            auto& partAdded = added[part];
+            std::move(partAdded.begin(), partAdded.end(), std::back_inserter(features));
+            result->parts[part] = std::make_shared<const GeoJSONVTPart>(std::move(features), options);
+        }
+        return result;
+    }
+
+    bool isTileChanged(const CanonicalTileID& id, const GeoJSONData& previous) const final {
+        if (&previous != updatedFrom) {
+            return true;
+        }
+        return std::ranges::any_of(changed, [&](const Box& bounds) { return intersects(bounds, id, buffer); });
+    }
+
+private:
+    LocationMap& locationMap(const std::string& key) {
+        return *locations[std::hash<std::string>()(key) % locationMapCount];
+    }
+
+    std::array<std::shared_ptr<const GeoJSONVTPart>, std::size_t(partsPerSide) * partsPerSide> parts;
+    // The parts of the features with identifiers
+    std::array<std::shared_ptr<LocationMap>, locationMapCount> locations;
+
+    mapbox::geojsonvt::Options options;
+    // The buffer of the tiles, in tiles
+    double buffer;
+    std::shared_ptr<Scheduler> sequencedScheduler;
+
+    // The data this data was updated from, which is only compared with, and the bounds of the features the update
+    // added or removed
+    const GeoJSONData* updatedFrom = nullptr;
+    std::vector<Box> changed;
+};
+
+/// Clusters the features of a collection. A collection without features has no index, as Supercluster can't index
+/// one, but stays cluster data, so that features added by updates are clustered.
 class SuperclusterData final : public GeoJSONData {
     void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn, bool) final {
         assert(fn);
-        fn(impl.getTile(id.z, id.x, id.y));
+        fn(impl ? impl->getTile(id.z, id.x, id.y) : TileFeatures{});
     }
 
-    Features getChildren(const std::uint32_t cluster_id) final { return impl.getChildren(cluster_id); }
+    Features getChildren(const std::uint32_t cluster_id) final {
+        return impl ? impl->getChildren(cluster_id) : Features{};
+    }
 
     Features getLeaves(const std::uint32_t cluster_id, const std::uint32_t limit, const std::uint32_t offset) final {
-        return impl.getLeaves(cluster_id, limit, offset);
+        return impl ? impl->getLeaves(cluster_id, limit, offset) : Features{};
     }
 
     std::uint8_t getClusterExpansionZoom(std::uint32_t cluster_id) final {
-        return impl.getClusterExpansionZoom(cluster_id);
+        return impl ? impl->getClusterExpansionZoom(cluster_id) : 0;
+    }
+
+    std::shared_ptr<GeoJSONData> update(const GeoJSONDiff& diff) const final {
+        if (!updatable) {
+            return nullptr;
+        }
+        // Clusters may change anywhere, so the features, which the index keeps, are clustered anew
+        return std::shared_ptr<GeoJSONData>(
+            new SuperclusterData(applyDiff(impl ? impl->features : Features{}, diff), options, true));
     }
 
     friend GeoJSONData;
-    SuperclusterData(const Features& features, const mapbox::supercluster::Options& options)
-        : impl(features, options) {}
-    mapbox::supercluster::Supercluster impl;
+    SuperclusterData(const Features& features_, const mapbox::supercluster::Options& options_, bool updatable_)
+        : options(options_),
+          updatable(updatable_) {
+        if (!features_.empty()) {
+            impl.emplace(features_, options_);
+        }
+    }
+    std::optional<mapbox::supercluster::Supercluster> impl;
+    mapbox::supercluster::Options options;
+    bool updatable;
 };
 
 template <class T>
@@ -98,7 +406,7 @@ std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
                                                  std::shared_ptr<Scheduler> sequencedScheduler,
                                                  const Immutable<GeoJSONOptions>& options) {
     constexpr double scale = util::EXTENT / util::tileSize_D;
-    if (options->cluster && geoJSON.is<Features>() && !geoJSON.get<Features>().empty()) {
+    if (options->cluster && geoJSON.is<Features>()) {
         mapbox::supercluster::Options clusterOptions;
         clusterOptions.maxZoom = options->clusterMaxZoom;
         clusterOptions.extent = util::EXTENT;
@@ -125,7 +433,8 @@ std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
                 toReturn[p.first] = evaluateFeature<Value>(*feature, p.second.second, accumulated);
             }
         };
-        return std::shared_ptr<GeoJSONData>(new SuperclusterData(geoJSON.get<Features>(), clusterOptions));
+        return std::shared_ptr<GeoJSONData>(
+            new SuperclusterData(geoJSON.get<Features>(), clusterOptions, options->updatable));
     }
 
     mapbox::geojsonvt::Options vtOptions;
@@ -134,6 +443,10 @@ std::shared_ptr<GeoJSONData> GeoJSONData::create(const GeoJSON& geoJSON,
     vtOptions.buffer = static_cast<uint16_t>(::round(scale * options->buffer));
     vtOptions.tolerance = scale * options->tolerance;
     vtOptions.lineMetrics = options->lineMetrics;
+    if (options->updatable && geoJSON.is<Features>()) {
+        return std::make_shared<UpdatableGeoJSONVTData>(
+            geoJSON.get<Features>(), vtOptions, options->buffer / util::tileSize_D, std::move(sequencedScheduler));
+    }
     return std::shared_ptr<GeoJSONData>(new GeoJSONVTData(geoJSON, vtOptions, std::move(sequencedScheduler)));
 }
 
@@ -0,0 +1,195 @@
+#include <mbgl/style/sources/geojson_stream_reader.hpp>
+#include <mbgl/util/string.hpp>
+
+#include <mapbox/geojson.hpp>
+#include <mapbox/geojson/rapidjson.hpp>
+
+#include <rapidjson/error/en.h>
+
+namespace mln {
+namespace style {
+
+namespace {
+constexpr unsigned parseFlags = 0;
+} // namespace
+
+/// Follows the top level of the document, and where the features are
+class GeoJSONStreamReader::Handler : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, Handler> {
+public:
+    explicit Handler(GeoJSONStreamReader& reader_)
+        : reader(reader_) {}
+
+    // Called for the values which aren't strings, objects or arrays
+    bool Default() { return !isFeature() || notAnObject(); }
+
+    bool String(const char* string, rapidjson::SizeType length, bool) {
+        if (reader.depth == 1 && reader.key == "type") {
+            reader.type.assign(string, length);
+        }
+        return !isFeature() || notAnObject();
+    }
+
+    bool Key(const char* string, rapidjson::SizeType length, bool) {
+        if (reader.depth == 1) {
+            reader.key.assign(string, length);
+        }
+        return true;
+    }
+
+    bool StartObject() {
+        if (isFeature()) {
+            // The feature is read into a document of its own
+            reader.featureStarted = true;
+            return true;
+        }
+        ++reader.depth;
+        return true;
+    }
+
+    bool EndObject(rapidjson::SizeType) {
+        --reader.depth;
+        return true;
+    }
+
+    bool StartArray() {
+        if (isFeature()) {
+            return notAnObject();
+        }
+        if (reader.depth == 1 && reader.key == "features") {
+            reader.inFeatures = true;
+        }
+        ++reader.depth;
+        return true;
+    }
+
+    bool EndArray(rapidjson::SizeType) {
+        --reader.depth;
+        if (reader.depth == 1) {
+            reader.inFeatures = false;
+        }
+        return true;
+    }
+
+private:
+    // Whether the value being read is an element of the features
+    bool isFeature() const { return reader.inFeatures && reader.depth == 2; }
+
+    bool notAnObject() {
+        reader.error = "Feature must be an object";
+        return false;
+    }
+
+    GeoJSONStreamReader& reader;
+};
+
+/// Builds the document of a feature from the events of the reader, once the feature has started
+class GeoJSONStreamReader::FeatureReader {
+public:
+    explicit FeatureReader(GeoJSONStreamReader& reader_)
+        : reader(reader_) {}
+
+    // Called by `JSDocument::Populate()`
+    bool operator()(JSDocument& document_) {
+        document = &document_;
+        document->StartObject();
+        while (depth > 0) {
+            if (!reader.reader.IterativeParseNext<parseFlags>(reader.stream, *this)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Null() { return document->Null(); }
+    bool Bool(bool value) { return document->Bool(value); }
+    bool Int(int value) { return document->Int(value); }
+    bool Uint(unsigned value) { return document->Uint(value); }
+    bool Int64(int64_t value) { return document->Int64(value); }
+    bool Uint64(uint64_t value) { return document->Uint64(value); }
+    bool Double(double value) { return document->Double(value); }
+
+    bool RawNumber(const char* string, rapidjson::SizeType length, bool copy) {
+        return document->RawNumber(string, length, copy);
+    }
+
+    bool String(const char* string, rapidjson::SizeType length, bool copy) {
+        return document->String(string, length, copy);
+    }
+
+    bool Key(const char* string, rapidjson::SizeType length, bool copy) {
+        return document->Key(string, length, copy);
+    }
+
+    bool StartObject() {
+        ++depth;
+        return document->StartObject();
+    }
+
+    bool EndObject(rapidjson::SizeType count) {
+        --depth;
+        return document->EndObject(count);
+    }
+
+    bool StartArray() {
+        ++depth;
+        return document->StartArray();
+    }
+
+    bool EndArray(rapidjson::SizeType count) {
+        --depth;
+        return document->EndArray(count);
+    }
+
+private:
+    GeoJSONStreamReader& reader;
+    JSDocument* document = nullptr;
+    std::size_t depth = 1;
+};
+
+GeoJSONStreamReader::GeoJSONStreamReader(std::shared_ptr<const std::string> data_)
+    : data(std::move(data_)),
+      stream(data->c_str()) {
+    reader.IterativeParseInit();
+}
+
+bool GeoJSONStreamReader::read(std::size_t count) {
+    if (done) {
+        return !error;
+    }
+
+    const auto end = features.size() + count;
+    Handler handler(*this);
+    while (features.size() < end && !reader.IterativeParseComplete()) {
+        if (!reader.IterativeParseNext<parseFlags>(stream, handler) || (featureStarted && !readFeature())) {
+            if (!error) {
+                error = std::string{rapidjson::GetParseError_En(reader.GetParseErrorCode())} + " at offset " +
+                        util::toString(reader.GetErrorOffset());
+            }
+            break;
+        }
+    }
+    done = error || reader.IterativeParseComplete();
+    return !error;
+}
+
+bool GeoJSONStreamReader::readFeature() {
+    featureStarted = false;
+
+    JSDocument document;
+    FeatureReader featureReader(*this);
+    document.Populate(featureReader);
+    if (reader.HasParseError()) {
+        return false;
+    }
+
+    try {
+        features.push_back(mapbox::geojson::convert<mapbox::geojson::feature>(document));
+    } catch (const std::exception& ex) {
+        error = ex.what();
+        return false;
+    }
+    return true;
+}
+
+} // namespace style
+} // namespace mln
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <mbgl/util/geojson.hpp>
+#include <mbgl/util/rapidjson.hpp>
+
+#include <rapidjson/reader.h>
+
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace mln {
+namespace style {
+
+/**
+ * Reads the features of a GeoJSON feature collection while the document is parsed, a chunk at a time,
+ * without building a JSON document for all of it. Only the feature being read is held as JSON.
+ *
+ * Other kinds of GeoJSON documents are only recognized once they are read entirely, and are left to the
+ * caller to parse.
+ */
+class GeoJSONStreamReader {
+public:
+    explicit GeoJSONStreamReader(std::shared_ptr<const std::string> data);
+
+    /// Reads features until `count` more were read, or the document ended. Returns false on errors.
+    bool read(std::size_t count);
+
+    bool isDone() const noexcept { return done; }
+
+    /// Whether the document is a feature collection, as far as it was read
+    bool isFeatureCollection() const noexcept { return type == "FeatureCollection"; }
+
+    const std::optional<std::string>& getError() const noexcept { return error; }
+
+    /// The features read so far
+    FeatureCollection& getFeatures() noexcept { return features; }
+
+    /// The number of bytes of the document read so far
+    std::size_t getBytesRead() const noexcept { return stream.Tell(); }
+
+    const std::shared_ptr<const std::string>& getData() const noexcept { return data; }
+
+private:
+    class Handler;
+    class FeatureReader;
+
+    bool readFeature();
+
+    std::shared_ptr<const std::string> data;
+    rapidjson::StringStream stream;
+    rapidjson::Reader reader;
+
+    // The nesting of the value being read, and the key of the current member of the top level object
+    std::size_t depth = 0;
+    std::string key;
+    std::string type;
+    bool inFeatures = false;
+    bool featureStarted = false;
+
+    FeatureCollection features;
+    std::optional<std::string> error;
+    bool done = false;
+};
+
+} // namespace style
+} // namespace mln
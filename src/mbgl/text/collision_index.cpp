@@ -32,6 +32,11 @@ inline float findViewportPadding(const TransformState& transformState, MapMode m
     return (transformState.getPitch() != 0.0f) ? viewportPaddingDefault * 2 : viewportPaddingDefault;
 }
 
+template <typename Shape, typename Predicate>
+bool hitTest(const CollisionIndex::CollisionGrid& grid, const Shape& shape, const std::optional<Predicate>& predicate) {
+    return predicate ? grid.hitTest(shape, *predicate) : grid.hitTest(shape);
+}
+
 } // namespace
 
 CollisionIndex::CollisionIndex(const TransformState& transformState_, MapMode mapMode)
@@ -54,7 +59,7 @@ float CollisionIndex::approximateTileDistance(const TileDistance& tileDistance,
                                               const float lastSegmentAngle,
                                               const float pixelsToTileUnits,
                                               const float cameraToAnchorDistance,
-                                              const bool pitchWithMap) {
+                                              const bool pitchWithMap) const {
     // This is a quick and dirty solution for choosing which collision circles to
     // use (since collision circles are laid out in tile units). Ideally, I
     // think we should generate collision circles on the fly in viewport
@@ -146,6 +151,7 @@ IntersectStatus CollisionIndex::intersectsTileEdges(const CollisionBox& box,
     return result;
 }
 
+template <typename Predicate>
 std::pair<bool, bool> CollisionIndex::placeFeature(
     const CollisionFeature& feature,
     Point<float> shift,
@@ -159,8 +165,9 @@ std::pair<bool, bool> CollisionIndex::placeFeature(
     const bool pitchWithMap,
     const bool collisionDebug,
     const std::optional<CollisionBoundaries>& avoidEdges,
-    const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
-    std::vector<ProjectedCollisionBox>& projectedBoxes) {
+    const std::optional<Predicate>& collisionGroupPredicate,
+    std::vector<ProjectedCollisionBox>& projectedBoxes,
+    const ProjectedLineFeature* projected) {
     assert(projectedBoxes.empty());
     if (!feature.alongLine) {
         const CollisionBox& box = feature.boxes.front();
@@ -168,11 +175,15 @@ std::pair<bool, bool> CollisionIndex::placeFeature(
         projectedBoxes.emplace_back(
             collisionBoundaries[0], collisionBoundaries[1], collisionBoundaries[2], collisionBoundaries[3]);
         if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) || !isInsideGrid(collisionBoundaries) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes.back().box(), collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(collisionGrid, projectedBoxes.back().box(), collisionGroupPredicate))) {
             return {false, false};
         }
 
         return {true, isOffscreen(collisionBoundaries)};
+    } else if (projected) {
+        assert(projected->circles.size() == feature.boxes.size());
+        return placeProjectedLineFeature(
+            *projected, allowOverlap, collisionDebug, avoidEdges, collisionGroupPredicate, projectedBoxes);
     } else {
         return placeLineFeature(feature,
                                 posMatrix,
@@ -190,22 +201,18 @@ std::pair<bool, bool> CollisionIndex::placeFeature(
     }
 }
 
-std::pair<bool, bool> CollisionIndex::placeLineFeature(
-    const CollisionFeature& feature,
-    const mat4& posMatrix,
-    const mat4& labelPlaneMatrix,
-    const float textPixelRatio,
-    const PlacedSymbol& symbol,
-    const float scale,
-    const float fontSize,
-    const bool allowOverlap,
-    const bool pitchWithMap,
-    const bool collisionDebug,
-    const std::optional<CollisionBoundaries>& avoidEdges,
-    const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
-    std::vector<ProjectedCollisionBox>& projectedBoxes) {
+template <typename Visit>
+bool CollisionIndex::projectLineCircles(const CollisionFeature& feature,
+                                        const mat4& posMatrix,
+                                        const mat4& labelPlaneMatrix,
+                                        const float textPixelRatio,
+                                        const PlacedSymbol& symbol,
+                                        const float scale,
+                                        const float fontSize,
+                                        const bool pitchWithMap,
+                                        std::vector<ProjectedCollisionBox>& circles,
+                                        Visit&& visit) const {
     assert(feature.alongLine);
-    assert(projectedBoxes.empty());
     const auto tileUnitAnchorPoint = symbol.anchorPoint;
     const auto projectedAnchor = projectAnchor(posMatrix, tileUnitAnchorPoint);
 
@@ -225,10 +232,6 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
                                                           labelPlaneMatrix,
                                                           /*return tile distance*/ true);
 
-    bool collisionDetected = false;
-    bool inGrid = false;
-    bool entirelyOffscreen = true;
-
     const auto tileToViewport = projectedAnchor.first * textPixelRatio;
     // pixelsToTileUnits is used for translating line geometry to tile units
     // ... so we care about 'scale' but not 'perspectiveRatio'
@@ -251,7 +254,7 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
     }
 
     bool previousCirclePlaced = false;
-    projectedBoxes.resize(feature.boxes.size());
+    circles.resize(feature.boxes.size());
     for (size_t i = 0; i < feature.boxes.size(); i++) {
         const CollisionBox& circle = feature.boxes[i];
         const float boxSignedDistanceFromAnchor = circle.signedDistanceFromAnchor;
@@ -269,7 +272,7 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
         const float radius = tileUnitRadius * tileToViewport;
 
         if (previousCirclePlaced) {
-            const ProjectedCollisionBox& previousCircle = projectedBoxes[i - 1];
+            const ProjectedCollisionBox& previousCircle = circles[i - 1];
             assert(previousCircle.isCircle());
             const auto& previousCenter = previousCircle.circle().center;
             const float dx = projectedPoint.x - previousCenter.x;
@@ -303,18 +306,125 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
 
         previousCirclePlaced = true;
 
-        CollisionBoundaries collisionBoundaries{{projectedPoint.x - radius,
-                                                 projectedPoint.y - radius,
-                                                 projectedPoint.x + radius,
-                                                 projectedPoint.y + radius}};
+        const CollisionBoundaries collisionBoundaries{{projectedPoint.x - radius,
+                                                       projectedPoint.y - radius,
+                                                       projectedPoint.x + radius,
+                                                       projectedPoint.y + radius}};
 
-        projectedBoxes[i] = ProjectedCollisionBox{projectedPoint.x, projectedPoint.y, radius};
+        circles[i] = ProjectedCollisionBox{projectedPoint.x, projectedPoint.y, radius};
 
-        entirelyOffscreen &= isOffscreen(collisionBoundaries);
-        inGrid |= isInsideGrid(collisionBoundaries);
+        if (!visit(i, collisionBoundaries)) {
+            break;
+        }
+    }
+
+    return firstAndLastGlyph.has_value();
+}
+
+CollisionIndex::ProjectedLineFeature CollisionIndex::projectLineFeature(const CollisionFeature& feature,
+                                                                      const mat4& posMatrix,
+                                                                      const mat4& labelPlaneMatrix,
+                                                                      const float textPixelRatio,
+                                                                      const PlacedSymbol& symbol,
+                                                                      const float scale,
+                                                                      const float fontSize,
+                                                                      const bool pitchWithMap) const {
+    ProjectedLineFeature projected;
+    bool inGrid = false;
+    const bool onLine = projectLineCircles(feature,
+                                           posMatrix,
+                                           labelPlaneMatrix,
+                                           textPixelRatio,
+                                           symbol,
+                                           scale,
+                                           fontSize,
+                                           pitchWithMap,
+                                           projected.circles,
+                                           [&](std::size_t, const CollisionBoundaries& collisionBoundaries) {
+                                               projected.entirelyOffscreen &= isOffscreen(collisionBoundaries);
+                                               inGrid |= isInsideGrid(collisionBoundaries);
+                                               return true;
+                                           });
+
+    projected.fits = onLine && inGrid;
+    return projected;
+}
+
+template <typename Predicate>
+std::pair<bool, bool> CollisionIndex::placeLineFeature(const CollisionFeature& feature,
+                                                       const mat4& posMatrix,
+                                                       const mat4& labelPlaneMatrix,
+                                                       const float textPixelRatio,
+                                                       const PlacedSymbol& symbol,
+                                                       const float scale,
+                                                       const float fontSize,
+                                                       const bool allowOverlap,
+                                                       const bool pitchWithMap,
+                                                       const bool collisionDebug,
+                                                       const std::optional<CollisionBoundaries>& avoidEdges,
+                                                       const std::optional<Predicate>& collisionGroupPredicate,
+                                                       std::vector<ProjectedCollisionBox>& projectedBoxes) const {
+    assert(projectedBoxes.empty());
+    bool collisionDetected = false;
+    bool inGrid = false;
+    bool entirelyOffscreen = true;
+
+    // Each circle is tested as soon as it's projected, so that a label stops being projected once it collides
+    const bool onLine = projectLineCircles(
+        feature,
+        posMatrix,
+        labelPlaneMatrix,
+        textPixelRatio,
+        symbol,
+        scale,
+        fontSize,
+        pitchWithMap,
+        projectedBoxes,
+        [&](std::size_t i, const CollisionBoundaries& collisionBoundaries) {
+            entirelyOffscreen &= isOffscreen(collisionBoundaries);
+            inGrid |= isInsideGrid(collisionBoundaries);
+
+            if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) ||
+                (!allowOverlap && hitTest(collisionGrid, projectedBoxes[i].circle(), collisionGroupPredicate))) {
+                // Don't stop if we're showing the debug circles because
+                // we still want to calculate which circles are in use
+                collisionDetected = true;
+                return collisionDebug;
+            }
+            return true;
+        });
+
+    if (collisionDetected && !collisionDebug) {
+        return {false, false};
+    }
+    return {!collisionDetected && onLine && inGrid, entirelyOffscreen};
+}
+
+template <typename Predicate>
+std::pair<bool, bool> CollisionIndex::placeProjectedLineFeature(
+    const ProjectedLineFeature& projected,
+    const bool allowOverlap,
+    const bool collisionDebug,
+    const std::optional<CollisionBoundaries>& avoidEdges,
+    const std::optional<Predicate>& collisionGroupPredicate,
+    std::vector<ProjectedCollisionBox>& projectedBoxes) const {
+    assert(projectedBoxes.empty());
+    bool collisionDetected = false;
+    projectedBoxes.resize(projected.circles.size());
+    for (size_t i = 0; i < projected.circles.size(); i++) {
+        if (!projected.circles[i].isCircle()) {
+            continue;
+        }
+
+        projectedBoxes[i] = projected.circles[i];
+        const auto& circle = projectedBoxes[i].circle();
+        const CollisionBoundaries collisionBoundaries{{circle.center.x - circle.radius,
+                                                       circle.center.y - circle.radius,
+                                                       circle.center.x + circle.radius,
+                                                       circle.center.y + circle.radius}};
 
         if ((avoidEdges && !isInsideTile(collisionBoundaries, *avoidEdges)) ||
-            (!allowOverlap && collisionGrid.hitTest(projectedBoxes[i].circle(), collisionGroupPredicate))) {
+            (!allowOverlap && hitTest(collisionGrid, circle, collisionGroupPredicate))) {
             if (!collisionDebug) {
                 return {false, false};
             } else {
@@ -325,9 +435,26 @@ std::pair<bool, bool> CollisionIndex::placeLineFeature(
         }
     }
 
-    return {!collisionDetected && firstAndLastGlyph && inGrid, entirelyOffscreen};
+    return {!collisionDetected && projected.fits, projected.entirelyOffscreen};
 }
 
+// Placement tests features within their collision group, or against all placed features
+template std::pair<bool, bool> CollisionIndex::placeFeature(const CollisionFeature&,
+                                                            Point<float>,
+                                                            const mat4&,
+                                                            const mat4&,
+                                                            float,
+                                                            const PlacedSymbol&,
+                                                            float,
+                                                            float,
+                                                            bool,
+                                                            bool,
+                                                            bool,
+                                                            const std::optional<CollisionBoundaries>&,
+                                                            const std::optional<CollisionGroupPredicate>&,
+                                                            std::vector<ProjectedCollisionBox>&,
+                                                            const ProjectedLineFeature*);
+
 void CollisionIndex::insertFeature(const CollisionFeature& feature,
                                    const std::vector<ProjectedCollisionBox>& projectedBoxes,
                                    bool ignorePlacement,
@@ -394,30 +521,20 @@ std::unordered_map<uint32_t, std::vector<IndexedSubfeature>> CollisionIndex::que
 
     auto envelope = mapbox::geometry::envelope(gridQuery);
 
-    using QueryResult = std::pair<IndexedSubfeature, GridIndex<IndexedSubfeature>::BBox>;
-
-    std::vector<QueryResult> features = collisionGrid.queryWithBoxes(envelope);
-    std::vector<QueryResult> ignoredFeatures = ignoredGrid.queryWithBoxes(envelope);
-    features.insert(features.end(),
-                    std::make_move_iterator(ignoredFeatures.begin()),
-                    std::make_move_iterator(ignoredFeatures.end()));
-
     mln::unordered_map<uint32_t, mln::unordered_set<size_t>> seenBuckets;
-    for (auto& queryResult : features) {
-        auto& feature = queryResult.first;
-        auto& bbox = queryResult.second;
-
+    const auto addFeature = [&](const IndexedSubfeature& feature, const CollisionGrid::BBox& bbox) {
         // Skip already seen features.
         auto& seenFeatures = seenBuckets[feature.getBucketInstanceId()];
-        if (seenFeatures.find(feature.getIndex()) != seenFeatures.end()) continue;
+        if (seenFeatures.find(feature.getIndex()) != seenFeatures.end()) return false;
 
-        if (!polygonIntersectsBox(gridQuery, bbox)) {
-            continue;
+        if (polygonIntersectsBox(gridQuery, bbox)) {
+            seenFeatures.insert(feature.getIndex());
+            result[feature.getBucketInstanceId()].push_back(feature);
         }
-
-        seenFeatures.insert(feature.getIndex());
-        result[feature.getBucketInstanceId()].push_back(feature);
-    }
+        return false;
+    };
+    collisionGrid.query(envelope, addFeature);
+    ignoredGrid.query(envelope, addFeature);
 
     return result;
 }
@@ -7,6 +7,8 @@
 #include <mbgl/map/transform_state.hpp>
 
 #include <array>
+#include <optional>
+#include <vector>
 
 namespace mln {
 
@@ -15,6 +17,16 @@ class PlacedSymbol;
 struct TileDistance;
 
 using CollisionBoundaries = std::array<float, 4>; // [x1, y1, x2, y2]
+
+/// Selects the placed features of a collision group, for symbols which only collide within their group
+struct CollisionGroupPredicate {
+    uint16_t collisionGroupId;
+
+    bool operator()(const RefIndexedSubfeature& feature) const {
+        return feature.getCollisionGroupId() == collisionGroupId;
+    }
+};
+
 struct IntersectStatus {
     enum Flags : uint8_t {
         None = 0,
@@ -29,12 +41,24 @@ class CollisionIndex {
 public:
     using CollisionGrid = GridIndex<IndexedSubfeature>;
 
+    /// The circles of a label along a line, projected to the viewport. Projecting them doesn't depend on the labels
+    /// placed before, so that it can be done ahead of placement and concurrently for many labels.
+    struct ProjectedLineFeature {
+        // One entry per circle of the feature; circles the label doesn't use are left `Unknown`
+        std::vector<ProjectedCollisionBox> circles;
+        // Whether the label fits on its line, and some of its circles are inside the grid
+        bool fits = false;
+        bool entirelyOffscreen = true;
+    };
+
     explicit CollisionIndex(const TransformState&, MapMode);
     IntersectStatus intersectsTileEdges(const CollisionBox&,
                                         Point<float> shift,
                                         const mat4& posMatrix,
                                         float textPixelRatio,
                                         const CollisionBoundaries& tileEdges) const;
+    /// Tests a feature against the placed features, or against the ones `collisionGroupPredicate` selects
+    template <typename Predicate>
     std::pair<bool, bool> placeFeature(
         const CollisionFeature& feature,
         Point<float> shift,
@@ -48,9 +72,21 @@ public:
         bool pitchWithMap,
         bool collisionDebug,
         const std::optional<CollisionBoundaries>& avoidEdges,
-        const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
-        std::vector<ProjectedCollisionBox>& /*out*/
-    );
+        const std::optional<Predicate>& collisionGroupPredicate,
+        std::vector<ProjectedCollisionBox>& /*out*/,
+        // The result of `projectLineFeature()` for the feature, if it was projected ahead of placement
+        const ProjectedLineFeature* projected = nullptr);
+
+    /// Projects the circles of a feature along a line as `placeFeature()` does, without testing them against the
+    /// placed features. Doesn't look at the grids, so that it can be called from several threads at once.
+    ProjectedLineFeature projectLineFeature(const CollisionFeature& feature,
+                                            const mat4& posMatrix,
+                                            const mat4& labelPlaneMatrix,
+                                            float textPixelRatio,
+                                            const PlacedSymbol& symbol,
+                                            float scale,
+                                            float fontSize,
+                                            bool pitchWithMap) const;
 
     void insertFeature(const CollisionFeature& feature,
                        const std::vector<ProjectedCollisionBox>&,
@@ -72,27 +108,51 @@ private:
     bool isInsideTile(const CollisionBoundaries& boundaries, const CollisionBoundaries& tileBoundaries) const;
     bool overlapsTile(const CollisionBoundaries& boundaries, const CollisionBoundaries& tileBoundaries) const;
 
-    std::pair<bool, bool> placeLineFeature(
-        const CollisionFeature& feature,
-        const mat4& posMatrix,
-        const mat4& labelPlaneMatrix,
-        float textPixelRatio,
-        const PlacedSymbol& symbol,
-        float scale,
-        float fontSize,
+    // Projects the circles of a feature along a line into `circles`, calling `visit(index, boundaries)` for each
+    // circle the label uses until it returns false. Returns whether the label fits on its line.
+    template <typename Visit>
+    bool projectLineCircles(const CollisionFeature& feature,
+                            const mat4& posMatrix,
+                            const mat4& labelPlaneMatrix,
+                            float textPixelRatio,
+                            const PlacedSymbol& symbol,
+                            float scale,
+                            float fontSize,
+                            bool pitchWithMap,
+                            std::vector<ProjectedCollisionBox>& circles,
+                            Visit&& visit) const;
+
+    template <typename Predicate>
+    std::pair<bool, bool> placeLineFeature(const CollisionFeature& feature,
+                                           const mat4& posMatrix,
+                                           const mat4& labelPlaneMatrix,
+                                           float textPixelRatio,
+                                           const PlacedSymbol& symbol,
+                                           float scale,
+                                           float fontSize,
+                                           bool allowOverlap,
+                                           bool pitchWithMap,
+                                           bool collisionDebug,
+                                           const std::optional<CollisionBoundaries>& avoidEdges,
+                                           const std::optional<Predicate>& collisionGroupPredicate,
+                                           std::vector<ProjectedCollisionBox>& /*out*/
+    ) const;
+
+    template <typename Predicate>
+    std::pair<bool, bool> placeProjectedLineFeature(
+        const ProjectedLineFeature& projected,
         bool allowOverlap,
-        bool pitchWithMap,
         bool collisionDebug,
         const std::optional<CollisionBoundaries>& avoidEdges,
-        const std::optional<std::function<bool(const RefIndexedSubfeature&)>>& collisionGroupPredicate,
+        const std::optional<Predicate>& collisionGroupPredicate,
         std::vector<ProjectedCollisionBox>& /*out*/
-    );
+    ) const;
 
     float approximateTileDistance(const TileDistance& tileDistance,
                                   float lastSegmentAngle,
                                   float pixelsToTileUnits,
                                   float cameraToAnchorDistance,
-                                  bool pitchWithMap);
+                                  bool pitchWithMap) const;
 
     std::pair<float, float> projectAnchor(const mat4& posMatrix, const Point<float>& point) const;
     std::pair<Point<float>, float> projectAndGetPerspectiveRatio(const mat4& posMatrix,
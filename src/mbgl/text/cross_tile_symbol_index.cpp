@@ -6,25 +6,73 @@
 #include <mbgl/tile/tile.hpp>
 #include <mbgl/util/instrumentation.hpp>
 
+#include <algorithm>
+#include <cassert>
+
 namespace mln {
 
 TileLayerIndex::TileLayerIndex(OverscaledTileID coord_,
                                std::vector<SymbolInstance>& symbolInstances,
+                               const std::vector<std::size_t>& keyHashes,
                                uint32_t bucketInstanceId_,
                                std::string bucketLeaderId_)
     : coord(coord_),
       bucketInstanceId(bucketInstanceId_),
       bucketLeaderId(std::move(bucketLeaderId_)) {
-    for (const SymbolInstance& symbolInstance : symbolInstances) {
+    assert(keyHashes.size() == symbolInstances.size());
+    for (std::size_t i = 0; i < symbolInstances.size(); ++i) {
+        const SymbolInstance& symbolInstance = symbolInstances[i];
         if (!symbolInstance.check(SYM_GUARD_LOC) ||
             symbolInstance.getCrossTileID() == SymbolInstance::invalidCrossTileID) {
             continue;
         }
-        indexedSymbolInstances[symbolInstance.getKey()].emplace_back(symbolInstance.getCrossTileID(),
-                                                                     getScaledCoordinates(symbolInstance, coord));
+
+        auto [it, inserted] = symbolsByKeyHash.try_emplace(keyHashes[i]);
+        KeySymbols* keySymbols = &it->second;
+        if (inserted) {
+            keySymbols->key = symbolInstance.getKey();
+        } else if (keySymbols->key != symbolInstance.getKey()) {
+            keySymbols = &collidingKeys[symbolInstance.getKey()];
+        }
+        keySymbols->symbols.emplace_back(
+            symbolInstance.getCrossTileID(), getScaledCoordinates(symbolInstance, coord), static_cast<uint32_t>(i));
+        crossTileIDs.push_back(symbolInstance.getCrossTileID());
+    }
+
+    const auto sortByX = [](KeySymbols& keySymbols) {
+        std::sort(keySymbols.symbols.begin(),
+                  keySymbols.symbols.end(),
+                  [](const IndexedSymbolInstance& a, const IndexedSymbolInstance& b) { return a.coord.x < b.coord.x; });
+    };
+    for (auto& entry : symbolsByKeyHash) {
+        sortByX(entry.second);
+    }
+    for (auto& entry : collidingKeys) {
+        sortByX(entry.second);
     }
 }
 
+std::vector<std::size_t> TileLayerIndex::hashKeys(const std::vector<SymbolInstance>& symbolInstances) {
+    std::vector<std::size_t> hashes;
+    hashes.reserve(symbolInstances.size());
+    for (const SymbolInstance& symbolInstance : symbolInstances) {
+        hashes.push_back(symbolInstance.check(SYM_GUARD_LOC) ? std::hash<std::u16string>()(symbolInstance.getKey())
+                                                             : 0);
+    }
+    return hashes;
+}
+
+auto TileLayerIndex::findKey(std::size_t hash, const std::u16string& key) const -> const KeySymbols* {
+    const auto it = symbolsByKeyHash.find(hash);
+    if (it == symbolsByKeyHash.end()) {
+        return nullptr;
+    } else if (it->second.key == key) {
+        return &it->second;
+    }
+    const auto colliding = collidingKeys.find(key);
+    return colliding != collidingKeys.end() ? &colliding->second : nullptr;
+}
+
 Point<int64_t> TileLayerIndex::getScaledCoordinates(const SymbolInstance& symbolInstance,
                                                     const OverscaledTileID& childTileCoord) const {
     // Round anchor positions to roughly 4 pixel grid
@@ -37,43 +85,53 @@ Point<int64_t> TileLayerIndex::getScaledCoordinates(const SymbolInstance& symbol
 }
 
 void TileLayerIndex::findMatches(SymbolBucket& bucket,
+                                 const std::vector<std::size_t>& keyHashes,
                                  const OverscaledTileID& newCoord,
-                                 std::set<uint32_t>& zoomCrossTileIDs) const {
+                                 mln::unordered_set<uint32_t>& zoomCrossTileIDs) const {
     auto& symbolInstances = bucket.symbolInstances;
-    float tolerance = coord.canonical.z < newCoord.canonical.z
-                          ? 1.0f
-                          : static_cast<float>(std::pow(2, coord.canonical.z - newCoord.canonical.z));
+    const int64_t tolerance = coord.canonical.z < newCoord.canonical.z
+                                  ? 1
+                                  : int64_t{1} << (coord.canonical.z - newCoord.canonical.z);
 
     if (bucket.bucketLeaderID != bucketLeaderId) return;
 
-    for (auto& symbolInstance : symbolInstances) {
+    for (std::size_t i = 0; i < symbolInstances.size(); ++i) {
+        auto& symbolInstance = symbolInstances[i];
         if (symbolInstance.getCrossTileID() || !symbolInstance.check(SYM_GUARD_LOC)) {
             // already has a match, skip
             continue;
         }
 
-        auto it = indexedSymbolInstances.find(symbolInstance.getKey());
-        if (it == indexedSymbolInstances.end()) {
+        const KeySymbols* keySymbols = findKey(keyHashes[i], symbolInstance.getKey());
+        if (!keySymbols) {
             // No symbol with this key in this bucket
             continue;
         }
 
         auto scaledSymbolCoord = getScaledCoordinates(symbolInstance, newCoord);
 
-        for (const IndexedSymbolInstance& thisTileSymbol : it->second) {
-            // Return any symbol with the same keys whose coordinates are within
-            // 1 grid unit. (with a 4px grid, this covers a 12px by 12px area)
-            if (std::abs(thisTileSymbol.coord.x - scaledSymbolCoord.x) <= tolerance &&
-                std::abs(thisTileSymbol.coord.y - scaledSymbolCoord.y) <= tolerance &&
-                zoomCrossTileIDs.find(thisTileSymbol.crossTileID) == zoomCrossTileIDs.end()) {
-                // Once we've marked ourselves duplicate against this parent
-                // symbol, don't let any other symbols at the same zoom level
-                // duplicate against the same parent (see issue #10844)
-                zoomCrossTileIDs.insert(thisTileSymbol.crossTileID);
-                symbolInstance.setCrossTileID(thisTileSymbol.crossTileID);
-                break;
+        // Return the first symbol of the bucket with the same key whose coordinates are
+        // within 1 grid unit. (with a 4px grid, this covers a 12px by 12px area)
+        const IndexedSymbolInstance* match = nullptr;
+        const auto& symbols = keySymbols->symbols;
+        auto it = std::lower_bound(symbols.begin(),
+                                   symbols.end(),
+                                   scaledSymbolCoord.x - tolerance,
+                                   [](const IndexedSymbolInstance& symbol, int64_t x) { return symbol.coord.x < x; });
+        for (; it != symbols.end() && it->coord.x <= scaledSymbolCoord.x + tolerance; ++it) {
+            if ((!match || it->order < match->order) && std::abs(it->coord.y - scaledSymbolCoord.y) <= tolerance &&
+                zoomCrossTileIDs.find(it->crossTileID) == zoomCrossTileIDs.end()) {
+                match = &*it;
             }
         }
+
+        if (match) {
+            // Once we've marked ourselves duplicate against this parent
+            // symbol, don't let any other symbols at the same zoom level
+            // duplicate against the same parent (see issue #10844)
+            zoomCrossTileIDs.insert(match->crossTileID);
+            symbolInstance.setCrossTileID(match->crossTileID);
+        }
     }
 }
 
@@ -158,6 +216,7 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID,
         }
     }
 
+    const auto keyHashes = TileLayerIndex::hashKeys(bucket.symbolInstances);
     auto& thisZoomUsedCrossTileIDs = usedCrossTileIDs[tileID.overscaledZ];
 
     for (auto& it : indexes) {
@@ -166,14 +225,14 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID,
         if (zoom > tileID.overscaledZ) {
             for (auto& childIndex : zoomIndexes) {
                 if (childIndex.second.coord.isChildOf(tileID)) {
-                    childIndex.second.findMatches(bucket, tileID, thisZoomUsedCrossTileIDs);
+                    childIndex.second.findMatches(bucket, keyHashes, tileID, thisZoomUsedCrossTileIDs);
                 }
             }
         } else {
             auto parentTileID = tileID.scaledTo(zoom);
             auto parentIndex = zoomIndexes.find(parentTileID);
             if (parentIndex != zoomIndexes.end()) {
-                parentIndex->second.findMatches(bucket, tileID, thisZoomUsedCrossTileIDs);
+                parentIndex->second.findMatches(bucket, keyHashes, tileID, thisZoomUsedCrossTileIDs);
             }
         }
     }
@@ -190,15 +249,15 @@ bool CrossTileSymbolLayerIndex::addBucket(const OverscaledTileID& tileID,
     thisZoomIndexes.emplace(
         std::piecewise_construct,
         std::forward_as_tuple(tileID),
-        std::forward_as_tuple(tileID, bucket.symbolInstances, bucket.bucketInstanceId, bucket.bucketLeaderID));
+        std::forward_as_tuple(
+            tileID, bucket.symbolInstances, keyHashes, bucket.bucketInstanceId, bucket.bucketLeaderID));
     return true;
 }
 
 void CrossTileSymbolLayerIndex::removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket) {
-    for (const auto& key : removedBucket.indexedSymbolInstances) {
-        for (auto indexedSymbolInstance : key.second) {
-            usedCrossTileIDs[zoom].erase(indexedSymbolInstance.crossTileID);
-        }
+    auto& zoomCrossTileIDs = usedCrossTileIDs[zoom];
+    for (const auto crossTileID : removedBucket.crossTileIDs) {
+        zoomCrossTileIDs.erase(crossTileID);
     }
 }
 
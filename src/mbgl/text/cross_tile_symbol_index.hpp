@@ -3,6 +3,7 @@
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/bitmask_operations.hpp>
 #include <mbgl/util/constants.hpp>
+#include <mbgl/util/containers.hpp>
 #include <mbgl/util/geometry.hpp>
 #include <mbgl/util/mat4.hpp>
 
@@ -12,6 +13,7 @@
 #include <string>
 #include <memory>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 
 namespace mln {
@@ -22,28 +24,52 @@ class SymbolBucket;
 
 class IndexedSymbolInstance {
 public:
-    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_)
+    IndexedSymbolInstance(uint32_t crossTileID_, Point<int64_t> coord_, uint32_t order_)
         : crossTileID(crossTileID_),
-          coord(coord_) {}
+          coord(coord_),
+          order(order_) {}
 
     uint32_t crossTileID;
     Point<int64_t> coord;
+    // Position of the symbol in its bucket
+    uint32_t order;
 };
 
 class TileLayerIndex {
 public:
+    /// `keyHashes` holds the hashes of the keys of the symbol instances, see `hashKeys()`
     TileLayerIndex(OverscaledTileID coord,
                    std::vector<SymbolInstance>&,
+                   const std::vector<std::size_t>& keyHashes,
                    uint32_t bucketInstanceId,
                    std::string bucketLeaderId);
 
+    static std::vector<std::size_t> hashKeys(const std::vector<SymbolInstance>&);
+
     Point<int64_t> getScaledCoordinates(const SymbolInstance&, const OverscaledTileID&) const;
-    void findMatches(SymbolBucket&, const OverscaledTileID&, std::set<uint32_t>&) const;
+    void findMatches(SymbolBucket&,
+                     const std::vector<std::size_t>& keyHashes,
+                     const OverscaledTileID&,
+                     mln::unordered_set<uint32_t>&) const;
 
     OverscaledTileID coord;
     uint32_t bucketInstanceId;
     std::string bucketLeaderId;
-    std::map<std::u16string, std::vector<IndexedSymbolInstance>> indexedSymbolInstances;
+    std::vector<uint32_t> crossTileIDs;
+
+private:
+    /// The symbols sharing a key, sorted by their x coordinate, so that the ones
+    /// within the matching tolerance of a position are found by binary search
+    struct KeySymbols {
+        std::u16string key;
+        std::vector<IndexedSymbolInstance> symbols;
+    };
+
+    const KeySymbols* findKey(std::size_t hash, const std::u16string& key) const;
+
+    mln::unordered_map<std::size_t, KeySymbols> symbolsByKeyHash;
+    // Keys whose hash is already taken by another key of the tile
+    std::map<std::u16string, KeySymbols> collidingKeys;
 };
 
 class CrossTileSymbolLayerIndex {
@@ -57,7 +83,7 @@ private:
     void removeBucketCrossTileIDs(uint8_t zoom, const TileLayerIndex& removedBucket);
 
     std::map<uint8_t, std::map<OverscaledTileID, TileLayerIndex>> indexes;
-    std::map<uint8_t, std::set<uint32_t>> usedCrossTileIDs;
+    mln::unordered_map<uint8_t, mln::unordered_set<uint32_t>> usedCrossTileIDs;
     float lng = 0;
     uint32_t& maxCrossTileID;
 };
@@ -80,7 +106,7 @@ public:
     const std::thread::id renderThreadID = std::this_thread::get_id();
 
 private:
-    std::map<std::string, CrossTileSymbolLayerIndex> layerIndexes;
+    std::unordered_map<std::string, CrossTileSymbolLayerIndex> layerIndexes;
     uint32_t maxCrossTileID = 0;
 };
 
@@ -0,0 +1,354 @@
+#include <mbgl/text/glyph_cache.hpp>
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/lru_cache.hpp>
+#include <mbgl/util/logging.hpp>
+
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace mln {
+
+namespace {
+
+constexpr char fileMagic[8] = {'M', 'L', 'N', 'G', 'L', 'Y', 'P', 'H'};
+// Bump when the record layout or the SDF transformation changes, so that older files are discarded
+constexpr uint32_t fileVersion = 2;
+constexpr std::size_t fileHeaderSize = sizeof(fileMagic) + sizeof(fileVersion);
+
+// Rough size of an entry besides its bitmap and key
+constexpr std::size_t entryOverhead = sizeof(Glyph) + 64;
+
+std::string makeKey(const std::string& fontFamily, const FontStack& fontStack, GlyphID glyphID) {
+    std::string key = fontFamily;
+    key += '\n';
+    for (const auto& font : fontStack) {
+        key += font;
+        key += '\n';
+    }
+    const char32_t id = glyphID.hash;
+    key.append(reinterpret_cast<const char*>(&id), sizeof(id));
+    return key;
+}
+
+template <typename T>
+void write(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Appends the record of a glyph, followed by the checksum of the record
+void encode(std::string& out, const std::string& key, const Glyph& glyph) {
+    const std::size_t start = out.size();
+    write(out, static_cast<uint32_t>(key.size()));
+    out += key;
+    write(out, static_cast<uint32_t>(glyph.id.hash));
+    write(out, glyph.metrics.width);
+    write(out, glyph.metrics.height);
+    write(out, glyph.metrics.left);
+    write(out, glyph.metrics.top);
+    write(out, glyph.metrics.advance);
+    write(out, static_cast<uint8_t>(glyph.metrics.isDoubleResolution));
+    write(out, glyph.bitmap.size.width);
+    write(out, glyph.bitmap.size.height);
+    out.append(reinterpret_cast<const char*>(glyph.bitmap.data.get()), glyph.bitmap.bytes());
+    write(out, util::crc32(out.data() + start, out.size() - start));
+}
+
+// Holds an advisory lock on a cache file, so that processes sharing it don't interleave their records or
+// append to it while it is rewritten. Files aren't locked on Windows.
+class FileLock {
+public:
+    explicit FileLock([[maybe_unused]] const std::string& path) {
+#ifndef _WIN32
+        fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+        if (fd >= 0 && ::flock(fd, LOCK_EX) != 0) {
+            ::close(fd);
+            fd = -1;
+        }
+#endif
+    }
+
+    ~FileLock() {
+#ifndef _WIN32
+        if (fd >= 0) {
+            ::flock(fd, LOCK_UN);
+            ::close(fd);
+        }
+#endif
+    }
+
+    FileLock(const FileLock&) = delete;
+    FileLock& operator=(const FileLock&) = delete;
+
+private:
+    [[maybe_unused]] int fd = -1;
+};
+
+// Reads the records of a cache file, stopping at the first one which is cut short or doesn't match its checksum
+class Reader {
+public:
+    Reader(const std::string& data_, std::size_t offset_)
+        : data(data_),
+          offset(offset_) {}
+
+    std::size_t getOffset() const { return offset; }
+
+    bool next(std::string& key, Glyph& glyph) {
+        const std::size_t start = offset;
+        uint32_t keySize = 0;
+        uint32_t id = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint8_t doubleResolution = 0;
+        uint32_t checksum = 0;
+        if (!read(keySize) || !read(key, keySize) || !read(id) || !read(glyph.metrics.width) ||
+            !read(glyph.metrics.height) || !read(glyph.metrics.left) || !read(glyph.metrics.top) ||
+            !read(glyph.metrics.advance) || !read(doubleResolution) || !read(width) || !read(height) ||
+            data.size() - offset < std::size_t(width) * height + sizeof(checksum)) {
+            offset = start;
+            return false;
+        }
+
+        const auto* bitmap = reinterpret_cast<const uint8_t*>(data.data() + offset);
+        offset += std::size_t(width) * height;
+        const std::size_t end = offset;
+        read(checksum);
+        if (checksum != util::crc32(data.data() + start, end - start)) {
+            offset = start;
+            return false;
+        }
+
+        glyph.id.hash = id;
+        glyph.metrics.isDoubleResolution = doubleResolution != 0;
+        glyph.bitmap = AlphaImage({width, height}, bitmap, std::size_t(width) * height);
+        return true;
+    }
+
+private:
+    template <typename T>
+    bool read(T& value) {
+        if (data.size() - offset < sizeof(T)) {
+            return false;
+        }
+        std::memcpy(&value, data.data() + offset, sizeof(T));
+        offset += sizeof(T);
+        return true;
+    }
+
+    bool read(std::string& value, std::size_t size) {
+        if (data.size() - offset < size) {
+            return false;
+        }
+        value.assign(data, offset, size);
+        offset += size;
+        return true;
+    }
+
+    const std::string& data;
+    std::size_t offset;
+};
+
+} // namespace
+
+class GlyphCache::Impl {
+public:
+    Impl(std::size_t maxBytes_, std::optional<std::string> path_)
+        : path(std::move(path_)),
+          glyphs(maxBytes_) {
+        if (path) {
+            load();
+        }
+    }
+
+    void load() {
+        const FileLock lock(*path);
+        const auto data = util::readFile(*path);
+        std::size_t valid = 0;
+        if (data && data->size() >= fileHeaderSize && std::memcmp(data->data(), fileMagic, sizeof(fileMagic)) == 0) {
+            uint32_t version = 0;
+            std::memcpy(&version, data->data() + sizeof(fileMagic), sizeof(version));
+            if (version == fileVersion) {
+                Reader reader(*data, fileHeaderSize);
+                std::string key;
+                Glyph glyph;
+                while (reader.next(key, glyph)) {
+                    const std::size_t glyphBytes = key.size() + glyph.bitmap.bytes() + entryOverhead;
+                    glyphs.put(key, makeMutable<Glyph>(std::move(glyph)), glyphBytes);
+                    stats.loaded++;
+                    glyph = Glyph();
+                }
+                valid = reader.getOffset();
+            }
+        }
+
+        // Rewrite the file with the glyphs kept in memory when it can't be appended to as it is, and
+        // when glyphs evicted since it was last rewritten take up as much space as the kept ones.
+        const bool rewrite = valid < fileHeaderSize || valid != data->size() ||
+                             valid > 2 * (glyphs.getBytes() + fileHeaderSize);
+        file.open(*path, std::ios::binary | (rewrite ? std::ios::trunc : std::ios::app));
+        if (!file) {
+            Log::Warning(Event::Glyph, "Unable to open glyph cache file " + *path);
+            path.reset();
+            return;
+        }
+        if (rewrite) {
+            writeHeader();
+            std::string records;
+            glyphs.forEach(
+                [&](const std::string& key, const Immutable<Glyph>& glyph) { encode(records, key, *glyph); });
+            file.write(records.data(), static_cast<std::streamsize>(records.size()));
+            file.flush();
+        }
+    }
+
+    void writeHeader() {
+        file.write(fileMagic, sizeof(fileMagic));
+        file.write(reinterpret_cast<const char*>(&fileVersion), sizeof(fileVersion));
+    }
+
+    /// Appends the glyphs put since the last call to the file in one write, without holding the cache lock
+    void writePending() {
+        std::scoped_lock fileLock(fileMutex);
+        std::vector<std::pair<std::string, Immutable<Glyph>>> glyphs;
+        {
+            std::scoped_lock lock(mutex);
+            glyphs.swap(pending);
+            writeScheduled = false;
+        }
+        if (glyphs.empty() || !path) {
+            return;
+        }
+
+        std::string records;
+        for (const auto& [key, glyph] : glyphs) {
+            encode(records, key, *glyph);
+        }
+        const FileLock lock(*path);
+        file.write(records.data(), static_cast<std::streamsize>(records.size()));
+        file.flush();
+    }
+
+    /// Guards the file, and is taken before `mutex` when both are needed
+    std::mutex fileMutex;
+    std::optional<std::string> path;
+    std::ofstream file;
+
+    mutable std::mutex mutex;
+    SizedLRU<std::string, Immutable<Glyph>> glyphs;
+    /// Glyphs put but not yet written to the file, and whether a task to write them is scheduled
+    std::vector<std::pair<std::string, Immutable<Glyph>>> pending;
+    bool writeScheduled = false;
+    GlyphCacheStats stats;
+};
+
+GlyphCache::GlyphCache(std::size_t maxBytes, std::optional<std::string> path)
+    : impl(std::make_shared<Impl>(maxBytes, std::move(path))) {}
+
+GlyphCache::~GlyphCache() {
+    impl->writePending();
+}
+
+std::shared_ptr<GlyphCache> GlyphCache::getShared() {
+    static std::mutex mutex;
+    static std::shared_ptr<GlyphCache> shared;
+
+    auto& settings = platform::Settings::getInstance();
+    const auto sizeValue = settings.get(platform::EXPERIMENTAL_GLYPH_CACHE_SIZE);
+    const auto* size = sizeValue.getDouble();
+    if (!size || *size <= 0) {
+        return nullptr;
+    }
+
+    std::scoped_lock lock(mutex);
+    if (!shared) {
+        const auto pathValue = settings.get(platform::EXPERIMENTAL_GLYPH_CACHE_PATH);
+        const auto* path = pathValue.getString();
+        shared = std::make_shared<GlyphCache>(static_cast<std::size_t>(*size),
+                                              path ? std::optional<std::string>(*path) : std::nullopt);
+    } else {
+        shared->setMaxBytes(static_cast<std::size_t>(*size));
+    }
+    return shared;
+}
+
+std::optional<Immutable<Glyph>> GlyphCache::get(const std::string& fontFamily,
+                                                const FontStack& fontStack,
+                                                GlyphID glyphID) {
+    const std::string key = makeKey(fontFamily, fontStack, glyphID);
+    std::scoped_lock lock(impl->mutex);
+    const auto* glyph = impl->glyphs.get(key);
+    if (!glyph) {
+        impl->stats.misses++;
+        return std::nullopt;
+    }
+    impl->stats.hits++;
+    return *glyph;
+}
+
+void GlyphCache::put(const std::string& fontFamily, const FontStack& fontStack, Immutable<Glyph> glyph) {
+    std::string key = makeKey(fontFamily, fontStack, glyph->id);
+    std::scoped_lock lock(impl->mutex);
+    if (impl->glyphs.contains(key)) {
+        // Rasterized by another glyph manager in the meantime, and already written
+        return;
+    }
+    impl->glyphs.put(key, glyph, key.size() + glyph->bitmap.bytes() + entryOverhead);
+    if (impl->path) {
+        // Written in batches by a background task, so that the glyph managers putting glyphs don't wait on the file
+        impl->pending.emplace_back(std::move(key), std::move(glyph));
+        if (!impl->writeScheduled) {
+            impl->writeScheduled = true;
+            Scheduler::GetBackground()->schedule([weak = std::weak_ptr<Impl>(impl)] {
+                if (auto strong = weak.lock()) {
+                    strong->writePending();
+                }
+            });
+        }
+    }
+}
+
+void GlyphCache::setMaxBytes(std::size_t maxBytes) {
+    std::scoped_lock lock(impl->mutex);
+    impl->glyphs.setMaxBytes(maxBytes);
+}
+
+std::size_t GlyphCache::getMaxBytes() const {
+    std::scoped_lock lock(impl->mutex);
+    return impl->glyphs.getMaxBytes();
+}
+
+GlyphCacheStats GlyphCache::getStats() const {
+    std::scoped_lock lock(impl->mutex);
+    GlyphCacheStats result = impl->stats;
+    result.evictions = impl->glyphs.getEvictions();
+    result.glyphs = impl->glyphs.size();
+    result.bytes = impl->glyphs.getBytes();
+    return result;
+}
+
+void GlyphCache::clear() {
+    std::scoped_lock lock(impl->fileMutex, impl->mutex);
+    impl->glyphs.clear();
+    impl->pending.clear();
+    if (impl->path) {
+        const FileLock fileLock(*impl->path);
+        impl->file.close();
+        impl->file.open(*impl->path, std::ios::binary | std::ios::trunc);
+        impl->writeHeader();
+        impl->file.flush();
+    }
+}
+
+} // namespace mln
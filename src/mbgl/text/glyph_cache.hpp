@@ -0,0 +1,66 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/font_stack.hpp>
+#include <mbgl/util/immutable.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace mln {
+
+struct GlyphCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    // Glyphs read from the cache file when the cache was created
+    std::size_t loaded = 0;
+    std::size_t glyphs = 0;
+    std::size_t bytes = 0;
+};
+
+/**
+ * Keeps glyphs rasterized from local fonts and transformed into signed distance fields, so that
+ * each one only has to be generated once per process rather than once per map. The cache is
+ * thread-safe and shared by all glyph managers which are given it; the least recently used glyphs
+ * are evicted once their bitmaps exceed the size limit.
+ *
+ * Glyphs are keyed by the local font family they were rasterized with, the font stack and the
+ * glyph ID. When a path is given, glyphs are also appended to a file there in batches, off the
+ * calling thread, and the glyphs an earlier process stored in it are loaded when the cache is
+ * created. Each record carries a checksum, and processes sharing the file take an advisory lock
+ * on it while writing. The file is in host byte order and is discarded when its format version
+ * doesn't match, so it isn't meant to be moved between machines.
+ */
+class GlyphCache {
+public:
+    explicit GlyphCache(std::size_t maxBytes, std::optional<std::string> path = std::nullopt);
+    ~GlyphCache();
+
+    GlyphCache(const GlyphCache&) = delete;
+    GlyphCache& operator=(const GlyphCache&) = delete;
+
+    /// Returns the process-wide cache configured through the EXPERIMENTAL_GLYPH_CACHE_SIZE and
+    /// EXPERIMENTAL_GLYPH_CACHE_PATH settings, or null when no size is set.
+    static std::shared_ptr<GlyphCache> getShared();
+
+    std::optional<Immutable<Glyph>> get(const std::string& fontFamily, const FontStack&, GlyphID);
+    void put(const std::string& fontFamily, const FontStack&, Immutable<Glyph>);
+
+    void setMaxBytes(std::size_t);
+    std::size_t getMaxBytes() const;
+
+    GlyphCacheStats getStats() const;
+
+    /// Removes all glyphs from memory, and truncates the cache file
+    void clear();
+
+private:
+    class Impl;
+    const std::shared_ptr<Impl> impl;
+};
+
+} // namespace mln
@@ -18,9 +18,13 @@ namespace {
 GlyphManagerObserver nullObserver;
 }
 
-GlyphManager::GlyphManager(std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_)
+GlyphManager::GlyphManager(std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer_,
+                           std::shared_ptr<GlyphCache> glyphCache_,
+                           std::string localFontFamily_)
     : observer(&nullObserver),
-      localGlyphRasterizer(std::move(localGlyphRasterizer_)) {}
+      localGlyphRasterizer(std::move(localGlyphRasterizer_)),
+      glyphCache(std::move(glyphCache_)),
+      localFontFamily(std::move(localFontFamily_)) {}
 
 GlyphManager::~GlyphManager() {
     hbShapers.clear(); // clear harfbuzz + freetype face before library;
@@ -44,7 +48,7 @@ void GlyphManager::getGlyphs(GlyphRequestor& requestor, GlyphDependencies glyphD
             for (const auto& glyphID : glyphIDs) {
                 if (localGlyphRasterizer->canRasterizeGlyph(fontStack, glyphID)) {
                     if (entry.glyphs.find(glyphID) == entry.glyphs.end()) {
-                        entry.glyphs.emplace(glyphID, makeMutable<Glyph>(generateLocalSDF(fontStack, glyphID)));
+                        entry.glyphs.emplace(glyphID, getLocalGlyph(fontStack, glyphID));
                     }
                 } else {
                     ranges.insert(getGlyphRange(glyphID));
@@ -76,6 +80,20 @@ Glyph GlyphManager::generateLocalSDF(const FontStack& fontStack, GlyphID glyphID
     return local;
 }
 
+Immutable<Glyph> GlyphManager::getLocalGlyph(const FontStack& fontStack, GlyphID glyphID) {
+    if (glyphCache) {
+        if (auto cached = glyphCache->get(localFontFamily, fontStack, glyphID)) {
+            return std::move(*cached);
+        }
+    }
+
+    Immutable<Glyph> glyph = makeMutable<Glyph>(generateLocalSDF(fontStack, glyphID));
+    if (glyphCache) {
+        glyphCache->put(localFontFamily, fontStack, glyph);
+    }
+    return glyph;
+}
+
 void GlyphManager::requestRange(GlyphRequest& request,
                                 const FontStack& fontStack,
                                 const GlyphRange& range,
@@ -248,9 +266,17 @@ void GlyphManager::hbShaping(const std::u16string& text,
                              GlyphIDType type,
                              std::vector<GlyphID>& glyphIDs,
                              std::vector<HBShapeAdjust>& adjusts) {
+    const std::string fontFace = shapingCache ? getFontFaceURL(type) : std::string();
+    if (shapingCache && shapingCache->getHBShaping(fontFace, font, type, text, glyphIDs, adjusts)) {
+        return;
+    }
+
     auto shaper = getHBShaper(font, type);
     if (shaper) {
         shaper->createComplexGlyphIDs(text, glyphIDs, adjusts);
+        if (shapingCache) {
+            shapingCache->putHBShaping(fontFace, font, type, text, glyphIDs, adjusts);
+        }
     }
 }
 
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <mbgl/text/glyph.hpp>
+#include <mbgl/text/glyph_cache.hpp>
 #include <mbgl/text/glyph_manager_observer.hpp>
 #include <mbgl/text/glyph_range.hpp>
 #include <mbgl/text/local_glyph_rasterizer.hpp>
+#include <mbgl/text/shaping_cache.hpp>
 #include <mbgl/util/font_stack.hpp>
 #include <mbgl/util/immutable.hpp>
 
@@ -44,8 +46,12 @@ class GlyphManager {
 public:
     GlyphManager(const GlyphManager &) = delete;
     GlyphManager &operator=(const GlyphManager &) = delete;
+    // Glyphs generated from local fonts are shared with other glyph managers through the glyph
+    // cache, if one is given, keyed by the font family the rasterizer was created with.
     explicit GlyphManager(
-        std::unique_ptr<LocalGlyphRasterizer> = std::make_unique<LocalGlyphRasterizer>(std::optional<std::string>()));
+        std::unique_ptr<LocalGlyphRasterizer> = std::make_unique<LocalGlyphRasterizer>(std::optional<std::string>()),
+        std::shared_ptr<GlyphCache> = nullptr,
+        std::string localFontFamily = {});
     ~GlyphManager();
 
     // Workers send a `getGlyphs` message to the main thread once they have
@@ -69,6 +75,9 @@ public:
 
     std::shared_ptr<HBShaper> getHBShaper(FontStack, GlyphIDType);
 
+    // HarfBuzz shaping results are kept in the shaping cache, if one is set
+    void setShapingCache(std::shared_ptr<ShapingCache> cache) { shapingCache = std::move(cache); }
+
     void hbShaping(const std::u16string &text,
                    const FontStack &font,
                    GlyphIDType type,
@@ -81,6 +90,7 @@ public:
 
 private:
     Glyph generateLocalSDF(const FontStack &fontStack, GlyphID glyphID);
+    Immutable<Glyph> getLocalGlyph(const FontStack &fontStack, GlyphID glyphID);
     std::string glyphURL;
 
     struct GlyphRequest {
@@ -104,6 +114,9 @@ private:
 
     // Shaping objects
     std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer;
+    std::shared_ptr<GlyphCache> glyphCache;
+    const std::string localFontFamily;
+    std::shared_ptr<ShapingCache> shapingCache;
     std::shared_ptr<FontFaces> fontFaces;
 
     FreeTypeLibrary ftLibrary;
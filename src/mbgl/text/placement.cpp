@@ -1,6 +1,8 @@
 #include <mbgl/text/placement.hpp>
 
+#include <mbgl/actor/scheduler.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/bucket.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/render_layer.hpp>
@@ -9,7 +11,10 @@
 #include <mbgl/tile/geometry_tile.hpp>
 #include <mbgl/util/instrumentation.hpp>
 #include <mbgl/util/math.hpp>
+#include <mbgl/util/parallel_jobs.hpp>
 
+#include <algorithm>
+#include <cmath>
 #include <list>
 #include <utility>
 
@@ -49,12 +54,7 @@ const CollisionGroups::CollisionGroup& CollisionGroups::get(const std::string& s
     if (!crossSourceCollisions) {
         if (!collisionGroups.contains(sourceID)) {
             uint16_t nextGroupID = ++maxGroupID;
-            collisionGroups.emplace(
-                sourceID,
-                CollisionGroup(nextGroupID,
-                               std::optional<Predicate>([nextGroupID](const RefIndexedSubfeature& feature) -> bool {
-                                   return feature.getCollisionGroupId() == nextGroupID;
-                               })));
+            collisionGroups.emplace(sourceID, CollisionGroup(nextGroupID, CollisionGroupPredicate{nextGroupID}));
         }
         return collisionGroups[sourceID];
     } else {
@@ -147,6 +147,181 @@ public:
     std::optional<CollisionBoundaries> avoidEdges;
 };
 
+// Incremental placement
+
+namespace {
+
+// Bound on the memory a placement holds to record what its symbols were placed with
+constexpr std::size_t maxSymbolRecordBytes = 16 * 1024 * 1024;
+
+std::size_t getRecordBytes(const std::vector<ProjectedCollisionBox>& textBoxes,
+                           const std::vector<ProjectedCollisionBox>& iconBoxes) {
+    // The record, its node in the map, and its boxes
+    return 64 + (textBoxes.size() + iconBoxes.size()) * sizeof(ProjectedCollisionBox);
+}
+
+std::optional<CollisionBoundaries> getBoundaries(const ProjectedCollisionBox& box) {
+    if (box.isBox()) {
+        const auto& b = box.box();
+        return CollisionBoundaries{{b.min.x, b.min.y, b.max.x, b.max.y}};
+    }
+    if (box.isCircle()) {
+        const auto& c = box.circle();
+        return CollisionBoundaries{
+            {c.center.x - c.radius, c.center.y - c.radius, c.center.x + c.radius, c.center.y + c.radius}};
+    }
+    return std::nullopt;
+}
+} // namespace
+
+/// The state of a placement that reuses the results of the previous one. Symbols are visited in the
+/// order they are placed; the result of one is reused when the previous placement saw all of its
+/// predecessors again before it, and none of them changed the collision grid where it was tested.
+class Placement::IncrementalPass {
+public:
+    explicit IncrementalPass(const CollisionIndex& collisionIndex) {
+        const Size size = collisionIndex.getTransformState().getSize();
+        const float padding = collisionIndex.getViewportPadding();
+        screen = {{padding, padding, size.width + padding, size.height + padding}};
+        grid = {{0.0f, 0.0f, size.width + 2 * padding, size.height + 2 * padding}};
+        columns = static_cast<std::size_t>(std::ceil(grid[2] / cellSize));
+        rows = static_cast<std::size_t>(std::ceil(grid[3] / cellSize));
+        dirty.assign(columns * rows, false);
+    }
+
+    /// Reuses the records of the previous placement, except for the `seen` ones, at a camera moved by `shift_`
+    void start(const Placement& prevPlacement, Point<float> shift_, std::vector<bool> seen) {
+        prev = &prevPlacement;
+        shift = shift_;
+        visited = std::move(seen);
+        advance();
+    }
+
+    /// Marks a previous record as seen, returns whether all the ones placed before it were seen already
+    bool visit(uint32_t order) {
+        const bool inOrder = order == nextOrder;
+        if (order < visited.size()) {
+            visited[order] = true;
+        }
+        advance();
+        return inOrder;
+    }
+
+    CollisionBoundaries shifted(const CollisionBoundaries& bounds) const {
+        return {{bounds[0] + shift.x, bounds[1] + shift.y, bounds[2] + shift.x, bounds[3] + shift.y}};
+    }
+
+    ProjectedCollisionBox shifted(const ProjectedCollisionBox& box) const {
+        if (box.isBox()) {
+            const auto& b = box.box();
+            return {b.min.x + shift.x, b.min.y + shift.y, b.max.x + shift.x, b.max.y + shift.y};
+        }
+        if (box.isCircle()) {
+            const auto& c = box.circle();
+            return {c.center.x + shift.x, c.center.y + shift.y, c.radius};
+        }
+        return box;
+    }
+
+    /// Whether the checks against the grid and screen edges come out the same at both positions
+    bool isStable(const CollisionBoundaries& prevBounds, const CollisionBoundaries& bounds) const {
+        const auto inside = [](const CollisionBoundaries& b, const CollisionBoundaries& area) {
+            return b[0] >= area[0] && b[1] >= area[1] && b[2] < area[2] && b[3] < area[3];
+        };
+        const auto outside = [](const CollisionBoundaries& b, const CollisionBoundaries& area) {
+            return b[2] < area[0] || b[3] < area[1] || b[0] >= area[2] || b[1] >= area[3];
+        };
+        return inside(prevBounds, grid) && inside(bounds, grid) &&
+               ((inside(prevBounds, screen) && inside(bounds, screen)) ||
+                (outside(prevBounds, screen) && outside(bounds, screen)));
+    }
+
+    /// Whether boxes of the previous placement moved along with the camera to where `boxes` are
+    bool moved(const std::vector<ProjectedCollisionBox>& prevBoxes,
+               const std::vector<ProjectedCollisionBox>& boxes) const {
+        constexpr float tolerance = 0.05f;
+        if (prevBoxes.size() != boxes.size()) return false;
+        for (std::size_t i = 0; i < boxes.size(); ++i) {
+            const auto prevBounds = getBoundaries(prevBoxes[i]);
+            const auto bounds = getBoundaries(boxes[i]);
+            if (prevBoxes[i].isCircle() != boxes[i].isCircle() || prevBounds.has_value() != bounds.has_value()) {
+                return false;
+            }
+            if (bounds) {
+                const auto movedBounds = shifted(*prevBounds);
+                for (std::size_t j = 0; j < 4; ++j) {
+                    if (std::abs(movedBounds[j] - (*bounds)[j]) > tolerance) return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    /// Marks where boxes of this placement, or the previous one when `prevPlacement`, are
+    void markDirty(const std::vector<ProjectedCollisionBox>& boxes, bool prevPlacement = false) {
+        for (const auto& box : boxes) {
+            if (const auto bounds = getBoundaries(box)) {
+                markDirty(prevPlacement ? shifted(*bounds) : *bounds);
+            }
+        }
+    }
+
+    void markDirty(const CollisionBoundaries& bounds) {
+        forEachCell(bounds, [&](std::size_t cell) {
+            dirty[cell] = true;
+            return true;
+        });
+    }
+
+    bool isDirty(const CollisionBoundaries& bounds) const {
+        bool found = false;
+        forEachCell(bounds, [&](std::size_t cell) {
+            found = dirty[cell];
+            return !found;
+        });
+        return found;
+    }
+
+    const Placement* prev = nullptr;
+    Point<float> shift{0.0f, 0.0f};
+    uint32_t order = 0;
+
+private:
+    void advance() {
+        while (nextOrder < visited.size() && visited[nextOrder]) {
+            ++nextOrder;
+        }
+    }
+
+    template <typename Fn>
+    void forEachCell(const CollisionBoundaries& bounds, Fn&& fn) const {
+        const auto cell = [](float value, std::size_t count) -> std::size_t {
+            const float index = value / cellSize;
+            if (!(index > 0.0f)) return 0;
+            if (index >= static_cast<float>(count - 1)) return count - 1;
+            return static_cast<std::size_t>(index);
+        };
+        const std::size_t x1 = cell(bounds[0], columns);
+        const std::size_t x2 = cell(bounds[2], columns);
+        const std::size_t y1 = cell(bounds[1], rows);
+        const std::size_t y2 = cell(bounds[3], rows);
+        for (std::size_t y = y1; y <= y2; ++y) {
+            for (std::size_t x = x1; x <= x2; ++x) {
+                if (!fn(y * columns + x)) return;
+            }
+        }
+    }
+
+    static constexpr float cellSize = 25.0f;
+    CollisionBoundaries screen;
+    CollisionBoundaries grid;
+    std::size_t columns;
+    std::size_t rows;
+    std::vector<bool> dirty;
+    std::vector<bool> visited;
+    uint32_t nextOrder = 0;
+};
+
 // PlacementController implementation
 
 PlacementController::PlacementController()
@@ -155,6 +330,12 @@ PlacementController::PlacementController()
 void PlacementController::setPlacement(Immutable<Placement> placement_) {
     placement = std::move(placement_);
     stale = false;
+
+    const PlacementStats placementStats = placement->getStats();
+    stats.placements += placementStats.placements;
+    stats.symbolsPlaced += placementStats.symbolsPlaced;
+    stats.symbolsReused += placementStats.symbolsReused;
+    stats.recordBytes = placementStats.recordBytes;
 }
 
 bool PlacementController::placementIsRecent(TimePoint now,
@@ -190,6 +371,14 @@ Placement::Placement(std::shared_ptr<const UpdateParameters> updateParameters_,
     if (prevPlacement) {
         prevPlacement->get()->prevPlacement = std::nullopt; // Only hold on to one placement back
     }
+    if (updateParameters->mode == MapMode::Continuous && !showCollisionBoxes && !isTiltedView()) {
+        const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_INCREMENTAL_PLACEMENT);
+        const auto* enabled = value.getBool();
+        incremental = enabled && *enabled;
+    }
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PARALLEL_PLACEMENT);
+    const auto* enabled = value.getBool();
+    parallel = enabled && *enabled;
 }
 
 Placement::Placement()
@@ -198,14 +387,199 @@ Placement::Placement()
 
 Placement::~Placement() = default;
 
+PlacementStats Placement::getStats() const {
+    return {.placements = 1,
+            .symbolsPlaced = symbolsPlaced,
+            .symbolsReused = symbolsReused,
+            .recordBytes = symbolRecordBytes};
+}
+
 void Placement::placeLayers(const RenderLayerReferences& layers) {
+    if (incremental) {
+        beginIncrementalPass(layers);
+    }
+    if (parallel) {
+        projectLineLabels(layers);
+    }
     for (auto it = layers.crbegin(); it != layers.crend(); ++it) {
         std::set<uint32_t> seenCrossTileIDs;
         placeLayer(*it, seenCrossTileIDs);
     }
+    if (incrementalPass) {
+        symbolRecordCount = incrementalPass->order;
+        incrementalPass.reset();
+    }
+    projectedLines.clear();
     commit();
 }
 
+void Placement::beginIncrementalPass(const RenderLayerReferences& layers) {
+    incrementalPass = std::make_unique<IncrementalPass>(collisionIndex);
+
+    // Symbols can keep their results when the camera only moved, as their boxes move along with it.
+    const Placement* prev = getPrevPlacement();
+    const TransformState& state = collisionIndex.getTransformState();
+    const bool panned = prev && prev->incremental && prev->updateParameters &&
+                        prev->updateParameters->transformState.getSize() == state.getSize() &&
+                        prev->updateParameters->transformState.getZoom() == state.getZoom() &&
+                        prev->updateParameters->transformState.getBearing() == state.getBearing();
+
+    std::unordered_set<uint32_t> bucketInstanceIds;
+    std::optional<Point<float>> shift;
+    for (const RenderLayer& layer : layers) {
+        for (const BucketPlacementData& data : layer.getPlacementData()) {
+            const auto& bucket = static_cast<const SymbolBucket&>(data.bucket.get());
+            const auto bounds = collisionIndex.projectTileBoundaries(data.tile.get().matrix);
+            tileBoundaries.emplace(bucket.bucketInstanceId, bounds);
+            bucketInstanceIds.insert(bucket.bucketInstanceId);
+            if (panned && !shift) {
+                const auto prevBounds = prev->tileBoundaries.find(bucket.bucketInstanceId);
+                if (prevBounds != prev->tileBoundaries.end()) {
+                    shift = Point<float>{bounds[0] - prevBounds->second[0], bounds[1] - prevBounds->second[1]};
+                }
+            }
+        }
+    }
+    if (!shift) return;
+
+    std::vector<bool> seen(prev->symbolRecordCount, true);
+    std::vector<const SymbolRecord*> removed;
+    for (const auto& [crossTileID, record] : prev->symbolRecords) {
+        if (bucketInstanceIds.contains(record.bucketInstanceId)) {
+            seen[record.order] = false;
+        } else {
+            removed.push_back(&record);
+        }
+    }
+    incrementalPass->start(*prev, *shift, std::move(seen));
+
+    // Symbols of the tiles that went away no longer take up their place in the grid
+    for (const SymbolRecord* record : removed) {
+        incrementalPass->markDirty(record->textBoxes, true);
+        incrementalPass->markDirty(record->iconBoxes, true);
+    }
+}
+
+// Parallel placement
+
+namespace {
+
+/// The text along lines of a range of symbols of a bucket, projected as `Placement::placeSymbol()` places it
+struct LineProjectionJob {
+    std::size_t context;
+    std::size_t begin;
+    std::size_t end;
+    std::vector<std::pair<const CollisionFeature*, CollisionIndex::ProjectedLineFeature>> results;
+};
+
+/// The buckets whose labels are projected, and the jobs they are split into
+struct LineProjections {
+    explicit LineProjections(const CollisionIndex& collisionIndex_)
+        : collisionIndex(collisionIndex_) {}
+
+    void run(LineProjectionJob&) const;
+
+    const CollisionIndex& collisionIndex;
+    std::vector<PlacementContext> contexts;
+    std::vector<LineProjectionJob> jobs;
+};
+
+void LineProjections::run(LineProjectionJob& job) const {
+    const PlacementContext& ctx = contexts[job.context];
+    const SymbolBucket& bucket = ctx.getBucket();
+    const mat4& posMatrix = ctx.getRenderTile().matrix;
+    try {
+        for (std::size_t i = job.begin; i < job.end; ++i) {
+            const SymbolInstance& symbol = bucket.symbolInstances[i];
+            const auto index = symbol.getDefaultHorizontalPlacedTextIndex();
+            if (!index) {
+                continue;
+            }
+            const PlacedSymbol& placedSymbol = bucket.text.placedSymbols.at(*index);
+            const float fontSize = evaluateSizeForFeature(ctx.partiallyEvaluatedTextSize, placedSymbol);
+            const auto project = [&](const CollisionFeature& feature) {
+                if (feature.alongLine) {
+                    job.results.emplace_back(&feature,
+                                             collisionIndex.projectLineFeature(feature,
+                                                                               posMatrix,
+                                                                               ctx.textLabelPlaneMatrix,
+                                                                               ctx.pixelRatio,
+                                                                               placedSymbol,
+                                                                               ctx.scale,
+                                                                               fontSize,
+                                                                               ctx.pitchTextWithMap));
+                }
+            };
+            project(symbol.getTextCollisionFeature());
+            if (bucket.allowVerticalPlacement && symbol.getVerticalTextCollisionFeature()) {
+                project(*symbol.getVerticalTextCollisionFeature());
+            }
+        }
+    } catch (...) {
+        // Placement projects these symbols itself, and reports what is wrong with them
+        job.results.clear();
+    }
+}
+
+// Symbols per job, enough to outweigh scheduling a job
+constexpr std::size_t lineProjectionJobSize = 256;
+
+} // namespace
+
+void Placement::projectLineLabels(const RenderLayerReferences& layers) {
+    MLN_TRACE_FUNC();
+
+    // Symbols are tested against the collision grid as the symbols placed before them left it, but projecting
+    // labels along lines, the larger part of placing them, doesn't depend on the grid and is done here for all
+    // buckets at once. The buckets are only read meanwhile, as the calling thread waits for the helpers.
+    LineProjections state(collisionIndex);
+    std::unordered_set<const SymbolBucket*> buckets;
+    for (const RenderLayer& layer : layers) {
+        for (const BucketPlacementData& data : layer.getPlacementData()) {
+            const auto& bucket = static_cast<const SymbolBucket&>(data.bucket.get());
+            if (data.tile.get().holdForFade() || !buckets.insert(&bucket).second) {
+                continue;
+            }
+            const std::size_t context = state.contexts.size();
+            state.contexts.emplace_back(bucket,
+                                        data.tile,
+                                        collisionIndex.getTransformState(),
+                                        placementZoom,
+                                        CollisionGroups::CollisionGroup{});
+            for (std::size_t begin = 0; begin < bucket.symbolInstances.size(); begin += lineProjectionJobSize) {
+                const std::size_t end = std::min(begin + lineProjectionJobSize, bucket.symbolInstances.size());
+                state.jobs.push_back({.context = context, .begin = begin, .end = end, .results = {}});
+            }
+        }
+    }
+    if (state.jobs.empty()) {
+        return;
+    }
+
+    util::ParallelJobs parallelJobs(state.jobs.size(), [&](std::size_t i) { state.run(state.jobs[i]); });
+    parallelJobs.schedule(*Scheduler::GetBackground());
+    parallelJobs.run();
+
+    std::size_t count = 0;
+    for (const auto& job : state.jobs) {
+        count += job.results.size();
+    }
+    projectedLines.reserve(count);
+    for (auto& job : state.jobs) {
+        for (auto& [feature, projected] : job.results) {
+            projectedLines.emplace(feature, std::move(projected));
+        }
+    }
+}
+
+const CollisionIndex::ProjectedLineFeature* Placement::getProjectedLine(const CollisionFeature& feature) const {
+    if (projectedLines.empty()) {
+        return nullptr;
+    }
+    const auto it = projectedLines.find(&feature);
+    return it != projectedLines.end() ? &it->second : nullptr;
+}
+
 void Placement::placeLayer(const RenderLayer& layer, std::set<uint32_t>& seenCrossTileIDs) {
     for (const BucketPlacementData& data : layer.getPlacementData()) {
         Bucket& bucket = data.bucket;
@@ -274,8 +648,19 @@ JointPlacement Placement::placeSymbol(const SymbolInstance& symbolInstance, cons
         // Mark all symbols from this tile as "not placed", but don't add to
         // seenCrossTileIDs, because we don't know yet if we have a duplicate in
         // a parent tile that _should_ be placed.
+        if (incrementalPass) {
+            invalidateSymbolPlacement(symbolInstance.getCrossTileID());
+        }
         return kUnplaced;
     }
+    if (incrementalPass) {
+        if (auto reused = reuseSymbolPlacement(symbolInstance, ctx)) {
+            ++symbolsReused;
+            return *reused;
+        }
+        footprint.reset();
+    }
+    ++symbolsPlaced;
     const SymbolBucket& bucket = ctx.getBucket();
     const mat4& posMatrix = ctx.getRenderTile().matrix;
     const auto& collisionGroup = ctx.collisionGroup;
@@ -341,7 +726,9 @@ JointPlacement Placement::placeSymbol(const SymbolInstance& symbolInstance, cons
                                                                  showCollisionBoxes,
                                                                  ctx.avoidEdges,
                                                                  collisionGroup.second,
-                                                                 textBoxes);
+                                                                 textBoxes,
+                                                                 getProjectedLine(collisionFeature));
+                extendFootprint(textBoxes);
                 if (placedFeature.first) {
                     placedOrientations.emplace(symbolInstance.getCrossTileID(), orientation);
                 }
@@ -436,6 +823,7 @@ JointPlacement Placement::placeSymbol(const SymbolInstance& symbolInstance, cons
                                                                 ctx.avoidEdges,
                                                                 collisionGroup.second,
                                                                 textBoxes);
+                    extendFootprint(textBoxes);
 
                     if (doVariableIconPlacement) {
                         auto placedIconFeature = collisionIndex.placeFeature(
@@ -453,6 +841,7 @@ JointPlacement Placement::placeSymbol(const SymbolInstance& symbolInstance, cons
                             ctx.avoidEdges,
                             collisionGroup.second,
                             iconBoxes);
+                        extendFootprint(iconBoxes);
                         iconBoxes.clear();
                         if (!placedIconFeature.first) continue;
                     }
@@ -537,20 +926,22 @@ JointPlacement Placement::placeSymbol(const SymbolInstance& symbolInstance, cons
         const PlacedSymbol& placedSymbol = iconBuffer.placedSymbols.at(*symbolInstance.getPlacedIconIndex());
         const float fontSize = evaluateSizeForFeature(ctx.partiallyEvaluatedIconSize, placedSymbol);
         const auto& placeIconFeature = [&](const CollisionFeature& collisionFeature) {
-            return collisionIndex.placeFeature(collisionFeature,
-                                               shift,
-                                               posMatrix,
-                                               ctx.iconLabelPlaneMatrix,
-                                               ctx.pixelRatio,
-                                               placedSymbol,
-                                               ctx.scale,
-                                               fontSize,
-                                               ctx.iconAllowOverlap,
-                                               ctx.pitchTextWithMap,
-                                               showCollisionBoxes,
-                                               ctx.avoidEdges,
-                                               collisionGroup.second,
-                                               iconBoxes);
+            const auto placedFeature = collisionIndex.placeFeature(collisionFeature,
+                                                                   shift,
+                                                                   posMatrix,
+                                                                   ctx.iconLabelPlaneMatrix,
+                                                                   ctx.pixelRatio,
+                                                                   placedSymbol,
+                                                                   ctx.scale,
+                                                                   fontSize,
+                                                                   ctx.iconAllowOverlap,
+                                                                   ctx.pitchTextWithMap,
+                                                                   showCollisionBoxes,
+                                                                   ctx.avoidEdges,
+                                                                   collisionGroup.second,
+                                                                   iconBoxes);
+            extendFootprint(iconBoxes);
+            return placedFeature;
         };
 
         std::pair<bool, bool> placedIcon;
@@ -638,10 +1029,172 @@ JointPlacement Placement::placeSymbol(const SymbolInstance& symbolInstance, cons
     JointPlacement result(
         placeText || ctx.alwaysShowText, placeIcon || ctx.alwaysShowIcon, offscreen || bucket.justReloaded);
     placements.emplace(symbolInstance.getCrossTileID(), result);
+    if (incrementalPass) {
+        recordSymbolPlacement(symbolInstance,
+                              ctx,
+                              placeText,
+                              placeIcon,
+                              placedVerticalText.first && symbolInstance.getVerticalTextCollisionFeature(),
+                              placedVerticalIcon.first && symbolInstance.getVerticalIconCollisionFeature(),
+                              offscreen);
+    }
     newSymbolPlaced(symbolInstance, ctx, result, ctx.placementType, textBoxes, iconBoxes);
     return result;
 }
 
+std::optional<JointPlacement> Placement::reuseSymbolPlacement(const SymbolInstance& symbolInstance,
+                                                              const PlacementContext& ctx) {
+    IncrementalPass& pass = *incrementalPass;
+    if (!pass.prev) return std::nullopt;
+    const uint32_t crossTileID = symbolInstance.getCrossTileID();
+    const auto found = pass.prev->symbolRecords.find(crossTileID);
+    if (found == pass.prev->symbolRecords.end()) return std::nullopt;
+    const SymbolRecord& record = found->second;
+
+    const SymbolBucket& bucket = ctx.getBucket();
+    const bool inOrder = pass.visit(record.order);
+    if (!inOrder || record.bucketInstanceId != bucket.bucketInstanceId ||
+        record.collisionGroupId != ctx.collisionGroup.first) {
+        return std::nullopt;
+    }
+    const CollisionBoundaries bounds = pass.shifted(record.footprint);
+    if (!pass.isStable(record.footprint, bounds) || pass.isDirty(bounds)) return std::nullopt;
+    if ((record.verticalText && !symbolInstance.getVerticalTextCollisionFeature()) ||
+        (record.verticalIcon && !symbolInstance.getVerticalIconCollisionFeature())) {
+        return std::nullopt;
+    }
+
+    SymbolRecord moved = record;
+    moved.order = pass.order;
+    moved.footprint = bounds;
+    for (auto& box : moved.textBoxes) box = pass.shifted(box);
+    for (auto& box : moved.iconBoxes) box = pass.shifted(box);
+
+    if (moved.text) {
+        collisionIndex.insertFeature(moved.verticalText ? *symbolInstance.getVerticalTextCollisionFeature()
+                                                        : symbolInstance.getTextCollisionFeature(),
+                                     moved.textBoxes,
+                                     ctx.getLayout().get<TextIgnorePlacement>(),
+                                     bucket.bucketInstanceId,
+                                     ctx.collisionGroup.first);
+    }
+    if (moved.icon) {
+        collisionIndex.insertFeature(moved.verticalIcon ? *symbolInstance.getVerticalIconCollisionFeature()
+                                                        : symbolInstance.getIconCollisionFeature(),
+                                     moved.iconBoxes,
+                                     ctx.getLayout().get<IconIgnorePlacement>(),
+                                     bucket.bucketInstanceId,
+                                     ctx.collisionGroup.first);
+    }
+
+    if (const auto offset = pass.prev->variableOffsets.find(crossTileID); offset != pass.prev->variableOffsets.end()) {
+        variableOffsets.insert_or_assign(crossTileID, offset->second);
+    }
+    if (const auto orientation = pass.prev->placedOrientations.find(crossTileID);
+        orientation != pass.prev->placedOrientations.end()) {
+        placedOrientations.insert_or_assign(crossTileID, orientation->second);
+    }
+
+    JointPlacement result(
+        moved.text || ctx.alwaysShowText, moved.icon || ctx.alwaysShowIcon, moved.offscreen || bucket.justReloaded);
+    placements.erase(crossTileID);
+    placements.emplace(crossTileID, result);
+    storeSymbolRecord(crossTileID, std::move(moved));
+    return result;
+}
+
+void Placement::recordSymbolPlacement(const SymbolInstance& symbolInstance,
+                                      const PlacementContext& ctx,
+                                      bool placeText,
+                                      bool placeIcon,
+                                      bool verticalText,
+                                      bool verticalIcon,
+                                      bool offscreen) {
+    IncrementalPass& pass = *incrementalPass;
+    const uint32_t crossTileID = symbolInstance.getCrossTileID();
+    SymbolRecord record{.bucketInstanceId = ctx.getBucket().bucketInstanceId,
+                        .order = pass.order,
+                        .collisionGroupId = ctx.collisionGroup.first,
+                        .text = placeText,
+                        .icon = placeIcon,
+                        .verticalText = verticalText,
+                        .verticalIcon = verticalIcon,
+                        .offscreen = offscreen,
+                        .footprint = footprint.value_or(CollisionBoundaries{}),
+                        .textBoxes = placeText ? textBoxes : std::vector<ProjectedCollisionBox>(),
+                        .iconBoxes = placeIcon ? iconBoxes : std::vector<ProjectedCollisionBox>()};
+
+    // Symbols placed after this one have to be placed again where it changed the grid
+    if (pass.prev) {
+        const auto found = pass.prev->symbolRecords.find(crossTileID);
+        const SymbolRecord* prevRecord = found != pass.prev->symbolRecords.end() ? &found->second : nullptr;
+        if (!prevRecord || prevRecord->text != record.text || prevRecord->icon != record.icon ||
+            prevRecord->verticalText != record.verticalText || prevRecord->verticalIcon != record.verticalIcon ||
+            !pass.moved(prevRecord->textBoxes, record.textBoxes) ||
+            !pass.moved(prevRecord->iconBoxes, record.iconBoxes)) {
+            if (prevRecord) {
+                pass.markDirty(prevRecord->textBoxes, true);
+                pass.markDirty(prevRecord->iconBoxes, true);
+            }
+            pass.markDirty(record.textBoxes);
+            pass.markDirty(record.iconBoxes);
+        }
+    }
+
+    if (footprint) {
+        storeSymbolRecord(crossTileID, std::move(record));
+    } else {
+        eraseSymbolRecord(crossTileID);
+    }
+}
+
+void Placement::storeSymbolRecord(uint32_t crossTileID, SymbolRecord&& record) {
+    eraseSymbolRecord(crossTileID);
+    const std::size_t recordBytes = getRecordBytes(record.textBoxes, record.iconBoxes);
+    if (symbolRecordBytes + recordBytes > maxSymbolRecordBytes) {
+        return;
+    }
+    symbolRecordBytes += recordBytes;
+    ++incrementalPass->order;
+    symbolRecords.emplace(crossTileID, std::move(record));
+}
+
+void Placement::eraseSymbolRecord(uint32_t crossTileID) {
+    const auto found = symbolRecords.find(crossTileID);
+    if (found != symbolRecords.end()) {
+        symbolRecordBytes -= getRecordBytes(found->second.textBoxes, found->second.iconBoxes);
+        symbolRecords.erase(found);
+    }
+}
+
+void Placement::invalidateSymbolPlacement(uint32_t crossTileID) {
+    IncrementalPass& pass = *incrementalPass;
+    if (!pass.prev) return;
+    const auto found = pass.prev->symbolRecords.find(crossTileID);
+    if (found != pass.prev->symbolRecords.end()) {
+        pass.visit(found->second.order);
+        pass.markDirty(found->second.textBoxes, true);
+        pass.markDirty(found->second.iconBoxes, true);
+    }
+}
+
+void Placement::extendFootprint(const std::vector<ProjectedCollisionBox>& boxes) {
+    if (!incrementalPass) return;
+    for (const auto& box : boxes) {
+        const auto bounds = getBoundaries(box);
+        if (!bounds) continue;
+        if (!footprint) {
+            footprint = bounds;
+        } else {
+            auto& extended = *footprint;
+            extended = {{std::min(extended[0], (*bounds)[0]),
+                         std::min(extended[1], (*bounds)[1]),
+                         std::max(extended[2], (*bounds)[2]),
+                         std::max(extended[3], (*bounds)[3])}};
+        }
+    }
+}
+
 namespace {
 
 SymbolInstanceReferences getBucketSymbols(const SymbolBucket& bucket,
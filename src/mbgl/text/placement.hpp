@@ -5,6 +5,7 @@
 #include <mbgl/style/transition_options.hpp>
 #include <mbgl/text/collision_index.hpp>
 #include <mbgl/util/chrono.hpp>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -77,8 +78,7 @@ struct RetainedQueryData {
 
 class CollisionGroups {
 public:
-    using Predicate = std::function<bool(const RefIndexedSubfeature&)>;
-    using CollisionGroup = std::pair<uint16_t, std::optional<Predicate>>;
+    using CollisionGroup = std::pair<uint16_t, std::optional<CollisionGroupPredicate>>;
 
     CollisionGroups(const bool crossSourceCollisions_)
         : maxGroupID(0),
@@ -102,10 +102,12 @@ public:
     void setPlacementStale() { stale = true; }
     bool placementIsRecent(TimePoint now, float zoom, std::optional<Duration> periodOverride = std::nullopt) const;
     bool hasTransitions(TimePoint now) const;
+    const PlacementStats& getStats() const { return stats; }
 
 private:
     Immutable<Placement> placement;
     bool stale = false;
+    PlacementStats stats;
 };
 
 class Placement {
@@ -131,6 +133,8 @@ public:
 
     const CollisionIndex& getCollisionIndex() const;
     TimePoint getCommitTime() const { return commitTime; }
+    /// The symbols this placement placed and reused, and the bytes of its records
+    PlacementStats getStats() const;
     Duration getUpdatePeriod(float zoom) const;
 
     float zoomAdjustment(float zoom) const;
@@ -181,6 +185,41 @@ protected:
     const Placement* getPrevPlacement() const { return prevPlacement ? prevPlacement->get() : nullptr; }
     bool isTiltedView() const;
 
+    // Incremental placement, see EXPERIMENTAL_INCREMENTAL_PLACEMENT.
+    // What a symbol was placed with, in the collision grid coordinates of this placement.
+    struct SymbolRecord {
+        uint32_t bucketInstanceId;
+        uint32_t order;
+        uint16_t collisionGroupId;
+        bool text;
+        bool icon;
+        bool verticalText;
+        bool verticalIcon;
+        bool offscreen;
+        // Bounds of all boxes the symbol was tested with, including the ones of rejected anchors
+        CollisionBoundaries footprint;
+        std::vector<ProjectedCollisionBox> textBoxes;
+        std::vector<ProjectedCollisionBox> iconBoxes;
+    };
+    class IncrementalPass;
+    void beginIncrementalPass(const RenderLayerReferences&);
+    std::optional<JointPlacement> reuseSymbolPlacement(const SymbolInstance&, const PlacementContext&);
+    void recordSymbolPlacement(const SymbolInstance&,
+                               const PlacementContext&,
+                               bool placeText,
+                               bool placeIcon,
+                               bool verticalText,
+                               bool verticalIcon,
+                               bool offscreen);
+    void invalidateSymbolPlacement(uint32_t crossTileID);
+    void storeSymbolRecord(uint32_t crossTileID, SymbolRecord&&);
+    void eraseSymbolRecord(uint32_t crossTileID);
+    void extendFootprint(const std::vector<ProjectedCollisionBox>&);
+
+    // Parallel placement, see EXPERIMENTAL_PARALLEL_PLACEMENT.
+    void projectLineLabels(const RenderLayerReferences&);
+    const CollisionIndex::ProjectedLineFeature* getProjectedLine(const CollisionFeature&) const;
+
     std::shared_ptr<const UpdateParameters> updateParameters;
     CollisionIndex collisionIndex;
 
@@ -206,6 +245,24 @@ protected:
     std::vector<ProjectedCollisionBox> iconBoxes;
     // Used for debug purposes.
     std::unordered_map<const CollisionFeature*, std::vector<ProjectedCollisionBox>> collisionCircles;
+
+    bool incremental = false;
+    std::unordered_map<uint32_t, SymbolRecord> symbolRecords;
+    uint32_t symbolRecordCount = 0;
+    // Approximate memory held by the records, which is bounded: symbols past the bound aren't recorded,
+    // and are placed in full by the next placement
+    std::size_t symbolRecordBytes = 0;
+    // Symbols tested against the collision grid, and symbols which kept their previous result
+    std::uint64_t symbolsPlaced = 0;
+    std::uint64_t symbolsReused = 0;
+    // Projected tile boundaries by bucket instance ID, to find the camera delta to the next placement
+    std::unordered_map<uint32_t, CollisionBoundaries> tileBoundaries;
+    std::unique_ptr<IncrementalPass> incrementalPass;
+    std::optional<CollisionBoundaries> footprint;
+
+    bool parallel = false;
+    // Line labels projected ahead of placement, by collision feature
+    std::unordered_map<const CollisionFeature*, CollisionIndex::ProjectedLineFeature> projectedLines;
 };
 
 } // namespace mln
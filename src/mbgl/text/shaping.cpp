@@ -402,7 +402,8 @@ std::set<std::size_t> determineLineBreaks(const TaggedString& logicalInput,
     return leastBadBreaks(evaluateBreak(logicalInput.length(), currentX, targetWidth, potentialBreaks, 0, true));
 }
 
-void shapeLines(Shaping& shaping,
+// Returns whether every glyph was positioned from `glyphPositions`
+bool shapeLines(Shaping& shaping,
                 std::vector<TaggedString>& lines,
                 const float spacing,
                 const float lineHeight,
@@ -414,6 +415,7 @@ void shapeLines(Shaping& shaping,
                 const ImagePositions& imagePositions,
                 float layoutTextSize,
                 bool allowVerticalPlacement) {
+    bool complete = true;
     float x = 0.0f;
     float y = Shaping::yOffset;
 
@@ -475,6 +477,7 @@ void shapeLines(Shaping& shaping,
             if (!section.imageID) {
                 auto glyphPositionMap = glyphPositions.find(section.fontStackHash);
                 if (glyphPositionMap == glyphPositions.end()) {
+                    complete = false;
                     continue;
                 }
 
@@ -483,6 +486,7 @@ void shapeLines(Shaping& shaping,
                     rect = glyphPosition->second.rect;
                     metrics = glyphPosition->second.metrics;
                 } else {
+                    complete = false;
                     auto glyphs = glyphMap.find(section.fontStackHash);
                     if (glyphs == glyphMap.end()) {
                         continue;
@@ -511,6 +515,8 @@ void shapeLines(Shaping& shaping,
                 // we scale up or down.
                 baselineOffset = (lineMaxScale - sectionScale) * util::ONE_EM;
             } else {
+                // Images are positioned from the atlas of the tile
+                complete = false;
                 auto image = imagePositions.find(*section.imageID);
                 if (image == imagePositions.end()) {
                     continue;
@@ -606,6 +612,7 @@ void shapeLines(Shaping& shaping,
     shaping.bottom = shaping.top + height;
     shaping.left += -anchorAlign.horizontalAlign * maxLineLength;
     shaping.right = shaping.left + maxLineLength;
+    return complete;
 }
 
 Shaping getShaping(const TaggedString& formattedString,
@@ -622,7 +629,8 @@ Shaping getShaping(const TaggedString& formattedString,
                    const ImagePositions& imagePositions,
                    float layoutTextSize,
                    float layoutTextSizeAtBucketZoomLevel,
-                   bool allowVerticalPlacement) {
+                   bool allowVerticalPlacement,
+                   bool* complete) {
     assert(layoutTextSize);
     std::vector<TaggedString> reorderedLines;
     if (formattedString.rawText().length()) {
@@ -743,18 +751,21 @@ Shaping getShaping(const TaggedString& formattedString,
     }
 
     Shaping shaping(translate[0], translate[1], writingMode);
-    shapeLines(shaping,
-               reorderedLines,
-               spacing,
-               lineHeight,
-               textAnchor,
-               textJustify,
-               writingMode,
-               glyphMap,
-               glyphPositions,
-               imagePositions,
-               layoutTextSizeAtBucketZoomLevel,
-               allowVerticalPlacement);
+    const bool positioned = shapeLines(shaping,
+                                       reorderedLines,
+                                       spacing,
+                                       lineHeight,
+                                       textAnchor,
+                                       textJustify,
+                                       writingMode,
+                                       glyphMap,
+                                       glyphPositions,
+                                       imagePositions,
+                                       layoutTextSizeAtBucketZoomLevel,
+                                       allowVerticalPlacement);
+    if (complete) {
+        *complete = positioned;
+    }
 
     return shaping;
 }
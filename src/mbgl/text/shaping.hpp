@@ -70,6 +70,8 @@ public:
     const Padding& collisionPadding() const { return _collisionPadding; }
 };
 
+// When given, `complete` is set to whether every glyph was positioned from `glyphPositions`, in which
+// case the shaping doesn't depend on the atlas of the tile other than through the glyph rects.
 Shaping getShaping(const TaggedString& string,
                    float maxWidth,
                    float lineHeight,
@@ -84,6 +86,7 @@ Shaping getShaping(const TaggedString& string,
                    const ImagePositions& imagePositions,
                    float layoutTextSize,
                    float layoutTextSizeAtBucketZoomLevel,
-                   bool allowVerticalPlacement);
+                   bool allowVerticalPlacement,
+                   bool* complete = nullptr);
 
 } // namespace mln
@@ -0,0 +1,370 @@
+#include <mbgl/text/shaping_cache.hpp>
+
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/text/tagged_string.hpp>
+#include <mbgl/util/lru_cache.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <functional>
+#include <mutex>
+
+namespace mln {
+
+namespace {
+
+// Rough size of an entry besides its key and contents
+constexpr std::size_t entryOverhead = 128;
+
+struct CachedShaping {
+    Shaping shaping;
+    // Advances line breaking measured the characters of the string with, empty without a max width
+    std::vector<int64_t> advances;
+};
+
+struct HBShaping {
+    std::vector<GlyphID> glyphIDs;
+    std::vector<HBShapeAdjust> adjusts;
+};
+
+template <typename T>
+void write(std::string& key, const T& value) {
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Everything the shaping of a string depends on besides glyph metrics. The text sizes only matter
+// for images, which aren't cached.
+std::string makeShapingKey(const TaggedString& string,
+                           float maxWidth,
+                           float lineHeight,
+                           style::SymbolAnchorType textAnchor,
+                           style::TextJustifyType textJustify,
+                           float spacing,
+                           const std::array<float, 2>& translate,
+                           WritingModeType writingMode,
+                           bool allowVerticalPlacement) {
+    std::string key;
+    key.reserve(64 + string.sectionCount() * 32 + string.length() * 3);
+    key += 's';
+    write(key, maxWidth);
+    write(key, lineHeight);
+    write(key, textAnchor);
+    write(key, textJustify);
+    write(key, spacing);
+    write(key, translate);
+    write(key, writingMode);
+    write(key, static_cast<uint8_t>(allowVerticalPlacement));
+
+    write(key, static_cast<uint32_t>(string.sectionCount()));
+    for (const auto& section : string.getSections()) {
+        write(key, section.scale);
+        write(key, section.fontStackHash);
+        write(key, section.type);
+        write(key, section.startIndex);
+        write(key, static_cast<uint32_t>(section.adjusts ? section.adjusts->size() : 0));
+        if (section.adjusts) {
+            for (const auto& adjust : *section.adjusts) {
+                write(key, adjust.x_offset);
+                write(key, adjust.y_offset);
+                write(key, adjust.advance);
+            }
+        }
+    }
+
+    const auto& [text, sectionIndices] = string.getStyledText();
+    key.append(reinterpret_cast<const char*>(text.data()), text.size() * sizeof(char16_t));
+    key.append(reinterpret_cast<const char*>(sectionIndices.data()), sectionIndices.size());
+    return key;
+}
+
+std::string makeHBKey(const std::string& fontFace,
+                      const FontStack& fontStack,
+                      GlyphIDType type,
+                      const std::u16string& text) {
+    std::string key = "h";
+    key += fontFace;
+    key += '\n';
+    for (const auto& font : fontStack) {
+        key += font;
+        key += '\n';
+    }
+    write(key, type);
+    key.append(reinterpret_cast<const char*>(text.data()), text.size() * sizeof(char16_t));
+    return key;
+}
+
+// The advance line breaking measures a character with, or -1 when its glyph is missing
+int64_t getAdvance(const TaggedString& string, std::size_t index, const GlyphMap& glyphMap) {
+    const SectionOptions& section = string.getSection(index);
+    if (section.type != GlyphIDType::FontPBF) {
+        return -1;
+    }
+    const auto glyphs = glyphMap.find(section.fontStackHash);
+    if (glyphs == glyphMap.end()) {
+        return -1;
+    }
+    const auto it = glyphs->second.find(string.getCharCodeAt(index));
+    if (it == glyphs->second.end() || !it->second) {
+        return -1;
+    }
+    return (*it->second)->metrics.advance;
+}
+
+bool hasSameAdvances(const TaggedString& string, const GlyphMap& glyphMap, const std::vector<int64_t>& advances) {
+    assert(advances.size() == string.length());
+    for (std::size_t i = 0; i < string.length(); ++i) {
+        if (getAdvance(string, i, glyphMap) != advances[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Takes the glyph rects of a cached shaping from the atlas of the tile. Fails when the tile doesn't
+// have one of the glyphs, or has it with other metrics.
+bool positionGlyphs(Shaping& shaping, const GlyphPositions& glyphPositions) {
+    for (auto& line : shaping.positionedLines) {
+        for (auto& glyph : line.positionedGlyphs) {
+            const auto positions = glyphPositions.find(glyph.font);
+            if (positions == glyphPositions.end()) {
+                return false;
+            }
+            const auto position = positions->second.find(glyph.glyph);
+            if (position == positions->second.end() || !(position->second.metrics == glyph.metrics)) {
+                return false;
+            }
+            glyph.rect = position->second.rect;
+        }
+    }
+    return true;
+}
+
+std::size_t getBytes(const CachedShaping& cached) {
+    std::size_t bytes = sizeof(CachedShaping) + cached.advances.size() * sizeof(int64_t);
+    for (const auto& line : cached.shaping.positionedLines) {
+        bytes += sizeof(PositionedLine) + line.positionedGlyphs.size() * sizeof(PositionedGlyph);
+    }
+    return bytes;
+}
+
+} // namespace
+
+class ShapingCache::Impl {
+public:
+    struct Entry {
+        std::shared_ptr<const CachedShaping> shaping;
+        std::shared_ptr<const HBShaping> hbShaping;
+    };
+
+    /// Part of the entries, picked by the hash of their keys, with a lock of its own so that the
+    /// parse workers of different tiles don't wait on each other
+    struct Shard {
+        explicit Shard(std::size_t maxBytes)
+            : entries(maxBytes) {}
+
+        std::mutex mutex;
+        SizedLRU<std::string, Entry> entries;
+        ShapingCacheStats stats;
+    };
+
+    explicit Impl(std::size_t maxBytes_)
+        : maxBytes(maxBytes_) {
+        for (auto& shard : shards) {
+            shard = std::make_unique<Shard>(maxBytes_ / shardCount);
+        }
+    }
+
+    Shard& getShard(const std::string& key) { return *shards[std::hash<std::string>()(key) % shardCount]; }
+
+    void insert(Shard& shard, const std::string& key, Entry entry, std::size_t entryBytes) {
+        shard.entries.put(key, std::move(entry), entryBytes + key.size() + entryOverhead);
+    }
+
+    static constexpr std::size_t shardCount = 16;
+    std::atomic<std::size_t> maxBytes;
+    std::array<std::unique_ptr<Shard>, shardCount> shards;
+};
+
+ShapingCache::ShapingCache(std::size_t maxBytes)
+    : impl(std::make_unique<Impl>(maxBytes)) {}
+
+ShapingCache::~ShapingCache() = default;
+
+std::shared_ptr<ShapingCache> ShapingCache::getShared() {
+    static std::mutex mutex;
+    static std::shared_ptr<ShapingCache> shared;
+
+    const auto sizeValue = platform::Settings::getInstance().get(platform::EXPERIMENTAL_SHAPING_CACHE_SIZE);
+    const auto* size = sizeValue.getDouble();
+    if (!size || *size <= 0) {
+        return nullptr;
+    }
+
+    std::scoped_lock lock(mutex);
+    if (!shared) {
+        shared = std::make_shared<ShapingCache>(static_cast<std::size_t>(*size));
+    } else {
+        shared->setMaxBytes(static_cast<std::size_t>(*size));
+    }
+    return shared;
+}
+
+Shaping ShapingCache::getShaping(const TaggedString& string,
+                                 const float maxWidth,
+                                 const float lineHeight,
+                                 const style::SymbolAnchorType textAnchor,
+                                 const style::TextJustifyType textJustify,
+                                 const float spacing,
+                                 const std::array<float, 2>& translate,
+                                 const WritingModeType writingMode,
+                                 BiDi& bidi,
+                                 const GlyphMap& glyphMap,
+                                 const GlyphPositions& glyphPositions,
+                                 const ImagePositions& imagePositions,
+                                 float layoutTextSize,
+                                 float layoutTextSizeAtBucketZoomLevel,
+                                 bool allowVerticalPlacement) {
+    const auto shape = [&](bool* complete) {
+        return mln::getShaping(string,
+                               maxWidth,
+                               lineHeight,
+                               textAnchor,
+                               textJustify,
+                               spacing,
+                               translate,
+                               writingMode,
+                               bidi,
+                               glyphMap,
+                               glyphPositions,
+                               imagePositions,
+                               layoutTextSize,
+                               layoutTextSizeAtBucketZoomLevel,
+                               allowVerticalPlacement,
+                               complete);
+    };
+
+    if (std::ranges::any_of(string.getSections(), [](const auto& section) { return section.imageID.has_value(); })) {
+        return shape(nullptr);
+    }
+
+    const std::string key = makeShapingKey(
+        string, maxWidth, lineHeight, textAnchor, textJustify, spacing, translate, writingMode, allowVerticalPlacement);
+    auto& shard = impl->getShard(key);
+    std::shared_ptr<const CachedShaping> cached;
+    {
+        std::scoped_lock lock(shard.mutex);
+        if (const auto* entry = shard.entries.get(key)) {
+            cached = entry->shaping;
+        }
+    }
+
+    // Copied and checked outside the lock, the cached shaping is never modified
+    if (cached && (cached->advances.empty() || hasSameAdvances(string, glyphMap, cached->advances))) {
+        Shaping shaping = cached->shaping;
+        if (positionGlyphs(shaping, glyphPositions)) {
+            std::scoped_lock lock(shard.mutex);
+            shard.stats.hits++;
+            return shaping;
+        }
+    }
+
+    bool complete = false;
+    Shaping shaping = shape(&complete);
+
+    std::shared_ptr<CachedShaping> entry;
+    if (complete) {
+        entry = std::make_shared<CachedShaping>(CachedShaping{.shaping = shaping, .advances = {}});
+        if (maxWidth) {
+            entry->advances.reserve(string.length());
+            for (std::size_t i = 0; i < string.length(); ++i) {
+                entry->advances.push_back(getAdvance(string, i, glyphMap));
+            }
+        }
+    }
+
+    std::scoped_lock lock(shard.mutex);
+    shard.stats.misses++;
+    if (entry) {
+        const std::size_t entryBytes = getBytes(*entry);
+        impl->insert(shard, key, Impl::Entry{.shaping = std::move(entry), .hbShaping = nullptr}, entryBytes);
+    }
+    return shaping;
+}
+
+bool ShapingCache::getHBShaping(const std::string& fontFace,
+                                const FontStack& fontStack,
+                                GlyphIDType type,
+                                const std::u16string& text,
+                                std::vector<GlyphID>& glyphIDs,
+                                std::vector<HBShapeAdjust>& adjusts) {
+    const std::string key = makeHBKey(fontFace, fontStack, type, text);
+    auto& shard = impl->getShard(key);
+    std::shared_ptr<const HBShaping> cached;
+    {
+        std::scoped_lock lock(shard.mutex);
+        const auto* entry = shard.entries.get(key);
+        if (!entry) {
+            shard.stats.hbMisses++;
+            return false;
+        }
+        shard.stats.hbHits++;
+        cached = entry->hbShaping;
+    }
+    glyphIDs.insert(glyphIDs.end(), cached->glyphIDs.begin(), cached->glyphIDs.end());
+    adjusts.insert(adjusts.end(), cached->adjusts.begin(), cached->adjusts.end());
+    return true;
+}
+
+void ShapingCache::putHBShaping(const std::string& fontFace,
+                                const FontStack& fontStack,
+                                GlyphIDType type,
+                                const std::u16string& text,
+                                const std::vector<GlyphID>& glyphIDs,
+                                const std::vector<HBShapeAdjust>& adjusts) {
+    const std::string key = makeHBKey(fontFace, fontStack, type, text);
+    auto entry = std::make_shared<HBShaping>(HBShaping{.glyphIDs = glyphIDs, .adjusts = adjusts});
+    const std::size_t entryBytes = sizeof(HBShaping) + glyphIDs.size() * sizeof(GlyphID) +
+                                   adjusts.size() * sizeof(HBShapeAdjust);
+
+    auto& shard = impl->getShard(key);
+    std::scoped_lock lock(shard.mutex);
+    impl->insert(shard, key, Impl::Entry{.shaping = nullptr, .hbShaping = std::move(entry)}, entryBytes);
+}
+
+void ShapingCache::setMaxBytes(std::size_t maxBytes) {
+    impl->maxBytes = maxBytes;
+    for (auto& shard : impl->shards) {
+        std::scoped_lock lock(shard->mutex);
+        shard->entries.setMaxBytes(maxBytes / Impl::shardCount);
+    }
+}
+
+std::size_t ShapingCache::getMaxBytes() const {
+    return impl->maxBytes;
+}
+
+ShapingCacheStats ShapingCache::getStats() const {
+    ShapingCacheStats result;
+    for (const auto& shard : impl->shards) {
+        std::scoped_lock lock(shard->mutex);
+        result.hits += shard->stats.hits;
+        result.misses += shard->stats.misses;
+        result.hbHits += shard->stats.hbHits;
+        result.hbMisses += shard->stats.hbMisses;
+        result.evictions += shard->entries.getEvictions();
+        result.entries += shard->entries.size();
+        result.bytes += shard->entries.getBytes();
+    }
+    return result;
+}
+
+void ShapingCache::clear() {
+    for (auto& shard : impl->shards) {
+        std::scoped_lock lock(shard->mutex);
+        shard->entries.clear();
+    }
+}
+
+} // namespace mln
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/text/harfbuzz.hpp>
+#include <mbgl/text/shaping.hpp>
+#include <mbgl/util/font_stack.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace mln {
+
+struct ShapingCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t hbHits = 0;
+    uint64_t hbMisses = 0;
+    uint64_t evictions = 0;
+    std::size_t entries = 0;
+    std::size_t bytes = 0;
+};
+
+/**
+ * Keeps the shapings of label strings, so that a street name which appears in many neighbouring
+ * tiles and at every zoom level only goes through line breaking, BiDi and glyph positioning once.
+ * The cache is thread-safe and can be shared by the symbol layouts of all tiles. Its entries are
+ * split into shards with locks of their own, each getting an equal part of the size limit, and the
+ * least recently used shapings of a shard are evicted once they exceed its part.
+ *
+ * Shapings are keyed by the formatted string and the shaping parameters. Glyph metrics aren't part
+ * of the key: a cached shaping is only used when the glyphs of the tile have the same metrics as
+ * the ones it was made from, and its glyph rects are then taken from the atlas of the tile. Strings
+ * with images are shaped without the cache.
+ *
+ * HarfBuzz shaping results are kept as well, keyed by the font face URL, font stack and text.
+ */
+class ShapingCache {
+public:
+    explicit ShapingCache(std::size_t maxBytes);
+    ~ShapingCache();
+
+    ShapingCache(const ShapingCache&) = delete;
+    ShapingCache& operator=(const ShapingCache&) = delete;
+
+    /// Returns the process-wide cache configured through the EXPERIMENTAL_SHAPING_CACHE_SIZE
+    /// setting, or null when no size is set.
+    static std::shared_ptr<ShapingCache> getShared();
+
+    /// Same as mln::getShaping(), answered from the cache when possible
+    Shaping getShaping(const TaggedString&,
+                       float maxWidth,
+                       float lineHeight,
+                       style::SymbolAnchorType,
+                       style::TextJustifyType,
+                       float spacing,
+                       const std::array<float, 2>& translate,
+                       WritingModeType,
+                       BiDi&,
+                       const GlyphMap&,
+                       const GlyphPositions&,
+                       const ImagePositions&,
+                       float layoutTextSize,
+                       float layoutTextSizeAtBucketZoomLevel,
+                       bool allowVerticalPlacement);
+
+    /// Looks up the glyph IDs and adjustments HarfBuzz shaped a text into with a font face
+    bool getHBShaping(const std::string& fontFace,
+                      const FontStack&,
+                      GlyphIDType,
+                      const std::u16string& text,
+                      std::vector<GlyphID>& glyphIDs,
+                      std::vector<HBShapeAdjust>& adjusts);
+    void putHBShaping(const std::string& fontFace,
+                      const FontStack&,
+                      GlyphIDType,
+                      const std::u16string& text,
+                      const std::vector<GlyphID>& glyphIDs,
+                      const std::vector<HBShapeAdjust>& adjusts);
+
+    void setMaxBytes(std::size_t);
+    std::size_t getMaxBytes() const;
+
+    ShapingCacheStats getStats() const;
+
+    void clear();
+
+private:
+    class Impl;
+    const std::unique_ptr<Impl> impl;
+};
+
+} // namespace mln
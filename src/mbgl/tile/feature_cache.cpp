@@ -0,0 +1,236 @@
+#include <mbgl/tile/feature_cache.hpp>
+
+#include <mbgl/util/instrumentation.hpp>
+
+#include <mutex>
+#include <vector>
+
+namespace mln {
+
+namespace {
+
+std::size_t estimateSize(const GeometryCollection& geometries) {
+    std::size_t size = geometries.capacity() * sizeof(GeometryCoordinates);
+    for (const auto& ring : geometries) {
+        size += ring.capacity() * sizeof(GeometryCoordinate);
+    }
+    return size;
+}
+
+std::size_t estimateSize(const PropertyMap& properties) {
+    // One node per element plus the bucket array, and the characters of long strings
+    std::size_t size = properties.size() * (sizeof(PropertyMap::value_type) + 3 * sizeof(void*));
+    for (const auto& [key, value] : properties) {
+        size += key.capacity();
+        if (value.is<std::string>()) {
+            size += value.get<std::string>().capacity();
+        }
+    }
+    return size;
+}
+
+} // namespace
+
+class FeatureCache::Budget {
+public:
+    explicit Budget(std::size_t maxBytes_)
+        : maxBytes(maxBytes_) {}
+
+    bool exhausted() const { return bytes.load(std::memory_order_relaxed) >= maxBytes; }
+
+    const std::size_t maxBytes;
+    std::atomic<std::size_t> hits{0};
+    std::atomic<std::size_t> misses{0};
+    std::atomic<std::size_t> uncached{0};
+    std::atomic<std::size_t> bytes{0};
+};
+
+class FeatureCache::LayerEntry {
+public:
+    struct Entry {
+        std::unique_ptr<GeometryTileFeature> feature;
+        std::once_flag geometriesDecoded;
+        std::once_flag propertiesDecoded;
+        // Whether each part was decoded into the entry, or left to every reader because the budget was exhausted.
+        // Written once under the flags above.
+        bool geometriesShared = false;
+        bool propertiesShared = false;
+        std::atomic<bool> propertiesReady{false};
+    };
+
+    LayerEntry(std::unique_ptr<GeometryTileLayer> layer_, std::shared_ptr<Budget> budget_)
+        : layer(std::move(layer_)),
+          budget(std::move(budget_)),
+          featureCount(layer->featureCount()),
+          entries(featureCount) {}
+
+    std::unique_ptr<GeometryTileFeature> getUncachedFeature(std::size_t i) {
+        std::scoped_lock lock(mutex);
+        return layer->getFeature(i);
+    }
+
+    const std::unique_ptr<GeometryTileLayer> layer;
+    const std::shared_ptr<Budget> budget;
+    const std::size_t featureCount;
+
+    std::mutex mutex;
+    std::vector<std::shared_ptr<Entry>> entries;
+    bool released = false;
+};
+
+/// Reads through to a shared entry, decoding each part once. Keeps the entry's layer alive,
+/// as the underlying feature may refer to it.
+class FeatureCache::Feature final : public GeometryTileFeature {
+public:
+    Feature(std::shared_ptr<LayerEntry> layer_, std::shared_ptr<LayerEntry::Entry> entry_, std::size_t index_)
+        : layer(std::move(layer_)),
+          entry(std::move(entry_)),
+          index(index_) {}
+
+    FeatureType getType() const override { return entry->feature->getType(); }
+
+    std::optional<Value> getValue(const std::string& key) const override {
+        // Single values are read from the feature until all properties are needed, rather than decoding them all
+        if (!entry->propertiesReady.load(std::memory_order_acquire)) {
+            return entry->feature->getValue(key);
+        }
+        const auto& properties = entry->feature->getProperties();
+        const auto it = properties.find(key);
+        if (it == properties.end()) {
+            return std::nullopt;
+        }
+        if (it->second.is<NullValue>()) {
+            // Implementations differ on whether null values are reported, keep the original behavior
+            return entry->feature->getValue(key);
+        }
+        return it->second;
+    }
+
+    const PropertyMap& getProperties() const override {
+        std::call_once(entry->propertiesDecoded, [&] {
+            if (layer->budget->exhausted()) {
+                return;
+            }
+            layer->budget->bytes += estimateSize(entry->feature->getProperties());
+            entry->propertiesShared = true;
+            entry->propertiesReady.store(true, std::memory_order_release);
+        });
+        return entry->propertiesShared ? entry->feature->getProperties() : uncached().getProperties();
+    }
+
+    FeatureIdentifier getID() const override { return entry->feature->getID(); }
+
+    const GeometryCollection& getGeometries() const override {
+        std::call_once(entry->geometriesDecoded, [&] {
+            if (layer->budget->exhausted()) {
+                return;
+            }
+            layer->budget->bytes += estimateSize(entry->feature->getGeometries());
+            entry->geometriesShared = true;
+        });
+        return entry->geometriesShared ? entry->feature->getGeometries() : uncached().getGeometries();
+    }
+
+private:
+    // Decodes parts for this reader alone, once the budget no longer allows keeping them in the entry
+    const GeometryTileFeature& uncached() const {
+        if (!own) {
+            own = layer->getUncachedFeature(index);
+        }
+        return *own;
+    }
+
+    const std::shared_ptr<LayerEntry> layer;
+    const std::shared_ptr<LayerEntry::Entry> entry;
+    const std::size_t index;
+    mutable std::unique_ptr<GeometryTileFeature> own;
+};
+
+class FeatureCache::Layer final : public GeometryTileLayer {
+public:
+    explicit Layer(std::shared_ptr<LayerEntry> entry_)
+        : entry(std::move(entry_)) {}
+
+    std::size_t featureCount() const override { return entry->featureCount; }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        Budget& budget = *entry->budget;
+        std::shared_ptr<LayerEntry::Entry> cached;
+        {
+            std::scoped_lock lock(entry->mutex);
+            if (entry->released) {
+                // The parse is over, layouts reading the layer later no longer share features
+                return entry->layer->getFeature(i);
+            }
+            auto& slot = entry->entries.at(i);
+            if (slot) {
+                budget.hits++;
+                cached = slot;
+            } else if (!budget.exhausted()) {
+                slot = std::make_shared<LayerEntry::Entry>();
+                slot->feature = entry->layer->getFeature(i);
+                budget.misses++;
+                budget.bytes += sizeof(LayerEntry::Entry);
+                cached = slot;
+            }
+        }
+
+        if (!cached) {
+            budget.uncached++;
+            return entry->getUncachedFeature(i);
+        }
+        return std::make_unique<Feature>(entry, std::move(cached), i);
+    }
+
+    std::string getName() const override { return entry->layer->getName(); }
+
+private:
+    const std::shared_ptr<LayerEntry> entry;
+};
+
+FeatureCache::FeatureCache(std::size_t maxBytes)
+    : budget(std::make_shared<Budget>(maxBytes)) {}
+
+FeatureCache::~FeatureCache() {
+    // Layouts may keep layers and features beyond the parse. Entries that none of them refers to are released.
+    for (const auto& [sourceLayer, entry] : layers) {
+        std::scoped_lock lock(entry->mutex);
+        entry->released = true;
+        entry->entries.clear();
+        entry->entries.shrink_to_fit();
+    }
+}
+
+void FeatureCache::addUse(const std::string& sourceLayer) {
+    uses[sourceLayer]++;
+}
+
+std::unique_ptr<GeometryTileLayer> FeatureCache::getLayer(const GeometryTileData& data,
+                                                          const std::string& sourceLayer) {
+    MLN_TRACE_FUNC();
+
+    // Nothing to share when only one group reads the layer
+    const auto use = uses.find(sourceLayer);
+    if (use == uses.end() || use->second < 2) {
+        return data.getLayer(sourceLayer);
+    }
+
+    auto& entry = layers[sourceLayer];
+    if (!entry) {
+        auto layer = data.getLayer(sourceLayer);
+        if (!layer) {
+            return nullptr;
+        }
+        entry = std::make_shared<LayerEntry>(std::move(layer), budget);
+    }
+    return std::make_unique<Layer>(entry);
+}
+
+FeatureCache::Stats FeatureCache::getStats() const {
+    return {.hits = budget->hits,
+            .misses = budget->misses,
+            .uncached = budget->uncached,
+            .bytes = budget->bytes};
+}
+
+} // namespace mln
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/containers.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace mln {
+
+/**
+ * Shares decoded features between the layer groups of a single parse.
+ *
+ * Every group reading a source layer normally gets its own layer object and decodes each
+ * feature's geometry and properties again. Layers obtained from the cache for a source layer
+ * which is used by more than one group instead return features backed by a shared entry,
+ * decoded the first time they are needed by any group. Entries are safe to read from several
+ * threads at once.
+ *
+ * Decoded data is counted against a byte budget, which is checked before any part of a feature
+ * is decoded into an entry. Once it is exhausted, further features and parts are decoded for each
+ * reader alone, so memory use stays bounded for very large tiles. Entries are released when the
+ * cache is destroyed at the end of the parse, except for features still held by layouts.
+ */
+class FeatureCache {
+public:
+    struct Stats {
+        /// Features returned from an existing entry
+        std::size_t hits = 0;
+        /// Features for which an entry was created
+        std::size_t misses = 0;
+        /// Features returned without caching because the budget was exhausted
+        std::size_t uncached = 0;
+        /// Approximate size of the decoded data held by entries
+        std::size_t bytes = 0;
+    };
+
+    explicit FeatureCache(std::size_t maxBytes);
+    ~FeatureCache();
+
+    /// Record that a layer group will read the given source layer. Must be called for all groups before `getLayer`.
+    void addUse(const std::string& sourceLayer);
+
+    /// Get a source layer, sharing its features with other layers returned for the same name.
+    /// Source layers with a single use are returned directly from the data.
+    std::unique_ptr<GeometryTileLayer> getLayer(const GeometryTileData&, const std::string& sourceLayer);
+
+    Stats getStats() const;
+
+private:
+    class Budget;
+    class LayerEntry;
+    class Layer;
+    class Feature;
+
+    const std::shared_ptr<Budget> budget;
+    mln::unordered_map<std::string, std::size_t> uses;
+    mln::unordered_map<std::string, std::shared_ptr<LayerEntry>> layers;
+};
+
+} // namespace mln
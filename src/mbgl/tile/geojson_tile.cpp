@@ -27,15 +27,20 @@ void GeoJSONTile::updateData(std::shared_ptr<style::GeoJSONData> data_, bool nee
     if (needsRelayout) reset();
     data->getTile(
         id.canonical,
-        [this, self = weakFactory.makeWeakPtr(), capturedData = data.get()](TileFeatures features) {
+        [this, self = weakFactory.makeWeakPtr(), capturedRequest = ++dataRequest](TileFeatures features) {
             // If the data has changed, a new request is being processed, ignore this one
-            if (auto guard = self.lock(); self && data.get() == capturedData) {
+            if (auto guard = self.lock(); self && dataRequest == capturedRequest) {
                 setData(std::make_unique<GeoJSONTileData>(std::move(features)));
             }
         },
         runSynchronously);
 }
 
+void GeoJSONTile::retainData(std::shared_ptr<style::GeoJSONData> data_) {
+    assert(data_);
+    data = std::move(data_);
+}
+
 void GeoJSONTile::querySourceFeatures(std::vector<Feature>& result, const SourceQueryOptions& options) {
     MLN_TRACE_FUNC();
 
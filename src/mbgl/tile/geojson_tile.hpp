@@ -20,11 +20,16 @@ public:
                 TileObserver* observer = nullptr);
 
     void updateData(std::shared_ptr<style::GeoJSONData> data, bool needsRelayout, bool runSynchronously);
+    /// Switches to data whose features in this tile are the same as the ones of the current data, keeping the
+    /// features loaded or being loaded
+    void retainData(std::shared_ptr<style::GeoJSONData> data);
 
     void querySourceFeatures(std::vector<Feature>& result, const SourceQueryOptions&) override;
 
 private:
     std::shared_ptr<style::GeoJSONData> data;
+    // Counts the loads of the features, so that only the features of the latest one are set
+    uint64_t dataRequest = 0;
     mapbox::base::WeakPtrFactory<GeoJSONTile> weakFactory{this};
     // Do not add members here, see `WeakPtrFactory`
 };
@@ -5,6 +5,7 @@
 #include <mbgl/style/layers/custom_layer.hpp>
 #include <mbgl/renderer/layers/render_custom_layer.hpp>
 #include <mbgl/map/transform_state.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/layers/render_background_layer.hpp>
 #include <mbgl/renderer/layers/render_symbol_layer.hpp>
@@ -23,6 +24,7 @@
 #include <mbgl/util/thread_pool.hpp>
 #include <mbgl/gfx/upload_pass.hpp>
 
+#include <unordered_set>
 #include <utility>
 
 namespace mln {
@@ -211,7 +213,13 @@ GeometryTile::GeometryTile(const OverscaledTileID& id_,
       glyphManager(parameters.glyphManager),
       imageManager(parameters.imageManager),
       mode(parameters.mode),
-      showCollisionBoxes(parameters.debugOptions & MapDebugOptions::Collision) {}
+      showCollisionBoxes(parameters.debugOptions & MapDebugOptions::Collision) {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_TILE_PRIORITY_SCHEDULING);
+    if (const auto* enabled = value.getBool(); enabled && *enabled) {
+        priority = std::make_shared<std::atomic<int32_t>>(0);
+        worker.setPriority(priority);
+    }
+}
 
 GeometryTile::~GeometryTile() {
     MLN_TRACE_FUNC();
@@ -238,6 +246,12 @@ void GeometryTile::cancel() {
     markObsolete();
 }
 
+void GeometryTile::setPriority(int32_t value) {
+    if (priority) {
+        priority->store(value, std::memory_order_relaxed);
+    }
+}
+
 void GeometryTile::markObsolete() {
     obsolete = true;
     mailbox->abandon();
@@ -340,7 +354,7 @@ void GeometryTile::onLayout(std::shared_ptr<LayoutResult>&& result, const uint64
     MLN_TRACE_FUNC();
 
     loaded = true;
-    renderable = true;
+    setRenderable(true);
     if (resultCorrelationID == correlationID) {
         pending = false;
         observer->onTileAction(id, sourceID, TileOperation::EndParse);
@@ -462,6 +476,22 @@ std::shared_ptr<FeatureIndex> GeometryTile::getFeatureIndex() const {
     return layoutResult ? layoutResult->featureIndex : nullptr;
 }
 
+std::size_t GeometryTile::getMemoryUsage() const {
+    if (!layoutResult) {
+        return 0;
+    }
+
+    // Layers of a group share their bucket
+    std::size_t bytes = 0;
+    std::unordered_set<const Bucket*> buckets;
+    for (const auto& [id, renderData] : layoutResult->layerRenderData) {
+        if (renderData.bucket && buckets.insert(renderData.bucket.get()).second) {
+            bytes += renderData.bucket->getMemoryUsage();
+        }
+    }
+    return bytes;
+}
+
 bool GeometryTile::layerPropertiesUpdated(const Immutable<style::LayerProperties>& layerProperties) {
     MLN_TRACE_FUNC();
 
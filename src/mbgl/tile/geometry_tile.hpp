@@ -66,6 +66,8 @@ public:
 
     void cancel() override;
 
+    void setPriority(int32_t) override;
+
     class LayoutResult {
     public:
         mln::unordered_map<std::string, LayerRenderData> layerRenderData;
@@ -101,6 +103,8 @@ public:
     void performedFadePlacement() override;
     std::shared_ptr<FeatureIndex> getFeatureIndex() const;
 
+    std::size_t getMemoryUsage() const override;
+
     void setFeatureState(const LayerFeatureStates&) override;
 
 protected:
@@ -118,6 +122,9 @@ private:
     const std::shared_ptr<Mailbox> mailbox;
     OptionalActor<GeometryTileWorker> worker;
 
+    // Shared with the scheduler when priority scheduling is enabled, otherwise null
+    std::shared_ptr<std::atomic<int32_t>> priority;
+
     const std::shared_ptr<FileSource> fileSource;
     const std::shared_ptr<GlyphManager> glyphManager;
     const std::shared_ptr<ImageManager> imageManager;
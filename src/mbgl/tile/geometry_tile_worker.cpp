@@ -1,13 +1,17 @@
 #include <mbgl/tile/geometry_tile_worker.hpp>
+#include <mbgl/tile/feature_cache.hpp>
 #include <mbgl/tile/geometry_tile_data.hpp>
 #include <mbgl/tile/geometry_tile.hpp>
+#include <mbgl/tile/parallel_bucket_builder.hpp>
 #include <mbgl/tile/tile_observer.hpp>
 #include <mbgl/layermanager/layer_manager.hpp>
 #include <mbgl/layout/layout.hpp>
 #include <mbgl/layout/symbol_layout.hpp>
 #include <mbgl/layout/pattern_layout.hpp>
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
 #include <mbgl/renderer/group_by_layout.hpp>
+#include <mbgl/style/batch_filter.hpp>
 #include <mbgl/style/filter.hpp>
 #include <mbgl/style/layers/symbol_layer_impl.hpp>
 #include <mbgl/renderer/layers/render_fill_layer.hpp>
@@ -24,6 +28,9 @@
 #include <mbgl/util/stopwatch.hpp>
 #include <mbgl/util/thread_pool.hpp>
 
+#include <algorithm>
+#include <limits>
+#include <optional>
 #include <unordered_set>
 #include <utility>
 
@@ -31,6 +38,29 @@ namespace mln {
 
 using namespace style;
 
+namespace {
+// Bound for the decoded features shared between the layer groups of a single parse
+constexpr std::size_t maxFeatureCacheBytes = 16 * 1024 * 1024;
+
+bool parallelBucketBuildingEnabled() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_PARALLEL_BUCKET_BUILDING);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+
+bool batchFilterEvaluationEnabled() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_BATCH_FILTER_EVALUATION);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+
+bool featureCacheEnabled() {
+    const auto value = platform::Settings::getInstance().get(platform::EXPERIMENTAL_FEATURE_CACHE);
+    const auto* enabled = value.getBool();
+    return enabled && *enabled;
+}
+} // namespace
+
 GeometryTileWorker::GeometryTileWorker(OptionalActorRef<GeometryTileWorker> self_,
                                        OptionalActorRef<GeometryTile> parent_,
                                        const TaggedScheduler& scheduler_,
@@ -51,6 +81,9 @@ GeometryTileWorker::GeometryTileWorker(OptionalActorRef<GeometryTileWorker> self
       obsolete(obsolete_),
       mode(mode_),
       pixelRatio(pixelRatio_),
+      parallelBucketBuilding(parallelBucketBuildingEnabled()),
+      batchFilterEvaluation(batchFilterEvaluationEnabled()),
+      featureCaching(featureCacheEnabled()),
       showCollisionBoxes(showCollisionBoxes_),
       dynamicTextureAtlas(dynamicTextureAtlas_),
       fontFaces(fontFaces_),
@@ -445,6 +478,27 @@ void GeometryTileWorker::parse() {
     // Create render layers and group by layout
     GroupMap groupMap = groupLayers(*layers);
 
+    // When enabled, source layers read by several groups are decoded once and shared between them
+    std::optional<FeatureCache> featureCache;
+    if (featureCaching) {
+        featureCache.emplace(maxFeatureCacheBytes);
+        for (const auto& pair : groupMap) {
+            featureCache->addUse(pair.second.at(0)->baseImpl->sourceLayer);
+        }
+    }
+
+    // When enabled, groups are only collected here and built together below
+    std::optional<ParallelBucketBuilder> builder;
+    if (parallelBucketBuilding) {
+        builder.emplace(scheduler,
+                        obsolete,
+                        ParallelBucketBuilder::Parameters{.fontFaces = fontFaces,
+                                                          .availableImages = availableImages,
+                                                          .firstLoad = firstLoad,
+                                                          .showCollisionBoxes = showCollisionBoxes,
+                                                          .batchFilterEvaluation = batchFilterEvaluation});
+    }
+
     for (auto& pair : groupMap) {
         const auto& group = pair.second;
         if (obsolete) {
@@ -459,7 +513,8 @@ void GeometryTileWorker::parse() {
         BucketParameters parameters{
             .tileID = id, .mode = mode, .pixelRatio = pixelRatio, .layerType = leaderImpl.getTypeInfo()};
 
-        auto geometryLayer = (*data)->getLayer(leaderImpl.sourceLayer);
+        auto geometryLayer = featureCache ? featureCache->getLayer(**data, leaderImpl.sourceLayer)
+                                          : (*data)->getLayer(leaderImpl.sourceLayer);
         if (!geometryLayer) {
             continue;
         }
@@ -472,6 +527,11 @@ void GeometryTileWorker::parse() {
 
         featureIndex->setBucketLayerIDs(leaderImpl.id, layerIDs);
 
+        if (builder) {
+            builder->add(parameters, group, std::move(geometryLayer));
+            continue;
+        }
+
         // Symbol layers and layers that support pattern properties have an
         // extra step at layout time to figure out what images/glyphs are needed
         // to render the layer. They use the intermediate Layout data structure
@@ -496,10 +556,22 @@ void GeometryTileWorker::parse() {
             const std::string& sourceLayerID = leaderImpl.sourceLayer;
             std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(parameters, group);
 
+            std::optional<BatchFilter::Selection> selection;
+            std::vector<std::unique_ptr<GeometryTileFeature>> selected;
+            if (batchFilterEvaluation) {
+                selection = leaderImpl.getBatchFilter()(
+                    *geometryLayer, static_cast<float>(id.overscaledZ), id.canonical, &selected);
+            }
+
             for (std::size_t i = 0; !obsolete && i < geometryLayer->featureCount(); i++) {
-                std::unique_ptr<GeometryTileFeature> feature = geometryLayer->getFeature(i);
+                if (selection && !(*selection)[i]) continue;
+
+                std::unique_ptr<GeometryTileFeature> feature = i < selected.size() && selected[i]
+                                                                   ? std::move(selected[i])
+                                                                   : geometryLayer->getFeature(i);
 
-                if (!filter(expression::EvaluationContext(static_cast<float>(this->id.overscaledZ), feature.get())
+                if (!selection &&
+                    !filter(expression::EvaluationContext(static_cast<float>(this->id.overscaledZ), feature.get())
                                 .withCanonicalTileID(&id.canonical)))
                     continue;
 
@@ -518,9 +590,24 @@ void GeometryTileWorker::parse() {
         }
     }
 
+    if (builder) {
+        // The builder leaves room for this thread, which is one of the pool's workers
+        if (!builder->build(std::numeric_limits<std::size_t>::max(),
+                            {.featureIndex = featureIndex,
+                             .renderData = renderData,
+                             .layouts = layouts,
+                             .glyphDependencies = glyphDependencies,
+                             .imageDependencies = imageDependencies})) {
+            return;
+        }
+    }
+
     requestNewGlyphs(glyphDependencies);
     requestNewImages(imageDependencies);
 
+    if (featureCache) {
+        MLN_ZONE_VALUE(featureCache->getStats().bytes);
+    }
     MBGL_TIMING_FINISH(watch,
                        " Action: " << "Parsing,"
                                    << " SourceID: " << sourceID.c_str()
@@ -91,6 +91,9 @@ private:
     const std::atomic<bool>& obsolete;
     const MapMode mode;
     const float pixelRatio;
+    const bool parallelBucketBuilding;
+    const bool batchFilterEvaluation;
+    const bool featureCaching;
 
     std::unique_ptr<FeatureIndex> featureIndex;
     mln::unordered_map<std::string, LayerRenderData> renderData;
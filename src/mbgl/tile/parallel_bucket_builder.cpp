@@ -0,0 +1,226 @@
+#include <mbgl/tile/parallel_bucket_builder.hpp>
+
+#include <mbgl/geometry/feature_index.hpp>
+#include <mbgl/layermanager/layer_manager.hpp>
+#include <mbgl/layout/layout.hpp>
+#include <mbgl/renderer/bucket.hpp>
+#include <mbgl/style/batch_filter.hpp>
+#include <mbgl/style/filter.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/tile/geometry_tile_data.hpp>
+#include <mbgl/util/instrumentation.hpp>
+#include <mbgl/util/parallel_jobs.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <exception>
+#include <limits>
+#include <optional>
+
+namespace mln {
+
+using namespace style;
+
+struct ParallelBucketBuilder::Job {
+    Job(const BucketParameters& parameters_,
+        std::vector<Immutable<LayerProperties>> group_,
+        std::unique_ptr<GeometryTileLayer> layer_)
+        : parameters(parameters_),
+          group(std::move(group_)),
+          layer(std::move(layer_)),
+          offThread(group.front()->baseImpl->getTypeInfo()->crossTileIndex ==
+                    LayerTypeInfo::CrossTileIndex::NotRequired) {}
+
+    const BucketParameters parameters;
+    const std::vector<Immutable<LayerProperties>> group;
+    std::unique_ptr<GeometryTileLayer> layer;
+    const bool offThread;
+
+    std::unique_ptr<FeatureIndex> featureIndex;
+    mln::unordered_map<std::string, LayerRenderData> renderData;
+    // Set for layouts waiting on dependencies, and for on-thread layouts whose bucket is created when merging
+    std::unique_ptr<Layout> layout;
+    GlyphDependencies glyphDependencies;
+    ImageDependencies imageDependencies;
+    std::exception_ptr error;
+};
+
+struct ParallelBucketBuilder::State {
+    State(const std::atomic<bool>& obsolete_, Parameters parameters_)
+        : obsolete(obsolete_),
+          parameters(std::move(parameters_)) {}
+
+    void run(Job&);
+
+    const std::atomic<bool>& obsolete;
+    const Parameters parameters;
+
+    std::vector<Job> jobs;
+    std::vector<std::size_t> parallel;
+};
+
+void ParallelBucketBuilder::State::run(Job& job) {
+    MLN_TRACE_FUNC();
+
+    if (obsolete) {
+        return;
+    }
+
+    try {
+        const Layer::Impl& leaderImpl = *job.group.front()->baseImpl;
+        const auto& tileID = job.parameters.tileID;
+
+        if (job.offThread) {
+            job.featureIndex = std::make_unique<FeatureIndex>(nullptr);
+        }
+
+        if (leaderImpl.getTypeInfo()->layout == LayerTypeInfo::Layout::Required) {
+            job.layout = LayerManager::get()->createLayout({.bucketParameters = job.parameters,
+                                                            .fontFaces = parameters.fontFaces,
+                                                            .glyphDependencies = job.glyphDependencies,
+                                                            .imageDependencies = job.imageDependencies,
+                                                            .availableImages = parameters.availableImages},
+                                                           std::move(job.layer),
+                                                           job.group);
+            if (job.offThread && !job.layout->hasDependencies()) {
+                job.layout->createBucket({},
+                                         job.featureIndex,
+                                         job.renderData,
+                                         parameters.firstLoad,
+                                         parameters.showCollisionBoxes,
+                                         tileID.canonical);
+                job.layout.reset();
+            }
+            return;
+        }
+
+        // Non-layout layers never need cross-tile indexing, so this is always done off-thread
+        assert(job.featureIndex);
+        const Filter& filter = leaderImpl.filter;
+        std::shared_ptr<Bucket> bucket = LayerManager::get()->createBucket(job.parameters, job.group);
+
+        std::optional<BatchFilter::Selection> selection;
+        std::vector<std::unique_ptr<GeometryTileFeature>> selected;
+        if (parameters.batchFilterEvaluation) {
+            selection = leaderImpl.getBatchFilter()(
+                *job.layer, static_cast<float>(tileID.overscaledZ), tileID.canonical, &selected);
+        }
+
+        for (std::size_t i = 0; !obsolete && i < job.layer->featureCount(); i++) {
+            if (selection && !(*selection)[i]) continue;
+
+            // Features read to evaluate the filter are used as they are
+            std::unique_ptr<GeometryTileFeature> feature = i < selected.size() && selected[i]
+                                                               ? std::move(selected[i])
+                                                               : job.layer->getFeature(i);
+
+            if (!selection &&
+                !filter(expression::EvaluationContext(static_cast<float>(tileID.overscaledZ), feature.get())
+                            .withCanonicalTileID(&tileID.canonical)))
+                continue;
+
+            const GeometryCollection& geometries = feature->getGeometries();
+            bucket->addFeature(*feature, geometries, {}, PatternLayerMap(), i, tileID.canonical);
+            job.featureIndex->insert(geometries, i, leaderImpl.sourceLayer, leaderImpl.id);
+        }
+
+        if (bucket->hasData()) {
+            for (const auto& layer : job.group) {
+                job.renderData.emplace(layer->baseImpl->id,
+                                       LayerRenderData{.bucket = bucket, .layerProperties = layer});
+            }
+        }
+    } catch (...) {
+        job.error = std::current_exception();
+    }
+}
+
+ParallelBucketBuilder::ParallelBucketBuilder(TaggedScheduler scheduler_,
+                                             const std::atomic<bool>& obsolete,
+                                             Parameters parameters)
+    : scheduler(std::move(scheduler_)),
+      state(std::make_shared<State>(obsolete, std::move(parameters))) {}
+
+ParallelBucketBuilder::~ParallelBucketBuilder() = default;
+
+void ParallelBucketBuilder::add(const BucketParameters& parameters,
+                                std::vector<Immutable<LayerProperties>> group,
+                                std::unique_ptr<GeometryTileLayer> layer) {
+    assert(!group.empty());
+    const auto& job = state->jobs.emplace_back(parameters, std::move(group), std::move(layer));
+    if (job.offThread) {
+        state->parallel.push_back(state->jobs.size() - 1);
+    }
+}
+
+std::size_t ParallelBucketBuilder::parallelSize() const {
+    return state->parallel.size();
+}
+
+bool ParallelBucketBuilder::build(std::size_t maxHelpers, const Result& result) {
+    MLN_TRACE_FUNC();
+
+    util::ParallelJobs parallelJobs(state->parallel.size(),
+                                    [&state_ = *state](std::size_t i) { state_.run(state_.jobs[state_.parallel[i]]); });
+
+    // Helpers go ahead of the other tasks of the pool: the tile's own tag would queue them behind its prioritized
+    // tasks, by when this thread would have built every group on its own
+    static const TaskPriority helperPriority = std::make_shared<const std::atomic<int32_t>>(
+        std::numeric_limits<int32_t>::max());
+    parallelJobs.schedule(*scheduler.get(), maxHelpers, helperPriority);
+
+    for (auto& job : state->jobs) {
+        if (!job.offThread) {
+            state->run(job);
+        }
+    }
+    parallelJobs.run();
+
+    if (state->obsolete) {
+        return false;
+    }
+
+    const Parameters& parameters = state->parameters;
+    for (auto& job : state->jobs) {
+        if (job.error) {
+            std::rethrow_exception(job.error);
+        }
+
+        for (auto& [fontStack, glyphIDs] : job.glyphDependencies.glyphs) {
+            result.glyphDependencies.glyphs[fontStack].merge(glyphIDs);
+        }
+        for (auto& [fontStack, requests] : job.glyphDependencies.shapes) {
+            auto& target = result.glyphDependencies.shapes[fontStack];
+            for (auto& [type, strings] : requests) {
+                target[type].merge(strings);
+            }
+        }
+        for (const auto& [imageID, type] : job.imageDependencies) {
+            result.imageDependencies.emplace(imageID, type);
+        }
+
+        if (job.featureIndex) {
+            result.featureIndex->append(*job.featureIndex);
+        }
+        for (auto& [layerID, data] : job.renderData) {
+            result.renderData.emplace(layerID, std::move(data));
+        }
+
+        if (job.layout) {
+            if (job.layout->hasDependencies()) {
+                result.layouts.push_back(std::move(job.layout));
+            } else {
+                job.layout->createBucket({},
+                                         result.featureIndex,
+                                         result.renderData,
+                                         parameters.firstLoad,
+                                         parameters.showCollisionBoxes,
+                                         job.parameters.tileID.canonical);
+            }
+        }
+    }
+
+    return true;
+}
+
+} // namespace mln
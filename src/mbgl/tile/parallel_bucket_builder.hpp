@@ -0,0 +1,78 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/style/image_impl.hpp>
+#include <mbgl/style/layer_properties.hpp>
+#include <mbgl/text/glyph.hpp>
+#include <mbgl/util/containers.hpp>
+#include <mbgl/util/immutable.hpp>
+
+#include <atomic>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace mln {
+
+class FeatureIndex;
+class GeometryTileLayer;
+class Layout;
+
+/**
+ * Creates the layouts and buckets of a tile's layer groups, spreading the groups over
+ * helper tasks on a scheduler.
+ *
+ * Each group is built into its own feature index, render data and dependency sets, which
+ * are merged into the outputs in the order the groups were added once all of them are done.
+ * The result is the same as building the groups one after the other on the calling thread.
+ *
+ * Groups which need cross-tile indexing (symbols) are laid out on the calling thread, and
+ * layouts still waiting for glyphs or images are returned for the caller to finish later.
+ */
+class ParallelBucketBuilder {
+public:
+    struct Parameters {
+        std::shared_ptr<FontFaces> fontFaces;
+        std::set<std::string>& availableImages;
+        bool firstLoad;
+        bool showCollisionBoxes;
+        /// Evaluate the filters of non-layout groups with `style::BatchFilter`
+        bool batchFilterEvaluation = false;
+    };
+
+    /// Outputs, appended to in the order the groups were added
+    struct Result {
+        std::unique_ptr<FeatureIndex>& featureIndex;
+        mln::unordered_map<std::string, LayerRenderData>& renderData;
+        std::vector<std::unique_ptr<Layout>>& layouts;
+        GlyphDependencies& glyphDependencies;
+        ImageDependencies& imageDependencies;
+    };
+
+    ParallelBucketBuilder(TaggedScheduler, const std::atomic<bool>& obsolete, Parameters);
+    ~ParallelBucketBuilder();
+
+    void add(const BucketParameters&,
+             std::vector<Immutable<style::LayerProperties>> group,
+             std::unique_ptr<GeometryTileLayer>);
+
+    /// Build all groups using the calling thread and up to `maxHelpers` tasks on the scheduler's pool, then merge
+    /// the results. Helpers are also limited to the workers of the pool other than the calling one. Returns false,
+    /// leaving the outputs untouched, if the tile became obsolete in the meantime.
+    bool build(std::size_t maxHelpers, const Result&);
+
+    /// The number of groups which may be built off the calling thread
+    std::size_t parallelSize() const;
+
+private:
+    struct Job;
+    struct State;
+
+    TaggedScheduler scheduler;
+    std::shared_ptr<State> state;
+};
+
+} // namespace mln
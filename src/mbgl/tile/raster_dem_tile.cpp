@@ -85,7 +85,7 @@ void RasterDEMTile::onParsed(std::unique_ptr<HillshadeBucket> result, const uint
             pending = false;
             observer->onTileAction(id, sourceID, TileOperation::EndParse);
         }
-        renderable = static_cast<bool>(bucket);
+        setRenderable(static_cast<bool>(bucket));
         observer->onTileChanged(*this);
     }
 }
@@ -103,6 +103,10 @@ bool RasterDEMTile::layerPropertiesUpdated(const Immutable<style::LayerPropertie
     return bool(bucket);
 }
 
+std::size_t RasterDEMTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
 HillshadeBucket* RasterDEMTile::getBucket() const {
     return bucket.get();
 }
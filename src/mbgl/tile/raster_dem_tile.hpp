@@ -74,6 +74,7 @@ public:
     void setData(const std::shared_ptr<const std::string>& data);
 
     bool layerPropertiesUpdated(const Immutable<style::LayerProperties>& layerProperties) override;
+    std::size_t getMemoryUsage() const override;
 
     HillshadeBucket* getBucket() const;
     void backfillBorder(const RasterDEMTile& borderTile, DEMTileNeighbors mask);
@@ -74,7 +74,7 @@ void RasterTile::onParsed(std::unique_ptr<RasterBucket> result, const uint64_t r
             pending = false;
             observer->onTileAction(id, sourceID, TileOperation::EndParse);
         }
-        renderable = static_cast<bool>(bucket);
+        setRenderable(static_cast<bool>(bucket));
         observer->onTileChanged(*this);
     }
 }
@@ -92,6 +92,10 @@ bool RasterTile::layerPropertiesUpdated(const Immutable<style::LayerProperties>&
     return bool(bucket);
 }
 
+std::size_t RasterTile::getMemoryUsage() const {
+    return bucket ? bucket->getMemoryUsage() : 0;
+}
+
 void RasterTile::setMask(TileMask&& mask) {
     if (bucket) {
         bucket->setMask(std::move(mask));
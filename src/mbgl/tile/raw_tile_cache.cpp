@@ -0,0 +1,226 @@
+#include <mbgl/tile/raw_tile_cache.hpp>
+
+#include <mbgl/actor/actor_ref.hpp>
+#include <mbgl/actor/mailbox.hpp>
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/util/async_request.hpp>
+#include <mbgl/util/instrumentation.hpp>
+#include <mbgl/util/lru_cache.hpp>
+
+#include <optional>
+
+namespace mln {
+
+namespace {
+
+/// Delivers a response on the requesting thread's scheduler, unless cancelled first
+class CachedRequest final : public AsyncRequest {
+public:
+    CachedRequest(Response response, FileSource::Callback callback_)
+        : callback(std::move(callback_)),
+          mailbox(std::make_shared<Mailbox>(*Scheduler::GetCurrent())) {
+        ActorRef<CachedRequest>(*this, mailbox).invoke(&CachedRequest::respond, std::move(response));
+    }
+
+    ~CachedRequest() override { mailbox->close(); }
+
+    void respond(const Response& response) {
+        // Copy, the callback may destroy this object
+        auto callback_ = callback;
+        callback_(response);
+    }
+
+private:
+    FileSource::Callback callback;
+    std::shared_ptr<Mailbox> mailbox;
+};
+
+} // namespace
+
+class RawTileCache::Impl {
+public:
+    explicit Impl(std::size_t maxBytes)
+        : responses(maxBytes) {}
+
+    std::optional<Response> lookup(const Resource& resource) {
+        const Response* cached = responses.find(resource.url);
+        if (!cached) {
+            return std::nullopt;
+        }
+
+        const bool fresh = cached->expires && *cached->expires > util::now();
+        if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly ? !cached->isUsable() : !fresh) {
+            return std::nullopt;
+        }
+
+        Response response = *responses.get(resource.url);
+        if (resource.loadingMethod != Resource::LoadingMethod::CacheOnly && resource.priorExpires == response.expires) {
+            // The requester already has this response from an earlier cache-only request
+            response.data = nullptr;
+            response.notModified = true;
+        }
+        return response;
+    }
+
+    void store(const std::string& url, const Response& response) {
+        if (response.error || response.noContent) {
+            return;
+        }
+
+        if (response.notModified) {
+            if (Response* cached = responses.find(url)) {
+                cached->expires = response.expires;
+                cached->mustRevalidate = response.mustRevalidate;
+                if (response.modified) cached->modified = response.modified;
+                if (response.etag) cached->etag = response.etag;
+            }
+            return;
+        }
+        if (!response.data) {
+            return;
+        }
+
+        responses.put(url, response, url.size() + response.data->size());
+    }
+
+    std::shared_ptr<FileSource> fileSource;
+    RawTileCacheStats stats;
+    /// Responses keyed by URL
+    SizedLRU<std::string, Response> responses;
+};
+
+RawTileCache::RawTileCache(std::size_t maxBytes)
+    : impl(std::make_shared<Impl>(maxBytes)) {}
+
+RawTileCache::~RawTileCache() = default;
+
+void RawTileCache::setFileSource(std::shared_ptr<FileSource> fileSource) {
+    impl->fileSource = std::move(fileSource);
+}
+
+void RawTileCache::setMaxBytes(std::size_t maxBytes) {
+    impl->responses.setMaxBytes(maxBytes);
+}
+
+std::size_t RawTileCache::getMaxBytes() const {
+    return impl->responses.getMaxBytes();
+}
+
+RawTileCacheStats RawTileCache::getStats() const {
+    RawTileCacheStats result = impl->stats;
+    result.evictions = impl->responses.getEvictions();
+    result.tiles = impl->responses.size();
+    result.bytes = impl->responses.getBytes();
+    return result;
+}
+
+void RawTileCache::clear() {
+    impl->responses.clear();
+}
+
+std::unique_ptr<AsyncRequest> RawTileCache::request(const Resource& resource, Callback callback) {
+    MLN_TRACE_FUNC();
+
+    const auto& fileSource = impl->fileSource;
+    if (resource.kind != Resource::Kind::Tile && fileSource) {
+        return fileSource->request(resource, std::move(callback));
+    }
+
+    const TimePoint start = Clock::now();
+    if (auto response = impl->lookup(resource)) {
+        impl->stats.hits++;
+        return std::make_unique<CachedRequest>(
+            std::move(*response), [impl_ = impl, start, callback_ = std::move(callback)](const Response& res) {
+                impl_->stats.hitLatency += Clock::now() - start;
+                callback_(res);
+            });
+    }
+
+    if (!fileSource) {
+        Response response;
+        response.error = std::make_unique<Response::Error>(Response::Error::Reason::Other, "No file source.");
+        return std::make_unique<CachedRequest>(std::move(response), std::move(callback));
+    }
+
+    if (resource.loadingMethod == Resource::LoadingMethod::CacheOnly && !fileSource->supportsCacheOnlyRequests()) {
+        // Not advertised in this case, but a requester may still make one
+        Response response;
+        response.noContent = true;
+        response.error = std::make_unique<Response::Error>(Response::Error::Reason::NotFound);
+        return std::make_unique<CachedRequest>(std::move(response), std::move(callback));
+    }
+
+    impl->stats.misses++;
+    return fileSource->request(
+        resource, [impl_ = impl, url = resource.url, start, callback_ = std::move(callback)](const Response& res) {
+            impl_->stats.missLatency += Clock::now() - start;
+            impl_->store(url, res);
+            callback_(res);
+        });
+}
+
+void RawTileCache::forward(const Resource& resource, const Response& response, std::function<void()> callback) {
+    if (impl->fileSource) {
+        impl->fileSource->forward(resource, response, std::move(callback));
+    }
+}
+
+bool RawTileCache::supportsCacheOnlyRequests() const {
+    // Tile loaders otherwise wait for a response to their cache-only request before going to the network
+    return impl->fileSource && impl->fileSource->supportsCacheOnlyRequests();
+}
+
+bool RawTileCache::canRequest(const Resource& resource) const {
+    return impl->fileSource && impl->fileSource->canRequest(resource);
+}
+
+void RawTileCache::pause() {
+    if (impl->fileSource) {
+        impl->fileSource->pause();
+    }
+}
+
+void RawTileCache::resume() {
+    if (impl->fileSource) {
+        impl->fileSource->resume();
+    }
+}
+
+void RawTileCache::setProperty(const std::string& key, const mapbox::base::Value& value) {
+    if (impl->fileSource) {
+        impl->fileSource->setProperty(key, value);
+    }
+}
+
+mapbox::base::Value RawTileCache::getProperty(const std::string& key) const {
+    return impl->fileSource ? impl->fileSource->getProperty(key) : mapbox::base::Value();
+}
+
+void RawTileCache::setResourceTransform(ResourceTransform transform) {
+    if (impl->fileSource) {
+        impl->fileSource->setResourceTransform(std::move(transform));
+    }
+}
+
+void RawTileCache::setResourceOptions(ResourceOptions options) {
+    if (impl->fileSource) {
+        impl->fileSource->setResourceOptions(std::move(options));
+    }
+}
+
+ResourceOptions RawTileCache::getResourceOptions() {
+    return impl->fileSource ? impl->fileSource->getResourceOptions() : ResourceOptions();
+}
+
+void RawTileCache::setClientOptions(ClientOptions options) {
+    if (impl->fileSource) {
+        impl->fileSource->setClientOptions(std::move(options));
+    }
+}
+
+ClientOptions RawTileCache::getClientOptions() {
+    return impl->fileSource ? impl->fileSource->getClientOptions() : ClientOptions();
+}
+
+} // namespace mln
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mbgl/storage/file_source.hpp>
+#include <mbgl/tile/tile_cache_stats.hpp>
+
+#include <cstddef>
+#include <memory>
+
+namespace mln {
+
+/**
+ * Keeps the data of recently loaded tiles in memory, in front of the file source tiles are
+ * loaded from, so that tiles evicted from the tile caches can be loaded again with only a parse.
+ *
+ * Tile requests are answered from memory as long as the kept response may be used for them:
+ * cache-only requests get any usable response, other requests only one which has not expired
+ * yet. Cache-only requests are supported when the wrapped file source supports them. All other requests are passed on to the wrapped file source, and the tile data it responds
+ * with is kept for next time. Responses are kept as delivered, sharing their buffer with the
+ * tiles parsing them, and the least recently used ones are evicted once their total size exceeds
+ * the limit.
+ *
+ * Requests must be made on a thread with a scheduler, like for any file source.
+ */
+class RawTileCache final : public FileSource {
+public:
+    explicit RawTileCache(std::size_t maxBytes);
+    ~RawTileCache() override;
+
+    /// Sets the file source requests are passed on to
+    void setFileSource(std::shared_ptr<FileSource>);
+
+    void setMaxBytes(std::size_t);
+    std::size_t getMaxBytes() const;
+
+    RawTileCacheStats getStats() const;
+    void clear();
+
+    std::unique_ptr<AsyncRequest> request(const Resource&, Callback) override;
+    void forward(const Resource&, const Response&, std::function<void()>) override;
+    bool supportsCacheOnlyRequests() const override;
+    bool canRequest(const Resource&) const override;
+    void pause() override;
+    void resume() override;
+
+    void setProperty(const std::string&, const mapbox::base::Value&) override;
+    mapbox::base::Value getProperty(const std::string&) const override;
+
+    void setResourceTransform(ResourceTransform) override;
+    void setResourceOptions(ResourceOptions) override;
+    ResourceOptions getResourceOptions() override;
+    void setClientOptions(ClientOptions) override;
+    ClientOptions getClientOptions() override;
+
+private:
+    class Impl;
+    const std::shared_ptr<Impl> impl;
+};
+
+} // namespace mln
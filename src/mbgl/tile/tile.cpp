@@ -23,6 +23,13 @@ void Tile::setObserver(TileObserver* observer_) {
     observer = observer_;
 }
 
+void Tile::setRenderable(bool renderable_) {
+    if (renderable_ && loadDuration == Duration::zero()) {
+        loadDuration = Clock::now() - creationTime;
+    }
+    renderable = renderable_;
+}
+
 void Tile::setTriedCache() {
     triedOptional = true;
     observer->onTileChanged(*this);
@@ -66,6 +66,11 @@ public:
 
     virtual void setNecessity(TileNecessity) {}
 
+    // Sets the priority of this tile's pending and future background work relative to other
+    // tiles; higher values are processed first. Only honoured when the tile's worker was
+    // created with priority scheduling enabled.
+    virtual void setPriority(int32_t) {}
+
     virtual void setUpdateParameters(const TileUpdateParameters&) {}
 
     // Mark this tile as no longer needed and cancel any pending work.
@@ -106,6 +111,13 @@ public:
     // be rendered, although layers will be missing.
     bool isRenderable() const { return renderable; }
 
+    // Approximate bytes of CPU and GPU memory held by the tile's buckets.
+    virtual std::size_t getMemoryUsage() const { return 0; }
+
+    // How long the tile took to first become renderable after it was created, including
+    // fetching and parsing it. Zero until then. Estimates the cost of loading it again.
+    Duration getLoadDuration() const { return loadDuration; }
+
     // A tile is "Loaded" when we have received a response from a FileSource,
     // and have attempted to parse the tile (if applicable). Tile
     // implementations should set this to true when a load error occurred, or
@@ -149,11 +161,16 @@ public:
     bool usedByRenderedLayers = false;
 
 protected:
+    void setRenderable(bool);
+
     bool triedOptional = false;
     bool renderable = false;
     bool pending = false;
     bool loaded = false;
 
+    const TimePoint creationTime = Clock::now();
+    Duration loadDuration = Duration::zero();
+
     TileObserver* observer = nullptr;
 };
 
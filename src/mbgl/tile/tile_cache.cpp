@@ -3,7 +3,9 @@
 #include <mbgl/actor/scheduler.hpp>
 #include <mbgl/util/instrumentation.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 
 namespace mln {
 
@@ -17,24 +19,66 @@ TileCache::~TileCache() {
     deferredSignal.wait(counterLock, [&]() { return deferredDeletionsPending == 0; });
 }
 
+namespace {
+
+/// Cost of loading any tile again, in milliseconds, on top of its measured load time
+constexpr double reloadOverhead = 1.0;
+
+/// Tiles are considered to hold at least this many bytes, so that empty tiles don't all go last
+constexpr double minimumTileBytes = 1024.0;
+
+} // namespace
+
 void TileCache::setSize(size_t size_) {
     MLN_TRACE_FUNC();
 
     size = size_;
+    evict();
 
-    while (orderedKeys.size() > size) {
-        const auto key = orderedKeys.front();
-        orderedKeys.remove(key);
+    assert(tiles.size() <= size);
+}
 
-        auto hit = tiles.find(key);
-        if (hit != tiles.end()) {
-            auto tile = std::move(hit->second);
-            tiles.erase(hit);
-            deferredRelease(std::move(tile));
-        }
-    }
+void TileCache::setMaxBytes(size_t maxBytes_) {
+    MLN_TRACE_FUNC();
+
+    maxBytes = maxBytes_;
+    evict();
+}
+
+TileCacheStats TileCache::getStats() const {
+    TileCacheStats result = stats;
+    result.tiles = tiles.size();
+    result.bytes = bytes;
+    return result;
+}
 
-    assert(orderedKeys.size() <= size);
+double TileCache::getPriority(const Tile& tile, size_t tileBytes) const {
+    // Greedy-Dual-Size: the cost of loading the tile again per byte it holds, raised by the
+    // priority of the last evicted tile so that tiles added earlier age out eventually
+    const double cost = reloadOverhead +
+                        std::chrono::duration<double, std::milli>(tile.getLoadDuration()).count();
+    return inflation + cost / std::max(static_cast<double>(tileBytes), minimumTileBytes);
+}
+
+std::unique_ptr<Tile> TileCache::erase(Entries::iterator it) {
+    std::unique_ptr<Tile> tile = std::move(it->second.tile);
+    assert(bytes >= it->second.bytes);
+    bytes -= it->second.bytes;
+    evictionOrder.erase(it->second.order);
+    tiles.erase(it);
+    return tile;
+}
+
+void TileCache::evict() {
+    while (!evictionOrder.empty() && (tiles.size() > size || (maxBytes && bytes > maxBytes))) {
+        const auto lowest = evictionOrder.begin();
+        inflation = std::max(inflation, lowest->first.first);
+
+        const auto it = tiles.find(lowest->second);
+        assert(it != tiles.end());
+        deferredRelease(erase(it));
+        stats.evictions++;
+    }
 }
 
 namespace {
@@ -107,33 +151,31 @@ void TileCache::add(const OverscaledTileID& key, std::unique_ptr<Tile>&& tile) {
         return;
     }
 
-    const auto result = tiles.insert(std::make_pair(key, std::unique_ptr<Tile>{}));
-    if (result.second) {
-        // inserted
-        result.first->second = std::move(tile);
-    } else {
-        // already present
-        // remove existing tile key to move it to the end
-        orderedKeys.remove(key);
-        // release the newly-provided item
+    auto it = tiles.find(key);
+    if (it != tiles.end()) {
+        // already present, keep the existing tile and release the newly-provided one
         deferredRelease(std::move(tile));
+        evictionOrder.erase(it->second.order);
+    } else {
+        const size_t tileBytes = tile->getMemoryUsage();
+        it = tiles.emplace(key, Entry{.tile = std::move(tile), .bytes = tileBytes, .order = {}}).first;
+        bytes += tileBytes;
     }
 
-    // (re-)insert tile key as newest
-    orderedKeys.push_back(key);
+    // (re-)insert the tile as the newest of its priority
+    const double priority = getPriority(*it->second.tile, it->second.bytes);
+    it->second.order = evictionOrder.emplace(EvictionKey{priority, sequence++}, key).first;
 
-    // purge oldest key/tile if necessary
-    if (orderedKeys.size() > size) {
-        deferredRelease(pop(orderedKeys.front()));
-    }
+    // purge tiles if necessary
+    evict();
 
-    assert(orderedKeys.size() <= size);
+    assert(tiles.size() <= size);
 }
 
 Tile* TileCache::get(const OverscaledTileID& key) {
     auto it = tiles.find(key);
     if (it != tiles.end()) {
-        return it->second.get();
+        return it->second.tile.get();
     } else {
         return nullptr;
     }
@@ -144,9 +186,11 @@ std::unique_ptr<Tile> TileCache::pop(const OverscaledTileID& key) {
 
     const auto it = tiles.find(key);
     if (it != tiles.end()) {
-        tile = std::move(tiles.extract(it).mapped());
-        orderedKeys.remove(key);
+        tile = erase(it);
         assert(tile->isRenderable());
+        stats.hits++;
+    } else {
+        stats.misses++;
     }
 
     return tile;
@@ -158,10 +202,11 @@ bool TileCache::has(const OverscaledTileID& key) {
 
 void TileCache::clear() {
     for (auto& item : tiles) {
-        deferredRelease(std::move(item.second));
+        deferredRelease(std::move(item.second.tile));
     }
-    orderedKeys.clear();
+    evictionOrder.clear();
     tiles.clear();
+    bytes = 0;
 }
 
 } // namespace mln
@@ -1,10 +1,11 @@
 #pragma once
 
 #include <mbgl/actor/scheduler.hpp>
+#include <mbgl/tile/tile_cache_stats.hpp>
 #include <mbgl/tile/tile_id.hpp>
 #include <mbgl/tile/tile.hpp>
+#include <mbgl/util/containers.hpp>
 
-#include <list>
 #include <memory>
 #include <map>
 #include <atomic>
@@ -13,6 +14,12 @@
 
 namespace mln {
 
+/// Holds tiles which are no longer displayed, in case they are needed again.
+///
+/// The cache is bounded by a number of tiles and optionally by the approximate bytes of memory
+/// the tiles hold. When over either limit, tiles are evicted by their cost to load again for the
+/// memory they take, oldest first among equals, so a large tile which loaded quickly goes before
+/// a small one which took long to fetch and parse.
 class TileCache {
 public:
     TileCache(const TaggedScheduler& threadPool_, size_t size_ = 0)
@@ -20,12 +27,20 @@ public:
           size(size_) {}
     ~TileCache();
 
-    /// Change the maximum size of the cache.
+    /// Change the maximum number of tiles in the cache.
     void setSize(size_t);
 
-    /// Get the maximum size
+    /// Get the maximum number of tiles
     size_t getMaxSize() const { return size; }
 
+    /// Change the maximum bytes held by the tiles in the cache. Zero means no limit.
+    void setMaxBytes(size_t);
+
+    /// Get the maximum bytes
+    size_t getMaxBytes() const { return maxBytes; }
+
+    TileCacheStats getStats() const;
+
     /// Add a new tile with the given ID.
     /// If a tile with the same ID is already present, it will be retained and the new one will be discarded.
     void add(const OverscaledTileID& key, std::unique_ptr<Tile>&& tile);
@@ -42,14 +57,34 @@ public:
     void deferPendingReleases();
 
 private:
-    std::map<OverscaledTileID, std::unique_ptr<Tile>> tiles;
-    std::list<OverscaledTileID> orderedKeys;
+    /// Eviction priority and insertion sequence, lowest is evicted first
+    using EvictionKey = std::pair<double, uint64_t>;
+
+    struct Entry {
+        std::unique_ptr<Tile> tile;
+        size_t bytes;
+        std::map<EvictionKey, OverscaledTileID>::iterator order;
+    };
+    using Entries = mln::unordered_map<OverscaledTileID, Entry>;
+
+    double getPriority(const Tile&, size_t bytes) const;
+    std::unique_ptr<Tile> erase(Entries::iterator);
+    void evict();
+
+    Entries tiles;
+    std::map<EvictionKey, OverscaledTileID> evictionOrder;
+    double inflation = 0;
+    uint64_t sequence = 0;
+    size_t bytes = 0;
+    TileCacheStats stats;
+
     TaggedScheduler threadPool;
     std::vector<std::unique_ptr<Tile>> pendingReleases;
     size_t deferredDeletionsPending{0};
     std::mutex deferredSignalLock;
     std::condition_variable deferredSignal;
     size_t size;
+    size_t maxBytes = 0;
 };
 
 } // namespace mln
@@ -4,13 +4,14 @@
 #include <mapbox/geometry/box.hpp>
 #include <mbgl/math/minmax.hpp>
 
+#include <array>
+#include <bit>
 #include <cassert>
 #include <cmath>
 #include <cstddef>
 #include <cstdint>
-#include <functional>
-#include <optional>
-#include <unordered_set>
+#include <limits>
+#include <utility>
 #include <vector>
 
 namespace mln {
@@ -51,6 +52,15 @@ constexpr bool operator!=(circle<T> const& lhs, circle<T> const& rhs) {
  at least one cell. As long as the geometries are relatively
  uniformly distributed across the plane, this greatly reduces
  the number of comparisons necessary.
+
+ The first elements of a cell are kept in the cell itself, which is
+ all most cells need, and the others in a chain of fixed-size blocks,
+ all of which live in one contiguous pool. A block stores the bounds
+ of its elements as separate coordinate arrays, so that a query tests
+ all the elements of a block at once in a loop the compiler turns
+ into vector instructions. An element spanning several cells is only
+ reported from the first cell it shares with the query, which makes
+ queries free of allocations.
 */
 
 template <class T>
@@ -61,7 +71,7 @@ public:
     using BBox = mapbox::geometry::box<float>;
     using BCircle = geometry::circle<float>;
 
-    /// Set the expected number of elements per cell to avoid small re-allocations for populated cells
+    /// Set the expected number of elements per cell, so that the block pool is allocated once up front
     void reserve(std::size_t value) { estimatedElementsPerCell = value; }
 
     void insert(T&& t, const BBox&);
@@ -70,23 +80,93 @@ public:
     std::vector<T> query(const BBox&) const;
     std::vector<std::pair<T, BBox>> queryWithBoxes(const BBox&) const;
 
-    bool hitTest(const BBox&, std::optional<std::function<bool(const T&)>> predicate = std::nullopt) const;
-    bool hitTest(const BCircle&, std::optional<std::function<bool(const T&)>> predicate = std::nullopt) const;
+    /// Calls `fn(const T&, const BBox&)` for every element intersecting the box, until it returns true.
+    /// Returns whether the query was stopped that way.
+    template <typename Fn>
+    bool query(const BBox&, Fn&& fn) const;
+    template <typename Fn>
+    bool query(const BCircle&, Fn&& fn) const;
+
+    bool hitTest(const BBox&) const;
+    bool hitTest(const BCircle&) const;
+
+    /// Whether an element for which `predicate(const T&)` holds intersects the box or circle
+    template <typename Predicate>
+    bool hitTest(const BBox&, Predicate&& predicate) const;
+    template <typename Predicate>
+    bool hitTest(const BCircle&, Predicate&& predicate) const;
 
     bool empty() const;
 
+    /// The boxes inserted so far, in insertion order
+    const std::vector<std::pair<T, BBox>>& getBoxElements() const { return boxElements; }
+
 private:
+    static constexpr std::size_t inlineSize = 2;
+    static constexpr std::size_t blockSize = 8;
+    static constexpr uint32_t noBlock = std::numeric_limits<uint32_t>::max();
+
+    /// Up to `blockSize` elements of a cell, with their bounds laid out to be tested together.
+    /// For circles, the bounds are the ones of the enclosing box.
+    struct Block {
+        std::array<float, blockSize> minX;
+        std::array<float, blockSize> minY;
+        std::array<float, blockSize> maxX;
+        std::array<float, blockSize> maxY;
+        std::array<uint32_t, blockSize> uids;
+        // The first cell the element covers
+        std::array<uint16_t, blockSize> firstX;
+        std::array<uint16_t, blockSize> firstY;
+        uint32_t count = 0;
+        uint32_t next = noBlock;
+    };
+
+    /// The first `inlineSize` elements of a cell, which are tested one by one with the bounds they were inserted
+    /// with, and the chain of blocks of the others. A block takes about 200 bytes, which isn't worth it for a cell
+    /// with an element or two.
+    struct Cell {
+        std::array<uint32_t, inlineSize> uids;
+        std::array<uint16_t, inlineSize> firstX;
+        std::array<uint16_t, inlineSize> firstY;
+        uint32_t count = 0;
+        uint32_t first = noBlock;
+        uint32_t last = noBlock;
+    };
+
+    /// The cells covered by a box
+    struct CellRange {
+        std::size_t x1;
+        std::size_t y1;
+        std::size_t x2;
+        std::size_t y2;
+    };
+
     bool noIntersection(const BBox& queryBBox) const;
     bool completeIntersection(const BBox& queryBBox) const;
     BBox convertToBox(const BCircle& circle) const;
-
-    void query(const BBox&, std::function<bool(const T&, const BBox&)>) const;
-    void query(const BCircle&, std::function<bool(const T&, const BBox&)>) const;
+    CellRange convertToCellRange(const BBox&) const;
+
+    void append(Cell&, std::vector<Block>&, uint32_t uid, const BBox&, const CellRange&);
+
+    /// Calls `fn(uid)` for the elements of a cell whose bounds, as given by `bounds(uid)` for the ones kept in the
+    /// cell itself, intersect the box and which are reported from the cell, until it returns true
+    template <typename Bounds, typename Fn>
+    static bool visitCell(const Cell&,
+                          const std::vector<Block>&,
+                          Bounds&& bounds,
+                          const BBox&,
+                          std::size_t x,
+                          std::size_t y,
+                          const CellRange&,
+                          Fn&& fn);
+    static uint32_t intersecting(const Block&, const BBox&);
+
+    template <typename Fn>
+    bool visitAll(Fn&& fn) const;
 
     std::size_t convertToXCellCoord(float x) const;
     std::size_t convertToYCellCoord(float y) const;
 
-    bool boxesCollide(const BBox&, const BBox&) const;
     bool circlesCollide(const BCircle&, const BCircle&) const;
     bool circleAndBoxCollide(const BCircle&, const BBox&) const;
 
@@ -103,8 +183,10 @@ private:
     std::vector<std::pair<T, BBox>> boxElements;
     std::vector<std::pair<T, BCircle>> circleElements;
 
-    std::vector<std::vector<uint32_t>> boxCells;
-    std::vector<std::vector<uint32_t>> circleCells;
+    std::vector<Cell> boxCells;
+    std::vector<Cell> circleCells;
+    std::vector<Block> boxBlocks;
+    std::vector<Block> circleBlocks;
 };
 
 template <class T>
@@ -117,6 +199,8 @@ GridIndex<T>::GridIndex(const float width_, const float height_, const uint32_t
       yScale(yCellCount / height) {
     assert(width > 0.0f);
     assert(height > 0.0f);
+    assert(xCellCount <= std::numeric_limits<uint16_t>::max() + 1u);
+    assert(yCellCount <= std::numeric_limits<uint16_t>::max() + 1u);
     boxCells.resize(xCellCount * yCellCount);
     circleCells.resize(xCellCount * yCellCount);
 }
@@ -126,18 +210,10 @@ void GridIndex<T>::insert(T&& t, const BBox& bbox) {
     assert(boxElements.size() < std::numeric_limits<uint32_t>::max());
     const auto uid = static_cast<uint32_t>(boxElements.size());
 
-    const auto cx1 = convertToXCellCoord(bbox.min.x);
-    const auto cy1 = convertToYCellCoord(bbox.min.y);
-    const auto cx2 = convertToXCellCoord(bbox.max.x);
-    const auto cy2 = convertToYCellCoord(bbox.max.y);
-
-    for (std::size_t x = cx1; x <= cx2; ++x) {
-        for (std::size_t y = cy1; y <= cy2; ++y) {
-            auto& cell = boxCells[xCellCount * y + x];
-            if (estimatedElementsPerCell && cell.empty()) {
-                cell.reserve(estimatedElementsPerCell);
-            }
-            cell.push_back(uid);
+    const auto cells = convertToCellRange(bbox);
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            append(boxCells[xCellCount * y + x], boxBlocks, uid, bbox, cells);
         }
     }
 
@@ -149,24 +225,54 @@ void GridIndex<T>::insert(T&& t, const BCircle& bcircle) {
     assert(circleElements.size() < std::numeric_limits<uint32_t>::max());
     const auto uid = static_cast<uint32_t>(circleElements.size());
 
-    const auto cx1 = convertToXCellCoord(bcircle.center.x - bcircle.radius);
-    const auto cy1 = convertToYCellCoord(bcircle.center.y - bcircle.radius);
-    const auto cx2 = convertToXCellCoord(bcircle.center.x + bcircle.radius);
-    const auto cy2 = convertToYCellCoord(bcircle.center.y + bcircle.radius);
-
-    for (std::size_t x = cx1; x <= cx2; ++x) {
-        for (std::size_t y = cy1; y <= cy2; ++y) {
-            auto& cell = circleCells[xCellCount * y + x];
-            if (estimatedElementsPerCell && cell.empty()) {
-                cell.reserve(estimatedElementsPerCell);
-            }
-            cell.push_back(uid);
+    const auto bbox = convertToBox(bcircle);
+    const auto cells = convertToCellRange(bbox);
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            append(circleCells[xCellCount * y + x], circleBlocks, uid, bbox, cells);
         }
     }
 
     circleElements.emplace_back(std::move(t), bcircle);
 }
 
+template <class T>
+void GridIndex<T>::append(
+    Cell& cell, std::vector<Block>& blocks, const uint32_t uid, const BBox& bbox, const CellRange& cells) {
+    if (cell.count < inlineSize) {
+        const auto i = cell.count++;
+        cell.uids[i] = uid;
+        cell.firstX[i] = static_cast<uint16_t>(cells.x1);
+        cell.firstY[i] = static_cast<uint16_t>(cells.y1);
+        return;
+    }
+
+    if (cell.last == noBlock || blocks[cell.last].count == blockSize) {
+        if (blocks.empty() && estimatedElementsPerCell > inlineSize) {
+            blocks.reserve(boxCells.size() * ((estimatedElementsPerCell - inlineSize + blockSize - 1) / blockSize));
+        }
+        assert(blocks.size() < noBlock);
+        const auto index = static_cast<uint32_t>(blocks.size());
+        blocks.emplace_back();
+        if (cell.last == noBlock) {
+            cell.first = index;
+        } else {
+            blocks[cell.last].next = index;
+        }
+        cell.last = index;
+    }
+
+    Block& block = blocks[cell.last];
+    const auto i = block.count++;
+    block.minX[i] = bbox.min.x;
+    block.minY[i] = bbox.min.y;
+    block.maxX[i] = bbox.max.x;
+    block.maxY[i] = bbox.max.y;
+    block.uids[i] = uid;
+    block.firstX[i] = static_cast<uint16_t>(cells.x1);
+    block.firstY[i] = static_cast<uint16_t>(cells.y1);
+}
+
 template <class T>
 std::vector<T> GridIndex<T>::query(const BBox& queryBBox) const {
     std::vector<T> result;
@@ -188,31 +294,25 @@ std::vector<std::pair<T, typename GridIndex<T>::BBox>> GridIndex<T>::queryWithBo
 }
 
 template <class T>
-bool GridIndex<T>::hitTest(const BBox& queryBBox, std::optional<std::function<bool(const T&)>> predicate) const {
-    bool hit = false;
-    query(queryBBox, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
-    });
-    return hit;
+bool GridIndex<T>::hitTest(const BBox& queryBBox) const {
+    return query(queryBBox, [](const T&, const BBox&) { return true; });
 }
 
 template <class T>
-bool GridIndex<T>::hitTest(const BCircle& queryBCircle, std::optional<std::function<bool(const T&)>> predicate) const {
-    bool hit = false;
-    query(queryBCircle, [&](const T& t, const BBox&) -> bool {
-        if (!predicate || (*predicate)(t)) {
-            hit = true;
-            return true;
-        } else {
-            return false;
-        }
-    });
-    return hit;
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle) const {
+    return query(queryBCircle, [](const T&, const BBox&) { return true; });
+}
+
+template <class T>
+template <typename Predicate>
+bool GridIndex<T>::hitTest(const BBox& queryBBox, Predicate&& predicate) const {
+    return query(queryBBox, [&](const T& t, const BBox&) -> bool { return predicate(t); });
+}
+
+template <class T>
+template <typename Predicate>
+bool GridIndex<T>::hitTest(const BCircle& queryBCircle, Predicate&& predicate) const {
+    return query(queryBCircle, [&](const T& t, const BBox&) -> bool { return predicate(t); });
 }
 
 template <class T>
@@ -232,133 +332,144 @@ typename GridIndex<T>::BBox GridIndex<T>::convertToBox(const BCircle& circle) co
 }
 
 template <class T>
-void GridIndex<T>::query(const BBox& queryBBox, std::function<bool(const T&, const BBox&)> resultFn) const {
-    std::unordered_set<uint32_t> seenBoxes;
-    std::unordered_set<uint32_t> seenCircles;
+typename GridIndex<T>::CellRange GridIndex<T>::convertToCellRange(const BBox& bbox) const {
+    return {convertToXCellCoord(bbox.min.x),
+            convertToYCellCoord(bbox.min.y),
+            convertToXCellCoord(bbox.max.x),
+            convertToYCellCoord(bbox.max.y)};
+}
 
-    if (noIntersection(queryBBox)) {
-        return;
-    } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
-                return;
-            }
+template <class T>
+uint32_t GridIndex<T>::intersecting(const Block& block, const BBox& box) {
+    // Non-short-circuiting, so that the comparisons of all slots vectorize
+    uint32_t mask = 0;
+    for (std::size_t i = 0; i < blockSize; ++i) {
+        const bool hit = (block.minX[i] <= box.max.x) & (block.minY[i] <= box.max.y) & (block.maxX[i] >= box.min.x) &
+                         (block.maxY[i] >= box.min.y);
+        mask |= static_cast<uint32_t>(hit) << i;
+    }
+    return mask & ((1u << block.count) - 1u);
+}
+
+template <class T>
+template <typename Bounds, typename Fn>
+bool GridIndex<T>::visitCell(const Cell& cell,
+                             const std::vector<Block>& blocks,
+                             Bounds&& bounds,
+                             const BBox& queryBBox,
+                             const std::size_t x,
+                             const std::size_t y,
+                             const CellRange& queryCells,
+                             Fn&& fn) {
+    for (uint32_t i = 0; i < cell.count; ++i) {
+        const BBox bbox = bounds(cell.uids[i]);
+        if (bbox.min.x <= queryBBox.max.x && bbox.min.y <= queryBBox.max.y && bbox.max.x >= queryBBox.min.x &&
+            bbox.max.y >= queryBBox.min.y && std::max<std::size_t>(cell.firstX[i], queryCells.x1) == x &&
+            std::max<std::size_t>(cell.firstY[i], queryCells.y1) == y && fn(cell.uids[i])) {
+            return true;
         }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
-                return;
+    }
+    for (uint32_t index = cell.first; index != noBlock; index = blocks[index].next) {
+        const Block& block = blocks[index];
+        for (uint32_t mask = intersecting(block, queryBBox); mask; mask &= mask - 1) {
+            const auto i = static_cast<std::size_t>(std::countr_zero(mask));
+            // Elements spanning several cells are reported from the first cell they share with the query only
+            if (std::max<std::size_t>(block.firstX[i], queryCells.x1) == x &&
+                std::max<std::size_t>(block.firstY[i], queryCells.y1) == y && fn(block.uids[i])) {
+                return true;
             }
         }
-        return;
     }
+    return false;
+}
 
-    auto cx1 = convertToXCellCoord(queryBBox.min.x);
-    auto cy1 = convertToYCellCoord(queryBBox.min.y);
-    auto cx2 = convertToXCellCoord(queryBBox.max.x);
-    auto cy2 = convertToYCellCoord(queryBBox.max.y);
-
-    std::size_t x;
-    std::size_t y;
-    std::size_t cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
+template <class T>
+template <typename Fn>
+bool GridIndex<T>::visitAll(Fn&& fn) const {
+    for (auto& element : boxElements) {
+        if (fn(element.first, element.second)) {
+            return true;
+        }
+    }
+    for (auto& element : circleElements) {
+        if (fn(element.first, convertToBox(element.second))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+template <class T>
+template <typename Fn>
+bool GridIndex<T>::query(const BBox& queryBBox, Fn&& fn) const {
+    if (noIntersection(queryBBox)) {
+        return false;
+    } else if (completeIntersection(queryBBox)) {
+        return visitAll(fn);
+    }
+
+    const auto boxBounds = [&](uint32_t uid) { return boxElements[uid].second; };
+    const auto circleBounds = [&](uint32_t uid) { return convertToBox(circleElements[uid].second); };
+    const auto cells = convertToCellRange(queryBBox);
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            const std::size_t cellIndex = xCellCount * y + x;
             // Look up other boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (!seenBoxes.contains(uid)) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (boxesCollide(queryBBox, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
+            if (visitCell(boxCells[cellIndex], boxBlocks, boxBounds, queryBBox, x, y, cells, [&](uint32_t uid) {
+                    const auto& pair = boxElements[uid];
+                    return fn(pair.first, pair.second);
+                })) {
+                return true;
             }
 
             // Look up circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (!seenCircles.contains(uid)) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circleAndBoxCollide(bcircle, queryBBox)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
+            if (visitCell(
+                    circleCells[cellIndex], circleBlocks, circleBounds, queryBBox, x, y, cells, [&](uint32_t uid) {
+                    const auto& pair = circleElements[uid];
+                    return circleAndBoxCollide(pair.second, queryBBox) && fn(pair.first, convertToBox(pair.second));
+                })) {
+                return true;
             }
         }
     }
+    return false;
 }
 
 template <class T>
-void GridIndex<T>::query(const BCircle& queryBCircle, std::function<bool(const T&, const BBox&)> resultFn) const {
-    std::unordered_set<size_t> seenBoxes;
-    std::unordered_set<size_t> seenCircles;
-
-    BBox queryBBox = convertToBox(queryBCircle);
+template <typename Fn>
+bool GridIndex<T>::query(const BCircle& queryBCircle, Fn&& fn) const {
+    const BBox queryBBox = convertToBox(queryBCircle);
     if (noIntersection(queryBBox)) {
-        return;
+        return false;
     } else if (completeIntersection(queryBBox)) {
-        for (auto& element : boxElements) {
-            if (resultFn(element.first, element.second)) {
-                return;
-            }
-        }
-        for (auto& element : circleElements) {
-            if (resultFn(element.first, convertToBox(element.second))) {
-                return;
-            }
-        }
+        return visitAll(fn);
     }
 
-    auto cx1 = convertToXCellCoord(queryBCircle.center.x - queryBCircle.radius);
-    auto cy1 = convertToYCellCoord(queryBCircle.center.y - queryBCircle.radius);
-    auto cx2 = convertToXCellCoord(queryBCircle.center.x + queryBCircle.radius);
-    auto cy2 = convertToYCellCoord(queryBCircle.center.y + queryBCircle.radius);
-
-    std::size_t x;
-    std::size_t y;
-    std::size_t cellIndex;
-    for (x = cx1; x <= cx2; ++x) {
-        for (y = cy1; y <= cy2; ++y) {
-            cellIndex = xCellCount * y + x;
+    const auto boxBounds = [&](uint32_t uid) { return boxElements[uid].second; };
+    const auto circleBounds = [&](uint32_t uid) { return convertToBox(circleElements[uid].second); };
+    const auto cells = convertToCellRange(queryBBox);
+    for (std::size_t x = cells.x1; x <= cells.x2; ++x) {
+        for (std::size_t y = cells.y1; y <= cells.y2; ++y) {
+            const std::size_t cellIndex = xCellCount * y + x;
             // Look up boxes
-            for (auto uid : boxCells[cellIndex]) {
-                if (!seenBoxes.contains(uid)) {
-                    seenBoxes.insert(uid);
-
-                    auto& pair = boxElements.at(uid);
-                    auto& bbox = pair.second;
-                    if (circleAndBoxCollide(queryBCircle, bbox)) {
-                        if (resultFn(pair.first, bbox)) {
-                            return;
-                        }
-                    }
-                }
+            if (visitCell(boxCells[cellIndex], boxBlocks, boxBounds, queryBBox, x, y, cells, [&](uint32_t uid) {
+                    const auto& pair = boxElements[uid];
+                    return circleAndBoxCollide(queryBCircle, pair.second) && fn(pair.first, pair.second);
+                })) {
+                return true;
             }
 
             // Look up other circles
-            for (auto uid : circleCells[cellIndex]) {
-                if (!seenCircles.contains(uid)) {
-                    seenCircles.insert(uid);
-
-                    auto& pair = circleElements.at(uid);
-                    auto& bcircle = pair.second;
-                    if (circlesCollide(queryBCircle, bcircle)) {
-                        if (resultFn(pair.first, convertToBox(bcircle))) {
-                            return;
-                        }
-                    }
-                }
+            if (visitCell(
+                    circleCells[cellIndex], circleBlocks, circleBounds, queryBBox, x, y, cells, [&](uint32_t uid) {
+                    const auto& pair = circleElements[uid];
+                    return circlesCollide(queryBCircle, pair.second) && fn(pair.first, convertToBox(pair.second));
+                })) {
+                return true;
             }
         }
     }
+    return false;
 }
 
 template <class T>
@@ -371,12 +482,6 @@ std::size_t GridIndex<T>::convertToYCellCoord(const float y) const {
     return static_cast<size_t>(util::max(0.0, util::min(yCellCount - 1.0, std::floor(y * yScale))));
 }
 
-template <class T>
-bool GridIndex<T>::boxesCollide(const BBox& first, const BBox& second) const {
-    return first.min.x <= second.max.x && first.min.y <= second.max.y && first.max.x >= second.min.x &&
-           first.max.y >= second.min.y;
-}
-
 template <class T>
 bool GridIndex<T>::circlesCollide(const BCircle& first, const BCircle& second) const {
     auto dx = second.center.x - first.center.x;
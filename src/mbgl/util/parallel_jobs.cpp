@@ -0,0 +1,85 @@
+#include <mbgl/util/parallel_jobs.hpp>
+
+#include <mbgl/util/instrumentation.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+
+namespace mln {
+namespace util {
+
+struct ParallelJobs::State {
+    State(std::size_t count_, Job job_)
+        : count(count_),
+          job(std::move(job_)) {}
+
+    // Claim and run jobs until none are left
+    void run() {
+        for (auto index = next++; index < count; index = next++) {
+            std::exception_ptr exception;
+            try {
+                job(index);
+            } catch (...) {
+                exception = std::current_exception();
+            }
+
+            std::scoped_lock lock(mutex);
+            if (exception && !error) {
+                error = exception;
+            }
+            if (++finished == count) {
+                cv.notify_all();
+            }
+        }
+    }
+
+    const std::size_t count;
+    const Job job;
+    std::atomic<std::size_t> next{0};
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::size_t finished = 0;
+    std::exception_ptr error;
+};
+
+ParallelJobs::ParallelJobs(std::size_t count, Job job)
+    : state(std::make_shared<State>(count, std::move(job))) {}
+
+ParallelJobs::~ParallelJobs() = default;
+
+void ParallelJobs::schedule(Scheduler& scheduler, std::size_t maxHelpers, const TaskPriority& priority) {
+    // The calling thread takes a share too, so one job fewer than there are is enough, and it counts as one of the
+    // threads the scheduler may run at once
+    const std::size_t concurrency = scheduler.getConcurrency();
+    const std::size_t helpers = std::min(
+        {maxHelpers, state->count > 0 ? state->count - 1 : 0, concurrency > 0 ? concurrency - 1 : 0});
+    for (std::size_t i = 0; i < helpers; ++i) {
+        auto helper = [state_ = state] { state_->run(); };
+        if (priority) {
+            scheduler.scheduleWithPriority(util::SimpleIdentity::Empty, std::move(helper), priority);
+        } else {
+            scheduler.schedule(std::move(helper));
+        }
+    }
+}
+
+void ParallelJobs::run() {
+    state->run();
+
+    {
+        MLN_TRACE_ZONE(wait);
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->cv.wait(lock, [&] { return state->finished == state->count; });
+    }
+
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+} // namespace util
+} // namespace mln
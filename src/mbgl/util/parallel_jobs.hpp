@@ -0,0 +1,43 @@
+#pragma once
+
+#include <mbgl/actor/scheduler.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+
+namespace mln {
+namespace util {
+
+/**
+ * Runs `job(0)` to `job(count - 1)` on the calling thread and on helper tasks of a scheduler.
+ *
+ * Jobs are claimed one at a time by whichever thread gets to them first, so the calling thread makes progress even
+ * when the scheduler is busy. Helpers starting after all jobs were claimed return without calling `job`, which
+ * therefore only needs to outlive `run()`.
+ */
+class ParallelJobs {
+public:
+    using Job = std::function<void(std::size_t)>;
+
+    ParallelJobs(std::size_t count, Job);
+    ~ParallelJobs();
+
+    /// Schedule up to `maxHelpers` helper tasks, no more than there are jobs besides the calling thread's first, and
+    /// than the scheduler's concurrency besides the calling thread. Helpers are scheduled with `priority` if set.
+    void schedule(Scheduler&,
+                  std::size_t maxHelpers = std::numeric_limits<std::size_t>::max(),
+                  const TaskPriority& priority = {});
+
+    /// Run jobs on the calling thread until none are left, then wait for the ones the helpers claimed. Rethrows the
+    /// first exception a job threw.
+    void run();
+
+private:
+    struct State;
+    std::shared_ptr<State> state;
+};
+
+} // namespace util
+} // namespace mln
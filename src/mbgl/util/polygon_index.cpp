@@ -0,0 +1,186 @@
+#include <mbgl/util/polygon_index.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace mln {
+
+namespace {
+
+// Edges per band when each edge spans a single band
+constexpr std::size_t edgesPerBand = 4;
+// Bands an edge spans on average at most, before fewer and taller bands are used
+constexpr std::size_t maxBandsPerEdge = 8;
+
+} // namespace
+
+PolygonIndex::PolygonIndex(const MultiPolygon<int64_t>& polygons) {
+    for (uint32_t polygon = 0; polygon < polygons.size(); ++polygon) {
+        for (const auto& ring : polygons[polygon]) {
+            for (std::size_t i = 0; i < ring.size(); ++i) {
+                updateBBox(bbox, ring[i]);
+                if (i + 1 < ring.size()) {
+                    edges.push_back({.a = ring[i], .b = ring[i + 1], .polygon = polygon});
+                }
+            }
+        }
+    }
+
+    // Long edges are listed in every band they span, so halve the number of bands until they don't take up
+    // more than a few times the space of the edges themselves.
+    const double height = static_cast<double>(bbox[3]) - static_cast<double>(bbox[1]);
+    std::size_t bandCount = std::max<std::size_t>(1, edges.size() / edgesPerBand);
+    while (true) {
+        bandScale = height > 0 ? static_cast<double>(bandCount) / height : 0;
+        bandStarts.assign(bandCount + 1, 0);
+        std::size_t total = 0;
+        for (const Edge& edge : edges) {
+            total += toBand(std::max(edge.a.y, edge.b.y)) - toBand(std::min(edge.a.y, edge.b.y)) + 1;
+        }
+        if (bandCount == 1 || total <= maxBandsPerEdge * edges.size()) {
+            bandEdges.resize(total);
+            break;
+        }
+        bandCount /= 2;
+    }
+
+    for (const Edge& edge : edges) {
+        for (auto band = toBand(std::min(edge.a.y, edge.b.y)); band <= toBand(std::max(edge.a.y, edge.b.y)); ++band) {
+            ++bandStarts[band + 1];
+        }
+    }
+    for (std::size_t band = 0; band < bandCount; ++band) {
+        bandStarts[band + 1] += bandStarts[band];
+    }
+
+    // Edges are added in the order of their polygons, which keeps the edges of each band ordered by polygon
+    std::vector<uint32_t> next(bandStarts.begin(), bandStarts.end() - 1);
+    for (uint32_t i = 0; i < edges.size(); ++i) {
+        const Edge& edge = edges[i];
+        for (auto band = toBand(std::min(edge.a.y, edge.b.y)); band <= toBand(std::max(edge.a.y, edge.b.y)); ++band) {
+            bandEdges[next[band]++] = i;
+        }
+    }
+}
+
+std::size_t PolygonIndex::toBand(const int64_t y) const noexcept {
+    const double band = std::floor((static_cast<double>(y) - static_cast<double>(bbox[1])) * bandScale);
+    return static_cast<std::size_t>(std::clamp(band, 0.0, static_cast<double>(bandStarts.size() - 2)));
+}
+
+PolygonIndex::EdgeRange PolygonIndex::getBand(const std::size_t band) const noexcept {
+    return {bandEdges.data() + bandStarts[band], bandEdges.data() + bandStarts[band + 1]};
+}
+
+PolygonIndex::EdgeRange PolygonIndex::getBand(const std::size_t band, const uint32_t polygon) const noexcept {
+    const EdgeRange range = getBand(band);
+    const auto* first = std::lower_bound(range.first, range.last, polygon, [&](uint32_t edge, uint32_t value) {
+        return edges[edge].polygon < value;
+    });
+    const auto* last = std::upper_bound(first, range.last, polygon, [&](uint32_t value, uint32_t edge) {
+        return value < edges[edge].polygon;
+    });
+    return {first, last};
+}
+
+bool PolygonIndex::contains(const Point<int64_t>& point) const noexcept {
+    if (point.y < bbox[1] || point.y > bbox[3]) {
+        return false;
+    }
+    const EdgeRange band = getBand(toBand(point.y));
+    for (const auto* first = band.first; first != band.last;) {
+        const uint32_t polygon = edges[*first].polygon;
+        const auto* last = first;
+        while (last != band.last && edges[*last].polygon == polygon) {
+            ++last;
+        }
+        if (contains(point, EdgeRange{first, last})) {
+            return true;
+        }
+        first = last;
+    }
+    return false;
+}
+
+bool PolygonIndex::contains(const LineString<int64_t>& line) const noexcept {
+    if (line.empty() || line.front().y < bbox[1] || line.front().y > bbox[3]) {
+        return false;
+    }
+
+    // Only the polygons holding the first point can hold the whole line
+    const auto within = [&](const uint32_t polygon) {
+        for (std::size_t i = 1; i < line.size(); ++i) {
+            if (!contains(line[i], polygon)) {
+                return false;
+            }
+        }
+        for (std::size_t i = 0; i + 1 < line.size(); ++i) {
+            if (intersects(line[i], line[i + 1], polygon)) {
+                return false;
+            }
+        }
+        return true;
+    };
+    const EdgeRange band = getBand(toBand(line.front().y));
+    for (const auto* first = band.first; first != band.last;) {
+        const uint32_t polygon = edges[*first].polygon;
+        const auto* last = first;
+        while (last != band.last && edges[*last].polygon == polygon) {
+            ++last;
+        }
+        if (contains(line.front(), EdgeRange{first, last}) && within(polygon)) {
+            return true;
+        }
+        first = last;
+    }
+    return false;
+}
+
+bool PolygonIndex::contains(const Point<int64_t>& point, const EdgeRange range) const noexcept {
+    // Ray casting, as `pointWithinPolygon()` does over every edge of the polygon
+    bool within = false;
+    for (const auto* it = range.first; it != range.last; ++it) {
+        const Edge& edge = edges[*it];
+        if (pointOnBoundary(point, edge.a, edge.b)) {
+            return false;
+        }
+        if (rayIntersect(point, edge.a, edge.b)) {
+            within = !within;
+        }
+    }
+    return within;
+}
+
+bool PolygonIndex::contains(const Point<int64_t>& point, const uint32_t polygon) const noexcept {
+    if (point.y < bbox[1] || point.y > bbox[3]) {
+        return false;
+    }
+    return contains(point, getBand(toBand(point.y), polygon));
+}
+
+bool PolygonIndex::intersects(const Point<int64_t>& a, const Point<int64_t>& b, const uint32_t polygon) const noexcept {
+    const int64_t minX = std::min(a.x, b.x);
+    const int64_t maxX = std::max(a.x, b.x);
+    const int64_t minY = std::max(std::min(a.y, b.y), bbox[1]);
+    const int64_t maxY = std::min(std::max(a.y, b.y), bbox[3]);
+    if (minY > maxY) {
+        return false;
+    }
+    // Edges spanning several of these bands are tested once for each, which doesn't change the result
+    for (auto band = toBand(minY); band <= toBand(maxY); ++band) {
+        const EdgeRange range = getBand(band, polygon);
+        for (const auto* it = range.first; it != range.last; ++it) {
+            const Edge& edge = edges[*it];
+            // Segments crossing each other overlap in x
+            if (std::max(edge.a.x, edge.b.x) < minX || std::min(edge.a.x, edge.b.x) > maxX) {
+                continue;
+            }
+            if (segmentIntersectSegment(a, b, edge.a, edge.b)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+} // namespace mln
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <mbgl/util/geometry.hpp>
+#include <mbgl/util/geometry_util.hpp>
+
+#include <cstdint>
+#include <vector>
+
+namespace mln {
+
+/**
+ * Polygons prepared for testing many points and lines against them, with the same results as
+ * `pointWithinPolygons()` and `lineStringWithinPolygons()`.
+ *
+ * The edges of all rings are sorted into horizontal bands by the rows they span. A point can only be on
+ * an edge, or have its ray cross it, if the edge spans the row of the point, so testing it only looks at
+ * the edges of one band instead of every edge of every ring.
+ */
+class PolygonIndex {
+public:
+    explicit PolygonIndex(const MultiPolygon<int64_t>&);
+
+    /// The bounding box of all polygons
+    const GeometryBBox<int64_t>& getBBox() const noexcept { return bbox; }
+
+    /// Whether the point is inside one of the polygons, and not on its boundary
+    bool contains(const Point<int64_t>&) const noexcept;
+
+    /// Whether all points of the line are inside one of the polygons, and no segment crosses its boundary
+    bool contains(const LineString<int64_t>&) const noexcept;
+
+private:
+    struct Edge {
+        Point<int64_t> a;
+        Point<int64_t> b;
+        uint32_t polygon;
+    };
+
+    struct EdgeRange {
+        const uint32_t* first;
+        const uint32_t* last;
+    };
+
+    std::size_t toBand(int64_t y) const noexcept;
+    // The edges of a band, ordered by polygon
+    EdgeRange getBand(std::size_t band) const noexcept;
+    // The edges of one polygon in a band
+    EdgeRange getBand(std::size_t band, uint32_t polygon) const noexcept;
+
+    // Tests the point against the edges of one polygon in its band
+    bool contains(const Point<int64_t>&, EdgeRange) const noexcept;
+    bool contains(const Point<int64_t>&, uint32_t polygon) const noexcept;
+    bool intersects(const Point<int64_t>& a, const Point<int64_t>& b, uint32_t polygon) const noexcept;
+
+    GeometryBBox<int64_t> bbox = DefaultWithinBBox;
+    std::vector<Edge> edges;
+    double bandScale = 0;
+    // Band `i` holds the edges `bandEdges[bandStarts[i]]` to `bandEdges[bandStarts[i + 1] - 1]`
+    std::vector<uint32_t> bandStarts;
+    std::vector<uint32_t> bandEdges;
+};
+
+} // namespace mln
@@ -7,8 +7,25 @@
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/string.hpp>
 
+#include <algorithm>
+
 namespace mln {
 
+namespace {
+// Index of the current worker within its owning scheduler, valid only when `thisThreadIsOwned()`
+thread_local std::size_t currentWorkerIndex = 0;
+} // namespace
+
+ThreadedSchedulerBase::ThreadedSchedulerBase(std::size_t workerCount, SchedulingStrategy strategy_)
+    : strategy(strategy_) {
+    if (strategy == SchedulingStrategy::WorkStealing) {
+        workerQueues.reserve(workerCount);
+        for (std::size_t i = 0; i < workerCount; ++i) {
+            workerQueues.push_back(std::make_unique<WorkerQueue>());
+        }
+    }
+}
+
 ThreadedSchedulerBase::~ThreadedSchedulerBase() = default;
 
 void ThreadedSchedulerBase::terminate() {
@@ -33,107 +50,236 @@ std::thread ThreadedSchedulerBase::makeSchedulerThread(size_t index) {
         platform::attachThread();
 
         owningThreadPool.set(this);
+        currentWorkerIndex = index;
 
-        while (true) {
-            std::unique_lock<std::mutex> conditionLock(workerMutex);
-            if (!terminated && taskCount == 0) {
-                cvAvailable.wait(conditionLock);
-            }
+        if (strategy == SchedulingStrategy::WorkStealing) {
+            runWorkStealingWorker(index);
+        } else {
+            runSharedQueueWorker();
+        }
 
-            if (terminated) {
-                platform::detachThread();
-                break;
-            }
+        platform::detachThread();
+    });
+}
+
+void ThreadedSchedulerBase::runSharedQueueWorker() {
+    while (true) {
+        std::unique_lock<std::mutex> conditionLock(workerMutex);
+        if (!terminated && taskCount == 0) {
+            cvAvailable.wait(conditionLock);
+        }
+
+        if (terminated) {
+            break;
+        }
 
-            // Let other threads run
-            conditionLock.unlock();
+        // Let other threads run
+        conditionLock.unlock();
 
-            std::vector<std::shared_ptr<Queue>> pending;
-            {
-                // 1. Gather buckets for us to visit this iteration
-                std::scoped_lock lock(taggedQueueLock);
-                for (const auto& [tag, queue] : taggedQueue) {
-                    pending.push_back(queue);
-                }
+        std::vector<std::shared_ptr<Queue>> pending;
+        {
+            // 1. Gather buckets for us to visit this iteration
+            std::scoped_lock lock(taggedQueueLock);
+            for (const auto& [tag, queue] : taggedQueue) {
+                pending.push_back(queue);
             }
+        }
+
+        // 2. Visit a task from each
+        for (auto& q : pending) {
+            runTask(q);
+        }
+    }
+}
+
+void ThreadedSchedulerBase::runWorkStealingWorker(std::size_t index) {
+    while (true) {
+        if (auto q = popTicket(index)) {
+            runTask(q);
+            continue;
+        }
 
-            // 2. Visit a task from each
-            for (auto& q : pending) {
-                std::function<void()> tasklet;
-                {
-                    std::scoped_lock lock(q->lock);
-                    if (q->queue.size()) {
-                        q->runningCount++;
-                        tasklet = std::move(q->queue.front());
-                        q->queue.pop();
-                    }
-                    if (!tasklet) continue;
-                }
-
-                assert(taskCount > 0);
+        std::unique_lock<std::mutex> conditionLock(workerMutex);
+        if (terminated) {
+            break;
+        }
+
+        // Announce ourselves as idle *before* checking for work so that a concurrent
+        // `schedule` either sees us waiting or we see its ticket.
+        idleWorkers++;
+        cvAvailable.wait(conditionLock, [&] { return terminated || taskCount > 0; });
+        idleWorkers--;
+
+        if (terminated) {
+            break;
+        }
+    }
+}
+
+std::shared_ptr<ThreadedSchedulerBase::Queue> ThreadedSchedulerBase::popTicket(std::size_t index) {
+    MLN_TRACE_FUNC();
+    const auto count = workerQueues.size();
+    {
+        // Newest first from our own deque, for cache locality with the task that scheduled it
+        auto& own = *workerQueues[index];
+        std::scoped_lock lock(own.lock);
+        if (!own.tickets.empty()) {
+            auto q = std::move(own.tickets.back());
+            own.tickets.pop_back();
+            taskCount--;
+            return q;
+        }
+    }
+
+    // Oldest first from the others, to take work which has been waiting the longest. Busy victims are skipped on
+    // the first pass, and waited for on a second one if any was skipped, so that a worker doesn't wake up straight
+    // away again for their work and spin while their locks are held.
+    bool skipped = false;
+    for (const bool blocking : {false, true}) {
+        if (blocking && !skipped) {
+            break;
+        }
+        for (std::size_t i = 1; i < count; ++i) {
+            auto& victim = *workerQueues[(index + i) % count];
+            std::unique_lock<std::mutex> lock(victim.lock, std::defer_lock);
+            if (blocking) {
+                lock.lock();
+            } else if (!lock.try_lock()) {
+                skipped = true;
+                continue;
+            }
+            if (!victim.tickets.empty()) {
+                auto q = std::move(victim.tickets.front());
+                victim.tickets.pop_front();
                 taskCount--;
+                return q;
+            }
+        }
+    }
+
+    return {};
+}
+
+void ThreadedSchedulerBase::runTask(const std::shared_ptr<Queue>& q) {
+    std::function<void()> tasklet;
+    {
+        std::scoped_lock lock(q->lock);
+        if (!q->empty()) {
+            q->runningCount++;
+            tasklet = q->pop();
+        }
+        if (!tasklet) return;
+    }
+
+    if (strategy == SchedulingStrategy::SharedQueue) {
+        // In work-stealing mode the count is released along with the ticket
+        assert(taskCount > 0);
+        taskCount--;
+    }
 
-                try {
-                    tasklet();
-                    tasklet = {}; // destroy the function and release its captures before unblocking `waitForEmpty`
-
-                    if (!--q->runningCount) {
-                        std::scoped_lock lock(q->lock);
-                        if (q->queue.empty()) {
-                            q->cv.notify_all();
-                        }
-                    }
-                } catch (...) {
-                    std::scoped_lock lock(q->lock);
-                    if (handler) {
-                        handler(std::current_exception());
-                    }
-
-                    tasklet = {};
-
-                    if (!--q->runningCount && q->queue.empty()) {
-                        q->cv.notify_all();
-                    }
-
-                    if (handler) {
-                        continue;
-                    }
-                    throw;
-                }
+    try {
+        tasklet();
+        tasklet = {}; // destroy the function and release its captures before unblocking `waitForEmpty`
+
+        if (!--q->runningCount) {
+            std::scoped_lock lock(q->lock);
+            if (q->empty()) {
+                q->cv.notify_all();
             }
         }
-    });
+    } catch (...) {
+        std::scoped_lock lock(q->lock);
+        if (handler) {
+            handler(std::current_exception());
+        }
+
+        tasklet = {};
+
+        if (!--q->runningCount && q->empty()) {
+            q->cv.notify_all();
+        }
+
+        if (handler) {
+            return;
+        }
+        throw;
+    }
 }
 
 void ThreadedSchedulerBase::schedule(std::function<void()>&& fn) {
     schedule(uniqueID, std::move(fn));
 }
 
+std::shared_ptr<ThreadedSchedulerBase::Queue> ThreadedSchedulerBase::getQueue(const util::SimpleIdentity tag) {
+    MLN_TRACE_ZONE(queue);
+    std::scoped_lock lock(taggedQueueLock);
+
+    // find or insert
+    auto result = taggedQueue.insert(std::make_pair(tag, std::shared_ptr<Queue>{}));
+    if (result.second) {
+        // new entry inserted
+        result.first->second = std::make_shared<Queue>();
+    }
+
+    MLN_ZONE_VALUE(taggedQueue.size());
+    return result.first->second;
+}
+
 void ThreadedSchedulerBase::schedule(const util::SimpleIdentity tag, std::function<void()>&& fn) {
     MLN_TRACE_FUNC();
+    enqueue(tag, std::move(fn), nullptr);
+}
+
+void ThreadedSchedulerBase::scheduleWithPriority(const util::SimpleIdentity tag,
+                                                 std::function<void()>&& fn,
+                                                 const TaskPriority& priority) {
+    MLN_TRACE_FUNC();
+    enqueue(tag.isEmpty() ? uniqueID : tag, std::move(fn), priority ? &priority : nullptr);
+}
+
+void ThreadedSchedulerBase::enqueue(const util::SimpleIdentity tag,
+                                    std::function<void()>&& fn,
+                                    const TaskPriority* priority) {
     assert(fn);
     if (!fn) return;
 
-    std::shared_ptr<Queue> q;
-    {
-        MLN_TRACE_ZONE(queue);
-        std::scoped_lock lock(taggedQueueLock);
+    std::shared_ptr<Queue> q = getQueue(tag);
 
-        // find or insert
-        auto result = taggedQueue.insert(std::make_pair(tag, std::shared_ptr<Queue>{}));
-        if (result.second) {
-            // new entry inserted
-            result.first->second = std::make_shared<Queue>();
+    const auto push = [&] {
+        MLN_TRACE_ZONE(push);
+        if (priority) {
+            q->pushPrioritized(*priority, std::move(fn));
+        } else {
+            q->queue.push(std::move(fn));
+        }
+    };
+
+    if (strategy == SchedulingStrategy::WorkStealing) {
+        {
+            std::scoped_lock lock(q->lock);
+            push();
+        }
+
+        // Tasks scheduled from one of our workers stay local, others are spread round-robin
+        const auto index = thisThreadIsOwned() ? currentWorkerIndex : (nextWorker++ % workerQueues.size());
+        {
+            auto& target = *workerQueues[index];
+            std::scoped_lock lock(target.lock);
+            target.tickets.push_back(std::move(q));
+            taskCount++;
         }
-        q = result.first->second;
 
-        MLN_ZONE_VALUE(taggedQueue.size());
+        // Only pay for the worker lock when someone may be sleeping on it
+        if (idleWorkers > 0) {
+            std::scoped_lock workerLock(workerMutex);
+            cvAvailable.notify_one();
+        }
+        return;
     }
 
     {
-        MLN_TRACE_ZONE(push);
         std::scoped_lock lock(q->lock);
-        q->queue.push(std::move(fn));
+        push();
         taskCount++;
     }
 
@@ -142,6 +288,50 @@ void ThreadedSchedulerBase::schedule(const util::SimpleIdentity tag, std::functi
     cvAvailable.notify_one();
 }
 
+// static
+bool ThreadedSchedulerBase::Queue::runsAfter(const PrioritizedTask& a, const PrioritizedTask& b) {
+    return a.value < b.value || (a.value == b.value && a.sequence > b.sequence);
+}
+
+void ThreadedSchedulerBase::Queue::pushPrioritized(const TaskPriority& priority, std::function<void()>&& fn) {
+    prioritized.push_back({priority->load(std::memory_order_relaxed), nextSequence++, priority, std::move(fn)});
+    std::push_heap(prioritized.begin(), prioritized.end(), runsAfter);
+}
+
+void ThreadedSchedulerBase::Queue::reorder() {
+    for (auto& task : prioritized) {
+        task.value = task.priority->load(std::memory_order_relaxed);
+    }
+    std::make_heap(prioritized.begin(), prioritized.end(), runsAfter);
+    // Reading them all again after an eighth of them ran keeps pops at amortized logarithmic cost
+    popsUntilReorder = prioritized.size() / 8;
+}
+
+std::function<void()> ThreadedSchedulerBase::Queue::pop() {
+    // Prioritized tasks run ahead of plain ones while their priority is above zero and after
+    // them once it drops below. Priorities may change after submission without notice: they are
+    // read again when the top one changed, and every so often in case others did.
+    if (!prioritized.empty()) {
+        const auto& top = prioritized.front();
+        if (popsUntilReorder == 0 || top.priority->load(std::memory_order_relaxed) != top.value) {
+            reorder();
+        } else {
+            --popsUntilReorder;
+        }
+
+        if (queue.empty() || prioritized.front().value > 0) {
+            std::pop_heap(prioritized.begin(), prioritized.end(), runsAfter);
+            auto fn = std::move(prioritized.back().fn);
+            prioritized.pop_back();
+            return fn;
+        }
+    }
+
+    auto fn = std::move(queue.front());
+    queue.pop();
+    return fn;
+}
+
 void ThreadedSchedulerBase::waitForEmpty(const util::SimpleIdentity tag) {
     // Must not be called from a thread in our pool, or we would deadlock
     assert(!thisThreadIsOwned());
@@ -159,7 +349,7 @@ void ThreadedSchedulerBase::waitForEmpty(const util::SimpleIdentity tag) {
         }
 
         std::unique_lock<std::mutex> queueLock(q->lock);
-        while (q->queue.size() + q->runningCount) {
+        while (q->size() + q->runningCount) {
             q->cv.wait(queueLock);
         }
 
@@ -7,7 +7,11 @@
 #include <mbgl/util/identity.hpp>
 #include <mbgl/util/instrumentation.hpp>
 
+#include <atomic>
 #include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <queue>
 #include <thread>
@@ -15,6 +19,15 @@
 
 namespace mln {
 
+/// @brief Strategy used by a `ThreadedSchedulerBase` to hand tasks to its workers.
+enum class SchedulingStrategy : uint8_t {
+    /// All workers wait on a single condition and scan every tagged queue for work.
+    SharedQueue,
+    /// Each worker owns a deque of ready tags and steals from its siblings when idle.
+    /// Tasks within a tag are still dequeued in submission order.
+    WorkStealing,
+};
+
 class ThreadedSchedulerBase : public Scheduler {
 public:
     /// @brief Schedule a generic task not assigned to any particular owner.
@@ -26,10 +39,19 @@ public:
     /// @param tag Identifier object to indicate ownership of `fn`
     /// @param fn Task to run
     void schedule(const util::SimpleIdentity tag, std::function<void()>&& fn) override;
+
+    /// @brief Schedule a task assigned to the given owner `tag`, to be run ahead of the owner's
+    /// other pending tasks with a lower current priority.
+    /// @param tag Identifier object to indicate ownership of `fn`
+    /// @param fn Task to run
+    /// @param priority Priority of the task, read each time a task is picked
+    void scheduleWithPriority(const util::SimpleIdentity tag,
+                              std::function<void()>&& fn,
+                              const TaskPriority& priority) override;
     const util::SimpleIdentity uniqueID;
 
 protected:
-    ThreadedSchedulerBase() = default;
+    ThreadedSchedulerBase(std::size_t workerCount, SchedulingStrategy strategy);
     ~ThreadedSchedulerBase() override;
 
     void terminate();
@@ -58,8 +80,60 @@ protected:
         std::condition_variable cv;              /* queue empty condition */
         std::mutex lock;                         /* lock */
         std::queue<std::function<void()>> queue; /* pending task queue */
+
+        /// A prioritized task, with the value of its priority when the heap was last ordered
+        struct PrioritizedTask {
+            int32_t value;
+            uint64_t sequence;
+            TaskPriority priority;
+            std::function<void()> fn;
+        };
+
+        /* pending prioritized tasks, in a max-heap by priority then submission order */
+        std::vector<PrioritizedTask> prioritized;
+        uint64_t nextSequence = 0;
+        /* pops left before the priorities are read again, even if the top one didn't change */
+        std::size_t popsUntilReorder = 0;
+
+        bool empty() const { return queue.empty() && prioritized.empty(); }
+        std::size_t size() const { return queue.size() + prioritized.size(); }
+
+        /// Add a prioritized task, must hold `lock`.
+        void pushPrioritized(const TaskPriority&, std::function<void()>&&);
+
+        /// Remove the next task to run, must hold `lock`.
+        std::function<void()> pop();
+
+    private:
+        /// Read the priorities again and restore the heap
+        void reorder();
+
+        /// Orders the heap by priority, and earlier submissions first among equal priorities
+        static bool runsAfter(const PrioritizedTask&, const PrioritizedTask&);
     };
     mln::unordered_map<util::SimpleIdentity, std::shared_ptr<Queue>> taggedQueue;
+
+    const SchedulingStrategy strategy;
+
+private:
+    std::shared_ptr<Queue> getQueue(const util::SimpleIdentity tag);
+    void enqueue(const util::SimpleIdentity tag, std::function<void()>&& fn, const TaskPriority* priority);
+    void runTask(const std::shared_ptr<Queue>& q);
+    void runSharedQueueWorker();
+    void runWorkStealingWorker(std::size_t index);
+
+    /// Take a ticket from our own deque, or steal one from another worker.
+    std::shared_ptr<Queue> popTicket(std::size_t index);
+
+    // Work-stealing state. Each ticket represents exactly one pending task in the
+    // referenced tag queue, so consuming tickets in any order preserves per-tag FIFO.
+    struct WorkerQueue {
+        std::mutex lock;
+        std::deque<std::shared_ptr<Queue>> tickets;
+    };
+    std::vector<std::unique_ptr<WorkerQueue>> workerQueues;
+    std::atomic<std::size_t> nextWorker{0};
+    std::atomic<std::size_t> idleWorkers{0};
 };
 
 /**
@@ -72,8 +146,9 @@ protected:
  */
 class ThreadedScheduler : public ThreadedSchedulerBase {
 public:
-    ThreadedScheduler(std::size_t n)
-        : threads(n) {
+    ThreadedScheduler(std::size_t n, SchedulingStrategy strategy_ = SchedulingStrategy::SharedQueue)
+        : ThreadedSchedulerBase(n, strategy_),
+          threads(n) {
         for (std::size_t i = 0u; i < threads.size(); ++i) {
             threads[i] = makeSchedulerThread(i);
         }
@@ -88,6 +163,8 @@ public:
         }
     }
 
+    std::size_t getConcurrency() const override { return threads.size(); }
+
     void runOnRenderThread(const util::SimpleIdentity tag, std::function<void()>&& fn) override {
         std::shared_ptr<RenderQueue> queue;
         {
@@ -165,21 +242,21 @@ private:
 class SequencedScheduler final : public ThreadedScheduler {
 public:
     SequencedScheduler()
-        : ThreadedScheduler(1) {}
+        : ThreadedScheduler(1, SchedulingStrategy::SharedQueue) {}
     ~SequencedScheduler() override { invalidateWeakPtrsEarly(); }
 };
 
 class ParallelScheduler : public ThreadedScheduler {
 public:
-    ParallelScheduler(std::size_t extra)
-        : ThreadedScheduler(1 + extra) {}
+    ParallelScheduler(std::size_t extra, SchedulingStrategy strategy_ = SchedulingStrategy::SharedQueue)
+        : ThreadedScheduler(1 + extra, strategy_) {}
     ~ParallelScheduler() override { invalidateWeakPtrsEarly(); }
 };
 
 class ThreadPool final : public ParallelScheduler {
 public:
-    ThreadPool()
-        : ParallelScheduler(3) {}
+    ThreadPool(SchedulingStrategy strategy_ = SchedulingStrategy::SharedQueue)
+        : ParallelScheduler(3, strategy_) {}
     ~ThreadPool() override { invalidateWeakPtrsEarly(); }
 };
 
@@ -3,6 +3,7 @@
 #include <mbgl/util/math.hpp>
 
 #include <algorithm>
+#include <array>
 
 namespace mln {
 namespace util {
@@ -11,83 +12,137 @@ namespace tinysdf {
 
 static const double INF = 1e20;
 
-// 1D squared distance transform
-void edt1d(
-    std::vector<double>& f, std::vector<double>& d, std::vector<int16_t>& v, std::vector<double>& z, uint32_t n) {
-    v[0] = 0;
-    z[0] = -INF;
-    z[1] = +INF;
+// Squared distances to the glyph outline for each alpha value, outside and inside of the glyph
+struct InitialDistances {
+    std::array<double, 256> outer;
+    std::array<double, 256> inner;
+};
+
+const InitialDistances& initialDistances() {
+    static const InitialDistances distances = [] {
+        InitialDistances result;
+        for (uint32_t alpha = 0; alpha < 256; alpha++) {
+            double a = static_cast<double>(alpha) / 255;
+            result.outer[alpha] = a == 1.0 ? 0.0 : a == 0.0 ? INF : std::pow(std::max(0.0, 0.5 - a), 2.0);
+            result.inner[alpha] = a == 1.0 ? INF : a == 0.0 ? 0.0 : std::pow(std::max(0.0, a - 0.5), 2.0);
+        }
+        return result;
+    }();
+    return distances;
+}
+
+// A line of n values which are all 0 or all INF transforms to itself: every value is the minimum of the parabola
+// rooted at it, and INF plus any squared distance within the line rounds back to INF if (n - 1)^2 is small enough.
+// Glyph rasters have wide empty borders, so this skips many lines of both grids.
+bool isUniform(const double* values, uint32_t n, std::size_t stride, bool infIsUniform) {
+    const double first = values[0];
+    if (first != 0.0 && (first != INF || !infIsUniform)) {
+        return false;
+    }
+    for (uint32_t i = 1; i < n; i++) {
+        if (values[i * stride] != first) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool infIsUniform(uint32_t n) {
+    const double maxDistance = static_cast<double>(n ? n - 1 : 0);
+    return maxDistance * maxDistance + INF == INF;
+}
+
+} // namespace tinysdf
+
+// 1D squared distance transform of the n values of a line, which are `stride` apart, in place
+void TinySDF::edt1d(double* line, std::size_t stride, uint32_t n) {
+    double* f_ = f.data();
+    double* g_ = g.data();
+    double* z_ = z.data();
+    int16_t* v_ = v.data();
+
+    for (uint32_t q = 0; q < n; q++) {
+        f_[q] = line[q * stride];
+        // Height of the parabola rooted at q, at the origin
+        g_[q] = f_[q] + q * q;
+    }
+
+    v_[0] = 0;
+    z_[0] = -tinysdf::INF;
+    z_[1] = +tinysdf::INF;
 
     for (uint32_t q = 1, k = 0; q < n; q++) {
-        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
-        while (s <= z[k]) {
+        double s = (g_[q] - g_[v_[k]]) / (2 * q - 2 * v_[k]);
+        while (s <= z_[k]) {
             k--;
-            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+            s = (g_[q] - g_[v_[k]]) / (2 * q - 2 * v_[k]);
         }
         k++;
-        v[k] = q;
-        z[k] = s;
-        z[k + 1] = +INF;
+        v_[k] = q;
+        z_[k] = s;
+        z_[k + 1] = +tinysdf::INF;
     }
 
     for (uint32_t q = 0, k = 0; q < n; q++) {
-        while (z[k + 1] < q) k++;
-        d[q] = (static_cast<double>(q) - v[k]) * (static_cast<double>(q) - v[k]) + f[v[k]];
+        while (z_[k + 1] < q) k++;
+        const double distance = static_cast<double>(q) - v_[k];
+        line[q * stride] = distance * distance + f_[v_[k]];
     }
 }
 
 // 2D Euclidean distance transform by Felzenszwalb & Huttenlocher https://cs.brown.edu/~pff/dt/
-void edt(std::vector<double>& data,
-         uint32_t width,
-         uint32_t height,
-         std::vector<double>& f,
-         std::vector<double>& d,
-         std::vector<int16_t>& v,
-         std::vector<double>& z) {
+void TinySDF::edt(double* data, uint32_t width, uint32_t height) {
+    const bool infColumns = tinysdf::infIsUniform(height);
     for (uint32_t x = 0; x < width; x++) {
-        for (uint32_t y = 0; y < height; y++) {
-            f[y] = data[y * width + x];
-        }
-        edt1d(f, d, v, z, height);
-        for (uint32_t y = 0; y < height; y++) {
-            data[y * width + x] = d[y];
+        if (!tinysdf::isUniform(data + x, height, width, infColumns)) {
+            edt1d(data + x, width, height);
         }
     }
+
+    const bool infRows = tinysdf::infIsUniform(width);
     for (uint32_t y = 0; y < height; y++) {
-        for (uint32_t x = 0; x < width; x++) {
-            f[x] = data[y * width + x];
+        double* row = data + y * width;
+        if (!tinysdf::isUniform(row, width, 1, infRows)) {
+            edt1d(row, 1, width);
         }
-        edt1d(f, d, v, z, width);
         for (uint32_t x = 0; x < width; x++) {
-            data[y * width + x] = std::sqrt(d[x]);
+            row[x] = std::sqrt(row[x]);
         }
     }
 }
 
-} // namespace tinysdf
-
-AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
-    uint32_t size = rasterInput.size.width * rasterInput.size.height;
-    uint32_t maxDimension = std::max(rasterInput.size.width, rasterInput.size.height);
+AlphaImage TinySDF::transform(const AlphaImage& rasterInput, double radius, double cutoff) {
+    const uint32_t width = rasterInput.size.width;
+    const uint32_t height = rasterInput.size.height;
+    const uint32_t size = width * height;
+    const uint32_t maxDimension = std::max(width, height);
 
     AlphaImage sdf(rasterInput.size);
+    if (size == 0) {
+        return sdf;
+    }
 
-    // temporary arrays for the distance transform
-    std::vector<double> gridOuter(size);
-    std::vector<double> gridInner(size);
-    std::vector<double> f(maxDimension);
-    std::vector<double> d(maxDimension);
-    std::vector<double> z(maxDimension + 1);
-    std::vector<int16_t> v(maxDimension);
+    // temporary arrays for the distance transform, kept for the next raster
+    if (gridOuter.size() < size) {
+        gridOuter.resize(size);
+        gridInner.resize(size);
+    }
+    if (v.size() < maxDimension) {
+        f.resize(maxDimension);
+        g.resize(maxDimension);
+        z.resize(maxDimension + 1);
+        v.resize(maxDimension);
+    }
 
+    const auto& distances = tinysdf::initialDistances();
     for (uint32_t i = 0; i < size; i++) {
-        double a = static_cast<double>(rasterInput.data[i]) / 255; // alpha value
-        gridOuter[i] = a == 1.0 ? 0.0 : a == 0.0 ? tinysdf::INF : std::pow(std::max(0.0, 0.5 - a), 2.0);
-        gridInner[i] = a == 1.0 ? tinysdf::INF : a == 0.0 ? 0.0 : std::pow(std::max(0.0, a - 0.5), 2.0);
+        const uint8_t alpha = rasterInput.data[i];
+        gridOuter[i] = distances.outer[alpha];
+        gridInner[i] = distances.inner[alpha];
     }
 
-    tinysdf::edt(gridOuter, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
-    tinysdf::edt(gridInner, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
+    edt(gridOuter.data(), width, height);
+    edt(gridInner.data(), width, height);
 
     for (uint32_t i = 0; i < size; i++) {
         double distance = gridOuter[i] - gridInner[i];
@@ -98,5 +153,10 @@ AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, do
     return sdf;
 }
 
+AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
+    thread_local TinySDF tinySDF;
+    return tinySDF.transform(rasterInput, radius, cutoff);
+}
+
 } // namespace util
 } // namespace mln
@@ -2,6 +2,9 @@
 
 #include <mbgl/util/image.hpp>
 
+#include <cstdint>
+#include <vector>
+
 namespace mln {
 namespace util {
 
@@ -17,5 +20,26 @@ namespace util {
 */
 AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff);
 
+/*
+    Generates SDFs for many rasters, keeping its working memory from one to the
+    next. The output is the same as transformRasterToSDF's, which uses one of
+    these per thread. An instance must not be used by several threads at once.
+*/
+class TinySDF {
+public:
+    AlphaImage transform(const AlphaImage& rasterInput, double radius, double cutoff);
+
+private:
+    void edt(double* data, uint32_t width, uint32_t height);
+    void edt1d(double* line, std::size_t stride, uint32_t n);
+
+    std::vector<double> gridOuter;
+    std::vector<double> gridInner;
+    std::vector<double> f;
+    std::vector<double> g;
+    std::vector<double> z;
+    std::vector<int16_t> v;
+};
+
 } // namespace util
 } // namespace mln
@@ -10,9 +10,13 @@
 #include <mbgl/renderer/buckets/raster_bucket.hpp>
 #include <mbgl/renderer/buckets/symbol_bucket.hpp>
 #include <mbgl/renderer/bucket_parameters.hpp>
+#include <mbgl/style/expression/dsl.hpp>
 #include <mbgl/style/layers/symbol_layer_properties.hpp>
 #include <mbgl/gl/context.hpp>
 #include <mbgl/gl/headless_backend.hpp>
+#include <mbgl/gl/upload_pass.hpp>
+#include <mbgl/tile/geojson_tile_data.hpp>
+#include <mbgl/util/string.hpp>
 
 #include <mbgl/map/mode.hpp>
 
@@ -215,6 +219,69 @@ TEST(Buckets, RasterBucket) {
     ASSERT_TRUE(bucket.needsUpload());
 }
 
+TEST(Buckets, FeatureStateUpdate) {
+    gl::HeadlessBackend backend({512, 256});
+    gfx::BackendScope scope{backend};
+    gl::Context context{backend};
+
+    auto features = std::make_shared<mapbox::feature::feature_collection<int16_t>>();
+    for (uint64_t i = 0; i < 10; ++i) {
+        features->emplace_back(mapbox::geometry::point<int16_t>{0, 0}, PropertyMap{}, i);
+    }
+    const GeoJSONTileLayer layer(features);
+
+    style::CirclePaintProperties::PossiblyEvaluated evaluated;
+    evaluated.get<style::CircleColor>() = PossiblyEvaluatedPropertyValue<Color>(
+        style::PropertyExpression<Color>(style::expression::dsl::createExpression(
+            R"(["case", ["boolean", ["feature-state", "hover"], false], ["to-color", "red"], ["to-color", "blue"]])")));
+    CircleBinders binders(evaluated, 0.0f);
+
+    // Circles have 4 vertices each
+    for (std::size_t i = 0; i < features->size(); ++i) {
+        binders.populateVertexVectors(*layer.getFeature(i), 4 * (i + 1), i, {}, {}, CanonicalTileID(0, 0, 0));
+    }
+    const auto& vertices = binders.interleavedVertexBuffer.sharedVertexVector;
+    const auto stride = binders.interleavedVertexBuffer.stride;
+    const gfx::VertexVectorBasePtr vector = vertices;
+
+    auto commandEncoder = context.createCommandEncoder();
+    auto uploadPass = commandEncoder->createUploadPass("upload", backend.getDefaultRenderable());
+    auto& glUploadPass = static_cast<gl::UploadPass&>(*uploadPass);
+    ASSERT_TRUE(glUploadPass.getBuffer(vector, gfx::BufferUsageType::StaticDraw));
+    const auto& stats = context.renderingStats();
+    EXPECT_EQ(0u, stats.vertexUpdateBytes);
+
+    // Only the vertices of the features whose state changed are uploaded
+    const FeatureStates changes{{"3", {{"hover", true}}}, {"4", {{"hover", true}}}, {"8", {}}};
+    binders.updateVertexVectors(changes, layer, {});
+    const std::vector<gfx::VertexVectorBase::ModifiedRange> expected{{12 * stride, 8 * stride},
+                                                                    {32 * stride, 4 * stride}};
+    const auto& ranges = vertices->getModifiedRanges();
+    ASSERT_EQ(expected.size(), ranges.size());
+    for (std::size_t i = 0; i < ranges.size(); ++i) {
+        EXPECT_EQ(expected[i].offset, ranges[i].offset);
+        EXPECT_EQ(expected[i].size, ranges[i].size);
+    }
+
+    ASSERT_TRUE(glUploadPass.getBuffer(vector, gfx::BufferUsageType::StaticDraw));
+    EXPECT_EQ(1u, stats.vertexPartialUpdates);
+    EXPECT_EQ(12 * stride, stats.vertexPartialUpdateBytes);
+    EXPECT_EQ(vertices->bytes(), stats.vertexPartialUpdateFullBytes);
+    EXPECT_EQ(12 * stride, stats.vertexUpdateBytes);
+    EXPECT_TRUE(vertices->getModifiedRanges().empty());
+
+    // Once half the vertices changed, the whole buffer is uploaded
+    FeatureStates states;
+    for (std::size_t i = 0; i < 5; ++i) {
+        states.emplace(util::toString(i), FeatureState{{"hover", false}});
+    }
+    binders.updateVertexVectors(states, layer, {});
+    EXPECT_TRUE(vertices->getModifiedRanges().empty());
+    ASSERT_TRUE(glUploadPass.getBuffer(vector, gfx::BufferUsageType::StaticDraw));
+    EXPECT_EQ(1u, stats.vertexPartialUpdates);
+    EXPECT_EQ(12 * stride + vertices->bytes(), stats.vertexUpdateBytes);
+}
+
 TEST(Buckets, RasterBucketMaskEmpty) {
     RasterBucket bucket{nullptr};
     bucket.setMask({});
@@ -1,10 +1,13 @@
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/mbtiles_file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/resource_options.hpp>
+#include <mbgl/util/async_request.hpp>
 #include <mbgl/util/platform.hpp>
 #include <mbgl/util/run_loop.hpp>
 
 #include <filesystem>
+#include <vector>
 
 #include <climits>
 #include <gtest/gtest.h>
@@ -124,3 +127,56 @@ TEST(MBTilesFileSource, NonExistentTile) {
 
     loop.run();
 }
+
+// Tiles read through the connection pool match those read on the file source thread
+TEST(MBTilesFileSource, ConnectionPool) {
+    util::RunLoop loop;
+
+    auto& settings = platform::Settings::getInstance();
+    settings.set(platform::EXPERIMENTAL_MBTILES_CONNECTION_POOL, true);
+    settings.set(platform::EXPERIMENTAL_MBTILES_MMAP_SIZE, 64.0 * 1024 * 1024);
+    MBTilesFileSource pooled(ResourceOptions::Default(), ClientOptions());
+    settings.set(platform::EXPERIMENTAL_MBTILES_CONNECTION_POOL, false);
+    settings.set(platform::EXPERIMENTAL_MBTILES_MMAP_SIZE, mapbox::base::NullValue());
+    MBTilesFileSource mbtiles(ResourceOptions::Default(), ClientOptions());
+
+    const auto url = toAbsoluteURL("geography-class-png.mbtiles?file={z}/{x}/{y}.png");
+    std::vector<Resource> resources;
+    for (int32_t x = 0; x < 2; ++x) {
+        for (int32_t y = 0; y < 2; ++y) {
+            resources.push_back(Resource::tile(url, 1.0, x, y, 1, Tileset::Scheme::XYZ));
+        }
+    }
+    resources.push_back(Resource::tile(url, 1.0, 0, 0, 4, Tileset::Scheme::XYZ));
+
+    std::vector<Response> expected(resources.size());
+    std::vector<std::unique_ptr<AsyncRequest>> requests;
+    std::size_t pending = resources.size();
+    auto done = [&] {
+        if (--pending == 0) {
+            loop.stop();
+        }
+    };
+
+    for (std::size_t i = 0; i < resources.size(); ++i) {
+        requests.push_back(mbtiles.request(resources[i], [&, i](Response res) {
+            expected[i] = res;
+            done();
+        }));
+    }
+    loop.run();
+
+    pending = resources.size();
+    for (std::size_t i = 0; i < resources.size(); ++i) {
+        requests.push_back(pooled.request(resources[i], [&, i](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            EXPECT_EQ(expected[i].noContent, res.noContent);
+            ASSERT_EQ(bool(expected[i].data), bool(res.data));
+            if (res.data) {
+                EXPECT_EQ(*expected[i].data, *res.data);
+            }
+            done();
+        }));
+    }
+    loop.run();
+}
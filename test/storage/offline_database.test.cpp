@@ -2,6 +2,7 @@
 #include <mbgl/test/fixture_log_observer.hpp>
 #include <mbgl/test/sqlite3_test_fs.hpp>
 
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/offline_database.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/response.hpp>
@@ -2086,3 +2087,100 @@ TEST(OfflineDatabase, TEST_REQUIRES_WRITE(UpdateDatabaseReadOnlyMode)) {
 
     EXPECT_EQ(0u, log.uncheckedCount());
 }
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(BatchedWrites)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    const auto committedTileCount = [] {
+        mapbox::sqlite::Database db = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadOnly);
+        mapbox::sqlite::Statement stmt{db, "SELECT COUNT(*) FROM tiles"};
+        mapbox::sqlite::Query query{stmt};
+        query.run();
+        return query.get<int>(0);
+    };
+
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES, true);
+    {
+        OfflineDatabase db(filename, fixture::tileServerOptions);
+        EXPECT_EQ("wal", databaseJournalMode(filename));
+        EXPECT_FALSE(db.hasPendingWrites());
+
+        EXPECT_TRUE(db.put(fixture::tile, fixture::response).first);
+        EXPECT_TRUE(db.hasPendingWrites());
+        EXPECT_EQ(0, committedTileCount());
+
+        // The batch is visible to reads before it is committed
+        auto res = db.get(fixture::tile);
+        ASSERT_TRUE(res && res->data);
+        EXPECT_EQ(*fixture::response.data, *res->data);
+
+        db.flushPendingWrites();
+        EXPECT_FALSE(db.hasPendingWrites());
+        EXPECT_EQ(1, committedTileCount());
+
+        // Access times are written with the next batch
+        EXPECT_TRUE(db.get(fixture::tile));
+        EXPECT_TRUE(db.hasPendingWrites());
+
+        // Other operations commit the pending batch first
+        EXPECT_TRUE(db.put(fixture::resource, fixture::response).first);
+        EXPECT_EQ(nullptr, db.invalidateAmbientCache());
+        EXPECT_FALSE(db.hasPendingWrites());
+
+        for (std::size_t x = 0; x < OfflineDatabase::MaxBatchedWrites; ++x) {
+            const auto x32 = static_cast<int32_t>(x);
+            db.put(Resource::tile("maptiler://test", 1, x32, 0, 10, Tileset::Scheme::XYZ), fixture::response);
+        }
+        EXPECT_FALSE(db.hasPendingWrites());
+        EXPECT_EQ(static_cast<int>(OfflineDatabase::MaxBatchedWrites) + 1, committedTileCount());
+    }
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES, false);
+
+    {
+        // The database is left in WAL mode, while writes are made one by one again
+        OfflineDatabase db(filename, fixture::tileServerOptions);
+        EXPECT_EQ("wal", databaseJournalMode(filename));
+
+        db.put(fixture::tile, fixture::response);
+        EXPECT_FALSE(db.hasPendingWrites());
+    }
+
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
+
+TEST(OfflineDatabase, TEST_REQUIRES_WRITE(BatchedWriteFailure)) {
+    FixtureLog log;
+    deleteDatabaseFiles();
+
+    { OfflineDatabase db(filename, fixture::tileServerOptions); }
+    {
+        // Writes of tiles from this template fail
+        mapbox::sqlite::Database db = mapbox::sqlite::Database::open(filename, mapbox::sqlite::ReadWriteCreate);
+        db.exec(
+            "CREATE TRIGGER fail_insert BEFORE INSERT ON tiles WHEN NEW.url_template = 'fail://test' "
+            "BEGIN SELECT RAISE(ABORT, 'failed'); END");
+    }
+
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES, true);
+    {
+        OfflineDatabase db(filename, fixture::tileServerOptions);
+        EXPECT_TRUE(db.put(fixture::tile, fixture::response).first);
+        EXPECT_FALSE(db.put(Resource::tile("fail://test", 1, 0, 0, 0, Tileset::Scheme::XYZ), fixture::response).first);
+
+        // Only the failed write is undone
+        EXPECT_TRUE(db.hasPendingWrites());
+        db.flushPendingWrites();
+        auto res = db.get(fixture::tile);
+        ASSERT_TRUE(res && res->data);
+        EXPECT_EQ(*fixture::response.data, *res->data);
+    }
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_OFFLINE_DATABASE_BATCHED_WRITES, false);
+
+    EXPECT_EQ(1u,
+              log.count({EventSeverity::Warning,
+                         Event::Database,
+                         static_cast<int64_t>(mapbox::sqlite::ResultCode::Constraint),
+                         "Can't write resource: failed"}));
+    EXPECT_EQ(0u, log.uncheckedCount());
+}
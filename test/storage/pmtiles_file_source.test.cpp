@@ -1,3 +1,4 @@
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/storage/pmtiles_file_source.hpp>
 #include <mbgl/storage/resource.hpp>
 #include <mbgl/storage/resource_options.hpp>
@@ -199,3 +200,91 @@ TEST(PMTilesFileSource, UncompressedTile) {
 
     loop.run();
 }
+
+// Local archives read through a memory mapping return the same tiles and errors
+TEST(PMTilesFileSource, MemoryMapped) {
+    util::RunLoop loop;
+
+    auto& settings = platform::Settings::getInstance();
+    settings.set(platform::EXPERIMENTAL_PMTILES_MEMORY_MAPPING, true);
+    PMTilesFileSource mapped(ResourceOptions::Default(), ClientOptions());
+    settings.set(platform::EXPERIMENTAL_PMTILES_MEMORY_MAPPING, false);
+    PMTilesFileSource pmtiles(ResourceOptions::Default(), ClientOptions());
+
+    const auto tile = Resource::tile(
+        toAbsoluteURL("geography-class-png.pmtiles"), 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    std::unique_ptr<AsyncRequest> req;
+
+    req = pmtiles.request(tile, [&](Response expected) {
+        ASSERT_TRUE(expected.data.get());
+
+        req = mapped.request(tile, [&, expected](Response res) {
+            EXPECT_EQ(nullptr, res.error);
+            ASSERT_TRUE(res.data.get());
+            EXPECT_EQ(*expected.data, *res.data);
+
+            req = mapped.request(
+                Resource::tile(toAbsoluteURL("geography-class-png.pmtiles"), 1.0, 0, 0, 4, Tileset::Scheme::XYZ),
+                [&](Response missing) {
+                    EXPECT_EQ(nullptr, missing.error);
+                    ASSERT_FALSE(missing.data.get());
+                    ASSERT_EQ(missing.noContent, true);
+
+                    req = mapped.request(
+                        Resource::tile(toAbsoluteURL("corrupt-gzip-tile.pmtiles"), 1.0, 0, 0, 0, Tileset::Scheme::XYZ),
+                        [&](Response corrupt) {
+                            req.reset();
+                            ASSERT_NE(nullptr, corrupt.error);
+                            EXPECT_NE(corrupt.error->message.find("Error decompressing PMTiles tile:"),
+                                      std::string::npos);
+                            loop.stop();
+                        });
+                });
+        });
+    });
+
+    loop.run();
+}
+
+// A mapped archive is opened again once the file is rewritten
+TEST(PMTilesFileSource, MemoryMappedRewritten) {
+    util::RunLoop loop;
+
+    const auto fixtures = std::filesystem::current_path() / "test/fixtures/storage/pmtiles";
+    const auto path = std::filesystem::temp_directory_path() / "pmtiles-memory-mapped-rewritten.pmtiles";
+    std::filesystem::copy_file(
+        fixtures / "geography-class-png.pmtiles", path, std::filesystem::copy_options::overwrite_existing);
+
+    auto& settings = platform::Settings::getInstance();
+    settings.set(platform::EXPERIMENTAL_PMTILES_MEMORY_MAPPING, true);
+    PMTilesFileSource mapped(ResourceOptions::Default(), ClientOptions());
+    settings.set(platform::EXPERIMENTAL_PMTILES_MEMORY_MAPPING, false);
+
+    const auto url = std::string(util::PMTILES_PROTOCOL) + std::string(util::FILE_PROTOCOL) + path.string();
+    const auto tile = Resource::tile(url, 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    const auto expected = Resource::tile(
+        toAbsoluteURL("uncompressed-tiles.pmtiles"), 1.0, 0, 0, 0, Tileset::Scheme::XYZ);
+    std::unique_ptr<AsyncRequest> req;
+
+    req = mapped.request(tile, [&](Response before) {
+        ASSERT_TRUE(before.data.get());
+
+        std::filesystem::copy_file(
+            fixtures / "uncompressed-tiles.pmtiles", path, std::filesystem::copy_options::overwrite_existing);
+        req = mapped.request(expected, [&, before](Response rewritten) {
+            ASSERT_TRUE(rewritten.data.get());
+
+            req = mapped.request(tile, [&, before, rewritten](Response after) {
+                req.reset();
+                EXPECT_EQ(nullptr, after.error);
+                ASSERT_TRUE(after.data.get());
+                EXPECT_NE(*before.data, *after.data);
+                EXPECT_EQ(*rewritten.data, *after.data);
+                loop.stop();
+            });
+        });
+    });
+
+    loop.run();
+    std::filesystem::remove(path);
+}
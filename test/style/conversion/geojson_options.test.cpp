@@ -42,6 +42,9 @@ TEST(GeoJSONOptions, RetainsDefaults) {
     ASSERT_EQ(converted.clusterMaxZoom, defaults.clusterMaxZoom);
     ASSERT_EQ(converted.clusterMinPoints, defaults.clusterMinPoints);
     ASSERT_TRUE(converted.clusterProperties.empty());
+
+    // Updates
+    ASSERT_EQ(converted.updatable, defaults.updatable);
 }
 
 TEST(GeoJSONOptions, FullConversion) {
@@ -56,6 +59,7 @@ TEST(GeoJSONOptions, FullConversion) {
         "clusterMaxZoom": 5,
         "clusterMinPoints": 6,
         "lineMetrics": true,
+        "updatable": true,
         "clusterProperties": {
             "max": ["max", ["get", "scalerank"]],
             "sum": [["+", ["accumulated"], ["get", "sum"]], ["get", "scalerank"]],
@@ -80,4 +84,7 @@ TEST(GeoJSONOptions, FullConversion) {
     ASSERT_EQ(converted.clusterProperties.count("max"), 1);
     ASSERT_EQ(converted.clusterProperties.count("sum"), 1);
     ASSERT_EQ(converted.clusterProperties.count("has_island"), 1);
+
+    // Updates
+    ASSERT_TRUE(converted.updatable);
 }
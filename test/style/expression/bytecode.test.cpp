@@ -0,0 +1,194 @@
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/style/expression/bytecode.hpp>
+#include <mbgl/style/expression/dsl.hpp>
+#include <mbgl/style/property_expression.hpp>
+#include <mbgl/test/stub_geometry_tile_feature.hpp>
+#include <mbgl/test/util.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+using namespace mln;
+using namespace mln::style;
+using namespace mln::style::expression;
+using namespace mln::style::expression::dsl;
+
+namespace {
+
+std::vector<StubGeometryTileFeature> makeFeatures() {
+    std::vector<StubGeometryTileFeature> features;
+    features.emplace_back(PropertyMap{});
+    features.emplace_back(PropertyMap{{"class", std::string("park")},
+                                      {"rank", int64_t(3)},
+                                      {"height", 12.5},
+                                      {"open", true},
+                                      {"label", std::string("Park")}});
+    features.emplace_back(PropertyMap{{"class", std::string("water")},
+                                      {"rank", uint64_t(7)},
+                                      {"height", -4.0},
+                                      {"open", false},
+                                      {"min_height", 2.0}});
+    features.emplace_back(PropertyMap{{"class", std::string("road")}, {"rank", 2.5}, {"height", 0.0}});
+    // Values of the wrong type, which the tree reports errors for
+    features.emplace_back(PropertyMap{{"class", int64_t(1)},
+                                      {"rank", std::string("high")},
+                                      {"height", std::vector<mln::Value>{1.0, 2.0}},
+                                      {"open", std::string("yes")}});
+    features.emplace_back(PropertyMap{{"class", mln::NullValue()}, {"rank", int64_t(-1)}, {"height", 1e9}});
+    return features;
+}
+
+/// Checks that wherever the bytecode evaluates the expression, it gives the result of the tree, and
+/// returns how many evaluations it took over
+std::size_t expectMatchesTree(const Expression& expression, const Bytecode& bytecode) {
+    const auto features = makeFeatures();
+    const std::array<std::optional<float>, 5> zooms{std::nullopt, 0.0f, 5.5f, 10.0f, 22.0f};
+
+    std::size_t evaluated = 0;
+    for (const auto& feature : features) {
+        for (const auto& zoom : zooms) {
+            const EvaluationContext context(zoom, &feature, std::nullopt);
+            const EvaluationResult tree = expression.evaluate(context);
+            const std::optional<Value> compiled = bytecode.evaluate(context);
+            if (!compiled) {
+                continue;
+            }
+            ++evaluated;
+            EXPECT_TRUE(tree) << stringify(expression.serialize());
+            if (tree) {
+                EXPECT_EQ(stringify(*tree), stringify(*compiled)) << stringify(expression.serialize());
+            }
+        }
+    }
+    return evaluated;
+}
+
+std::unique_ptr<Expression> parse(const char* json) {
+    auto expression = createExpression(json);
+    EXPECT_TRUE(expression) << json;
+    return expression;
+}
+
+} // namespace
+
+TEST(Bytecode, MatchesTree) {
+    const std::vector<const char*> expressions = {
+        R"(["get", "class"])",
+        R"(["+", ["number", ["get", "rank"], 0], ["*", ["zoom"], 2], 1])",
+        R"(["-", ["number", ["get", "height"]]])",
+        R"(["/", ["number", ["get", "height"], 0], ["-", ["zoom"], 10]])",
+        R"(["%", ["number", ["get", "rank"], 5], 3])",
+        R"(["^", 2, ["number", ["get", "rank"], 1]])",
+        R"(["min", ["number", ["get", "height"], 1], ["zoom"], 8])",
+        R"(["max", ["number", ["get", "height"], 1], ["zoom"]])",
+        R"(["sqrt", ["abs", ["number", ["get", "height"], 4]]])",
+        R"(["round", ["*", ["log2", ["+", ["zoom"], 1]], ["ln", 10]]])",
+        R"(["floor", ["number", ["get", "rank"], 0.5]])",
+        R"(["!", ["boolean", ["get", "open"], false]])",
+        R"(["==", ["get", "class"], "park"])",
+        R"(["!=", ["get", "rank"], 3])",
+        R"(["<", ["get", "rank"], ["get", "height"]])",
+        R"([">=", ["string", ["get", "class"], ""], "road"])",
+        R"(["any", ["==", ["get", "class"], "water"], [">", ["zoom"], 9]])",
+        R"(["all", ["has", "rank"], ["<", ["number", ["get", "rank"], 0], 5]])",
+        R"(["case", ["==", ["get", "class"], "park"], "green", ["<", ["zoom"], 6], "small", "other"])",
+        R"(["coalesce", ["get", "label"], ["get", "class"], "unnamed"])",
+        R"(["match", ["get", "class"], "park", "#00ff00", ["water", "lake"], "#0000ff", "#888888"])",
+        R"(["match", ["get", "rank"], 3, "three", [2, 7], "prime", "other"])",
+        R"(["to-color", ["match", ["get", "class"], "park", "green", "water", "blue", "gray"]])",
+        R"(["step", ["zoom"], 1, 5, ["number", ["get", "rank"], 0], 10, 3])",
+        R"(["step", ["number", ["get", "height"], 0], "low", 0, "mid", 10, "high"])",
+        R"(["interpolate", ["linear"], ["zoom"], 0, 1, 10, ["number", ["get", "height"], 1], 20, 100])",
+        R"(["interpolate", ["exponential", 1.5], ["number", ["get", "height"], 0], -10, 0, 0, 1, 100, 2])",
+        R"(["interpolate", ["cubic-bezier", 0.4, 0, 0.6, 1], ["zoom"],
+            5, ["to-color", "red"], 15, ["to-color", "blue"]])",
+        R"(["interpolate", ["linear"], ["zoom"], 0,
+            ["match", ["get", "class"], "park", ["to-color", "green"], ["to-color", "white"]],
+            10, ["to-color", "black"]])",
+        R"(["let", "h", ["number", ["get", "height"], 0], ["*", ["var", "h"], ["var", "h"]]])",
+        R"(["concat", ["get", "class"], "-", ["to-string", ["zoom"]]])",
+        R"(["case", ["has", "label"], ["length", ["string", ["get", "label"]]], ["zoom"]])",
+        R"(["number", ["get", "height"]])",
+    };
+
+    for (const char* json : expressions) {
+        const auto expression = parse(json);
+        ASSERT_TRUE(expression);
+        const auto bytecode = Bytecode::compile(*expression);
+        if (!bytecode) {
+            continue;
+        }
+        EXPECT_LT(0u, expectMatchesTree(*expression, *bytecode)) << json;
+    }
+}
+
+TEST(Bytecode, Compile) {
+    // Arrays and lone subexpressions which only the tree evaluates aren't compiled
+    EXPECT_FALSE(Bytecode::compile(*parse(R"(["array", ["get", "list"]])")));
+    EXPECT_FALSE(Bytecode::compile(*parse(R"(["concat", ["get", "class"], "-"])")));
+
+    const auto expression = parse(R"(["+", ["length", ["string", ["get", "label"], ""]], ["zoom"]])");
+    const auto bytecode = Bytecode::compile(*expression);
+    ASSERT_TRUE(bytecode);
+    EXPECT_EQ(1u, bytecode->getTreeCount());
+    EXPECT_LT(0u, expectMatchesTree(*expression, *bytecode));
+}
+
+TEST(Bytecode, FoldsConstants) {
+    // Expressions built in code aren't folded when they are parsed, the outputs here become constants
+    const auto expression = step(number(get("height")), toColor(literal("red")), 10.0, toColor(literal("blue")));
+    const auto bytecode = Bytecode::compile(*expression);
+    ASSERT_TRUE(bytecode);
+    EXPECT_EQ(0u, bytecode->getTreeCount());
+    // Reading the property, asserting it's a number, and picking the constant output
+    EXPECT_EQ(3u, bytecode->getInstructionCount());
+
+    const StubGeometryTileFeature low(PropertyMap{{"height", 2.0}});
+    const StubGeometryTileFeature high(PropertyMap{{"height", 20.0}});
+    const auto lowColor = bytecode->evaluateColor(EvaluationContext(&low));
+    const auto highColor = bytecode->evaluateColor(EvaluationContext(&high));
+    ASSERT_TRUE(lowColor && highColor);
+    EXPECT_EQ(Color::red(), *lowColor);
+    EXPECT_EQ(Color::blue(), *highColor);
+    EXPECT_FALSE(bytecode->evaluateNumber(EvaluationContext(&low)));
+}
+
+TEST(Bytecode, ErrorsFallBackToTree) {
+    const auto expression = parse(R"(["*", ["number", ["get", "height"]], ["zoom"]])");
+    const auto bytecode = Bytecode::compile(*expression);
+    ASSERT_TRUE(bytecode);
+
+    const StubGeometryTileFeature feature(PropertyMap{{"height", 2.0}});
+    const auto result = bytecode->evaluateNumber(EvaluationContext(3.0f, &feature));
+    ASSERT_TRUE(result);
+    EXPECT_EQ(6.0, *result);
+    // No zoom level
+    EXPECT_FALSE(bytecode->evaluate(EvaluationContext(&feature)));
+    // No feature
+    EXPECT_FALSE(bytecode->evaluate(EvaluationContext(3.0f)));
+    // Failed assertion
+    const StubGeometryTileFeature text(PropertyMap{{"height", std::string("tall")}});
+    EXPECT_FALSE(bytecode->evaluate(EvaluationContext(3.0f, &text)));
+    EXPECT_FALSE(expression->evaluate(EvaluationContext(3.0f, &text)));
+}
+
+TEST(Bytecode, PropertyExpression) {
+    const char* json = R"(["interpolate", ["linear"], ["zoom"], 0,
+        ["match", ["get", "class"], "park", ["to-color", "green"], "water", ["to-color", "blue"],
+            ["to-color", "white"]],
+        10, ["to-color", "black"]])";
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_EXPRESSION_BYTECODE, true);
+    const PropertyExpression<Color> compiled(parse(json));
+    const PropertyExpression<float> compiledNumber(parse(R"(["*", ["number", ["get", "rank"]], 2])"));
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_EXPRESSION_BYTECODE, false);
+    const PropertyExpression<Color> tree(parse(json));
+    const PropertyExpression<float> treeNumber(parse(R"(["*", ["number", ["get", "rank"]], 2])"));
+
+    for (const auto& feature : makeFeatures()) {
+        for (const float zoom : {0.0f, 2.5f, 10.0f}) {
+            EXPECT_EQ(tree.evaluate(zoom, feature, Color()), compiled.evaluate(zoom, feature, Color()));
+            EXPECT_EQ(treeNumber.evaluate(zoom, feature, -1.0f), compiledNumber.evaluate(zoom, feature, -1.0f));
+        }
+    }
+}
@@ -8,9 +8,13 @@
 #include <rapidjson/stringbuffer.h>
 #include <mbgl/style/conversion/stringify.hpp>
 
+#include <mbgl/style/batch_filter.hpp>
 #include <mbgl/style/filter.hpp>
+#include <mbgl/style/layer_impl.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
 #include <mbgl/style/conversion/json.hpp>
 #include <mbgl/style/conversion/filter.hpp>
+#include <mbgl/tile/tile_id.hpp>
 #include <mbgl/util/rapidjson.hpp>
 
 #include <rapidjson/writer.h>
@@ -384,3 +388,102 @@ TEST(Filter, LegacyExpressionInvalidType) {
     std::optional<Filter> result = conversion::convert<Filter>(conversion::Convertible(&value), error);
     EXPECT_FALSE(result);
 }
+
+namespace {
+
+class StubGeometryTileLayer : public GeometryTileLayer {
+public:
+    std::size_t featureCount() const override { return features.size(); }
+
+    std::unique_ptr<GeometryTileFeature> getFeature(std::size_t i) const override {
+        return std::make_unique<StubGeometryTileFeature>(features.at(i));
+    }
+
+    std::string getName() const override { return "stub"; }
+
+    std::vector<StubGeometryTileFeature> features;
+};
+
+} // namespace
+
+TEST(Filter, Batch) {
+    StubGeometryTileLayer layer;
+    const std::vector<Value> classes = {
+        std::string("street"), std::string("motorway"), int64_t(1), uint64_t(1), 1.0, true, NullValue()};
+    const std::vector<FeatureType> types = {FeatureType::Point, FeatureType::LineString, FeatureType::Polygon};
+    for (std::size_t i = 0; i < 150; ++i) {
+        PropertyMap properties;
+        if (i % 11 != 0) {
+            properties.emplace("class", classes[i % classes.size()]);
+        }
+        if (i % 3 == 0) {
+            properties.emplace("rank", int64_t(i % 7));
+        }
+        layer.features.emplace_back(
+            FeatureIdentifier(uint64_t(i)), types[i % types.size()], GeometryCollection{}, std::move(properties));
+    }
+
+    const CanonicalTileID tileID{14, 8803, 5375};
+    const std::vector<const char*> filters = {
+        R"(["==", "class", "street"])",
+        R"(["!=", "class", 1])",
+        R"(["in", "class", "motorway", "street", true])",
+        R"(["!in", "class", "motorway"])",
+        R"(["has", "rank"])",
+        R"(["==", "$type", "LineString"])",
+        R"(["all", ["has", "class"], [">", "rank", 2], ["!=", "$type", "Point"]])",
+        R"(["any", ["==", "rank", 0], ["==", "class", "motorway"]])",
+        R"(["==", ["get", "class"], "street"])",
+        R"(["match", ["get", "class"], ["street", "motorway"], true, false])",
+        R"(["in", ["get", "class"], ["literal", ["street", 1]]])",
+        R"(["all", ["<", ["get", "rank"], 4], ["==", ["geometry-type"], "Polygon"]])",
+        R"(["any", [">", ["get", "class"], 0], ["==", ["get", "rank"], 1]])",
+        R"(["!", ["all", ["has", "class"], ["<", ["get", "rank"], 3]]])",
+        R"(["all", ["==", ["%", ["id"], 2], 0], ["has", "rank"]])",
+        R"(["any", ["==", ["get", "rank"], ["get", "class"]], ["==", ["zoom"], 14]])",
+    };
+
+    conversion::Error error;
+    for (const char* json : filters) {
+        SCOPED_TRACE(json);
+        const std::optional<Filter> filter = conversion::convertJSON<Filter>(json, error);
+        ASSERT_TRUE(filter);
+
+        std::vector<std::unique_ptr<GeometryTileFeature>> features;
+        const auto selection = BatchFilter(*filter)(layer, 14.0f, tileID, &features);
+        ASSERT_EQ(layer.featureCount(), features.size());
+        std::size_t selected = 0;
+        for (std::size_t i = 0; i < layer.featureCount(); ++i) {
+            const auto context = expression::EvaluationContext(14.0f, &layer.features[i]).withCanonicalTileID(&tileID);
+            const bool expected = (*filter)(context);
+            EXPECT_EQ(expected, selection[i]) << "feature " << i;
+            // Selected features are handed over as they were read
+            EXPECT_EQ(expected, bool(features[i])) << "feature " << i;
+            if (features[i]) {
+                EXPECT_EQ(layer.features[i].getID(), features[i]->getID());
+            }
+            selected += expected;
+        }
+        EXPECT_EQ(selected, selection.count());
+    }
+
+    EXPECT_TRUE(BatchFilter(*conversion::convertJSON<Filter>(R"(["==", "class", "street"])", error)).isBatched());
+    EXPECT_FALSE(BatchFilter(*conversion::convertJSON<Filter>(R"(["==", ["id"], 1])", error)).isBatched());
+    EXPECT_EQ(layer.featureCount(), BatchFilter(Filter())(layer, 14.0f, tileID).count());
+}
+
+TEST(Filter, BatchCompiledOncePerLayer) {
+    conversion::Error error;
+    LineLayer layer("line", "source");
+    layer.setFilter(*conversion::convertJSON<Filter>(R"(["==", "class", "street"])", error));
+
+    const auto impl = layer.baseImpl;
+    const BatchFilter& compiled = impl->getBatchFilter();
+    EXPECT_EQ(&compiled, &impl->getBatchFilter());
+    EXPECT_TRUE(compiled.isBatched());
+
+    // Changing the filter makes a new Impl, which compiles its own
+    layer.setFilter(*conversion::convertJSON<Filter>(R"(["==", ["id"], 1])", error));
+    EXPECT_FALSE(layer.baseImpl->getBatchFilter().isBatched());
+    EXPECT_TRUE(impl->getBatchFilter().isBatched());
+}
@@ -0,0 +1,110 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/style/sources/geojson_stream_reader.hpp>
+
+#include <memory>
+#include <string>
+
+using namespace mln;
+using namespace mln::style;
+
+namespace {
+
+std::shared_ptr<const std::string> makeCollection(std::size_t count, const std::string& members = "") {
+    std::string json = R"({"type": "FeatureCollection",)" + members + R"("features": [)";
+    for (std::size_t i = 0; i < count; ++i) {
+        json += (i ? "," : "") + std::string(R"({"type": "Feature", "id": )") + std::to_string(i) +
+                R"(, "properties": {"name": "feature", "list": [1, {"nested": true}]},)" +
+                R"("geometry": {"type": "Point", "coordinates": [)" + std::to_string(i % 180) + ", 0]}}";
+    }
+    return std::make_shared<const std::string>(json + "]}");
+}
+
+} // namespace
+
+TEST(GeoJSONStreamReader, Chunks) {
+    const auto data = makeCollection(10);
+    GeoJSONStreamReader reader(data);
+
+    ASSERT_TRUE(reader.read(4));
+    EXPECT_FALSE(reader.isDone());
+    EXPECT_TRUE(reader.isFeatureCollection());
+    EXPECT_EQ(4u, reader.getFeatures().size());
+    EXPECT_LT(0u, reader.getBytesRead());
+    EXPECT_GT(data->size(), reader.getBytesRead());
+
+    ASSERT_TRUE(reader.read(4));
+    EXPECT_EQ(8u, reader.getFeatures().size());
+    ASSERT_TRUE(reader.read(4));
+    EXPECT_TRUE(reader.isDone());
+    EXPECT_FALSE(reader.getError());
+    EXPECT_EQ(data->size(), reader.getBytesRead());
+
+    const auto& features = reader.getFeatures();
+    ASSERT_EQ(10u, features.size());
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        EXPECT_EQ(mapbox::feature::identifier{uint64_t(i)}, features[i].id);
+        ASSERT_TRUE(features[i].geometry.is<mapbox::geometry::point<double>>());
+        EXPECT_EQ(double(i % 180), features[i].geometry.get<mapbox::geometry::point<double>>().x);
+        EXPECT_EQ(Value{std::string("feature")}, features[i].properties.at("name"));
+    }
+}
+
+TEST(GeoJSONStreamReader, ForeignMembers) {
+    // Members other than the features, with features keys and arrays of objects of their own
+    GeoJSONStreamReader reader(
+        makeCollection(3, R"("bbox": [0, 0, 2, 0], "extra": {"features": [{"a": 1}], "type": "Feature"},)"));
+    ASSERT_TRUE(reader.read(100));
+    EXPECT_TRUE(reader.isDone());
+    EXPECT_TRUE(reader.isFeatureCollection());
+    EXPECT_EQ(3u, reader.getFeatures().size());
+}
+
+TEST(GeoJSONStreamReader, TypeAfterFeatures) {
+    GeoJSONStreamReader reader(std::make_shared<const std::string>(
+        R"({"features": [{"type": "Feature", "properties": {}, "geometry": null}], "type": "FeatureCollection"})"));
+    ASSERT_TRUE(reader.read(1));
+    EXPECT_FALSE(reader.isFeatureCollection());
+    EXPECT_EQ(1u, reader.getFeatures().size());
+
+    ASSERT_TRUE(reader.read(1));
+    EXPECT_TRUE(reader.isDone());
+    EXPECT_TRUE(reader.isFeatureCollection());
+}
+
+TEST(GeoJSONStreamReader, NotACollection) {
+    GeoJSONStreamReader reader(std::make_shared<const std::string>(
+        R"({"type": "Feature", "properties": {}, "geometry": {"type": "Point", "coordinates": [1, 2]}})"));
+    ASSERT_TRUE(reader.read(1));
+    EXPECT_TRUE(reader.isDone());
+    EXPECT_FALSE(reader.isFeatureCollection());
+    EXPECT_TRUE(reader.getFeatures().empty());
+}
+
+TEST(GeoJSONStreamReader, Errors) {
+    {
+        // Truncated document
+        auto data = makeCollection(3);
+        GeoJSONStreamReader reader(std::make_shared<const std::string>(data->substr(0, data->size() / 2)));
+        EXPECT_FALSE(reader.read(100));
+        EXPECT_TRUE(reader.isDone());
+        ASSERT_TRUE(reader.getError());
+        EXPECT_NE(std::string::npos, reader.getError()->find("at offset"));
+        // Reading after an error keeps failing
+        EXPECT_FALSE(reader.read(100));
+    }
+    {
+        GeoJSONStreamReader reader(
+            std::make_shared<const std::string>(R"({"type": "FeatureCollection", "features": [1]})"));
+        EXPECT_FALSE(reader.read(100));
+        EXPECT_EQ(std::string("Feature must be an object"), *reader.getError());
+    }
+    {
+        // A feature without a geometry member
+        GeoJSONStreamReader reader(std::make_shared<const std::string>(
+            R"({"type": "FeatureCollection", "features": [{"type": "Feature", "properties": {}}]})"));
+        EXPECT_FALSE(reader.read(100));
+        EXPECT_TRUE(reader.getError());
+        EXPECT_TRUE(reader.getFeatures().empty());
+    }
+}
@@ -4,6 +4,7 @@
 #include <mbgl/test/stub_style_observer.hpp>
 #include <mbgl/test/util.hpp>
 
+#include <mbgl/platform/settings.hpp>
 #include <mbgl/style/layers/circle_layer.hpp>
 #include <mbgl/style/layers/circle_layer_impl.hpp>
 #include <mbgl/style/layers/hillshade_layer.hpp>
@@ -49,6 +50,8 @@
 
 #include <gmock/gmock.h>
 
+#include <algorithm>
+#include <map>
 #include <optional>
 
 using namespace mln;
@@ -1014,6 +1017,236 @@ TEST(Source, GeoJSONSourceTilesAfterDataReset) {
     EXPECT_TRUE(renderSource.isLoaded()); // Tiles are reset in static mode.
 }
 
+TEST(Source, GeoJSONSourceUpdate) {
+    FixtureLog log;
+    const auto makeFeature = [](uint64_t id, double longitude) {
+        GeoJSONFeature feature{mapbox::geometry::point<double>{longitude, 10.0}};
+        feature.id = id;
+        return feature;
+    };
+    const GeoJSONData::Features features{makeFeature(1, -100.0), makeFeature(2, 100.0), makeFeature(3, 100.5)};
+    Mutable<GeoJSONOptions> options = makeMutable<GeoJSONOptions>();
+    options->updatable = true;
+    auto data = GeoJSONData::create(features, Scheduler::GetSequenced(), std::move(options));
+
+    const auto featureCount = [](GeoJSONData& data_, const CanonicalTileID& id) {
+        std::size_t count = 0;
+        data_.getTile(id, [&](GeoJSONData::TileFeatures tileFeatures) { count = tileFeatures.size(); }, true);
+        return count;
+    };
+    const CanonicalTileID world(0, 0, 0);
+    const CanonicalTileID west(1, 0, 0);
+    const CanonicalTileID east(1, 1, 0);
+    EXPECT_EQ(3u, featureCount(*data, world));
+    EXPECT_EQ(1u, featureCount(*data, west));
+    EXPECT_EQ(2u, featureCount(*data, east));
+
+    // Moving a feature in the east, and removing another
+    const GeoJSONDiff diff{.update = {makeFeature(2, 101.0)}, .remove = {FeatureIdentifier{uint64_t(3)}}};
+    const auto updated = data->update(diff);
+    ASSERT_TRUE(updated);
+    EXPECT_EQ(2u, featureCount(*updated, world));
+    EXPECT_EQ(1u, featureCount(*updated, west));
+    EXPECT_EQ(1u, featureCount(*updated, east));
+    EXPECT_TRUE(updated->isTileChanged(world, *data));
+    EXPECT_TRUE(updated->isTileChanged(east, *data));
+    EXPECT_FALSE(updated->isTileChanged(west, *data));
+    // Compared with data it wasn't updated from, any tile may have changed
+    EXPECT_TRUE(updated->isTileChanged(west, *updated));
+    // The data it was updated from is left as it was
+    EXPECT_EQ(2u, featureCount(*data, east));
+
+    // Features with new identifiers are added, and later features replace earlier ones with the same identifier
+    const auto added = updated->update({.update = {makeFeature(4, -101.0), makeFeature(4, -102.0)}});
+    ASSERT_TRUE(added);
+    EXPECT_EQ(2u, featureCount(*added, west));
+    EXPECT_EQ(1u, featureCount(*added, east));
+    EXPECT_FALSE(added->isTileChanged(east, *updated));
+
+    // Clustered data stays clustered whether it has features or not
+    Mutable<GeoJSONOptions> clusterOptions = makeMutable<GeoJSONOptions>();
+    clusterOptions->cluster = true;
+    clusterOptions->updatable = true;
+    const auto empty = GeoJSONData::create(
+        GeoJSONData::Features{}, Scheduler::GetSequenced(), std::move(clusterOptions));
+    EXPECT_EQ(0u, featureCount(*empty, world));
+    const auto clustered = empty->update({.update = features});
+    ASSERT_TRUE(clustered);
+    GeoJSONData::TileFeatures clusters;
+    clustered->getTile(
+        world, [&](GeoJSONData::TileFeatures tileFeatures) { clusters = std::move(tileFeatures); }, true);
+    ASSERT_EQ(2u, clusters.size());
+    const auto cluster = std::find_if(clusters.begin(), clusters.end(), [](const auto& feature) {
+        return feature.properties.count("cluster") != 0;
+    });
+    ASSERT_NE(clusters.end(), cluster);
+    EXPECT_EQ(2u, cluster->properties.at("point_count").get<uint64_t>());
+    const auto clusterId = static_cast<std::uint32_t>(cluster->properties.at("cluster_id").get<uint64_t>());
+    EXPECT_EQ(2u, clustered->getLeaves(clusterId, 10, 0).size());
+    const auto removed = clustered->update({.remove = {FeatureIdentifier{uint64_t(1)},
+                                                       FeatureIdentifier{uint64_t(2)},
+                                                       FeatureIdentifier{uint64_t(3)}}});
+    ASSERT_TRUE(removed);
+    EXPECT_EQ(0u, featureCount(*removed, world));
+    EXPECT_TRUE(removed->update({.update = features}));
+
+    GeoJSONSource source("source");
+    source.setGeoJSONData(data);
+    source.updateGeoJSON(diff);
+    auto sourceData = source.impl().getData().lock();
+    ASSERT_TRUE(sourceData);
+    EXPECT_EQ(1u, featureCount(*sourceData, east));
+    EXPECT_TRUE(sourceData->isTileChanged(east, *data));
+
+    // Data created without the option can't be updated
+    source.setGeoJSONData(GeoJSONData::create(features, Scheduler::GetSequenced()));
+    sourceData = source.impl().getData().lock();
+    source.updateGeoJSON(diff);
+    EXPECT_EQ(sourceData, source.impl().getData().lock());
+    EXPECT_EQ(1u,
+              log.count({EventSeverity::Warning,
+                         Event::General,
+                         int64_t(-1),
+                         "GeoJSON source 'source' can't be updated, its data is left as is"}));
+}
+
+namespace {
+
+// Counts the loads of the features of each tile
+class CountingGeoJSONData final : public GeoJSONData {
+public:
+    using Loads = std::map<CanonicalTileID, int>;
+
+    CountingGeoJSONData(std::shared_ptr<GeoJSONData> data_, std::shared_ptr<Loads> loads_)
+        : data(std::move(data_)),
+          loads(std::move(loads_)) {}
+
+    void getTile(const CanonicalTileID& id, const std::function<void(TileFeatures)>& fn, bool sync) override {
+        ++(*loads)[id];
+        data->getTile(id, fn, sync);
+    }
+
+    std::shared_ptr<GeoJSONData> update(const GeoJSONDiff& diff) const override {
+        auto updated = data->update(diff);
+        return updated ? std::make_shared<CountingGeoJSONData>(std::move(updated), loads) : nullptr;
+    }
+
+    bool isTileChanged(const CanonicalTileID& id, const GeoJSONData& previous) const override {
+        const auto* counting = dynamic_cast<const CountingGeoJSONData*>(&previous);
+        return !counting || data->isTileChanged(id, *counting->data);
+    }
+
+    Features getChildren(std::uint32_t id) override { return data->getChildren(id); }
+    Features getLeaves(std::uint32_t id, std::uint32_t limit, std::uint32_t offset) override {
+        return data->getLeaves(id, limit, offset);
+    }
+    std::uint8_t getClusterExpansionZoom(std::uint32_t id) override { return data->getClusterExpansionZoom(id); }
+
+private:
+    std::shared_ptr<GeoJSONData> data;
+    std::shared_ptr<Loads> loads;
+};
+
+} // namespace
+
+TEST(Source, GeoJSONSourceUpdateReloadsChangedTiles) {
+    SourceTest test;
+    test.transform.jumpTo(CameraOptions().withCenter(LatLng()).withZoom(1.0));
+    test.transformState = test.transform.getState();
+
+    const auto makeFeature = [](uint64_t id, double longitude) {
+        GeoJSONFeature feature{mapbox::geometry::point<double>{longitude, 10.0}};
+        feature.id = id;
+        return feature;
+    };
+    Mutable<GeoJSONOptions> mutableOptions = makeMutable<GeoJSONOptions>();
+    mutableOptions->updatable = true;
+    const Immutable<GeoJSONOptions> options = std::move(mutableOptions);
+    GeoJSONSource source("source", options);
+    auto loads = std::make_shared<CountingGeoJSONData::Loads>();
+    source.setGeoJSONData(std::make_shared<CountingGeoJSONData>(
+        GeoJSONData::create(GeoJSONData::Features{makeFeature(1, -100.0), makeFeature(2, 100.0)},
+                            Scheduler::GetSequenced(),
+                            options),
+        loads));
+
+    CircleLayer layer("id", "source");
+    Immutable<LayerProperties> layerProperties = makeMutable<CircleLayerProperties>(
+        staticImmutableCast<CircleLayer::Impl>(layer.baseImpl));
+    std::vector<Immutable<LayerProperties>> layers{layerProperties};
+
+    RenderGeoJSONSource renderSource{staticImmutableCast<GeoJSONSource::Impl>(source.baseImpl), test.threadPool};
+    renderSource.setObserver(&test.renderSourceObserver);
+    test.renderSourceObserver.tileChanged = [&](RenderSource& source_, const OverscaledTileID&) {
+        if (source_.isLoaded()) {
+            test.end();
+        }
+    };
+    test.renderSourceObserver.tileError = [&](RenderSource&, const OverscaledTileID&, std::exception_ptr) {
+        FAIL() << "Should never be called";
+    };
+
+    static_cast<RenderSource&>(renderSource).update(source.baseImpl, layers, true, true, test.tileParameters());
+    const CanonicalTileID west0(1, 0, 0);
+    const CanonicalTileID west1(1, 0, 1);
+    const CanonicalTileID east0(1, 1, 0);
+    const CanonicalTileID east1(1, 1, 1);
+    for (const auto& id : {west0, west1, east0, east1}) {
+        EXPECT_EQ(1, (*loads)[id]) << id;
+    }
+
+    // The update comes while the first loads are still in flight. The tiles of the west keep theirs, which must
+    // still be set, and only the tiles of the east load again.
+    source.updateGeoJSON({.update = {makeFeature(2, 101.0)}});
+    static_cast<RenderSource&>(renderSource).update(source.baseImpl, layers, true, false, test.tileParameters());
+    EXPECT_EQ(1, (*loads)[west0]);
+    EXPECT_EQ(1, (*loads)[west1]);
+    EXPECT_EQ(2, (*loads)[east0]);
+    EXPECT_EQ(2, (*loads)[east1]);
+
+    util::Timer timeout;
+    timeout.start(Seconds(5), Duration::zero(), [&] { test.end(); });
+    test.run();
+    EXPECT_TRUE(renderSource.isLoaded());
+}
+
+TEST(Source, GeoJSONSourceStreamReplacedByData) {
+    SourceTest test;
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_GEOJSON_STREAMING, true);
+
+    GeoJSONSource source("source");
+    source.setObserver(&test.styleObserver);
+    test.fileSource->sourceResponse = [&](const Resource&) {
+        // Data is set after the response arrived, while its first chunk is read
+        test.loop.invoke([&] {
+            source.setGeoJSON(mapbox::geojson::parse(R"({"type": "Point", "coordinates": [1, 1]})"));
+            // The chunk's reply is queued after this, and must leave the data as it was set
+            Scheduler::GetBackground()->waitForEmpty();
+            test.loop.invoke([&] { test.end(); });
+        });
+        Response response;
+        response.data = std::make_unique<std::string>(
+            R"({"type": "FeatureCollection", "features": [)"
+            R"({"type": "Feature", "properties": {}, "geometry": {"type": "Point", "coordinates": [2, 2]}},)"
+            R"({"type": "Feature", "properties": {}, "geometry": {"type": "Point", "coordinates": [3, 3]}}]})");
+        return response;
+    };
+    test.styleObserver.sourceLoaded = [&](Source&) {
+        FAIL() << "The streamed data replaced the data set meanwhile";
+    };
+
+    source.setURL("url");
+    source.loadDescription(*test.fileSource);
+    test.run();
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_GEOJSON_STREAMING, false);
+
+    auto data = source.impl().getData().lock();
+    ASSERT_TRUE(data);
+    std::size_t count = 0;
+    data->getTile({0, 0, 0}, [&](GeoJSONData::TileFeatures features) { count = features.size(); }, true);
+    EXPECT_EQ(1u, count);
+}
+
 TEST(Source, SetMaxParentOverscaleFactor) {
     SourceTest test;
     test.transform.jumpTo(CameraOptions().withCenter(LatLng()).withZoom(8.0));
@@ -319,6 +319,74 @@ TEST(CrossTileSymbolLayerIndex, noDuplicatesWithinZoomLevel) {
               3u); // C' gets new ID
 }
 
+TEST(CrossTileSymbolLayerIndex, repeatedKeys) {
+    uint32_t maxCrossTileID = 0;
+    uint32_t maxBucketInstanceId = 0;
+    CrossTileSymbolLayerIndex index(maxCrossTileID);
+
+    Immutable<style::SymbolLayoutProperties::PossiblyEvaluated> layout =
+        makeMutable<style::SymbolLayoutProperties::PossiblyEvaluated>();
+    bool iconsNeedLinear = false;
+    bool sortFeaturesByY = false;
+    std::string bucketLeaderID = "test";
+
+    OverscaledTileID mainID(6, 0, 6, 8, 8);
+    std::vector<SymbolInstance> mainInstances;
+    std::vector<SortKeyRange> mainRanges;
+    mainInstances.push_back(makeSymbolInstance(1001, 1001, u"Main Street")); // A
+    mainInstances.push_back(makeSymbolInstance(1000, 1000, u"Main Street")); // B
+    mainInstances.push_back(makeSymbolInstance(3000, 3000, u"Main Street")); // C
+    mainInstances.push_back(makeSymbolInstance(1000, 1000, u"Elm Street"));  // D
+    SymbolBucket mainBucket{layout,
+                            {},
+                            16.0f,
+                            1.0f,
+                            0,
+                            iconsNeedLinear,
+                            sortFeaturesByY,
+                            bucketLeaderID,
+                            std::move(mainInstances),
+                            std::move(mainRanges),
+                            1.0f,
+                            false,
+                            {},
+                            false /*iconsInText*/};
+    mainBucket.bucketInstanceId = ++maxBucketInstanceId;
+    index.addBucket(mainID, mat4{}, mainBucket);
+
+    OverscaledTileID childID(7, 0, 7, 16, 16);
+    std::vector<SymbolInstance> childInstances;
+    std::vector<SortKeyRange> childRanges;
+    childInstances.push_back(makeSymbolInstance(2000, 2000, u"Main Street")); // A'
+    childInstances.push_back(makeSymbolInstance(2000, 2000, u"Main Street")); // B'
+    childInstances.push_back(makeSymbolInstance(6000, 6000, u"Main Street")); // C'
+    childInstances.push_back(makeSymbolInstance(2000, 2000, u"Elm Street"));  // D'
+    childInstances.push_back(makeSymbolInstance(2000, 2000, u"Main Street")); // E'
+    SymbolBucket childBucket{layout,
+                             {},
+                             16.0f,
+                             1.0f,
+                             0,
+                             iconsNeedLinear,
+                             sortFeaturesByY,
+                             bucketLeaderID,
+                             std::move(childInstances),
+                             std::move(childRanges),
+                             1.0f,
+                             false,
+                             {},
+                             false /*iconsInText*/};
+    childBucket.bucketInstanceId = ++maxBucketInstanceId;
+    index.addBucket(childID, mat4{}, childBucket);
+
+    // Of several matching parent symbols, the first one in the bucket wins
+    ASSERT_EQ(childBucket.symbolInstances.at(0).getCrossTileID(), 1u); // A' copies from A
+    ASSERT_EQ(childBucket.symbolInstances.at(1).getCrossTileID(), 2u); // B' copies from B
+    ASSERT_EQ(childBucket.symbolInstances.at(2).getCrossTileID(), 3u); // C' copies from C
+    ASSERT_EQ(childBucket.symbolInstances.at(3).getCrossTileID(), 4u); // D' copies from D
+    ASSERT_EQ(childBucket.symbolInstances.at(4).getCrossTileID(), 5u); // E' gets new ID
+}
+
 TEST(CrossTileSymbolLayerIndex, bucketReplacement) {
     uint32_t maxCrossTileID = 0;
     uint32_t maxBucketInstanceId = 0;
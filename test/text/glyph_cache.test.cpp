@@ -0,0 +1,169 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/glyph_cache.hpp>
+#include <mbgl/util/io.hpp>
+
+using namespace mln;
+
+namespace {
+
+constexpr const char* filename = "test/fixtures/local_glyphs/glyph_cache.bin";
+
+const FontStack fontStack{"Test Stack"};
+
+Immutable<Glyph> makeGlyph(char16_t code, uint8_t value) {
+    Glyph glyph;
+    glyph.id = GlyphID(code);
+    glyph.metrics.width = 24;
+    glyph.metrics.height = 24;
+    glyph.metrics.top = -8;
+    glyph.metrics.advance = 24;
+    glyph.metrics.isDoubleResolution = true;
+    glyph.bitmap = AlphaImage({30, 30});
+    glyph.bitmap.fill(value);
+    return makeMutable<Glyph>(std::move(glyph));
+}
+
+void expectGlyph(const std::optional<Immutable<Glyph>>& glyph, char16_t code, uint8_t value) {
+    ASSERT_TRUE(glyph);
+    EXPECT_EQ(code, (*glyph)->id.complex.code);
+    EXPECT_EQ(24u, (*glyph)->metrics.width);
+    EXPECT_EQ(-8, (*glyph)->metrics.top);
+    EXPECT_TRUE((*glyph)->metrics.isDoubleResolution);
+    ASSERT_EQ(Size(30, 30), (*glyph)->bitmap.size);
+    EXPECT_EQ(value, (*glyph)->bitmap.data[0]);
+    EXPECT_EQ(value, (*glyph)->bitmap.data[30 * 30 - 1]);
+}
+
+} // namespace
+
+TEST(GlyphCache, Memory) {
+    const std::size_t glyphBytes = [] {
+        GlyphCache cache(1024 * 1024);
+        cache.put("", fontStack, makeGlyph(u'中', 1));
+        return cache.getStats().bytes;
+    }();
+
+    GlyphCache cache(2 * glyphBytes);
+    EXPECT_FALSE(cache.get("", fontStack, u'中'));
+    cache.put("", fontStack, makeGlyph(u'中', 1));
+    cache.put("", fontStack, makeGlyph(u'国', 2));
+    expectGlyph(cache.get("", fontStack, u'中'), u'中', 1);
+
+    // Keyed by font family and font stack too
+    EXPECT_FALSE(cache.get("PingFang", fontStack, u'中'));
+    EXPECT_FALSE(cache.get("", {"Other Stack"}, u'中'));
+
+    // The least recently used glyph goes first
+    cache.put("", fontStack, makeGlyph(u'人', 3));
+    EXPECT_FALSE(cache.get("", fontStack, u'国'));
+    expectGlyph(cache.get("", fontStack, u'中'), u'中', 1);
+    expectGlyph(cache.get("", fontStack, u'人'), u'人', 3);
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(3u, stats.hits);
+    EXPECT_EQ(4u, stats.misses);
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(2u, stats.glyphs);
+    EXPECT_EQ(2 * glyphBytes, stats.bytes);
+
+    cache.setMaxBytes(glyphBytes);
+    EXPECT_EQ(1u, cache.getStats().glyphs);
+    cache.clear();
+    EXPECT_EQ(0u, cache.getStats().glyphs);
+    EXPECT_EQ(0u, cache.getStats().bytes);
+}
+
+TEST(GlyphCache, File) {
+    util::deleteFile(filename);
+
+    {
+        GlyphCache cache(1024 * 1024, filename);
+        EXPECT_EQ(0u, cache.getStats().loaded);
+        cache.put("", fontStack, makeGlyph(u'中', 1));
+        cache.put("PingFang", fontStack, makeGlyph(u'国', 2));
+    }
+
+    {
+        // A later process starts with the glyphs of the earlier one
+        GlyphCache cache(1024 * 1024, filename);
+        EXPECT_EQ(2u, cache.getStats().loaded);
+        expectGlyph(cache.get("", fontStack, u'中'), u'中', 1);
+        expectGlyph(cache.get("PingFang", fontStack, u'国'), u'国', 2);
+        EXPECT_FALSE(cache.get("", fontStack, u'国'));
+        cache.put("", fontStack, makeGlyph(u'人', 3));
+    }
+
+    // A record cut short, as by a crash while appending, is dropped with the ones after it
+    auto data = util::read_file(filename);
+    util::write_file(filename, data.substr(0, data.size() - 10));
+    {
+        GlyphCache cache(1024 * 1024, filename);
+        EXPECT_EQ(2u, cache.getStats().loaded);
+        EXPECT_FALSE(cache.get("", fontStack, u'人'));
+        cache.put("", fontStack, makeGlyph(u'人', 4));
+    }
+    {
+        GlyphCache cache(1024 * 1024, filename);
+        EXPECT_EQ(3u, cache.getStats().loaded);
+        expectGlyph(cache.get("", fontStack, u'人'), u'人', 4);
+        cache.clear();
+    }
+
+    // Files of another format version are discarded
+    data = util::read_file(filename);
+    EXPECT_EQ(12u, data.size());
+    data[8] = char(0xFF);
+    util::write_file(filename, data);
+    {
+        GlyphCache cache(1024 * 1024, filename);
+        EXPECT_EQ(0u, cache.getStats().loaded);
+    }
+    EXPECT_NE(data, util::read_file(filename));
+
+    util::deleteFile(filename);
+}
+
+TEST(GlyphCache, FileChecksum) {
+    util::deleteFile(filename);
+
+    {
+        GlyphCache cache(1024 * 1024, filename);
+        cache.put("", fontStack, makeGlyph(u'中', 1));
+        cache.put("", fontStack, makeGlyph(u'国', 2));
+    }
+
+    // A record whose bitmap was changed is dropped like one cut short
+    auto data = util::read_file(filename);
+    data[data.size() - 100] ^= 1;
+    util::write_file(filename, data);
+    {
+        GlyphCache cache(1024 * 1024, filename);
+        EXPECT_EQ(1u, cache.getStats().loaded);
+        expectGlyph(cache.get("", fontStack, u'中'), u'中', 1);
+        EXPECT_FALSE(cache.get("", fontStack, u'国'));
+    }
+
+    util::deleteFile(filename);
+}
+
+TEST(GlyphCache, FileSkipsPresentGlyphs) {
+    util::deleteFile(filename);
+
+    {
+        GlyphCache cache(1024 * 1024, filename);
+        cache.put("", fontStack, makeGlyph(u'中', 1));
+    }
+    const auto size = util::read_file(filename).size();
+    {
+        // Putting a glyph the cache already has, as glyph managers rasterizing it at once do, keeps the first one
+        // and doesn't append it again
+        GlyphCache cache(1024 * 1024, filename);
+        cache.put("", fontStack, makeGlyph(u'中', 5));
+        cache.put("", fontStack, makeGlyph(u'中', 6));
+        expectGlyph(cache.get("", fontStack, u'中'), u'中', 1);
+    }
+    EXPECT_EQ(size, util::read_file(filename).size());
+
+    util::deleteFile(filename);
+}
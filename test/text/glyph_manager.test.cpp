@@ -126,6 +126,20 @@ public:
     }
 };
 
+class CountingLocalGlyphRasterizer : public StubLocalGlyphRasterizer {
+public:
+    explicit CountingLocalGlyphRasterizer(unsigned& count_)
+        : count(count_) {}
+
+    Glyph rasterizeGlyph(const FontStack& fontStack, GlyphID glyphID) override {
+        count++;
+        return StubLocalGlyphRasterizer::rasterizeGlyph(fontStack, glyphID);
+    }
+
+private:
+    unsigned& count;
+};
+
 class StubGlyphManagerObserver : public GlyphManagerObserver {
 public:
     void onGlyphsLoaded(const FontStack& fontStack, const GlyphRange& glyphRange) override {
@@ -158,8 +172,9 @@ public:
     GlyphManager glyphManager;
 
     GlyphManagerTest(
-        std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer = std::make_unique<StubLocalGlyphRasterizer>())
-        : glyphManager(std::move(localGlyphRasterizer)) {}
+        std::unique_ptr<LocalGlyphRasterizer> localGlyphRasterizer = std::make_unique<StubLocalGlyphRasterizer>(),
+        std::shared_ptr<GlyphCache> glyphCache = nullptr)
+        : glyphManager(std::move(localGlyphRasterizer), std::move(glyphCache)) {}
 
     void run(const std::string& url, GlyphDependencies dependencies) {
         // Squelch logging.
@@ -328,6 +343,37 @@ TEST(GlyphManager, LoadLocalCJKGlyph) {
              GlyphDependencies{.glyphs = {{{{"Test Stack"}}, {u'中'}}}, .shapes = {}});
 }
 
+TEST(GlyphManager, SharedGlyphCache) {
+    auto glyphCache = std::make_shared<GlyphCache>(1024 * 1024);
+    unsigned rasterized = 0;
+
+    // Glyph managers of two maps sharing a cache
+    for (int i = 0; i < 2; i++) {
+        GlyphManagerTest test(std::make_unique<CountingLocalGlyphRasterizer>(rasterized), glyphCache);
+
+        test.requestor.glyphsAvailable = [&](GlyphMap glyphs) {
+            const auto& testPositions = glyphs.at(FontStackHasher()({{"Test Stack"}}));
+            ASSERT_EQ(testPositions.count(u'中'), 1u);
+
+            Immutable<Glyph> glyph = *testPositions.at(u'中');
+            EXPECT_EQ(glyph->bitmap.size, Size(30, 30));
+            for (size_t j = 0; j < glyph->bitmap.bytes(); j++) {
+                EXPECT_EQ(glyph->bitmap.data[j], sdfBitmap[j]);
+            }
+
+            test.end();
+        };
+
+        test.run("test/fixtures/resources/glyphs.pbf",
+                 GlyphDependencies{.glyphs = {{{{"Test Stack"}}, {u'中'}}}, .shapes = {}});
+    }
+
+    // Only the first one rasterized the glyph
+    EXPECT_EQ(1u, rasterized);
+    EXPECT_EQ(1u, glyphCache->getStats().hits);
+    EXPECT_EQ(1u, glyphCache->getStats().glyphs);
+}
+
 TEST(GlyphManager, LoadLocalCJKSymbols) {
     GlyphManagerTest test;
     int glyphResponses = 0;
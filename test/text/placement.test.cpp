@@ -0,0 +1,189 @@
+#include <mbgl/test/map_adapter.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/test/stub_map_observer.hpp>
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/gfx/headless_frontend.hpp>
+#include <mbgl/map/map_options.hpp>
+#include <mbgl/platform/settings.hpp>
+#include <mbgl/renderer/renderer.hpp>
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/storage/response.hpp>
+#include <mbgl/style/image.hpp>
+#include <mbgl/style/layers/symbol_layer.hpp>
+#include <mbgl/style/sources/geojson_source.hpp>
+#include <mbgl/style/style.hpp>
+#include <mbgl/util/image.hpp>
+#include <mbgl/util/io.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <set>
+#include <string>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+/// IDs of the markers shown in each frame of a slow pan over a dense grid of markers, and the placement counters
+std::vector<std::set<uint64_t>> placeWhilePanning(bool incremental, PlacementStats& stats) {
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_INCREMENTAL_PLACEMENT, incremental);
+
+    util::RunLoop loop;
+    StubMapObserver observer;
+    HeadlessFrontend frontend{{256, 256}, 1};
+    MapAdapter map{frontend,
+                   observer,
+                   std::make_shared<StubFileSource>(),
+                   MapOptions().withMapMode(MapMode::Continuous).withSize(frontend.getSize())};
+
+    map.getStyle().loadJSON(R"STYLE({ "version": 8, "sources": {}, "layers": [] })STYLE");
+    // Places symbols in every frame
+    map.getStyle().setTransitionOptions(style::TransitionOptions{{}, {}, false});
+    map.getStyle().addImage(std::make_unique<style::Image>(
+        "marker", decodeImage(util::read_file("test/fixtures/sprites/default_marker.png")), 1.0f));
+
+    mapbox::geojson::feature_collection markers;
+    for (int x = 0; x < 16; ++x) {
+        for (int y = 0; y < 16; ++y) {
+            mapbox::geojson::feature marker{mapbox::geometry::point<double>{x * 2.5 - 20.0, y * 2.5 - 20.0}};
+            marker.id = static_cast<uint64_t>(x * 16 + y);
+            markers.push_back(std::move(marker));
+        }
+    }
+    auto source = std::make_unique<style::GeoJSONSource>("markers");
+    source->setGeoJSON(mapbox::geojson::geojson{markers});
+    map.getStyle().addSource(std::move(source));
+    auto layer = std::make_unique<style::SymbolLayer>("markers", "markers");
+    layer->setIconImage({"marker"});
+    map.getStyle().addLayer(std::move(layer));
+    map.jumpTo(CameraOptions().withCenter(LatLng{0, 0}).withZoom(0.0));
+
+    observer.didFinishLoadingMapCallback = [&] {
+        loop.stop();
+    };
+    loop.run();
+
+    std::vector<std::set<uint64_t>> frames;
+    for (int i = 0; i < 12; ++i) {
+        map.moveBy(i < 6 ? ScreenCoordinate{3, 2} : ScreenCoordinate{-2.5, -1.5});
+        frontend.renderFrame();
+
+        std::set<uint64_t> shown;
+        for (const auto& feature : frontend.getRenderer()->queryRenderedFeatures(ScreenBox{{0, 0}, {256, 256}},
+                                                                                {{{"markers"}}, {}})) {
+            shown.insert(feature.id.get<uint64_t>());
+        }
+        frames.push_back(std::move(shown));
+    }
+    stats = frontend.getRenderer()->getPlacementStats();
+
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_INCREMENTAL_PLACEMENT, false);
+    return frames;
+}
+
+/// IDs of the roads labelled in each frame of a zoom over a dense grid of roads, labelled along their lines
+std::vector<std::set<uint64_t>> placeWhileZooming(bool parallel) {
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_PARALLEL_PLACEMENT, parallel);
+
+    util::RunLoop loop;
+    StubMapObserver observer;
+    HeadlessFrontend frontend{{256, 256}, 1};
+    auto fileSource = std::make_shared<StubFileSource>();
+    fileSource->glyphsResponse = [](const Resource&) {
+        Response response;
+        response.data = std::make_shared<std::string>(util::read_file("test/fixtures/resources/glyphs.pbf"));
+        return response;
+    };
+    MapAdapter map{
+        frontend, observer, fileSource, MapOptions().withMapMode(MapMode::Continuous).withSize(frontend.getSize())};
+
+    map.getStyle().loadJSON(R"STYLE({
+        "version": 8,
+        "glyphs": "local://glyphs/{fontstack}/{range}.pbf",
+        "sources": {},
+        "layers": []
+    })STYLE");
+    // Places symbols in every frame
+    map.getStyle().setTransitionOptions(style::TransitionOptions{{}, {}, false});
+
+    mapbox::geojson::feature_collection roads;
+    for (int x = 0; x < 6; ++x) {
+        for (int y = 0; y < 80; ++y) {
+            mapbox::geojson::feature road{mapbox::geometry::line_string<double>{{x * 7.0 - 21.0, y * 0.5 - 20.0},
+                                                                                 {x * 7.0 - 15.0, y * 0.5 - 19.0}}};
+            road.id = static_cast<uint64_t>(x * 80 + y);
+            roads.push_back(std::move(road));
+        }
+    }
+    auto source = std::make_unique<style::GeoJSONSource>("roads");
+    source->setGeoJSON(mapbox::geojson::geojson{roads});
+    map.getStyle().addSource(std::move(source));
+    auto layer = std::make_unique<style::SymbolLayer>("roads", "roads");
+    layer->setSymbolPlacement(style::SymbolPlacementType::Line);
+    layer->setTextField(style::expression::Formatted("Road"));
+    map.getStyle().addLayer(std::move(layer));
+    map.jumpTo(CameraOptions().withCenter(LatLng{0, 0}).withZoom(3.0));
+
+    observer.didFinishLoadingMapCallback = [&] {
+        loop.stop();
+    };
+    loop.run();
+
+    std::vector<std::set<uint64_t>> frames;
+    for (int i = 0; i < 8; ++i) {
+        map.jumpTo(CameraOptions().withZoom(3.0 + i * 0.1));
+        frontend.renderFrame();
+
+        std::set<uint64_t> shown;
+        for (const auto& feature : frontend.getRenderer()->queryRenderedFeatures(ScreenBox{{0, 0}, {256, 256}},
+                                                                                {{{"roads"}}, {}})) {
+            shown.insert(feature.id.get<uint64_t>());
+        }
+        frames.push_back(std::move(shown));
+    }
+
+    platform::Settings::getInstance().set(platform::EXPERIMENTAL_PARALLEL_PLACEMENT, false);
+    return frames;
+}
+
+} // namespace
+
+TEST(Placement, IncrementalPan) {
+    PlacementStats fullStats;
+    PlacementStats stats;
+    const auto expected = placeWhilePanning(false, fullStats);
+    const auto frames = placeWhilePanning(true, stats);
+
+    ASSERT_EQ(expected.size(), frames.size());
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        // Markers collide with each other, so that only some are shown
+        EXPECT_LT(0u, expected[i].size());
+        EXPECT_GT(256u, expected[i].size());
+        EXPECT_EQ(expected[i], frames[i]) << "frame " << i;
+    }
+
+    // Placing in full reuses nothing, and keeps no records
+    EXPECT_LT(0u, fullStats.symbolsPlaced);
+    EXPECT_EQ(0u, fullStats.symbolsReused);
+    EXPECT_EQ(0u, fullStats.recordBytes);
+
+    // Markers keep their results from one frame of the pan to the next, and the records kept for that take
+    // a few bytes per marker
+    EXPECT_LT(0u, stats.symbolsReused);
+    EXPECT_LT(0u, stats.recordBytes);
+    EXPECT_GT(256u * 256u, stats.recordBytes);
+}
+
+TEST(Placement, ParallelLineLabels) {
+    const auto expected = placeWhileZooming(false);
+    const auto frames = placeWhileZooming(true);
+
+    ASSERT_EQ(expected.size(), frames.size());
+    for (std::size_t i = 0; i < frames.size(); ++i) {
+        // Labels collide with each other, so that only some are shown
+        EXPECT_LT(0u, expected[i].size());
+        EXPECT_GT(480u, expected[i].size());
+        EXPECT_EQ(expected[i], frames[i]) << "frame " << i;
+    }
+}
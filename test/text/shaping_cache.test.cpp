@@ -0,0 +1,206 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/text/bidi.hpp>
+#include <mbgl/text/shaping_cache.hpp>
+#include <mbgl/text/tagged_string.hpp>
+#include <mbgl/util/constants.hpp>
+
+using namespace mln;
+using namespace util;
+
+namespace {
+
+const FontStack fontStack{{"font-stack"}};
+
+struct TileGlyphs {
+    GlyphMap glyphMap;
+    GlyphPositions glyphPositions;
+};
+
+/// Glyphs for the characters of a text, at a different place in the atlas of every tile
+TileGlyphs makeGlyphs(const std::u16string& text, uint16_t atlasOffset, uint32_t advance = 21) {
+    TileGlyphs glyphs;
+    const FontStackHash hash = FontStackHasher()(fontStack);
+    for (char16_t ch : text) {
+        GlyphMetrics metrics;
+        metrics.width = 18;
+        metrics.height = 18;
+        metrics.left = 2;
+        metrics.top = -8;
+        metrics.advance = advance;
+
+        Glyph glyph;
+        glyph.id = ch;
+        glyph.metrics = metrics;
+        glyphs.glyphMap[hash].emplace(ch, Immutable<Glyph>(makeMutable<Glyph>(std::move(glyph))));
+        glyphs.glyphPositions[hash].emplace(
+            ch, GlyphPosition{.rect = {static_cast<uint16_t>(atlasOffset + ch), 0, 24, 24}, .metrics = metrics});
+    }
+    return glyphs;
+}
+
+Shaping shape(ShapingCache* cache, const TaggedString& string, const TileGlyphs& glyphs) {
+    BiDi bidi;
+    const ImagePositions imagePositions;
+    if (!cache) {
+        return getShaping(string,
+                          5 * ONE_EM, // maxWidth
+                          ONE_EM,     // lineHeight
+                          style::SymbolAnchorType::Center,
+                          style::TextJustifyType::Center,
+                          0,              // spacing
+                          {{0.0f, 0.0f}}, // translate
+                          WritingModeType::Horizontal,
+                          bidi,
+                          glyphs.glyphMap,
+                          glyphs.glyphPositions,
+                          imagePositions,
+                          16.0f,
+                          16.0f,
+                          /*allowVerticalPlacement*/ false);
+    }
+    return cache->getShaping(string,
+                             5 * ONE_EM,
+                             ONE_EM,
+                             style::SymbolAnchorType::Center,
+                             style::TextJustifyType::Center,
+                             0,
+                             {{0.0f, 0.0f}},
+                             WritingModeType::Horizontal,
+                             bidi,
+                             glyphs.glyphMap,
+                             glyphs.glyphPositions,
+                             imagePositions,
+                             16.0f,
+                             16.0f,
+                             false);
+}
+
+void expectSameShaping(const Shaping& expected, const Shaping& actual) {
+    EXPECT_EQ(expected.top, actual.top);
+    EXPECT_EQ(expected.bottom, actual.bottom);
+    EXPECT_EQ(expected.left, actual.left);
+    EXPECT_EQ(expected.right, actual.right);
+    ASSERT_EQ(expected.positionedLines.size(), actual.positionedLines.size());
+    for (std::size_t i = 0; i < expected.positionedLines.size(); ++i) {
+        const auto& expectedGlyphs = expected.positionedLines[i].positionedGlyphs;
+        const auto& actualGlyphs = actual.positionedLines[i].positionedGlyphs;
+        ASSERT_EQ(expectedGlyphs.size(), actualGlyphs.size());
+        for (std::size_t j = 0; j < expectedGlyphs.size(); ++j) {
+            EXPECT_EQ(expectedGlyphs[j].glyph.hash, actualGlyphs[j].glyph.hash);
+            EXPECT_EQ(expectedGlyphs[j].x, actualGlyphs[j].x);
+            EXPECT_EQ(expectedGlyphs[j].y, actualGlyphs[j].y);
+            EXPECT_TRUE(expectedGlyphs[j].rect == actualGlyphs[j].rect);
+        }
+    }
+}
+
+} // namespace
+
+TEST(ShapingCache, Hit) {
+    ShapingCache cache(1024 * 1024);
+    const TaggedString string(u"Unter den Linden", SectionOptions(1.0, fontStack, GlyphIDType::FontPBF, 0));
+    const auto tile1 = makeGlyphs(string.rawText(), 0);
+    const auto tile2 = makeGlyphs(string.rawText(), 100);
+
+    expectSameShaping(shape(nullptr, string, tile1), shape(&cache, string, tile1));
+    auto stats = cache.getStats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.entries);
+
+    // Glyph rects come from the atlas of the other tile
+    const Shaping shaping = shape(&cache, string, tile2);
+    EXPECT_LT(1u, shaping.positionedLines.size());
+    expectSameShaping(shape(nullptr, string, tile2), shaping);
+    stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+
+    // Another text is shaped again
+    const TaggedString other(u"Unter den Linde", SectionOptions(1.0, fontStack, GlyphIDType::FontPBF, 0));
+    expectSameShaping(shape(nullptr, other, tile2), shape(&cache, other, tile2));
+    EXPECT_EQ(2u, cache.getStats().misses);
+    EXPECT_EQ(2u, cache.getStats().entries);
+}
+
+TEST(ShapingCache, Glyphs) {
+    ShapingCache cache(1024 * 1024);
+    const TaggedString string(u"Alexanderplatz", SectionOptions(1.0, fontStack, GlyphIDType::FontPBF, 0));
+    shape(&cache, string, makeGlyphs(string.rawText(), 0));
+
+    // Glyphs with other metrics, as from another glyph server, change the shaping
+    const auto wide = makeGlyphs(string.rawText(), 0, 40);
+    expectSameShaping(shape(nullptr, string, wide), shape(&cache, string, wide));
+    auto stats = cache.getStats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+    EXPECT_EQ(1u, stats.entries);
+
+    // Shapings which lack glyphs of the tile are not kept
+    cache.clear();
+    const auto partial = makeGlyphs(u"lexanderpltz", 0);
+    expectSameShaping(shape(nullptr, string, partial), shape(&cache, string, partial));
+    EXPECT_EQ(0u, cache.getStats().entries);
+
+    // Strings with images are shaped without the cache
+    TaggedString withImage(u"Alexanderplatz ", SectionOptions(1.0, fontStack, GlyphIDType::FontPBF, 0));
+    withImage.addImageSection("u-bahn");
+    shape(&cache, withImage, makeGlyphs(string.rawText(), 0));
+    stats = cache.getStats();
+    EXPECT_EQ(3u, stats.misses);
+    EXPECT_EQ(0u, stats.entries);
+}
+
+TEST(ShapingCache, HarfBuzz) {
+    ShapingCache cache(1024 * 1024);
+    const std::u16string text = u"क्ष";
+    const std::vector<GlyphID> shapedIDs = {GlyphID(12, GlyphIDType(1)), GlyphID(48, GlyphIDType(1))};
+    const std::vector<HBShapeAdjust> shapedAdjusts = {{0.0f, 0.0f, 20.0f}, {-2.0f, 1.0f, 0.0f}};
+
+    std::vector<GlyphID> glyphIDs;
+    std::vector<HBShapeAdjust> adjusts;
+    EXPECT_FALSE(cache.getHBShaping("devanagari.ttf", fontStack, GlyphIDType(1), text, glyphIDs, adjusts));
+    cache.putHBShaping("devanagari.ttf", fontStack, GlyphIDType(1), text, shapedIDs, shapedAdjusts);
+
+    ASSERT_TRUE(cache.getHBShaping("devanagari.ttf", fontStack, GlyphIDType(1), text, glyphIDs, adjusts));
+    ASSERT_EQ(shapedIDs.size(), glyphIDs.size());
+    EXPECT_EQ(shapedIDs[1].hash, glyphIDs[1].hash);
+    ASSERT_EQ(shapedAdjusts.size(), adjusts.size());
+    EXPECT_EQ(shapedAdjusts[1].x_offset, adjusts[1].x_offset);
+    EXPECT_EQ(shapedAdjusts[0].advance, adjusts[0].advance);
+
+    // Results of another font face are not used
+    glyphIDs.clear();
+    adjusts.clear();
+    EXPECT_FALSE(cache.getHBShaping("other.ttf", fontStack, GlyphIDType(1), text, glyphIDs, adjusts));
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hbHits);
+    EXPECT_EQ(2u, stats.hbMisses);
+    EXPECT_EQ(1u, stats.entries);
+}
+
+TEST(ShapingCache, MaxBytes) {
+    ShapingCache cache(1024 * 1024);
+    for (const std::u16string text : {u"Friedrichstraße", u"Leipziger Straße", u"Mohrenstraße"}) {
+        const TaggedString string(text, SectionOptions(1.0, fontStack, GlyphIDType::FontPBF, 0));
+        shape(&cache, string, makeGlyphs(text, 0));
+    }
+    auto stats = cache.getStats();
+    EXPECT_EQ(3u, stats.entries);
+    EXPECT_EQ(0u, stats.evictions);
+
+    // The limit is split between the shards of the cache, each evicting its own entries
+    cache.setMaxBytes(stats.bytes - 1);
+    EXPECT_EQ(stats.bytes - 1, cache.getMaxBytes());
+    stats = cache.getStats();
+    EXPECT_GT(3u, stats.entries);
+    EXPECT_EQ(3u - stats.entries, stats.evictions);
+
+    cache.setMaxBytes(0);
+    stats = cache.getStats();
+    EXPECT_EQ(0u, stats.entries);
+    EXPECT_EQ(0u, stats.bytes);
+    EXPECT_EQ(3u, stats.evictions);
+}
@@ -0,0 +1,137 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/feature_cache.hpp>
+#include <mbgl/tile/vector_mvt_tile_data.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+std::shared_ptr<const std::string> tileData() {
+    return std::make_shared<const std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt"));
+}
+
+} // namespace
+
+TEST(FeatureCache, SingleUseIsNotCached) {
+    VectorMVTTileData data(tileData());
+    FeatureCache cache(1024 * 1024);
+    cache.addUse("water");
+
+    auto layer = cache.getLayer(data, "water");
+    ASSERT_TRUE(layer);
+    ASSERT_TRUE(layer->getFeature(0));
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(0u, stats.hits);
+    EXPECT_EQ(0u, stats.misses);
+    EXPECT_EQ(0u, stats.bytes);
+}
+
+TEST(FeatureCache, SharedBetweenUses) {
+    VectorMVTTileData data(tileData());
+    VectorMVTTileData reference(tileData());
+    FeatureCache cache(64 * 1024 * 1024);
+    cache.addUse("admin");
+    cache.addUse("admin");
+
+    auto first = cache.getLayer(data, "admin");
+    auto second = cache.getLayer(data, "admin");
+    auto expected = reference.getLayer("admin");
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    ASSERT_EQ(expected->featureCount(), first->featureCount());
+    ASSERT_EQ(expected->getName(), first->getName());
+    ASSERT_FALSE(cache.getLayer(data, "invalid"));
+
+    for (std::size_t i = 0; i < 100; ++i) {
+        const auto a = first->getFeature(i);
+        const auto b = second->getFeature(i);
+        const auto e = expected->getFeature(i);
+        EXPECT_EQ(e->getType(), a->getType());
+        EXPECT_EQ(e->getID(), a->getID());
+        EXPECT_EQ(e->getProperties(), b->getProperties());
+        EXPECT_EQ(e->getValue("disputed"), a->getValue("disputed"));
+        EXPECT_EQ(std::nullopt, b->getValue("invalid"));
+        EXPECT_EQ(e->getGeometries(), b->getGeometries());
+        // Both refer to the same decoded geometries
+        EXPECT_EQ(&a->getGeometries(), &b->getGeometries());
+    }
+
+    ASSERT_THROW(first->getFeature(first->featureCount()), std::out_of_range);
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(100u, stats.misses);
+    EXPECT_EQ(100u, stats.hits);
+    EXPECT_EQ(0u, stats.uncached);
+    EXPECT_LT(0u, stats.bytes);
+}
+
+TEST(FeatureCache, Budget) {
+    VectorMVTTileData data(tileData());
+    FeatureCache cache(4 * 1024);
+    cache.addUse("admin");
+    cache.addUse("admin");
+
+    auto layer = cache.getLayer(data, "admin");
+    for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+        layer->getFeature(i)->getGeometries();
+    }
+
+    const auto stats = cache.getStats();
+    EXPECT_LT(0u, stats.misses);
+    EXPECT_LT(0u, stats.uncached);
+    EXPECT_EQ(layer->featureCount(), stats.misses + stats.uncached);
+    EXPECT_LE(4u * 1024, stats.bytes);
+}
+
+TEST(FeatureCache, BudgetCheckedBeforeDecoding) {
+    VectorMVTTileData data(tileData());
+    VectorMVTTileData reference(tileData());
+    FeatureCache cache(1024);
+    cache.addUse("admin");
+    cache.addUse("admin");
+
+    // Entries are created until the budget is spent, before any of them is decoded
+    auto layer = cache.getLayer(data, "admin");
+    auto expected = reference.getLayer("admin");
+    std::vector<std::unique_ptr<GeometryTileFeature>> features;
+    for (std::size_t i = 0; i < layer->featureCount(); ++i) {
+        features.push_back(layer->getFeature(i));
+    }
+    const auto created = cache.getStats();
+    ASSERT_LT(0u, created.misses);
+    ASSERT_LT(0u, created.uncached);
+
+    // Their parts are then decoded for each reader alone, and still read the same
+    for (std::size_t i = 0; i < features.size(); ++i) {
+        const auto e = expected->getFeature(i);
+        EXPECT_EQ(e->getGeometries(), features[i]->getGeometries());
+        EXPECT_EQ(e->getProperties(), features[i]->getProperties());
+    }
+    EXPECT_EQ(created.bytes, cache.getStats().bytes);
+}
+
+TEST(FeatureCache, ReleasedWithCache) {
+    VectorMVTTileData data(tileData());
+    std::unique_ptr<GeometryTileLayer> layer;
+    std::unique_ptr<GeometryTileFeature> kept;
+    {
+        FeatureCache cache(1024 * 1024);
+        cache.addUse("admin");
+        cache.addUse("admin");
+        layer = cache.getLayer(data, "admin");
+        kept = layer->getFeature(0);
+        layer->getFeature(1)->getGeometries();
+    }
+
+    // Features held beyond the parse keep their data, the layer goes on reading without sharing
+    EXPECT_FALSE(kept->getGeometries().empty());
+    const auto first = layer->getFeature(1);
+    const auto second = layer->getFeature(1);
+    EXPECT_EQ(first->getGeometries(), second->getGeometries());
+    EXPECT_NE(&first->getGeometries(), &second->getGeometries());
+}
@@ -0,0 +1,184 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/tile/raw_tile_cache.hpp>
+
+#include <mbgl/storage/resource.hpp>
+#include <mbgl/test/stub_file_source.hpp>
+#include <mbgl/util/async_request.hpp>
+#include <mbgl/util/run_loop.hpp>
+
+#include <memory>
+
+using namespace mln;
+
+namespace {
+
+Resource tileResource(int32_t x, Resource::LoadingMethod method = Resource::LoadingMethod::NetworkOnly) {
+    return Resource::tile("http://example.com/{z}/{x}/{y}.pbf", 1.0, x, 0, 1, Tileset::Scheme::XYZ, method);
+}
+
+std::shared_ptr<StubFileSource> makeFileSource(unsigned& requests, Timestamp expires) {
+    auto fileSource = std::make_shared<StubFileSource>();
+    fileSource->tileResponse = [&requests, expires](const Resource& resource) {
+        requests++;
+        Response response;
+        response.data = std::make_shared<std::string>(resource.url);
+        response.expires = expires;
+        return response;
+    };
+    return fileSource;
+}
+
+} // namespace
+
+TEST(RawTileCache, FreshResponse) {
+    util::RunLoop loop;
+    unsigned requests = 0;
+    RawTileCache cache(1024 * 1024);
+    cache.setFileSource(makeFileSource(requests, util::now() + Seconds(60)));
+
+    const Resource resource = tileResource(0);
+    std::unique_ptr<AsyncRequest> req1;
+    std::unique_ptr<AsyncRequest> req2;
+
+    req1 = cache.request(resource, [&](Response res) {
+        req1.reset();
+        ASSERT_TRUE(res.data);
+        EXPECT_EQ(resource.url, *res.data);
+
+        // Answered from memory without requesting the file source again
+        req2 = cache.request(resource, [&](Response res2) {
+            req2.reset();
+            EXPECT_EQ(nullptr, res2.error);
+            ASSERT_TRUE(res2.data);
+            EXPECT_EQ(res.data, res2.data);
+            EXPECT_TRUE(res.expires == res2.expires);
+            EXPECT_EQ(1u, requests);
+            loop.stop();
+        });
+    });
+
+    loop.run();
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(1u, stats.misses);
+    EXPECT_EQ(1u, stats.tiles);
+    EXPECT_EQ(2 * resource.url.size(), stats.bytes);
+}
+
+TEST(RawTileCache, ExpiredResponse) {
+    util::RunLoop loop;
+    unsigned requests = 0;
+    RawTileCache cache(1024 * 1024);
+    cache.setFileSource(makeFileSource(requests, util::now() - Seconds(60)));
+
+    const Resource resource = tileResource(0);
+    std::unique_ptr<AsyncRequest> req;
+
+    req = cache.request(resource, [&](Response) {
+        // Expired data is still usable for cache-only requests
+        req = cache.request(tileResource(0, Resource::LoadingMethod::CacheOnly), [&](Response res) {
+            ASSERT_TRUE(res.data);
+            EXPECT_EQ(1u, requests);
+
+            // But other requests go to the file source
+            req = cache.request(resource, [&](Response) {
+                req.reset();
+                EXPECT_EQ(2u, requests);
+                loop.stop();
+            });
+        });
+    });
+
+    loop.run();
+
+    const auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.hits);
+    EXPECT_EQ(2u, stats.misses);
+}
+
+TEST(RawTileCache, CacheOnly) {
+    util::RunLoop loop;
+    unsigned requests = 0;
+    RawTileCache cache(1024 * 1024);
+    cache.setFileSource(makeFileSource(requests, util::now() + Seconds(60)));
+    // Not advertised, as the wrapped file source does not support cache-only requests
+    ASSERT_FALSE(cache.supportsCacheOnlyRequests());
+
+    Resource resource = tileResource(0, Resource::LoadingMethod::CacheOnly);
+    std::unique_ptr<AsyncRequest> req;
+
+    // Answered from memory only
+    req = cache.request(resource, [&](Response res) {
+        ASSERT_TRUE(res.error);
+        EXPECT_EQ(Response::Error::Reason::NotFound, res.error->reason);
+        EXPECT_EQ(0u, requests);
+
+        resource.loadingMethod = Resource::LoadingMethod::NetworkOnly;
+        req = cache.request(resource, [&](Response) {
+            resource.loadingMethod = Resource::LoadingMethod::CacheOnly;
+            req = cache.request(resource, [&](Response res2) {
+                ASSERT_TRUE(res2.data);
+                EXPECT_FALSE(res2.notModified);
+
+                // A requester which has the data already is told it is up to date
+                resource.loadingMethod = Resource::LoadingMethod::NetworkOnly;
+                resource.priorExpires = res2.expires;
+                req = cache.request(resource, [&](Response res3) {
+                    req.reset();
+                    EXPECT_TRUE(res3.notModified);
+                    EXPECT_FALSE(res3.data);
+                    EXPECT_EQ(1u, requests);
+                    loop.stop();
+                });
+            });
+        });
+    });
+
+    loop.run();
+}
+
+TEST(RawTileCache, MaxBytes) {
+    util::RunLoop loop;
+    unsigned requests = 0;
+    const Resource resource0 = tileResource(0);
+    const Resource resource1 = tileResource(1);
+    RawTileCache cache(3 * resource0.url.size());
+    cache.setFileSource(makeFileSource(requests, util::now() + Seconds(60)));
+
+    std::unique_ptr<AsyncRequest> req;
+    req = cache.request(resource0, [&](Response) {
+        req = cache.request(resource1, [&](Response) {
+            req.reset();
+            loop.stop();
+        });
+    });
+
+    loop.run();
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(1u, stats.evictions);
+    EXPECT_EQ(1u, stats.tiles);
+    EXPECT_EQ(2 * resource1.url.size(), stats.bytes);
+
+    cache.setMaxBytes(resource1.url.size());
+    stats = cache.getStats();
+    EXPECT_EQ(2u, stats.evictions);
+    EXPECT_EQ(0u, stats.tiles);
+    EXPECT_EQ(0u, stats.bytes);
+}
+
+TEST(RawTileCache, SupportsCacheOnlyRequests) {
+    class CacheOnlyFileSource : public StubFileSource {
+    public:
+        bool supportsCacheOnlyRequests() const override { return true; }
+    };
+
+    RawTileCache cache(1024 * 1024);
+    EXPECT_FALSE(cache.supportsCacheOnlyRequests());
+    cache.setFileSource(std::make_shared<StubFileSource>());
+    EXPECT_FALSE(cache.supportsCacheOnlyRequests());
+    cache.setFileSource(std::make_shared<CacheOnlyFileSource>());
+    EXPECT_TRUE(cache.supportsCacheOnlyRequests());
+}
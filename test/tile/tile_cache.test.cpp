@@ -43,6 +43,23 @@ public:
     util::SimpleIdentity uniqueId;
 };
 
+class SizedTileMock : public VectorTileMock {
+public:
+    SizedTileMock(const OverscaledTileID& id_,
+                  const TileParameters& parameters,
+                  const Tileset& tileset,
+                  std::size_t bytes_,
+                  Duration loadDuration_)
+        : VectorTileMock(id_, "source", parameters, tileset),
+          bytes(bytes_) {
+        loadDuration = loadDuration_;
+    }
+
+    std::size_t getMemoryUsage() const override { return bytes; }
+
+    const std::size_t bytes;
+};
+
 } // namespace
 
 TEST(TileCache, Smoke) {
@@ -96,3 +113,51 @@ TEST(TileCache, Issue15926) {
         EXPECT_FALSE(cache.has(id1));
     }
 }
+
+TEST(TileCache, MaxBytes) {
+    VectorTileTest test;
+    {
+        TileCache cache(test.threadPool, 10);
+        cache.setMaxBytes(3 * 1024 * 1024);
+        const OverscaledTileID id0(0, 0, 0);
+        const OverscaledTileID id1(1, 0, 0);
+        const OverscaledTileID id2(1, 1, 0);
+
+        // A small tile which took long to load, then large ones which loaded quickly
+        cache.add(id0,
+                  std::make_unique<SizedTileMock>(
+                      id0, test.tileParameters, test.tileset, 64 * 1024, std::chrono::milliseconds(500)));
+        cache.add(id1,
+                  std::make_unique<SizedTileMock>(
+                      id1, test.tileParameters, test.tileset, 2 * 1024 * 1024, std::chrono::milliseconds(10)));
+        EXPECT_EQ(0u, cache.getStats().evictions);
+
+        // Over the limit, the large tile goes first although it is more recent
+        cache.add(id2,
+                  std::make_unique<SizedTileMock>(
+                      id2, test.tileParameters, test.tileset, 1024 * 1024, std::chrono::milliseconds(10)));
+        EXPECT_TRUE(cache.has(id0));
+        EXPECT_FALSE(cache.has(id1));
+        EXPECT_TRUE(cache.has(id2));
+
+        auto stats = cache.getStats();
+        EXPECT_EQ(1u, stats.evictions);
+        EXPECT_EQ(2u, stats.tiles);
+        EXPECT_EQ(1024u * 1024 + 64 * 1024, stats.bytes);
+
+        EXPECT_TRUE(cache.pop(id0));
+        EXPECT_FALSE(cache.pop(id1));
+        stats = cache.getStats();
+        EXPECT_EQ(1u, stats.hits);
+        EXPECT_EQ(1u, stats.misses);
+        EXPECT_EQ(1024u * 1024, stats.bytes);
+
+        // Lowering the limit evicts
+        cache.setMaxBytes(512 * 1024);
+        EXPECT_FALSE(cache.has(id2));
+        stats = cache.getStats();
+        EXPECT_EQ(2u, stats.evictions);
+        EXPECT_EQ(0u, stats.tiles);
+        EXPECT_EQ(0u, stats.bytes);
+    }
+}
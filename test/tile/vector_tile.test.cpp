@@ -18,8 +18,21 @@
 #include <mbgl/renderer/image_manager.hpp>
 #include <mbgl/test/vector_tile_test.hpp>
 #include <mbgl/text/glyph_manager.hpp>
+#include <mbgl/layermanager/layer_manager.hpp>
+#include <mbgl/layout/layout.hpp>
+#include <mbgl/renderer/property_evaluation_parameters.hpp>
+#include <mbgl/renderer/render_layer.hpp>
+#include <mbgl/renderer/source_state.hpp>
+#include <mbgl/renderer/transition_parameters.hpp>
+#include <mbgl/style/layers/fill_layer.hpp>
+#include <mbgl/style/layers/line_layer.hpp>
+#include <mbgl/tile/parallel_bucket_builder.hpp>
+#include <mbgl/util/mat4.hpp>
+#include <mbgl/util/thread_pool.hpp>
 
+#include <map>
 #include <memory>
+#include <set>
 #include "mbgl/tile/vector_mlt_tile_data.hpp"
 
 using namespace mln;
@@ -126,3 +139,121 @@ TEST(VectorTileData, MLTParseResults) {
         ASSERT_EQ(feature->getValue("invalid"), std::nullopt);
     }
 }
+
+TEST(VectorTileData, ParallelBucketBuilder) {
+    const OverscaledTileID tileID{0, 0, 0};
+    const auto data = std::make_shared<std::string>(util::read_file("test/fixtures/map/issue12432/0-0-0.mvt"));
+
+    std::vector<std::unique_ptr<RenderLayer>> renderLayers;
+    std::vector<std::vector<Immutable<style::LayerProperties>>> groups;
+    for (const auto* sourceLayer : {"admin", "water"}) {
+        for (int i = 0; i < 3; ++i) {
+            const std::string id = std::string(sourceLayer) + "-" + std::to_string(i);
+            std::unique_ptr<style::Layer> layer;
+            if (std::string_view(sourceLayer) == "admin") {
+                layer = std::make_unique<style::LineLayer>(id, "source");
+            } else {
+                layer = std::make_unique<style::FillLayer>(id, "source");
+            }
+            layer->setSourceLayer(sourceLayer);
+
+            auto renderLayer = LayerManager::get()->createRenderLayer(layer->baseImpl);
+            renderLayer->transition(TransitionParameters{.now = Clock::now(), .transition = {}});
+            renderLayer->evaluate(PropertyEvaluationParameters(0));
+            groups.push_back({renderLayer->evaluatedProperties});
+            renderLayers.push_back(std::move(renderLayer));
+        }
+    }
+    std::unordered_map<std::string, const RenderLayer*> queryLayers;
+    for (const auto& renderLayer : renderLayers) {
+        queryLayers.emplace(renderLayer->getID(), renderLayer.get());
+    }
+
+    // The layers with data, and the features queried in each quarter of the tile, in the order they are returned
+    using Built = std::pair<std::set<std::string>, std::vector<std::map<std::string, std::vector<GeoJSONFeature>>>>;
+    const auto build = [&](std::size_t helpers) -> Built {
+        VectorMVTTileData tile(data);
+        TaggedScheduler scheduler{std::make_shared<ThreadPool>(), util::SimpleIdentity{}};
+        const std::atomic<bool> obsolete{false};
+        std::set<std::string> availableImages;
+        ParallelBucketBuilder builder(
+            scheduler,
+            obsolete,
+            {.fontFaces = nullptr, .availableImages = availableImages, .firstLoad = true, .showCollisionBoxes = false});
+        auto featureIndex = std::make_unique<FeatureIndex>(std::make_unique<VectorMVTTileData>(data));
+        for (const auto& group : groups) {
+            const auto& leader = *group.front()->baseImpl;
+            featureIndex->setBucketLayerIDs(leader.id, {leader.id});
+            builder.add({.tileID = tileID,
+                         .mode = MapMode::Continuous,
+                         .pixelRatio = 1.0f,
+                         .layerType = leader.getTypeInfo()},
+                        group,
+                        tile.getLayer(leader.sourceLayer));
+        }
+        EXPECT_EQ(groups.size(), builder.parallelSize());
+
+        mln::unordered_map<std::string, LayerRenderData> renderData;
+        std::vector<std::unique_ptr<Layout>> layouts;
+        GlyphDependencies glyphDependencies;
+        ImageDependencies imageDependencies;
+        EXPECT_TRUE(builder.build(helpers,
+                                  {.featureIndex = featureIndex,
+                                   .renderData = renderData,
+                                   .layouts = layouts,
+                                   .glyphDependencies = glyphDependencies,
+                                   .imageDependencies = imageDependencies}));
+        EXPECT_TRUE(layouts.empty());
+
+        Built built;
+        for (const auto& [layerID, layerData] : renderData) {
+            if (layerData.bucket->hasData()) {
+                built.first.insert(layerID);
+            }
+        }
+
+        const TransformState transformState;
+        mat4 posMatrix;
+        matrix::identity(posMatrix);
+        const SourceFeatureState featureState;
+        constexpr int16_t half = util::EXTENT / 2;
+        for (const int16_t x : {int16_t(0), half}) {
+            for (const int16_t y : {int16_t(0), half}) {
+                const auto right = int16_t(x + half);
+                const auto bottom = int16_t(y + half);
+                const GeometryCoordinates quarter{{x, y}, {right, y}, {right, bottom}, {x, bottom}, {x, y}};
+                std::unordered_map<std::string, std::vector<Feature>> result;
+                featureIndex->query(result,
+                                    quarter,
+                                    transformState,
+                                    posMatrix,
+                                    util::tileSize_D,
+                                    1.0,
+                                    {},
+                                    tileID.toUnwrapped(),
+                                    queryLayers,
+                                    0.0f,
+                                    featureState);
+                auto& features = built.second.emplace_back();
+                for (const auto& [layerID, layerFeatures] : result) {
+                    features[layerID].assign(layerFeatures.begin(), layerFeatures.end());
+                }
+            }
+        }
+        return built;
+    };
+
+    const auto serial = build(0);
+    EXPECT_EQ(groups.size(), serial.first.size());
+    std::size_t queried = 0;
+    for (const auto& features : serial.second) {
+        for (const auto& pair : features) {
+            queried += pair.second.size();
+        }
+    }
+    EXPECT_LT(0u, queried);
+
+    const auto parallel = build(3);
+    EXPECT_EQ(serial.first, parallel.first);
+    EXPECT_EQ(serial.second, parallel.second);
+}
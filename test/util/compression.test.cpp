@@ -0,0 +1,111 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/compression.hpp>
+#include <mbgl/util/io.hpp>
+
+#include <optional>
+#include <stdexcept>
+#include <string>
+
+using namespace mln;
+
+namespace {
+
+std::size_t lastDecompressedSize = 0;
+std::optional<util::CompressedFormat> lastFormat;
+
+std::string passThrough(const char* data,
+                        std::size_t size,
+                        std::size_t decompressedSize,
+                        util::CompressedFormat format) {
+    lastDecompressedSize = decompressedSize;
+    lastFormat = format;
+    return std::string(data, size);
+}
+
+// Sets a decompressor for the scope, restoring the one it replaces even when an assertion fails
+class ScopedDecompressor {
+public:
+    ScopedDecompressor(util::Codec codec_, util::Decompressor decompressor)
+        : codec(codec_),
+          previous(util::setDecompressor(codec, decompressor)) {}
+    ~ScopedDecompressor() { util::setDecompressor(codec, previous); }
+
+private:
+    const util::Codec codec;
+    const util::Decompressor previous;
+};
+
+} // namespace
+
+TEST(Compression, RoundTrip) {
+    const std::string glyphs = util::read_file("test/fixtures/resources/glyphs.pbf");
+    // Compresses well beyond the initial guess of the output size
+    const std::string repeated(1024 * 1024, 'a');
+
+    for (const auto& raw : {glyphs, repeated, std::string()}) {
+        for (int format : {util::ZLIB, util::GZIP, util::DEFLATE}) {
+            const std::string compressed = util::compress(raw, format);
+            EXPECT_EQ(raw, util::decompress(compressed, format));
+            if (format != util::DEFLATE) {
+                EXPECT_TRUE(util::is_compressed(compressed));
+                EXPECT_EQ(raw, util::decompress(compressed));
+                EXPECT_EQ(raw, util::decompress(compressed.data(), compressed.size()));
+            }
+        }
+    }
+}
+
+TEST(Compression, ReusedAfterError) {
+    const std::string raw = "Hello, World!";
+    const std::string compressed = util::compress(raw, util::GZIP);
+
+    // A truncated stream leaves the inflate state of this thread half way
+    EXPECT_THROW(util::decompress(compressed.substr(0, compressed.size() / 2)), std::runtime_error);
+    EXPECT_THROW(util::decompress(std::string("\x78\x9c garbage")), std::runtime_error);
+
+    EXPECT_EQ(raw, util::decompress(compressed));
+    EXPECT_EQ(raw, util::decompress(util::compress(raw, util::DEFLATE), util::DEFLATE));
+}
+
+TEST(Compression, Decompressor) {
+    const std::string raw(1000, 'x');
+    const std::string gzip = util::compress(raw, util::GZIP);
+    const std::string zlib = util::compress(raw);
+
+    {
+        ScopedDecompressor scoped(util::Codec::Deflate, passThrough);
+        EXPECT_EQ(gzip, util::decompress(gzip));
+        // The size recorded by gzip is passed on, with the format
+        EXPECT_EQ(raw.size(), lastDecompressedSize);
+        EXPECT_EQ(util::CompressedFormat::Gzip, lastFormat);
+        EXPECT_EQ(zlib, util::decompress(zlib));
+        EXPECT_EQ(0u, lastDecompressedSize);
+        EXPECT_EQ(util::CompressedFormat::Zlib, lastFormat);
+        EXPECT_EQ(gzip, util::decompress(gzip, util::GZIP));
+        EXPECT_EQ(util::CompressedFormat::Gzip, lastFormat);
+    }
+    EXPECT_EQ(raw, util::decompress(gzip));
+
+    EXPECT_TRUE(util::hasDecompressor(util::Codec::Deflate));
+    EXPECT_FALSE(util::hasDecompressor(util::Codec::Zstd));
+    EXPECT_THROW(util::decompress(util::Codec::Zstd, raw.data(), raw.size()), std::runtime_error);
+
+    {
+        ScopedDecompressor scoped(util::Codec::Zstd, passThrough);
+        EXPECT_TRUE(util::hasDecompressor(util::Codec::Zstd));
+        EXPECT_EQ(raw, util::decompress(util::Codec::Zstd, raw.data(), raw.size()));
+        EXPECT_EQ(util::CompressedFormat::Zstd, lastFormat);
+    }
+    EXPECT_FALSE(util::hasDecompressor(util::Codec::Zstd));
+}
+
+TEST(Compression, ReusedAcrossFormats) {
+    const std::string raw = util::read_file("test/fixtures/resources/glyphs.pbf");
+    // The stream of this thread is reset for each call, and set up again when the format changes
+    for (int i = 0; i < 2; ++i) {
+        for (int format : {util::ZLIB, util::ZLIB, util::GZIP, util::DEFLATE, util::ZLIB}) {
+            EXPECT_EQ(raw, util::decompress(util::compress(raw, format), format));
+        }
+    }
+}
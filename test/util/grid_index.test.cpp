@@ -55,3 +55,74 @@ TEST(GridIndex, IndexesFeaturesOverflow) {
     grid.insert(0, {{4500, 4500}, {4900, 4900}});
     EXPECT_EQ(grid.query({{4000, 4000}, {5000, 5000}}), (std::vector<int16_t>{0}));
 }
+
+TEST(GridIndex, ManyElementsPerCell) {
+    GridIndex<int16_t> grid(100, 100, 25);
+    std::vector<int16_t> all;
+    for (int16_t i = 0; i < 40; ++i) {
+        // Even elements span four cells, odd ones stay within the first
+        const float size = i % 2 ? 5.0f : 30.0f;
+        grid.insert(int16_t(i), {{10, 10}, {10 + size, 10 + size}});
+        all.push_back(i);
+    }
+
+    // Every element is reported once, in insertion order
+    EXPECT_EQ(grid.query({{0, 0}, {99, 99}}), all);
+
+    std::vector<int16_t> even;
+    for (int16_t i = 0; i < 40; i += 2) {
+        even.push_back(i);
+    }
+    EXPECT_EQ(grid.query({{30, 30}, {60, 60}}), even);
+}
+
+TEST(GridIndex, FewElementsPerCell) {
+    // The first elements of a cell are kept in the cell itself, the third goes to a block
+    GridIndex<int16_t> grid(100, 100, 25);
+    grid.insert(0, {{0, 0}, {5, 5}});
+    grid.insert(1, {{20, 20}, {24, 24}});
+    grid.insert(2, {{10, 10}, {12, 12}});
+    grid.insert(3, {{16, 4}, 2});
+
+    EXPECT_EQ(grid.query({{15, 15}, {22, 22}}), (std::vector<int16_t>{1}));
+    EXPECT_EQ(grid.query({{8, 8}, {11, 11}}), (std::vector<int16_t>{2}));
+    EXPECT_EQ(grid.query({{1, 1}, {30, 30}}), (std::vector<int16_t>{0, 1, 2, 3}));
+    EXPECT_EQ(grid.query({{14, 0}, {15, 3}}), (std::vector<int16_t>{3}));
+    EXPECT_FALSE(grid.hitTest({{6, 6}, {9, 9}}));
+    EXPECT_TRUE(grid.hitTest({{17, 5}, 1}));
+}
+
+TEST(GridIndex, Visitor) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{4, 10}, {6, 30}});
+    grid.insert(1, {{4, 10}, {30, 12}});
+    grid.insert(2, {{50, 50}, 10});
+
+    std::vector<int16_t> visited;
+    EXPECT_TRUE(grid.query({{0, 0}, {60, 60}}, [&](int16_t key, const GridIndex<int16_t>::BBox&) {
+        visited.push_back(key);
+        return key == 1;
+    }));
+    EXPECT_EQ(visited, (std::vector<int16_t>{0, 1}));
+
+    visited.clear();
+    EXPECT_FALSE(grid.query({{0, 0}, {60, 60}}, [&](int16_t key, const GridIndex<int16_t>::BBox& bbox) {
+        visited.push_back(key);
+        if (key == 2) {
+            EXPECT_EQ(GridIndex<int16_t>::BBox({{40, 40}, {60, 60}}), bbox);
+        }
+        return false;
+    }));
+    EXPECT_EQ(visited, (std::vector<int16_t>{0, 1, 2}));
+}
+
+TEST(GridIndex, HitTestPredicate) {
+    GridIndex<int16_t> grid(100, 100, 10);
+    grid.insert(0, {{4, 10}, {6, 30}});
+    grid.insert(1, {{50, 50}, 10});
+
+    EXPECT_TRUE(grid.hitTest({{0, 0}, {10, 10}}));
+    EXPECT_FALSE(grid.hitTest({{0, 0}, {10, 10}}, [](int16_t key) { return key != 0; }));
+    EXPECT_TRUE(grid.hitTest({{55, 55}, 2}, [](int16_t key) { return key == 1; }));
+    EXPECT_FALSE(grid.hitTest({{55, 55}, 2}, [](int16_t key) { return key == 0; }));
+}
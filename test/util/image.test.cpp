@@ -1,11 +1,51 @@
 #include <mbgl/test/util.hpp>
 
 #include <mbgl/util/premultiply.hpp>
+#include <mbgl/util/compression.hpp>
 #include <mbgl/util/image.hpp>
 #include <mbgl/util/io.hpp>
 
+#include <string>
+
 using namespace mln;
 
+namespace {
+
+// The encoder as it was before it gained options: unfiltered rows, deflated in one piece with util::compress
+std::string encodeReferencePNG(const PremultipliedImage& pre) {
+    const auto src = util::unpremultiply(pre.clone());
+
+    const auto appendUInt32 = [](std::string& out, uint32_t value) {
+        const char bytes[4] = {char(value >> 24), char(value >> 16), char(value >> 8), char(value)};
+        out.append(bytes, 4);
+    };
+    const auto addChunk = [&](std::string& png, const char* type, const std::string& data) {
+        const std::string typed = type + data;
+        appendUInt32(png, static_cast<uint32_t>(data.size()));
+        png.append(typed);
+        appendUInt32(png, util::crc32(typed.data(), typed.size()));
+    };
+
+    std::string ihdr;
+    appendUInt32(ihdr, src.size.width);
+    appendUInt32(ihdr, src.size.height);
+    ihdr.append({8, 6, 0, 0, 0});
+
+    std::string idat;
+    for (uint32_t y = 0; y < src.size.height; y++) {
+        idat.append(1, 0);
+        idat.append(reinterpret_cast<const char*>(src.data.get() + y * src.stride()), src.stride());
+    }
+
+    std::string png = {char(0x89), 'P', 'N', 'G', '\r', '\n', 0x1a, '\n'};
+    addChunk(png, "IHDR", ihdr);
+    addChunk(png, "IDAT", util::compress(idat));
+    addChunk(png, "IEND", "");
+    return png;
+}
+
+} // namespace
+
 TEST(Image, PNGRoundTrip) {
     PremultipliedImage rgba({1, 1});
     rgba.data[0] = 128;
@@ -34,6 +74,49 @@ TEST(Image, PNGRoundTripAlpha) {
     EXPECT_EQ(128, image.data[3]);
 }
 
+TEST(Image, PNGEncodeOptions) {
+    // Large enough to be split into blocks of rows, with opaque, translucent and clear pixels
+    PremultipliedImage rgba({512, 512});
+    for (uint32_t y = 0; y < rgba.size.height; y++) {
+        for (uint32_t x = 0; x < rgba.size.width; x++) {
+            uint8_t* pixel = rgba.data.get() + rgba.stride() * y + 4 * x;
+            const auto alpha = static_cast<uint8_t>(x % 3 == 0 ? 255 : (x % 3 == 1 ? (x * y) % 256 : 0));
+            pixel[0] = static_cast<uint8_t>((x * alpha) / 512);
+            pixel[1] = static_cast<uint8_t>((y * alpha) / 512);
+            pixel[2] = static_cast<uint8_t>(((x ^ y) % 256 * alpha) / 255);
+            pixel[3] = alpha;
+        }
+    }
+
+    // The default options encode the same bytes as before
+    const std::string reference = encodeReferencePNG(rgba);
+    EXPECT_EQ(reference, encodePNG(rgba));
+    EXPECT_EQ(reference, encodePNG(rgba, PNGEncodeOptions()));
+    const PremultipliedImage expected = decodeImage(reference);
+
+    for (int level : {1, 6, 9}) {
+        for (bool adaptiveFiltering : {false, true}) {
+            for (std::size_t threads : {1, 4}) {
+                PNGEncodeOptions options;
+                options.compressionLevel = level;
+                options.adaptiveFiltering = adaptiveFiltering;
+                options.threads = threads;
+
+                const PremultipliedImage image = decodeImage(encodePNG(rgba, options));
+                ASSERT_EQ(expected.size, image.size);
+                EXPECT_EQ(0, std::memcmp(expected.data.get(), image.data.get(), image.bytes()))
+                    << "level " << level << ", adaptive filtering " << adaptiveFiltering << ", threads " << threads;
+            }
+        }
+    }
+
+    // Rows without pixels have nothing to filter
+    PNGEncodeOptions options;
+    options.adaptiveFiltering = true;
+    options.threads = 4;
+    EXPECT_NO_THROW(encodePNG(PremultipliedImage({0, 2}), options));
+}
+
 TEST(Image, PNGReadNoProfile) {
     PremultipliedImage image = decodeImage(util::read_file("test/fixtures/image/no_profile.png"));
     EXPECT_EQ(128, image.data[0]);
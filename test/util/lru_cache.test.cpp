@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 using namespace mln;
 
@@ -36,3 +38,45 @@ TEST(LRU, LRU) {
     EXPECT_FALSE(lru.isHit(4));
     EXPECT_THROW(lru.evict(), std::runtime_error);
 }
+
+TEST(LRU, SizedLRU) {
+    SizedLRU<int, std::string> lru(10);
+    EXPECT_TRUE(lru.put(1, "one", 4));
+    EXPECT_TRUE(lru.put(2, "two", 4));
+    EXPECT_EQ(2u, lru.size());
+    EXPECT_EQ(8u, lru.getBytes());
+
+    // Looking a value up with get() makes it the most recently used, with find() it doesn't
+    ASSERT_TRUE(lru.get(1));
+    EXPECT_EQ("one", *lru.get(1));
+    ASSERT_TRUE(lru.find(2));
+    EXPECT_FALSE(lru.get(3));
+
+    EXPECT_TRUE(lru.put(3, "three", 4));
+    EXPECT_FALSE(lru.contains(2));
+    EXPECT_TRUE(lru.contains(1));
+    EXPECT_TRUE(lru.contains(3));
+    EXPECT_EQ(1u, lru.getEvictions());
+
+    // Replacing a value, and one too large to be kept
+    EXPECT_TRUE(lru.put(3, "drei", 5));
+    EXPECT_EQ(9u, lru.getBytes());
+    EXPECT_FALSE(lru.put(4, "four", 11));
+    EXPECT_FALSE(lru.contains(4));
+
+    std::vector<int> keys;
+    lru.forEach([&](int key, const std::string&) { keys.push_back(key); });
+    EXPECT_EQ((std::vector<int>{1, 3}), keys);
+
+    lru.setMaxBytes(5);
+    EXPECT_EQ(1u, lru.size());
+    EXPECT_EQ(2u, lru.getEvictions());
+    lru.remove(3);
+    EXPECT_EQ(0u, lru.size());
+    EXPECT_EQ(0u, lru.getBytes());
+
+    lru.put(5, "five", 1);
+    lru.clear();
+    EXPECT_EQ(0u, lru.size());
+    EXPECT_EQ(0u, lru.getBytes());
+}
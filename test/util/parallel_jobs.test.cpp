@@ -0,0 +1,41 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/actor/scheduler.hpp>
+#include <mbgl/util/parallel_jobs.hpp>
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace mln;
+
+TEST(ParallelJobs, RunsEveryJobOnce) {
+    std::vector<std::atomic<int>> runs(1000);
+    util::ParallelJobs jobs(runs.size(), [&](std::size_t i) { ++runs[i]; });
+    jobs.schedule(*Scheduler::GetBackground());
+    jobs.run();
+
+    for (const auto& count : runs) {
+        EXPECT_EQ(1, count);
+    }
+}
+
+TEST(ParallelJobs, NoJobs) {
+    util::ParallelJobs jobs(0, [](std::size_t) { FAIL(); });
+    jobs.schedule(*Scheduler::GetBackground());
+    jobs.run();
+}
+
+TEST(ParallelJobs, Exception) {
+    std::atomic<std::size_t> finished{0};
+    util::ParallelJobs jobs(100, [&](std::size_t i) {
+        if (i == 42) {
+            throw std::runtime_error("job failed");
+        }
+        ++finished;
+    });
+    jobs.schedule(*Scheduler::GetBackground());
+    EXPECT_THROW(jobs.run(), std::runtime_error);
+    // The other jobs still ran
+    EXPECT_EQ(99u, finished);
+}
@@ -0,0 +1,94 @@
+#include <mbgl/util/polygon_index.hpp>
+
+#include <mbgl/test/util.hpp>
+
+#include <cmath>
+#include <random>
+
+using namespace mln;
+
+namespace {
+
+LinearRing<int64_t> square(int64_t x1, int64_t y1, int64_t x2, int64_t y2) {
+    return {{x1, y1}, {x2, y1}, {x2, y2}, {x1, y2}, {x1, y1}};
+}
+
+/// A closed ring around a center, with a radius changing from vertex to vertex, so that many of its edges
+/// are crossed by a horizontal line through the center
+LinearRing<int64_t> star(std::mt19937& generator, Point<int64_t> center, std::size_t vertices) {
+    std::uniform_int_distribution<int64_t> radius(200, 1000);
+    LinearRing<int64_t> ring;
+    for (std::size_t i = 0; i < vertices; ++i) {
+        const double angle = 2 * M_PI * static_cast<double>(i) / static_cast<double>(vertices);
+        const auto r = static_cast<double>(radius(generator));
+        ring.emplace_back(center.x + static_cast<int64_t>(std::round(r * std::cos(angle))),
+                          center.y + static_cast<int64_t>(std::round(r * std::sin(angle))));
+    }
+    ring.push_back(ring.front());
+    return ring;
+}
+
+} // namespace
+
+TEST(PolygonIndex, Points) {
+    const MultiPolygon<int64_t> polygons{{square(0, 0, 100, 100), square(20, 20, 40, 40)}, {{square(200, 0, 300, 50)}}};
+    const PolygonIndex index(polygons);
+
+    EXPECT_EQ(index.getBBox(), (GeometryBBox<int64_t>{{0, 0, 300, 100}}));
+    EXPECT_TRUE(index.contains(Point<int64_t>{10, 10}));
+    EXPECT_TRUE(index.contains(Point<int64_t>{250, 25}));
+    // In the hole
+    EXPECT_FALSE(index.contains(Point<int64_t>{30, 30}));
+    // On a boundary
+    EXPECT_FALSE(index.contains(Point<int64_t>{0, 50}));
+    EXPECT_FALSE(index.contains(Point<int64_t>{40, 30}));
+    // Outside
+    EXPECT_FALSE(index.contains(Point<int64_t>{150, 25}));
+    EXPECT_FALSE(index.contains(Point<int64_t>{250, 75}));
+    EXPECT_FALSE(index.contains(Point<int64_t>{50, -10}));
+}
+
+TEST(PolygonIndex, Lines) {
+    const MultiPolygon<int64_t> polygons{{square(0, 0, 100, 100), square(20, 20, 40, 40)}, {{square(200, 0, 300, 50)}}};
+    const PolygonIndex index(polygons);
+
+    EXPECT_TRUE(index.contains(LineString<int64_t>{{10, 10}, {90, 10}, {90, 90}}));
+    EXPECT_TRUE(index.contains(LineString<int64_t>{{210, 10}, {290, 40}}));
+    // Crosses the hole
+    EXPECT_FALSE(index.contains(LineString<int64_t>{{10, 30}, {90, 30}}));
+    // Leaves the polygon between its points
+    EXPECT_FALSE(index.contains(LineString<int64_t>{{10, 10}, {90, 10}, {90, 90}, {50, 150}, {10, 90}}));
+    // Its points are in different polygons
+    EXPECT_FALSE(index.contains(LineString<int64_t>{{10, 10}, {250, 25}}));
+    EXPECT_FALSE(index.contains(LineString<int64_t>{}));
+}
+
+TEST(PolygonIndex, MatchesLinearScan) {
+    std::mt19937 generator(42);
+    MultiPolygon<int64_t> polygons;
+    for (int i = 0; i < 4; ++i) {
+        const Point<int64_t> center{i * 1500, (i % 2) * 500};
+        polygons.push_back({star(generator, center, 2000), star(generator, center, 50)});
+    }
+    const PolygonIndex index(polygons);
+
+    std::uniform_int_distribution<int64_t> x(-1200, 5700);
+    std::uniform_int_distribution<int64_t> y(-1200, 1700);
+    std::uniform_int_distribution<int64_t> step(-100, 100);
+    std::size_t contained = 0;
+    for (int i = 0; i < 5000; ++i) {
+        const Point<int64_t> point{x(generator), y(generator)};
+        const bool expected = pointWithinPolygons(point, polygons);
+        ASSERT_EQ(expected, index.contains(point)) << point.x << ", " << point.y;
+        contained += expected;
+
+        LineString<int64_t> line{point};
+        for (int j = 0; j < 4; ++j) {
+            line.emplace_back(line.back().x + step(generator), line.back().y + step(generator));
+        }
+        ASSERT_EQ(lineStringWithinPolygons(line, polygons), index.contains(line)) << point.x << ", " << point.y;
+    }
+    // Both sides are covered
+    EXPECT_LT(250u, contained);
+    EXPECT_GT(4750u, contained);
+}
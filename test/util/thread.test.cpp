@@ -5,9 +5,11 @@
 #include <mbgl/platform/settings.hpp>
 #include <mbgl/test/util.hpp>
 #include <mbgl/util/run_loop.hpp>
+#include <mbgl/util/thread_pool.hpp>
 #include <mbgl/util/timer.hpp>
 
 #include <atomic>
+#include <future>
 #include <memory>
 
 using namespace mln;
@@ -477,3 +479,83 @@ TEST(Thread, TaggedPools) {
     // Same for queue 2
     ASSERT_TRUE(totalRuns2 == runCount2);
 }
+
+TEST(Thread, WorkStealingTaggedOrder) {
+    // A single worker dequeues each tag strictly in submission order
+    std::shared_ptr<Scheduler> pool = std::make_shared<ParallelScheduler>(0, SchedulingStrategy::WorkStealing);
+    const util::SimpleIdentity tag1;
+    const util::SimpleIdentity tag2;
+
+    std::vector<int> order1;
+    std::vector<int> order2;
+    constexpr int taskCount = 100;
+    for (int i = 0; i < taskCount; ++i) {
+        pool->schedule(tag1, [&, i] { order1.push_back(i); });
+        pool->schedule(tag2, [&, i] { order2.push_back(i); });
+    }
+
+    pool->waitForEmpty(tag1);
+    pool->waitForEmpty(tag2);
+
+    ASSERT_EQ(static_cast<std::size_t>(taskCount), order1.size());
+    ASSERT_EQ(static_cast<std::size_t>(taskCount), order2.size());
+    for (int i = 0; i < taskCount; ++i) {
+        EXPECT_EQ(i, order1[i]);
+        EXPECT_EQ(i, order2[i]);
+    }
+}
+
+TEST(Thread, WorkStealingWaitRecursiveAdd) {
+    std::shared_ptr<Scheduler> pool = std::make_shared<ThreadPool>(SchedulingStrategy::WorkStealing);
+    const util::SimpleIdentity tag;
+
+    std::atomic<int> executed{0};
+    constexpr int taskCount = 200;
+    for (int i = 0; i < taskCount; ++i) {
+        // Tasks scheduled from a worker land in its own deque and must be stolen by the others
+        pool->schedule(tag, [&] {
+            pool->schedule(tag, [&] {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                executed++;
+            });
+            executed++;
+        });
+    }
+
+    pool->waitForEmpty(tag);
+    EXPECT_EQ(2 * taskCount, executed);
+}
+
+TEST(Thread, PriorityOrder) {
+    for (const auto strategy : {SchedulingStrategy::SharedQueue, SchedulingStrategy::WorkStealing}) {
+        std::shared_ptr<Scheduler> pool = std::make_shared<ParallelScheduler>(0, strategy);
+        const util::SimpleIdentity tag;
+
+        // Occupy the only worker until everything is queued
+        std::promise<void> started;
+        std::promise<void> release;
+        pool->schedule(tag, [&, released = release.get_future().share()] {
+            started.set_value();
+            released.wait();
+        });
+        started.get_future().wait();
+
+        auto stale = std::make_shared<std::atomic<int32_t>>(-1);
+        auto low = std::make_shared<std::atomic<int32_t>>(1);
+        auto high = std::make_shared<std::atomic<int32_t>>(2);
+
+        std::vector<std::string> order;
+        pool->scheduleWithPriority(tag, [&] { order.emplace_back("stale"); }, stale);
+        pool->schedule(tag, [&] { order.emplace_back("plain"); });
+        pool->scheduleWithPriority(tag, [&] { order.emplace_back("low"); }, low);
+        pool->scheduleWithPriority(tag, [&] { order.emplace_back("high"); }, high);
+
+        // Priorities can change while tasks are pending
+        low->store(3);
+
+        release.set_value();
+        pool->waitForEmpty(tag);
+
+        EXPECT_EQ((std::vector<std::string>{"low", "high", "plain", "stale"}), order);
+    }
+}
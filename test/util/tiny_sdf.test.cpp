@@ -0,0 +1,190 @@
+#include <mbgl/test/util.hpp>
+
+#include <mbgl/util/tiny_sdf.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace mln;
+
+namespace {
+
+// The distance transform as it was before TinySDF kept its working memory and skipped lines
+// without edges, which the current one must match exactly.
+namespace reference {
+
+const double INF = 1e20;
+
+void edt1d(
+    std::vector<double>& f, std::vector<double>& d, std::vector<int16_t>& v, std::vector<double>& z, uint32_t n) {
+    v[0] = 0;
+    z[0] = -INF;
+    z[1] = +INF;
+
+    for (uint32_t q = 1, k = 0; q < n; q++) {
+        double s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ((f[q] + q * q) - (f[v[k]] + v[k] * v[k])) / (2 * q - 2 * v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k + 1] = +INF;
+    }
+
+    for (uint32_t q = 0, k = 0; q < n; q++) {
+        while (z[k + 1] < q) k++;
+        d[q] = (static_cast<double>(q) - v[k]) * (static_cast<double>(q) - v[k]) + f[v[k]];
+    }
+}
+
+void edt(std::vector<double>& data,
+         uint32_t width,
+         uint32_t height,
+         std::vector<double>& f,
+         std::vector<double>& d,
+         std::vector<int16_t>& v,
+         std::vector<double>& z) {
+    for (uint32_t x = 0; x < width; x++) {
+        for (uint32_t y = 0; y < height; y++) {
+            f[y] = data[y * width + x];
+        }
+        edt1d(f, d, v, z, height);
+        for (uint32_t y = 0; y < height; y++) {
+            data[y * width + x] = d[y];
+        }
+    }
+    for (uint32_t y = 0; y < height; y++) {
+        for (uint32_t x = 0; x < width; x++) {
+            f[x] = data[y * width + x];
+        }
+        edt1d(f, d, v, z, width);
+        for (uint32_t x = 0; x < width; x++) {
+            data[y * width + x] = std::sqrt(d[x]);
+        }
+    }
+}
+
+AlphaImage transformRasterToSDF(const AlphaImage& rasterInput, double radius, double cutoff) {
+    uint32_t size = rasterInput.size.width * rasterInput.size.height;
+    uint32_t maxDimension = std::max(rasterInput.size.width, rasterInput.size.height);
+
+    AlphaImage sdf(rasterInput.size);
+
+    std::vector<double> gridOuter(size);
+    std::vector<double> gridInner(size);
+    std::vector<double> f(maxDimension);
+    std::vector<double> d(maxDimension);
+    std::vector<double> z(maxDimension + 1);
+    std::vector<int16_t> v(maxDimension);
+
+    for (uint32_t i = 0; i < size; i++) {
+        double a = static_cast<double>(rasterInput.data[i]) / 255;
+        gridOuter[i] = a == 1.0 ? 0.0 : a == 0.0 ? INF : std::pow(std::max(0.0, 0.5 - a), 2.0);
+        gridInner[i] = a == 1.0 ? INF : a == 0.0 ? 0.0 : std::pow(std::max(0.0, a - 0.5), 2.0);
+    }
+
+    edt(gridOuter, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
+    edt(gridInner, rasterInput.size.width, rasterInput.size.height, f, d, v, z);
+
+    for (uint32_t i = 0; i < size; i++) {
+        double distance = gridOuter[i] - gridInner[i];
+        sdf.data[i] = static_cast<uint8_t>(
+            std::max(0l, std::min(255l, ::lround(255.0 - 255.0 * (distance / radius + cutoff)))));
+    }
+
+    return sdf;
+}
+
+} // namespace reference
+
+// A square with antialiased edges, within an empty border
+AlphaImage makeRaster(uint32_t size, uint32_t border) {
+    AlphaImage raster({size, size});
+    for (uint32_t y = 0; y < size; y++) {
+        for (uint32_t x = 0; x < size; x++) {
+            const bool inside = x >= border && y >= border && x < size - border && y < size - border;
+            const bool edge = inside && (x == border || y == border || x == size - border - 1);
+            raster.data[y * size + x] = edge ? 100 : (inside ? 255 : 0);
+        }
+    }
+    return raster;
+}
+
+bool equal(const AlphaImage& a, const AlphaImage& b) {
+    return a.size == b.size && std::equal(a.data.get(), a.data.get() + a.bytes(), b.data.get());
+}
+
+} // namespace
+
+TEST(TinySDF, Reuse) {
+    // Sizes on both sides of the largest lines whose empty parts are skipped
+    std::vector<AlphaImage> rasters;
+    for (uint32_t size : {30u, 120u, 12u, 91u, 92u}) {
+        rasters.push_back(makeRaster(size, size / 3));
+    }
+
+    util::TinySDF tinySDF;
+    std::vector<AlphaImage> sdfs;
+    for (const auto& raster : rasters) {
+        sdfs.push_back(tinySDF.transform(raster, 8, .25));
+    }
+    for (std::size_t i = 0; i < rasters.size(); i++) {
+        // A fresh generator, the one of this thread, and one that has transformed larger rasters agree
+        const auto sdf = util::TinySDF().transform(rasters[i], 8, .25);
+        EXPECT_TRUE(equal(sdf, sdfs[i])) << rasters[i].size.width;
+        EXPECT_TRUE(equal(sdf, util::transformRasterToSDF(rasters[i], 8, .25))) << rasters[i].size.width;
+        EXPECT_TRUE(equal(sdf, tinySDF.transform(rasters[i], 8, .25))) << rasters[i].size.width;
+    }
+
+    // Edges are at the middle of the range, the inside is brighter
+    const auto& sdf = sdfs[0];
+    EXPECT_EQ(0, sdf.data[0]);
+    EXPECT_EQ(255, sdf.data[15 * 30 + 15]);
+    EXPECT_GT(sdf.data[15 * 30 + 10], sdf.data[15 * 30 + 9]);
+}
+
+TEST(TinySDF, Uniform) {
+    for (uint32_t size : {1u, 30u, 120u}) {
+        AlphaImage raster({size, size});
+        raster.fill(0);
+        auto sdf = util::transformRasterToSDF(raster, 8, .25);
+        EXPECT_EQ(0, *std::max_element(sdf.data.get(), sdf.data.get() + sdf.bytes())) << size;
+
+        raster.fill(255);
+        sdf = util::transformRasterToSDF(raster, 8, .25);
+        EXPECT_EQ(255, *std::min_element(sdf.data.get(), sdf.data.get() + sdf.bytes())) << size;
+    }
+
+    EXPECT_EQ(Size(0, 0), util::transformRasterToSDF(AlphaImage({0, 0}), 8, .25).size);
+}
+
+TEST(TinySDF, Reference) {
+    std::vector<AlphaImage> rasters;
+    for (uint32_t size : {1u, 12u, 30u, 60u, 92u}) {
+        rasters.push_back(makeRaster(size, size / 3));
+        rasters.push_back(makeRaster(size, 0));
+    }
+    // Strokes of a glyph at double resolution, with lines both with and without edges in either direction
+    AlphaImage strokes({60, 48});
+    strokes.fill(0);
+    for (uint32_t along = 8; along < 40; along++) {
+        for (uint32_t across = 20; across < 24; across++) {
+            const uint8_t alpha = across == 20 || across == 23 ? 128 : 255;
+            strokes.data[across * 60 + along] = alpha;
+            strokes.data[along * 60 + across + 10] = alpha;
+        }
+    }
+    rasters.push_back(std::move(strokes));
+
+    util::TinySDF tinySDF;
+    for (const auto& raster : rasters) {
+        for (double radius : {8.0, 16.0}) {
+            const auto expected = reference::transformRasterToSDF(raster, radius, .25);
+            EXPECT_TRUE(equal(expected, tinySDF.transform(raster, radius, .25))) << raster.size.width;
+            EXPECT_TRUE(equal(expected, util::transformRasterToSDF(raster, radius, .25))) << raster.size.width;
+        }
+    }
+}